@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdio>
+#include <format>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Minimal registry of WarpBenchmarks, laid out like the one of WarpTests. Benchmarks register themselves with WARP_BENCHMARK,
+// get the command line arguments that follow their name and print their own timings
+namespace Warp::Benchmark
+{
+
+    using BenchmarkFunc = void(*)(std::span<char* const> args);
+
+    struct BenchmarkCase
+    {
+        const char* Name;
+        BenchmarkFunc Func;
+    };
+
+    std::vector<BenchmarkCase>& GetBenchmarks();
+
+    struct BenchmarkRegistrar
+    {
+        BenchmarkRegistrar(const char* name, BenchmarkFunc func) { GetBenchmarks().push_back(BenchmarkCase{ .Name = name, .Func = func }); }
+    };
+
+    // Results are printed rather than logged, logging is compiled out of release builds, which are the ones worth timing
+    template<typename... Args>
+    void Print(std::format_string<Args...> format, Args&&... args)
+    {
+        std::puts(std::format(format, std::forward<Args>(args)...).c_str());
+    }
+
+}
+
+#define WARP_BENCHMARK(Name)\
+    static void WarpBenchmark_##Name(std::span<char* const> args);\
+    static ::Warp::Benchmark::BenchmarkRegistrar s_warpBenchmarkRegistrar_##Name(#Name, &WarpBenchmark_##Name);\
+    static void WarpBenchmark_##Name(std::span<char* const> args)
\ No newline at end of file
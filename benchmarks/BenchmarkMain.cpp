@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "../src/Util/Logger.h"
+#include "../src/WinWrap.h"
+
+namespace Warp::Benchmark
+{
+
+    std::vector<BenchmarkCase>& GetBenchmarks()
+    {
+        static std::vector<BenchmarkCase> benchmarks;
+        return benchmarks;
+    }
+
+}
+
+// Runs the benchmark named by the first argument with the rest of the arguments. Lists the benchmarks if there is no such one
+int main(int argc, char** argv)
+{
+    using namespace Warp;
+
+    // Same setup as WinMain, image loaders decode through WIC
+    WinWrap::ScopedCOMLibrary comLibrary;
+    Log::Logger::Create();
+
+    const Benchmark::BenchmarkCase* benchmark = nullptr;
+    for (const Benchmark::BenchmarkCase& benchmarkCase : Benchmark::GetBenchmarks())
+    {
+        if (argc > 1 && std::strcmp(benchmarkCase.Name, argv[1]) == 0)
+        {
+            benchmark = &benchmarkCase;
+        }
+    }
+
+    if (!benchmark)
+    {
+        std::printf("Usage: WarpBenchmarks <benchmark> [arguments...]\n");
+        for (const Benchmark::BenchmarkCase& benchmarkCase : Benchmark::GetBenchmarks())
+        {
+            std::printf("    %s\n", benchmarkCase.Name);
+        }
+
+        Log::Logger::Delete();
+        return 1;
+    }
+
+    benchmark->Func(std::span<char* const>(argv + 2, static_cast<size_t>(argc - 2)));
+
+    Log::Logger::Delete();
+    return 0;
+}
\ No newline at end of file
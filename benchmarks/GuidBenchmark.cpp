@@ -0,0 +1,100 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_set>
+#include <vector>
+
+#include "../src/Util/Guid.h"
+#include "../src/Util/Timer.h"
+
+// WinApis GUID and CoCreateGuid, which Guid::Create() used before
+#include <combaseapi.h>
+
+namespace Warp
+{
+
+    // Times creation of Guids and hashing them against the previous implementations, then inserting and sorting them
+    // Usage: WarpBenchmarks Guids [number of Guids, 4000000 by default]
+    WARP_BENCHMARK(Guids)
+    {
+        const uint32_t numGuids = args.empty() ? 4'000'000 : static_cast<uint32_t>(std::strtoul(args[0], nullptr, 10));
+        std::vector<Guid> guids(numGuids);
+
+        Timer timer;
+        for (Guid& guid : guids)
+        {
+            guid = Guid::CreateV4();
+        }
+        double v4Ms = timer.GetElapsedMilliseconds();
+
+        timer.Reset();
+        for (Guid& guid : guids)
+        {
+            guid = Guid::CreateV7();
+        }
+        double v7Ms = timer.GetElapsedMilliseconds();
+
+        timer.Reset();
+        for (uint32_t i = 0; i < numGuids; ++i)
+        {
+            GUID winGuid;
+            CoCreateGuid(&winGuid);
+        }
+        double coCreateGuidMs = timer.GetElapsedMilliseconds();
+
+        Benchmark::Print("Guids -> Created {} Guids: CoCreateGuid {:.2f} ms, v4 {:.2f} ms, v7 {:.2f} ms ({:.1f}x)",
+            numGuids, coCreateGuidMs, v4Ms, v7Ms, coCreateGuidMs / std::max(v7Ms, 1e-3));
+
+        // Hashes are summed, thus the loops are not optimized away
+        uint64_t checksum = 0;
+        timer.Reset();
+        for (const Guid& guid : guids)
+        {
+            checksum += std::hash<Guid>()(guid);
+        }
+        double hashMs = timer.GetElapsedMilliseconds();
+
+        // Four std::hash calls chained with boost-style combining, which the specialization used before
+        auto combinedHash = [](const Guid& guid)
+            {
+                size_t seed = 0;
+                auto combine = [&seed]<typename T>(const T& value) { seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+                combine(guid.Data1);
+                combine(guid.Data2);
+                combine(guid.Data3);
+                combine(guid.Data4);
+                return seed;
+            };
+
+        timer.Reset();
+        for (const Guid& guid : guids)
+        {
+            checksum += combinedHash(guid);
+        }
+        double combinedHashMs = timer.GetElapsedMilliseconds();
+
+        Benchmark::Print("Guids -> Hashed {} Guids: combined std::hash {:.2f} ms, single pass {:.2f} ms ({:.1f}x), checksum {:x}",
+            numGuids, combinedHashMs, hashMs, combinedHashMs / std::max(hashMs, 1e-3), checksum);
+
+        timer.Reset();
+        std::unordered_set<Guid> set;
+        set.reserve(numGuids);
+        set.insert(guids.begin(), guids.end());
+        double insertMs = timer.GetElapsedMilliseconds();
+
+        // Sorting requires a strict weak ordering, v7 Guids of a single thread come out mostly sorted already
+        timer.Reset();
+        std::sort(guids.begin(), guids.end());
+        double sortMs = timer.GetElapsedMilliseconds();
+
+        size_t numUnique = static_cast<size_t>(std::unique(guids.begin(), guids.end()) - guids.begin());
+        if (numUnique != numGuids || set.size() != numGuids)
+        {
+            Benchmark::Print("Guids -> {} of {} Guids are duplicates", numGuids - numUnique, numGuids);
+        }
+
+        Benchmark::Print("Guids -> Inserted {} Guids into std::unordered_set in {:.2f} ms, sorted them in {:.2f} ms", numGuids, insertMs, sortMs);
+    }
+
+}
\ No newline at end of file
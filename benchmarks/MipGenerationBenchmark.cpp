@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../src/Assets/Importers/Formats/ImageLoader.h"
+#include "../src/Assets/Importers/Formats/MipGenerator.h"
+#include "../src/Util/ThreadPool.h"
+#include "../src/Util/Timer.h"
+
+namespace Warp
+{
+
+    // Decodes every .png and .jpg of the folder and times ImageLoader::GenerateMips() against DirectX::GenerateMipMaps() with
+    // TEX_FILTER_DEFAULT, which imports used before. Images are treated as albedo. Only mip generation is timed
+    // Usage: WarpBenchmarks MipGeneration <folder>
+    WARP_BENCHMARK(MipGeneration)
+    {
+        using namespace DirectX;
+
+        if (args.empty())
+        {
+            Benchmark::Print("MipGeneration -> Expected a folder of images, e.g. assets/Sponza");
+            return;
+        }
+
+        std::vector<std::string> filepaths;
+        std::error_code ec;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(args[0], ec))
+        {
+            std::string extension = entry.path().extension().string();
+            if (extension == ".png" || extension == ".jpg")
+            {
+                filepaths.push_back(entry.path().string());
+            }
+        }
+
+        ThreadPool threadPool;
+        const ImageLoader::MipGenerationDesc desc{ .Filter = ImageLoader::eMipFilter_Kaiser, .IsSrgb = true };
+
+        double totalDirectXTexMs = 0.0;
+        double totalSerialMs = 0.0;
+        double totalParallelMs = 0.0;
+        uint32_t numBenchmarked = 0;
+        for (const std::string& filepath : filepaths)
+        {
+            ImageLoader::Image source = ImageLoader::LoadWICFromFile(filepath, false);
+            if (!source.IsValid())
+            {
+                continue;
+            }
+
+            // Other formats fall back to DirectXTex in GenerateMips(), thus there would be nothing to compare
+            const TexMetadata& metadata = source.GetMetadata();
+            if (metadata.mipLevels != 1 || (MakeTypelessUNORM(MakeTypeless(metadata.format)) != DXGI_FORMAT_R8G8B8A8_UNORM &&
+                MakeTypelessUNORM(MakeTypeless(metadata.format)) != DXGI_FORMAT_B8G8R8A8_UNORM))
+            {
+                Benchmark::Print("MipGeneration -> Skipping {}, its format is not filtered by GenerateMips()", filepath);
+                continue;
+            }
+
+            Timer timer;
+            ScratchImage reference;
+            DirectX::GenerateMipMaps(source.DxImage.GetImages(), source.DxImage.GetImageCount(), metadata, TEX_FILTER_DEFAULT, 0, reference);
+            double directXTexMs = timer.GetElapsedMilliseconds();
+
+            // Every run gets a fresh copy of the top mip, copies are not timed
+            double elapsedMs[2] = {};
+            ThreadPool* threadPools[2] = { nullptr, &threadPool };
+            for (uint32_t run = 0; run < 2; ++run)
+            {
+                ImageLoader::Image image;
+                image.Filepath = filepath;
+                image.DxImage.InitializeFromImage(*source.DxImage.GetImages());
+
+                timer.Reset();
+                ImageLoader::GenerateMips(image, desc, threadPools[run]);
+                elapsedMs[run] = timer.GetElapsedMilliseconds();
+            }
+
+            Benchmark::Print("MipGeneration -> {} ({}x{}): DirectXTex {:.2f} ms, single thread {:.2f} ms, thread pool {:.2f} ms ({:.1f}x)",
+                filepath, metadata.width, metadata.height, directXTexMs, elapsedMs[0], elapsedMs[1], directXTexMs / std::max(elapsedMs[1], 1e-3));
+
+            totalDirectXTexMs += directXTexMs;
+            totalSerialMs += elapsedMs[0];
+            totalParallelMs += elapsedMs[1];
+            ++numBenchmarked;
+        }
+
+        Benchmark::Print("MipGeneration -> {} images: DirectXTex {:.2f} ms, single thread {:.2f} ms, thread pool {:.2f} ms ({:.1f}x)",
+            numBenchmarked, totalDirectXTexMs, totalSerialMs, totalParallelMs, totalDirectXTexMs / std::max(totalParallelMs, 1e-3));
+    }
+
+}
\ No newline at end of file
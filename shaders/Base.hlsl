@@ -13,6 +13,19 @@ struct ViewData
 #define DRAWFLAG_NO_NORMALMAP 8
 #define DRAWFLAG_NO_ROUGHNESSMETALNESSMAP 16
 #define DRAWFLAG_NO_BASECOLORMAP 32
+#define DRAWFLAG_16BIT_VERTEX_INDICES 64
+#define DRAWFLAG_QUANTIZED_VERTICES 128
+
+// Upper bound of vertices and primitives per meshlet. The renderer compiles a variant per supported size, see MeshAsset.h
+// Meshlets larger than a thread group are processed by the group in several iterations
+#ifndef MESHLET_SIZE
+#define MESHLET_SIZE 128
+#endif
+#ifndef MESHLET_NUM_THREADS
+#define MESHLET_NUM_THREADS 128
+#endif
+
+#include "OctahedronEncoding.hlsli"
 
 struct DrawData
 {
@@ -42,15 +55,19 @@ struct Meshlet
     uint PrimitiveOffset;
 };
 
-StructuredBuffer<float3> Positions : register(t0, space0);
-StructuredBuffer<float3> Normals : register(t0, space1);
-StructuredBuffer<float2> TexCoords : register(t0, space2);
-StructuredBuffer<float3> Tangents : register(t0, space3);
-StructuredBuffer<float3> Bitangents : register(t0, space4);
+// Vertex streams are raw, as their layout depends on DRAWFLAG_QUANTIZED_VERTICES. See Vertex.h:EVertexEncoding
+ByteAddressBuffer Positions : register(t0, space0);
+ByteAddressBuffer Normals : register(t0, space1);
+ByteAddressBuffer TexCoords : register(t0, space2);
+ByteAddressBuffer Tangents : register(t0, space3);
+ByteAddressBuffer Bitangents : register(t0, space4);
 StructuredBuffer<Meshlet> Meshlets : register(t1);
 ByteAddressBuffer UniqueVertexIndices : register(t2);
 StructuredBuffer<uint> PrimitiveIndices : register(t3);
 
+// Indices of meshlets that passed CPU culling, a group is dispatched for each of them. See Math/MeshletCulling.h
+StructuredBuffer<uint> VisibleMeshlets : register(t5);
+
 uint3 UnpackPrimitive(uint primitive)
 {
     // Unpacks a 10 bits per index triangle from a 32-bit uint.
@@ -65,59 +82,111 @@ uint3 GetPrimitive(Meshlet m, uint groupThreadID)
 uint GetVertexIndex(Meshlet m, uint localIndex)
 {
     localIndex = m.VertexOffset + localIndex;
+    if (CbDrawData.DrawFlags & DRAWFLAG_16BIT_VERTEX_INDICES)
+    {
+        // Byte address loads are 4-byte aligned, pick the half of the word that holds the index
+        uint word = UniqueVertexIndices.Load((localIndex * 2) & ~3);
+        return (localIndex & 1) ? (word >> 16) : (word & 0xFFFF);
+    }
     return UniqueVertexIndices.Load(localIndex * 4);
 }
 
+// Quantized positions are unorm16 relative to submesh bounds. InstanceToWorld brings them into model space as well
+float3 LoadPosition(uint vertexIndex)
+{
+    if (CbDrawData.DrawFlags & DRAWFLAG_QUANTIZED_VERTICES)
+    {
+        uint2 words = Positions.Load2(vertexIndex * 8);
+        return float3(words.x & 0xFFFF, words.x >> 16, words.y & 0xFFFF) / 65535.0;
+    }
+    return asfloat(Positions.Load3(vertexIndex * 12));
+}
+
+// Octahedral encoding with 16-bit snorm per component
+float3 LoadUnitVector(ByteAddressBuffer stream, uint vertexIndex)
+{
+    if (CbDrawData.DrawFlags & DRAWFLAG_QUANTIZED_VERTICES)
+    {
+        uint word = stream.Load(vertexIndex * 4);
+        int2 snorm = int2(word << 16, word) >> 16;
+        return Oct16_FastUnpack(max(float2(snorm) / 32767.0, -1.0));
+    }
+    return asfloat(stream.Load3(vertexIndex * 12));
+}
+
+float2 LoadTexCoord(uint vertexIndex)
+{
+    if (CbDrawData.DrawFlags & DRAWFLAG_QUANTIZED_VERTICES)
+    {
+        uint word = TexCoords.Load(vertexIndex * 4);
+        return f16tof32(uint2(word, word >> 16));
+    }
+    return asfloat(TexCoords.Load2(vertexIndex * 8));
+}
+
+// Quantized bitangents only store their handedness, one bit per vertex
+float3 LoadBitangent(uint vertexIndex, float3 normal, float3 tangent)
+{
+    if (CbDrawData.DrawFlags & DRAWFLAG_QUANTIZED_VERTICES)
+    {
+        uint word = Bitangents.Load((vertexIndex / 32) * 4);
+        float sign = ((word >> (vertexIndex % 32)) & 1) ? -1.0 : 1.0;
+        return cross(normal, tangent) * sign;
+    }
+    return asfloat(Bitangents.Load3(vertexIndex * 12));
+}
+
 OutVertex GetVertex(uint meshletIndex, uint vertexIndex)
 {
+    float3 position = LoadPosition(vertexIndex);
     matrix mvp = mul(CbDrawData.InstanceToWorld, mul(CbViewData.View, CbViewData.Projection));
-    float4 pos = mul(float4(Positions[vertexIndex], 1.0), mvp);
-    float4 posWorld = mul(float4(Positions[vertexIndex], 1.0), CbDrawData.InstanceToWorld);
+    float4 pos = mul(float4(position, 1.0), mvp);
+    float4 posWorld = mul(float4(position, 1.0), CbDrawData.InstanceToWorld);
     
+    float3 normal = LoadUnitVector(Normals, vertexIndex);
+
     OutVertex v;
     v.Pos = pos;
     v.PosWorld = posWorld.xyz;
-    v.Normal = normalize(mul(Normals[vertexIndex], (float3x3) CbDrawData.NormalMatrix));
+    v.Normal = normalize(mul(normal, (float3x3) CbDrawData.NormalMatrix));
     
     if (CbDrawData.DrawFlags & DRAWFLAG_HAS_TEXCOORDS)
-        v.TexUv = TexCoords[vertexIndex];
+        v.TexUv = LoadTexCoord(vertexIndex);
     
     if (CbDrawData.DrawFlags & DRAWFLAG_HAS_TANGENTS)
-        v.Tangent = Tangents[vertexIndex];
+        v.Tangent = LoadUnitVector(Tangents, vertexIndex);
     
     if (CbDrawData.DrawFlags & DRAWFLAG_HAS_BITANGENTS)
-        v.Bitangent = Bitangents[vertexIndex];
+        v.Bitangent = LoadBitangent(vertexIndex, normal, v.Tangent);
     
     return v;
 }
 
 [outputtopology("triangle")]
-[numthreads(128, 1, 1)]
+[numthreads(MESHLET_NUM_THREADS, 1, 1)]
 void MSMain(
     in uint groupID : SV_GroupID,
     in uint groupThreadID : SV_GroupThreadID,
-	out vertices OutVertex outVerts[128],
-	out indices uint3 outIndices[128])
+	out vertices OutVertex outVerts[MESHLET_SIZE],
+	out indices uint3 outIndices[MESHLET_SIZE])
 {
-    // In fact, we need to do Meshlets[offsetOfMeshlet + groupThreadID] but for cube it is good enough
-    Meshlet m = Meshlets[groupID];
+    uint meshletIndex = VisibleMeshlets[groupID];
+    Meshlet m = Meshlets[meshletIndex];
     
     SetMeshOutputCounts(m.VertexCount, m.PrimitiveCount);
 
-    if (groupThreadID < m.VertexCount)
+    for (uint v = groupThreadID; v < m.VertexCount; v += MESHLET_NUM_THREADS)
     {
-        uint vertexIndex = GetVertexIndex(m, groupThreadID);
-        outVerts[groupThreadID] = GetVertex(groupID, vertexIndex);
+        uint vertexIndex = GetVertexIndex(m, v);
+        outVerts[v] = GetVertex(meshletIndex, vertexIndex);
     }
     
-    if (groupThreadID < m.PrimitiveCount)
+    for (uint p = groupThreadID; p < m.PrimitiveCount; p += MESHLET_NUM_THREADS)
     {
-        outIndices[groupThreadID] = GetPrimitive(m, groupThreadID);
+        outIndices[p] = GetPrimitive(m, p);
     }
 }
 
-#include "OctahedronEncoding.hlsli"
-
 Texture2D BaseColor : register(t4, space0);
 Texture2D NormalMap : register(t4, space1);
 Texture2D RoughnessMetalnessMap : register(t4, space2);
@@ -147,7 +216,10 @@ OutFragment PSMain(OutVertex vertex)
         float3 tangent = normalize(vertex.Tangent);
         float3 bitangent = normalize(vertex.Bitangent);
         float3x3 TBN = float3x3(tangent, bitangent, SN);
-        float3 NSample = NormalMap.Sample(StaticSampler, vertex.TexUv).xyz * 2.0 - 1.0;
+        // Z is reconstructed, as BC5 normal maps only store X and Y. Tangent-space normals always point outwards
+        float3 NSample;
+        NSample.xy = NormalMap.Sample(StaticSampler, vertex.TexUv).xy * 2.0 - 1.0;
+        NSample.z = sqrt(saturate(1.0 - dot(NSample.xy, NSample.xy)));
         SN = normalize(mul(NSample, TBN));
     }
     
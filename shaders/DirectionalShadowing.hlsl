@@ -4,13 +4,33 @@ struct ViewData
     matrix Projection;
 };
 
+// see Renderer.h:EHlslDrawPropertyFlag
+#define DRAWFLAG_16BIT_VERTEX_INDICES 64
+#define DRAWFLAG_QUANTIZED_VERTICES 128
+
+// Upper bound of vertices and primitives per meshlet. The renderer compiles a variant per supported size, see MeshAsset.h
+// Meshlets larger than a thread group are processed by the group in several iterations
+#ifndef MESHLET_SIZE
+#define MESHLET_SIZE 128
+#endif
+#ifndef MESHLET_NUM_THREADS
+#define MESHLET_NUM_THREADS 128
+#endif
+
+// Draw data of every submesh is written once per frame and shared by every light, see Renderer.cpp:HlslShadowingDrawData
 struct DrawData
 {
     matrix InstanceToWorld;
+    uint DrawFlags;
+};
+
+struct DrawConstants
+{
+    uint DrawIndex;
 };
 
 ConstantBuffer<ViewData> CbViewData : register(b0);
-ConstantBuffer<DrawData> CbDrawData : register(b1);
+ConstantBuffer<DrawConstants> CbDrawConstants : register(b1);
 
 struct Meshlet
 {
@@ -25,10 +45,16 @@ struct OutVertex
     float4 Pos : SV_Position;
 };
 
-StructuredBuffer<float3> Positions : register(t0, space0);
+ByteAddressBuffer Positions : register(t0, space0);
 StructuredBuffer<Meshlet> Meshlets : register(t1);
 ByteAddressBuffer UniqueVertexIndices : register(t2);
 StructuredBuffer<uint> PrimitiveIndices : register(t3);
+StructuredBuffer<DrawData> DrawDatas : register(t4);
+
+DrawData GetDrawData()
+{
+    return DrawDatas[CbDrawConstants.DrawIndex];
+}
 
 uint3 UnpackPrimitive(uint primitive)
 {
@@ -44,13 +70,30 @@ uint3 GetPrimitive(Meshlet m, uint groupThreadID)
 uint GetVertexIndex(Meshlet m, uint localIndex)
 {
     localIndex = m.VertexOffset + localIndex;
+    if (GetDrawData().DrawFlags & DRAWFLAG_16BIT_VERTEX_INDICES)
+    {
+        // Byte address loads are 4-byte aligned, pick the half of the word that holds the index
+        uint word = UniqueVertexIndices.Load((localIndex * 2) & ~3);
+        return (localIndex & 1) ? (word >> 16) : (word & 0xFFFF);
+    }
     return UniqueVertexIndices.Load(localIndex * 4);
 }
 
+// Same as in Base.hlsl. InstanceToWorld dequantizes positions as well
+float3 LoadPosition(uint vertexIndex)
+{
+    if (GetDrawData().DrawFlags & DRAWFLAG_QUANTIZED_VERTICES)
+    {
+        uint2 words = Positions.Load2(vertexIndex * 8);
+        return float3(words.x & 0xFFFF, words.x >> 16, words.y & 0xFFFF) / 65535.0;
+    }
+    return asfloat(Positions.Load3(vertexIndex * 12));
+}
+
 OutVertex GetVertex(uint meshletIndex, uint vertexIndex)
 {
-    matrix mvp = mul(CbDrawData.InstanceToWorld, mul(CbViewData.View, CbViewData.Projection));
-    float4 pos = mul(float4(Positions[vertexIndex], 1.0), mvp);
+    matrix mvp = mul(GetDrawData().InstanceToWorld, mul(CbViewData.View, CbViewData.Projection));
+    float4 pos = mul(float4(LoadPosition(vertexIndex), 1.0), mvp);
     
     OutVertex v;
     v.Pos = pos;
@@ -58,24 +101,24 @@ OutVertex GetVertex(uint meshletIndex, uint vertexIndex)
 }
 
 [outputtopology("triangle")]
-[numthreads(128, 1, 1)]
+[numthreads(MESHLET_NUM_THREADS, 1, 1)]
 void MSMain(
     in uint groupID : SV_GroupID,
     in uint groupThreadID : SV_GroupThreadID,
-    out vertices OutVertex outVerts[128],
-    out indices uint3 outIndices[128])
+    out vertices OutVertex outVerts[MESHLET_SIZE],
+    out indices uint3 outIndices[MESHLET_SIZE])
 {
     Meshlet m = Meshlets[groupID];
     SetMeshOutputCounts(m.VertexCount, m.PrimitiveCount);
     
-    if (groupThreadID < m.VertexCount)
+    for (uint v = groupThreadID; v < m.VertexCount; v += MESHLET_NUM_THREADS)
     {
-        uint vertexIndex = GetVertexIndex(m, groupThreadID);
-        outVerts[groupThreadID] = GetVertex(groupID, vertexIndex);
+        uint vertexIndex = GetVertexIndex(m, v);
+        outVerts[v] = GetVertex(groupID, vertexIndex);
     }
     
-    if (groupThreadID < m.PrimitiveCount)
+    for (uint p = groupThreadID; p < m.PrimitiveCount; p += MESHLET_NUM_THREADS)
     {
-        outIndices[groupThreadID] = GetPrimitive(m, groupThreadID);
+        outIndices[p] = GetPrimitive(m, p);
     }
 }
\ No newline at end of file
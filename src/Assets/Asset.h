@@ -50,6 +50,9 @@ namespace Warp
         inline constexpr bool IsValid() const { return GetID() != Asset::InvalidID && m_type != EAssetType::Unknown; }
 
     protected:
+        // Assets created for a filepath take the Guid the filepath was given in previous runs, see AssetDatabase
+        friend class AssetManager;
+
         uint32_t    m_ID = Asset::InvalidID;
         EAssetType  m_type = EAssetType::Unknown;
 
@@ -66,10 +69,12 @@ namespace Warp
         AssetProxy(AssetProxy&& other) noexcept
             : ID(other.ID)
             , Index(other.Index)
+            , Generation(other.Generation)
             , Type(other.Type)
         {
             other.ID = Asset::InvalidID;
             other.Index = Asset::InvalidID;
+            other.Generation = 0;
             other.Type = EAssetType::Unknown;
         }
 
@@ -77,13 +82,15 @@ namespace Warp
         {
             if (this != &other)
             {
-                this->ID    = other.ID;
-                this->Index = other.Index;
-                this->Type  = other.Type;
-
-                other.ID    = Asset::InvalidID;
-                other.Index = Asset::InvalidID;
-                other.Type  = EAssetType::Unknown;
+                this->ID            = other.ID;
+                this->Index         = other.Index;
+                this->Generation    = other.Generation;
+                this->Type          = other.Type;
+
+                other.ID            = Asset::InvalidID;
+                other.Index         = Asset::InvalidID;
+                other.Generation    = 0;
+                other.Type          = EAssetType::Unknown;
             }
             return *this;
         }
@@ -96,6 +103,7 @@ namespace Warp
 
         uint32_t ID     = Asset::InvalidID; // Represents a unique identifier of an asset at runtime
         uint32_t Index  = Asset::InvalidID; // Index represents a value that can be used to access the actual asset inside of the registry
+        uint32_t Generation = 0; // Generation of the registry slot at Index. Slots are reused, proxies to destroyed assets do not match it anymore
         EAssetType Type = EAssetType::Unknown;
     };
 
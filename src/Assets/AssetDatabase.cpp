@@ -0,0 +1,616 @@
+#include "AssetDatabase.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <mutex>
+#include <type_traits>
+
+#include "../Core/Assert.h"
+#include "../Util/Hash.h"
+#include "../Util/Logger.h"
+
+namespace Warp
+{
+
+    // Index file layout (every section starts at AssetDatabaseFile::Alignment):
+    //   FileHeader
+    //   FileRecord[FileHeader::NumRecords]
+    //   uint32_t GuidTable[FileHeader::TableCapacity], record indices placed by the hash of their Guid with linear probing
+    //   uint32_t PathTable[FileHeader::TableCapacity], the same for hashes of source paths
+    //   String data (source and cooked paths), not null-terminated
+    //
+    // Section offsets are absolute offsets from the beginning of the file, string ranges are relative to the string data
+    // The format is little-endian and is not meant to be portable
+    namespace AssetDatabaseFile
+    {
+        static constexpr uint32_t Magic = 0x42444157; // "WADB"
+
+        // Bump the version whenever the layout of any structure below or the hashing of tables changes
+        static constexpr uint32_t Version = 1;
+
+        static constexpr uint64_t Alignment = 16;
+        static constexpr uint32_t EmptySlot = uint32_t(-1);
+        static constexpr uint32_t MinTableCapacity = 16;
+        static constexpr uint32_t MinProxyTableCapacity = 64;
+
+        inline constexpr uint64_t AlignUp(uint64_t value) { return (value + Alignment - 1) & ~(Alignment - 1); }
+
+        // Tables are part of the file, thus neither hash may depend on std::hash
+        static uint64_t HashGuid(const Guid& guid);
+        static uint64_t HashPath(std::string_view path) { return HashBytes(path.data(), path.size()).Low; }
+
+        // Returns true if the section lies within the file and starts at aligned offset
+        static bool IsValidSection(uint64_t offset, uint64_t numBytes, uint64_t fileSize);
+    }
+
+    struct AssetDatabase::FileHeader
+    {
+        uint32_t Magic = AssetDatabaseFile::Magic;
+        uint32_t Version = AssetDatabaseFile::Version;
+        uint64_t FileSize = 0;
+
+        uint32_t NumRecords = 0;
+        uint32_t TableCapacity = 0; // Power of two, always greater than NumRecords, thus probing ends at an empty slot
+        uint64_t RecordTableOffset = 0;
+        uint64_t GuidTableOffset = 0;
+        uint64_t PathTableOffset = 0;
+
+        uint64_t StringsOffset = 0;
+        uint64_t StringsNumBytes = 0;
+    };
+
+    struct AssetDatabase::FileRecord
+    {
+        Guid AssetGuid;
+        uint32_t Type = 0; // EAssetType
+        uint32_t Reserved = 0;
+
+        uint64_t SourcePathOffset = 0;
+        uint64_t SourcePathNumBytes = 0;
+        uint64_t CookedPathOffset = 0;
+        uint64_t CookedPathNumBytes = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Guid> && sizeof(Guid) == 16, "Guids are stored in the index as they are");
+
+    bool AssetDatabase::Load(const std::filesystem::path& filepath)
+    {
+        std::unique_lock lock(m_mutex);
+        return LoadUnlocked(filepath);
+    }
+
+    bool AssetDatabase::Save()
+    {
+        using namespace AssetDatabaseFile;
+
+        std::unique_lock lock(m_mutex);
+        if (m_records.empty())
+        {
+            return true;
+        }
+
+        if (m_filepath.empty())
+        {
+            WARP_LOG_ERROR("AssetDatabase::Save -> Nowhere to save, the database was never loaded");
+            return false;
+        }
+
+        // Mapped records that were not changed go first, they keep their order
+        std::vector<Record> records;
+        records.reserve(m_mappedRecords.size() + m_records.size());
+        for (uint32_t index = 0; index < static_cast<uint32_t>(m_mappedRecords.size()); ++index)
+        {
+            if (!m_recordsByGuid.contains(m_mappedRecords[index].AssetGuid))
+            {
+                records.push_back(GetMappedRecord(index));
+            }
+        }
+        records.insert(records.end(), m_records.begin(), m_records.end());
+
+        uint32_t numRecords = static_cast<uint32_t>(records.size());
+        uint32_t capacity = std::bit_ceil(std::max(MinTableCapacity, numRecords * 2));
+
+        std::string strings;
+        std::vector<FileRecord> fileRecords(numRecords);
+        std::vector<uint32_t> guidTable(capacity, EmptySlot);
+        std::vector<uint32_t> pathTable(capacity, EmptySlot);
+
+        auto insertIntoTable = [capacity](std::vector<uint32_t>& table, uint64_t hash, uint32_t index)
+            {
+                uint32_t slot = static_cast<uint32_t>(hash) & (capacity - 1);
+                while (table[slot] != EmptySlot)
+                {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+                table[slot] = index;
+            };
+
+        for (uint32_t index = 0; index < numRecords; ++index)
+        {
+            const Record& record = records[index];
+            FileRecord& fileRecord = fileRecords[index];
+            fileRecord.AssetGuid = record.AssetGuid;
+            fileRecord.Type = static_cast<uint32_t>(record.Type);
+            fileRecord.SourcePathOffset = strings.size();
+            fileRecord.SourcePathNumBytes = record.SourcePath.size();
+            strings.append(record.SourcePath);
+            fileRecord.CookedPathOffset = strings.size();
+            fileRecord.CookedPathNumBytes = record.CookedPath.size();
+            strings.append(record.CookedPath);
+
+            insertIntoTable(guidTable, HashGuid(record.AssetGuid), index);
+            insertIntoTable(pathTable, HashPath(record.SourcePath), index);
+        }
+
+        FileHeader header;
+        header.NumRecords = numRecords;
+        header.TableCapacity = capacity;
+        header.RecordTableOffset = AlignUp(sizeof(FileHeader));
+        header.GuidTableOffset = AlignUp(header.RecordTableOffset + numRecords * sizeof(FileRecord));
+        header.PathTableOffset = AlignUp(header.GuidTableOffset + capacity * sizeof(uint32_t));
+        header.StringsOffset = AlignUp(header.PathTableOffset + capacity * sizeof(uint32_t));
+        header.StringsNumBytes = strings.size();
+        header.FileSize = header.StringsOffset + header.StringsNumBytes;
+
+        // Write into a temporary file first and rename it afterwards, so that a crash never leaves a truncated index behind
+        std::filesystem::path tempFilepath = std::filesystem::path(m_filepath).concat(".tmp");
+        {
+            std::ofstream file(tempFilepath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                WARP_LOG_ERROR("AssetDatabase::Save -> Failed to open \'{}\' for writing", tempFilepath.string());
+                return false;
+            }
+
+            auto writeAt = [&file](uint64_t offset, const void* data, size_t numBytes)
+                {
+                    // Zero-fill the alignment gap
+                    static constexpr char Zeros[Alignment] = {};
+                    uint64_t position = static_cast<uint64_t>(file.tellp());
+                    WARP_ASSERT(offset >= position && offset - position < Alignment);
+                    file.write(Zeros, static_cast<std::streamsize>(offset - position));
+                    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(numBytes));
+                };
+
+            writeAt(0, &header, sizeof(header));
+            writeAt(header.RecordTableOffset, fileRecords.data(), fileRecords.size() * sizeof(FileRecord));
+            writeAt(header.GuidTableOffset, guidTable.data(), guidTable.size() * sizeof(uint32_t));
+            writeAt(header.PathTableOffset, pathTable.data(), pathTable.size() * sizeof(uint32_t));
+            writeAt(header.StringsOffset, strings.data(), strings.size());
+
+            if (!file)
+            {
+                WARP_LOG_ERROR("AssetDatabase::Save -> Failed to write \'{}\'", tempFilepath.string());
+                return false;
+            }
+        }
+
+        // Mapped files cannot be replaced, every record is kept in memory until the new index is mapped
+        ResetUnlocked();
+
+        std::error_code ec;
+        std::filesystem::rename(tempFilepath, m_filepath, ec);
+        if (ec || !LoadUnlocked(m_filepath))
+        {
+            WARP_LOG_ERROR("AssetDatabase::Save -> Failed to replace \'{}\': {}", m_filepath.string(), ec.message());
+            std::filesystem::remove(tempFilepath, ec);
+
+            ResetUnlocked();
+            for (Record& record : records)
+            {
+                AddRecordUnlocked(std::move(record), false);
+            }
+            return false;
+        }
+
+        WARP_LOG_INFO("AssetDatabase::Save -> Saved {} records into \'{}\' ({} bytes)", numRecords, m_filepath.string(), header.FileSize);
+        return true;
+    }
+
+    Guid AssetDatabase::Register(EAssetType type, std::string_view sourcePath, const Guid& newGuid)
+    {
+        {
+            std::shared_lock lock(m_mutex);
+            Guid guid = FindGuidUnlocked(sourcePath);
+            if (guid.IsValid())
+            {
+                return guid;
+            }
+        }
+
+        std::unique_lock lock(m_mutex);
+
+        // Another thread may have registered the path meanwhile
+        Guid guid = FindGuidUnlocked(sourcePath);
+        if (guid.IsValid())
+        {
+            return guid;
+        }
+
+        guid = newGuid.IsValid() ? newGuid : Guid::Create();
+        AddRecordUnlocked(Record{ .AssetGuid = guid, .Type = type, .SourcePath = std::string(sourcePath) }, false);
+        return guid;
+    }
+
+    void AssetDatabase::SetCookedPath(const Guid& guid, std::string_view cookedPath)
+    {
+        std::unique_lock lock(m_mutex);
+
+        auto it = m_recordsByGuid.find(guid);
+        if (it != m_recordsByGuid.end())
+        {
+            m_records[it->second].CookedPath = cookedPath;
+            return;
+        }
+
+        uint32_t index = FindMappedRecord(guid);
+        if (index == InvalidRecord)
+        {
+            return;
+        }
+
+        // Cooked paths are content-addressed, thus they mostly stay the same across runs and the index is not rewritten
+        Record record = GetMappedRecord(index);
+        if (record.CookedPath != cookedPath)
+        {
+            record.CookedPath = cookedPath;
+            AddRecordUnlocked(std::move(record), true);
+        }
+    }
+
+    bool AssetDatabase::FindRecord(const Guid& guid, Record& record) const
+    {
+        std::shared_lock lock(m_mutex);
+
+        auto it = m_recordsByGuid.find(guid);
+        if (it != m_recordsByGuid.end())
+        {
+            record = m_records[it->second];
+            return true;
+        }
+
+        uint32_t index = FindMappedRecord(guid);
+        if (index == InvalidRecord)
+        {
+            return false;
+        }
+
+        record = GetMappedRecord(index);
+        return true;
+    }
+
+    Guid AssetDatabase::FindGuid(std::string_view sourcePath) const
+    {
+        std::shared_lock lock(m_mutex);
+        return FindGuidUnlocked(sourcePath);
+    }
+
+    uint32_t AssetDatabase::GetNumRecords() const
+    {
+        std::shared_lock lock(m_mutex);
+        return static_cast<uint32_t>(m_mappedRecords.size() + m_records.size()) - m_numShadowedRecords;
+    }
+
+    void AssetDatabase::BindProxy(const Guid& guid, AssetProxy proxy)
+    {
+        if (!guid.IsValid())
+        {
+            return;
+        }
+
+        std::unique_lock lock(m_proxyMutex);
+
+        // Kept at most half full, tombstones included, thus probes stay short and always end at an empty slot
+        if ((m_numUsedProxySlots + 1) * 2 > m_proxySlots.size())
+        {
+            GrowProxyTable();
+        }
+
+        uint32_t mask = static_cast<uint32_t>(m_proxySlots.size()) - 1;
+        uint32_t slot = static_cast<uint32_t>(AssetDatabaseFile::HashGuid(guid)) & mask;
+        uint32_t tombstone = InvalidRecord;
+        for (; m_proxySlots[slot].Key.IsValid(); slot = (slot + 1) & mask)
+        {
+            ProxySlot& proxySlot = m_proxySlots[slot];
+            if (proxySlot.Key == guid)
+            {
+                proxySlot.Proxy = proxy;
+                return;
+            }
+
+            if (tombstone == InvalidRecord && !proxySlot.Proxy.IsValid())
+            {
+                tombstone = slot;
+            }
+        }
+
+        if (tombstone != InvalidRecord)
+        {
+            m_proxySlots[tombstone] = ProxySlot{ .Key = guid, .Proxy = proxy };
+            return;
+        }
+
+        m_proxySlots[slot] = ProxySlot{ .Key = guid, .Proxy = proxy };
+        ++m_numUsedProxySlots;
+    }
+
+    void AssetDatabase::UnbindProxy(const Guid& guid, AssetProxy proxy)
+    {
+        if (!guid.IsValid())
+        {
+            return;
+        }
+
+        std::unique_lock lock(m_proxyMutex);
+        if (m_proxySlots.empty())
+        {
+            return;
+        }
+
+        uint32_t mask = static_cast<uint32_t>(m_proxySlots.size()) - 1;
+        for (uint32_t slot = static_cast<uint32_t>(AssetDatabaseFile::HashGuid(guid)) & mask; m_proxySlots[slot].Key.IsValid(); slot = (slot + 1) & mask)
+        {
+            ProxySlot& proxySlot = m_proxySlots[slot];
+            if (proxySlot.Key == guid)
+            {
+                // The key stays, so that probes for Guids placed after it go on
+                if (proxySlot.Proxy.ID == proxy.ID)
+                {
+                    proxySlot.Proxy = AssetProxy();
+                }
+                return;
+            }
+        }
+    }
+
+    AssetProxy AssetDatabase::ResolveProxy(const Guid& guid) const
+    {
+        if (!guid.IsValid())
+        {
+            return AssetProxy();
+        }
+
+        std::shared_lock lock(m_proxyMutex);
+        if (m_proxySlots.empty())
+        {
+            return AssetProxy();
+        }
+
+        uint32_t mask = static_cast<uint32_t>(m_proxySlots.size()) - 1;
+        for (uint32_t slot = static_cast<uint32_t>(AssetDatabaseFile::HashGuid(guid)) & mask; m_proxySlots[slot].Key.IsValid(); slot = (slot + 1) & mask)
+        {
+            if (m_proxySlots[slot].Key == guid)
+            {
+                return m_proxySlots[slot].Proxy;
+            }
+        }
+
+        return AssetProxy();
+    }
+
+    uint32_t AssetDatabase::FindMappedRecord(const Guid& guid) const
+    {
+        if (m_guidTable.empty())
+        {
+            return InvalidRecord;
+        }
+
+        // Probes are bounded, thus a corrupted table without empty slots does not hang the lookup
+        uint32_t mask = static_cast<uint32_t>(m_guidTable.size()) - 1;
+        uint32_t slot = static_cast<uint32_t>(AssetDatabaseFile::HashGuid(guid)) & mask;
+        for (size_t numProbes = 0; numProbes < m_guidTable.size(); ++numProbes, slot = (slot + 1) & mask)
+        {
+            uint32_t index = m_guidTable[slot];
+            if (index == AssetDatabaseFile::EmptySlot)
+            {
+                break;
+            }
+
+            if (index < m_mappedRecords.size() && m_mappedRecords[index].AssetGuid == guid)
+            {
+                return index;
+            }
+        }
+
+        return InvalidRecord;
+    }
+
+    uint32_t AssetDatabase::FindMappedRecord(std::string_view sourcePath) const
+    {
+        if (m_pathTable.empty())
+        {
+            return InvalidRecord;
+        }
+
+        uint32_t mask = static_cast<uint32_t>(m_pathTable.size()) - 1;
+        uint32_t slot = static_cast<uint32_t>(AssetDatabaseFile::HashPath(sourcePath)) & mask;
+        for (size_t numProbes = 0; numProbes < m_pathTable.size(); ++numProbes, slot = (slot + 1) & mask)
+        {
+            uint32_t index = m_pathTable[slot];
+            if (index == AssetDatabaseFile::EmptySlot)
+            {
+                break;
+            }
+
+            if (index < m_mappedRecords.size())
+            {
+                const FileRecord& record = m_mappedRecords[index];
+                if (GetMappedString(record.SourcePathOffset, record.SourcePathNumBytes) == sourcePath)
+                {
+                    return index;
+                }
+            }
+        }
+
+        return InvalidRecord;
+    }
+
+    std::string_view AssetDatabase::GetMappedString(uint64_t offset, uint64_t numBytes) const
+    {
+        // Ranges of records are not validated on Load(), as that would touch every record
+        if (offset > m_strings.size() || numBytes > m_strings.size() - offset)
+        {
+            return std::string_view();
+        }
+
+        return std::string_view(m_strings.data() + offset, static_cast<size_t>(numBytes));
+    }
+
+    AssetDatabase::Record AssetDatabase::GetMappedRecord(uint32_t index) const
+    {
+        const FileRecord& record = m_mappedRecords[index];
+        EAssetType type = record.Type < static_cast<uint32_t>(EAssetType::NumTypes) ? static_cast<EAssetType>(record.Type) : EAssetType::Unknown;
+        return Record{
+            .AssetGuid = record.AssetGuid,
+            .Type = type,
+            .SourcePath = std::string(GetMappedString(record.SourcePathOffset, record.SourcePathNumBytes)),
+            .CookedPath = std::string(GetMappedString(record.CookedPathOffset, record.CookedPathNumBytes)),
+        };
+    }
+
+    Guid AssetDatabase::FindGuidUnlocked(std::string_view sourcePath) const
+    {
+        if (sourcePath.empty())
+        {
+            return Guid();
+        }
+
+        auto it = m_recordsByPath.find(sourcePath);
+        if (it != m_recordsByPath.end())
+        {
+            return m_records[it->second].AssetGuid;
+        }
+
+        uint32_t index = FindMappedRecord(sourcePath);
+        return index != InvalidRecord ? m_mappedRecords[index].AssetGuid : Guid();
+    }
+
+    void AssetDatabase::AddRecordUnlocked(Record&& record, bool shadowsMappedRecord)
+    {
+        uint32_t index = static_cast<uint32_t>(m_records.size());
+        m_recordsByGuid.insert_or_assign(record.AssetGuid, index);
+        m_recordsByPath.insert_or_assign(record.SourcePath, index);
+        m_records.push_back(std::move(record));
+
+        if (shadowsMappedRecord)
+        {
+            ++m_numShadowedRecords;
+        }
+    }
+
+    bool AssetDatabase::LoadUnlocked(const std::filesystem::path& filepath)
+    {
+        using namespace AssetDatabaseFile;
+
+        ResetUnlocked();
+        m_filepath = filepath;
+
+        std::error_code ec;
+        if (!std::filesystem::exists(filepath, ec))
+        {
+            WARP_LOG_INFO("AssetDatabase::Load -> No index at \'{}\', starting with an empty database", filepath.string());
+            return true;
+        }
+
+        if (!m_file.Open(filepath))
+        {
+            return false;
+        }
+
+        // Only the header and the placement of sections are validated, records and strings are checked as they are accessed
+        uint64_t fileSize = m_file.GetSize();
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(m_file.GetData());
+        bool isValid = fileSize >= sizeof(FileHeader) &&
+            header->Magic == AssetDatabaseFile::Magic &&
+            header->Version == AssetDatabaseFile::Version &&
+            header->FileSize == fileSize &&
+            std::has_single_bit(header->TableCapacity) && header->NumRecords < header->TableCapacity &&
+            IsValidSection(header->RecordTableOffset, uint64_t(header->NumRecords) * sizeof(FileRecord), fileSize) &&
+            IsValidSection(header->GuidTableOffset, uint64_t(header->TableCapacity) * sizeof(uint32_t), fileSize) &&
+            IsValidSection(header->PathTableOffset, uint64_t(header->TableCapacity) * sizeof(uint32_t), fileSize) &&
+            IsValidSection(header->StringsOffset, header->StringsNumBytes, fileSize);
+        if (!isValid)
+        {
+            WARP_LOG_WARN("AssetDatabase::Load -> \'{}\' is corrupted or outdated, starting with an empty database", filepath.string());
+            m_file.Close();
+            return false;
+        }
+
+        const std::byte* data = m_file.GetData();
+        m_header = header;
+        m_mappedRecords = std::span(reinterpret_cast<const FileRecord*>(data + header->RecordTableOffset), header->NumRecords);
+        m_guidTable = std::span(reinterpret_cast<const uint32_t*>(data + header->GuidTableOffset), header->TableCapacity);
+        m_pathTable = std::span(reinterpret_cast<const uint32_t*>(data + header->PathTableOffset), header->TableCapacity);
+        m_strings = std::span(reinterpret_cast<const char*>(data + header->StringsOffset), static_cast<size_t>(header->StringsNumBytes));
+
+        WARP_LOG_INFO("AssetDatabase::Load -> Mapped {} records from \'{}\'", header->NumRecords, filepath.string());
+        return true;
+    }
+
+    void AssetDatabase::ResetUnlocked()
+    {
+        m_header = nullptr;
+        m_mappedRecords = {};
+        m_guidTable = {};
+        m_pathTable = {};
+        m_strings = {};
+        m_file.Close();
+
+        m_records.clear();
+        m_recordsByGuid.clear();
+        m_recordsByPath.clear();
+        m_numShadowedRecords = 0;
+    }
+
+    void AssetDatabase::GrowProxyTable()
+    {
+        std::vector<ProxySlot> slots = std::move(m_proxySlots);
+
+        // Tombstones are dropped, thus a table full of them is rebuilt at the same capacity
+        uint32_t numBound = 0;
+        for (const ProxySlot& slot : slots)
+        {
+            numBound += slot.Proxy.IsValid() ? 1 : 0;
+        }
+
+        uint32_t capacity = std::bit_ceil(std::max(AssetDatabaseFile::MinProxyTableCapacity, numBound * 4));
+        m_proxySlots = std::vector<ProxySlot>(capacity);
+        m_numUsedProxySlots = numBound;
+
+        uint32_t mask = capacity - 1;
+        for (ProxySlot& slot : slots)
+        {
+            if (!slot.Proxy.IsValid())
+            {
+                continue;
+            }
+
+            uint32_t index = static_cast<uint32_t>(AssetDatabaseFile::HashGuid(slot.Key)) & mask;
+            while (m_proxySlots[index].Key.IsValid())
+            {
+                index = (index + 1) & mask;
+            }
+            m_proxySlots[index] = std::move(slot);
+        }
+    }
+
+    namespace AssetDatabaseFile
+    {
+        uint64_t HashGuid(const Guid& guid)
+        {
+            // Both halves are folded and finalized with splitmix64
+            uint64_t high = (uint64_t(guid.Data1) << 32) | (uint64_t(guid.Data2) << 16) | uint64_t(guid.Data3);
+            uint64_t hash = high ^ (guid.Data4 * 0x9E3779B97F4A7C15ull);
+            hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+            hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+            return hash ^ (hash >> 31);
+        }
+
+        bool IsValidSection(uint64_t offset, uint64_t numBytes, uint64_t fileSize)
+        {
+            return offset % Alignment == 0 && offset <= fileSize && numBytes <= fileSize - offset;
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Asset.h"
+#include "../Util/MappedFile.h"
+
+namespace Warp
+{
+
+    // Persistent mapping between Guids of assets, their source paths and cooked blobs (derived data, such as .wmesh, the asset is loaded from)
+    //
+    // A source path keeps its Guid across runs, thus cooked data may refer to assets by Guid instead of by path. The index is a single file,
+    // which Load() maps as it is. Records and both hash tables of the index are used in place, so loading only validates the header,
+    // regardless of the number of records. Records added or changed during the run are kept in memory and shadow the mapped ones until Save()
+    //
+    // Guids of loaded assets are resolved to their proxies with an open-addressing table, which AssetManager fills as assets are created
+    // Every member function may be called from any thread
+    class AssetDatabase
+    {
+    public:
+        struct Record
+        {
+            Guid AssetGuid;
+            EAssetType Type = EAssetType::Unknown;
+            std::string SourcePath;
+            std::string CookedPath; // Empty if the asset was never cooked
+        };
+
+        AssetDatabase() = default;
+
+        AssetDatabase(const AssetDatabase&) = delete;
+        AssetDatabase& operator=(const AssetDatabase&) = delete;
+
+        // Maps the index at filepath, which is also where Save() writes to. A missing index results in an empty database
+        // Returns false if the index is corrupted or of another version, the database starts empty then and the index is rewritten on Save()
+        bool Load(const std::filesystem::path& filepath);
+
+        // Writes every record into a new index and maps it. Does nothing if there is nothing new since the last Load() or Save()
+        bool Save();
+
+        // Returns the Guid of the source path. Paths that are not there yet are registered with newGuid, or with a new Guid if it is invalid
+        Guid Register(EAssetType type, std::string_view sourcePath, const Guid& newGuid = Guid());
+
+        // Associates a cooked blob with the record. Does nothing if the Guid is not registered
+        void SetCookedPath(const Guid& guid, std::string_view cookedPath);
+
+        bool FindRecord(const Guid& guid, Record& record) const;
+
+        // Returns an invalid Guid if the source path is not registered
+        Guid FindGuid(std::string_view sourcePath) const;
+
+        uint32_t GetNumRecords() const;
+
+        // Proxies are never persisted, they are only valid during the run the asset was created in
+        void BindProxy(const Guid& guid, AssetProxy proxy);
+
+        // Unbinds the Guid only if it is still bound to the asset of the proxy
+        void UnbindProxy(const Guid& guid, AssetProxy proxy);
+
+        // Returns an invalid proxy if no asset with the Guid was created. Proxies of destroyed assets are unbound by AssetManager
+        AssetProxy ResolveProxy(const Guid& guid) const;
+
+    private:
+        struct FileHeader;
+        struct FileRecord;
+
+        struct StringHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view str) const { return std::hash<std::string_view>()(str); }
+        };
+
+        static constexpr uint32_t InvalidRecord = uint32_t(-1);
+
+        // Indices of the mapped records
+        uint32_t FindMappedRecord(const Guid& guid) const;
+        uint32_t FindMappedRecord(std::string_view sourcePath) const;
+        std::string_view GetMappedString(uint64_t offset, uint64_t numBytes) const;
+        Record GetMappedRecord(uint32_t index) const;
+
+        // Callers should hold m_mutex
+        Guid FindGuidUnlocked(std::string_view sourcePath) const;
+        void AddRecordUnlocked(Record&& record, bool shadowsMappedRecord);
+        bool LoadUnlocked(const std::filesystem::path& filepath);
+        void ResetUnlocked();
+
+        std::filesystem::path m_filepath;
+
+        mutable std::shared_mutex m_mutex;
+        MappedFile m_file;
+        const FileHeader* m_header = nullptr;
+        std::span<const FileRecord> m_mappedRecords;
+        std::span<const uint32_t> m_guidTable;
+        std::span<const uint32_t> m_pathTable;
+        std::span<const char> m_strings;
+
+        // Records that were added or changed since the index was mapped. Changed mapped records are copied here and shadow the originals
+        std::vector<Record> m_records;
+        std::unordered_map<Guid, uint32_t> m_recordsByGuid;
+        std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> m_recordsByPath;
+        uint32_t m_numShadowedRecords = 0;
+
+        // Guid to proxy table with linear probing. Empty slots have an invalid Guid, unbound ones keep the Guid with an invalid proxy (tombstones)
+        struct ProxySlot
+        {
+            Guid Key;
+            AssetProxy Proxy;
+        };
+
+        void GrowProxyTable();
+
+        mutable std::shared_mutex m_proxyMutex;
+        std::vector<ProxySlot> m_proxySlots;
+        uint32_t m_numUsedProxySlots = 0; // Including tombstones
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "AssetHandle.h"
+
+#include "AssetManager.h"
+
+namespace Warp
+{
+
+    AssetHandle::AssetHandle(AssetManager* manager, AssetProxy proxy)
+    {
+        if (manager && manager->AddRef(proxy))
+        {
+            m_manager = manager;
+            m_proxy = proxy;
+        }
+    }
+
+    AssetHandle::AssetHandle(const AssetHandle& other)
+        : AssetHandle(other.m_manager, other.m_proxy)
+    {
+    }
+
+    AssetHandle& AssetHandle::operator=(const AssetHandle& other)
+    {
+        if (this != &other)
+        {
+            // Reference the new asset first, it might be the one that is only kept alive by this handle
+            AssetHandle copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    AssetHandle::AssetHandle(AssetHandle&& other) noexcept
+        : m_manager(other.m_manager)
+        , m_proxy(std::move(other.m_proxy))
+    {
+        other.m_manager = nullptr;
+    }
+
+    AssetHandle& AssetHandle::operator=(AssetHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_manager = other.m_manager;
+            m_proxy = std::move(other.m_proxy);
+            other.m_manager = nullptr;
+        }
+        return *this;
+    }
+
+    AssetHandle::~AssetHandle()
+    {
+        Reset();
+    }
+
+    void AssetHandle::Reset()
+    {
+        if (m_manager)
+        {
+            m_manager->Release(m_proxy);
+        }
+
+        m_manager = nullptr;
+        m_proxy = AssetProxy();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Asset.h"
+
+namespace Warp
+{
+
+    class AssetManager;
+
+    // Strong reference to an asset. AssetProxy on its own is a weak reference that may become invalid at any point,
+    // while an asset stays alive as long as there is at least a single handle to it
+    //
+    // Once the last handle goes away, the asset is handed over to AssetManager::TakeReleasedAssets(), whoever owns the GPU timeline
+    // destroys it after frames in flight are done with it (see AssetReleaseQueue). Assets that never had a handle are never released
+    // Handles convert to proxies implicitly, thus they are passed to AssetManager::GetAs() and alike as they are
+    class AssetHandle
+    {
+    public:
+        AssetHandle() = default;
+
+        // Adds a reference to the asset. Invalid proxies (or nullptr manager) result in an empty handle
+        AssetHandle(AssetManager* manager, AssetProxy proxy);
+
+        AssetHandle(const AssetHandle& other);
+        AssetHandle& operator=(const AssetHandle& other);
+
+        AssetHandle(AssetHandle&& other) noexcept;
+        AssetHandle& operator=(AssetHandle&& other) noexcept;
+
+        ~AssetHandle();
+
+        // Drops the reference, the handle becomes empty
+        void Reset();
+
+        inline bool IsValid() const { return m_proxy.IsValid(); }
+        inline const AssetProxy& GetProxy() const { return m_proxy; }
+        inline AssetManager* GetManager() const { return m_manager; }
+
+        inline operator const AssetProxy&() const { return m_proxy; }
+
+    private:
+        AssetManager* m_manager = nullptr;
+        AssetProxy m_proxy;
+    };
+
+}
\ No newline at end of file
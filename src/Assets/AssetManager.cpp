@@ -8,15 +8,36 @@ namespace Warp
         WARP_LOG_INFO("AssetManager::Destructor -> Destroying asset manager");
 
         // Iterate over each asset and destroy it here, warning user that there was a memory cleanup needed to shut the manager down
-        ResetRegistry<TextureAsset>();
-        ResetRegistry<MaterialAsset>();
+        // Meshes reference materials and materials reference textures, thus referenced assets are still there when their handles are dropped
         ResetRegistry<MeshAsset>();
+        ResetRegistry<MaterialAsset>();
+        ResetRegistry<TextureAsset>();
     }
 
     AssetProxy AssetManager::DestroyAsset(AssetProxy proxy)
     {
         WARP_ASSERT(proxy.IsValid());
 
+        // Erased first, thus lookups by filepath never treat the asset as alive once it is being destroyed
+        m_proxyTable.Erase(proxy.ID);
+
+        if (m_assetDatabase)
+        {
+            const Asset* asset = nullptr;
+            switch (proxy.Type)
+            {
+            case EAssetType::Texture: asset = GetAs<TextureAsset>(proxy); break;
+            case EAssetType::Material: asset = GetAs<MaterialAsset>(proxy); break;
+            case EAssetType::Mesh: asset = GetAs<MeshAsset>(proxy); break;
+            default: break;
+            }
+
+            if (asset)
+            {
+                m_assetDatabase->UnbindProxy(asset->GetGuid(), proxy);
+            }
+        }
+
         AssetProxy result;
         switch (proxy.Type)
         {
@@ -27,10 +48,120 @@ namespace Warp
         default: WARP_ASSERT(false, "Nothing to delete? How come"); return AssetProxy();
         }
 
-        m_proxyTable.erase(proxy.ID);
         return result;
     }
 
+    bool AssetManager::DestroyIfUnreferenced(AssetProxy proxy, const std::function<void(AssetProxy)>& onDestroy)
+    {
+        bool isMarked = false;
+        switch (proxy.Type)
+        {
+        case EAssetType::Texture: isMarked = m_textureRegistry.MarkDestroying(proxy); break;
+        case EAssetType::Material: isMarked = m_materialRegistry.MarkDestroying(proxy); break;
+        case EAssetType::Mesh: isMarked = m_meshRegistry.MarkDestroying(proxy); break;
+        case EAssetType::Unknown: WARP_ATTR_FALLTHROUGH;
+        default: return false;
+        }
+
+        if (!isMarked)
+        {
+            return false;
+        }
+
+        // Nothing can reference the asset from now on, it is owned by this call until it is destroyed
+        if (onDestroy)
+        {
+            onDestroy(proxy);
+        }
+
+        proxy = DestroyAsset(proxy);
+        return true;
+    }
+
+    bool AssetManager::AddRef(AssetProxy proxy)
+    {
+        switch (proxy.Type)
+        {
+        case EAssetType::Texture: return m_textureRegistry.AddRef(proxy);
+        case EAssetType::Material: return m_materialRegistry.AddRef(proxy);
+        case EAssetType::Mesh: return m_meshRegistry.AddRef(proxy);
+        case EAssetType::Unknown: WARP_ATTR_FALLTHROUGH;
+        default: return false;
+        }
+    }
+
+    void AssetManager::Release(AssetProxy proxy)
+    {
+        bool isLastRef = false;
+        switch (proxy.Type)
+        {
+        case EAssetType::Texture: isLastRef = m_textureRegistry.Release(proxy); break;
+        case EAssetType::Material: isLastRef = m_materialRegistry.Release(proxy); break;
+        case EAssetType::Mesh: isLastRef = m_meshRegistry.Release(proxy); break;
+        case EAssetType::Unknown: WARP_ATTR_FALLTHROUGH;
+        default: return;
+        }
+
+        if (isLastRef)
+        {
+            std::lock_guard lock(m_releasedAssetsMutex);
+            m_releasedAssets.push_back(proxy);
+        }
+    }
+
+    uint32_t AssetManager::GetNumRefs(AssetProxy proxy) const
+    {
+        switch (proxy.Type)
+        {
+        case EAssetType::Texture: return m_textureRegistry.GetNumRefs(proxy);
+        case EAssetType::Material: return m_materialRegistry.GetNumRefs(proxy);
+        case EAssetType::Mesh: return m_meshRegistry.GetNumRefs(proxy);
+        case EAssetType::Unknown: WARP_ATTR_FALLTHROUGH;
+        default: return 0;
+        }
+    }
+
+    void AssetManager::TakeReleasedAssets(std::vector<AssetProxy>& releasedAssets)
+    {
+        std::lock_guard lock(m_releasedAssetsMutex);
+        releasedAssets.insert(releasedAssets.end(), m_releasedAssets.begin(), m_releasedAssets.end());
+        m_releasedAssets.clear();
+    }
+
+    void AssetManager::LogLiveHandles() const
+    {
+        LogLiveHandles<TextureAsset>();
+        LogLiveHandles<MaterialAsset>();
+        LogLiveHandles<MeshAsset>();
+    }
+
+    bool AssetManager::AddFilepathAlias(const std::string& filepath, AssetProxy proxy)
+    {
+        if (filepath.empty() || !IsAlive(proxy))
+        {
+            return false;
+        }
+
+        return m_filepathCache.Insert(filepath, proxy);
+    }
+
+    bool AssetManager::IsAlive(const AssetProxy& proxy) const
+    {
+        if (!proxy.IsValid() || !m_proxyTable.Contains(proxy.ID))
+        {
+            return false;
+        }
+
+        switch (proxy.Type)
+        {
+        case EAssetType::Texture: return !m_textureRegistry.IsDestroying(proxy);
+        case EAssetType::Material: return !m_materialRegistry.IsDestroying(proxy);
+        case EAssetType::Mesh: return !m_meshRegistry.IsDestroying(proxy);
+        case EAssetType::Unknown: WARP_ATTR_FALLTHROUGH;
+        default: return false;
+        }
+    }
+
     WARP_ATTR_NODISCARD AssetProxy AssetManager::GetAssetProxy(uint32_t ID)
     {
         if (ID == Asset::InvalidID)
@@ -38,8 +169,20 @@ namespace Warp
             return AssetProxy();
         }
 
-        auto it = m_proxyTable.find(ID);
-        return it == m_proxyTable.end() ? AssetProxy() : it->second;
+        AssetProxy proxy;
+        m_proxyTable.Find(ID, proxy);
+        return proxy;
+    }
+
+    WARP_ATTR_NODISCARD AssetProxy AssetManager::GetAssetProxy(const Guid& guid)
+    {
+        if (!m_assetDatabase)
+        {
+            return AssetProxy();
+        }
+
+        AssetProxy proxy = m_assetDatabase->ResolveProxy(guid);
+        return IsAlive(proxy) ? proxy : AssetProxy();
     }
 
     WARP_ATTR_NODISCARD AssetProxy AssetManager::GetAssetProxy(const std::string& filepath)
@@ -49,20 +192,21 @@ namespace Warp
             return AssetProxy();
         }
 
-        auto it = m_filepathCache.find(filepath);
-        if (it == m_filepathCache.end())
+        AssetProxy proxy;
+        if (!m_filepathCache.Find(filepath, proxy))
         {
             return AssetProxy();
         }
 
-        AssetProxy proxy = it->second;
-
         // TODO: Maybe change this all story with filepaths and asset caching?
         // Its not so easy to clear the filepath cache, thats why it sucks... the only way to delete invalid elements is by
         // basically removing them on query... thats a bad way to flush cache
-        if (!proxy.IsValid())
+        // Released assets are destroyed without going through the cache, thus entries of destroyed assets are dropped here as well
+        // Another thread may have replaced the entry meanwhile, only the stale proxy itself is erased
+        if (!IsAlive(proxy))
         {
-            m_filepathCache.erase(filepath);
+            m_filepathCache.EraseIf(filepath, [&proxy](const AssetProxy& cached) { return cached.ID == proxy.ID; });
+            return AssetProxy();
         }
 
         return proxy;
@@ -1,20 +1,27 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
 #include <vector>
-#include <queue>
-#include <unordered_map>
 #include <string>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <concepts>
 
 #include "Asset.h"
+#include "AssetDatabase.h"
+#include "AssetHandle.h"
 #include "MaterialAsset.h"
 #include "MeshAsset.h"
 #include "TextureAsset.h"
 
 #include "../Core/Assert.h"
 #include "../Util/Logger.h"
+#include "../Util/ShardedHashMap.h"
 
 #define WARP_INTERNAL_ASSET_MANAGER_RETURN_REGISTRY(Type, Expected, Registry)\
 	if constexpr (std::is_same_v<Type, Expected>)\
@@ -25,21 +32,23 @@
 namespace Warp
 {
 
+    // IDs are unique across threads. IDs are never reused, even once their asset is destroyed
     class AssetIDGenerator
     {
     public:
         WARP_ATTR_NODISCARD inline uint32_t NextID()
         {
-            uint32_t ID = m_nextID++;
-            m_prevCachedID = ID;
+            uint32_t ID = m_nextID.fetch_add(1, std::memory_order_relaxed);
+            m_prevCachedID.store(ID, std::memory_order_relaxed);
             return ID;
         }
 
-        WARP_ATTR_NODISCARD inline uint32_t GetPrevCachedID() const { return m_prevCachedID; }
+        // With many threads generating IDs this is one of the latest IDs, not necessarily the one returned to the caller
+        WARP_ATTR_NODISCARD inline uint32_t GetPrevCachedID() const { return m_prevCachedID.load(std::memory_order_relaxed); }
 
     private:
-        uint32_t m_prevCachedID = Asset::InvalidID;
-        uint32_t m_nextID = 0;
+        std::atomic<uint32_t> m_prevCachedID = Asset::InvalidID;
+        std::atomic<uint32_t> m_nextID = 0;
     };
 
     template<typename T>
@@ -48,6 +57,9 @@ namespace Warp
     // The idea of AssetManager is to create assets and store them inside itself.
     // User is still able to access those assets using an interface-object called AssetProxy. It is a very light-weight object, somewhat simillar to Entity
     // It can be copied and moved around without worrying about efficieny cost
+    //
+    // Every member function may be called from any thread. Assets are created under a per-type lock, lookups by ID and filepath go through
+    // sharded maps and GetAs() is wait-free. Accessing the asset itself is not synchronized, as well as destroying an asset that is still in use
     class AssetManager
     {
     public:
@@ -66,7 +78,7 @@ namespace Warp
         // Assets are queried from AssetManager on the fly using AssetManager::GetAs member function
         //
         // (14.02.2024) -> CreateAsset() now generates Guid object while creating asset. Guid is a unique identifier of an asset
-        // Guid-to-Proxy mapping is then added to AssetManager's proxy map
+        // Guid-to-Proxy mapping is then added to the asset database, if there is one
         template<ValidAssetType T>
         WARP_ATTR_NODISCARD AssetProxy CreateAsset()
         {
@@ -76,7 +88,11 @@ namespace Warp
             AssetProxy proxy = registry->AllocateAsset(ID);
             if (registry->IsValid(proxy))
             {
-                m_proxyTable[ID] = proxy;
+                m_proxyTable.InsertOrAssign(ID, proxy);
+                if (m_assetDatabase)
+                {
+                    m_assetDatabase->BindProxy(registry->GetAsset(proxy)->GetGuid(), proxy);
+                }
             }
 
             return proxy;
@@ -85,51 +101,100 @@ namespace Warp
         // Allocates an asset and returns a proxy to an asset
         // Basically does the same behavior as CreateAsset() although it will also associate a provided filepath (or basically any unique name)
         // with the allocated asset
+        //
+        // Threads that create an asset for the same filepath at once get the same proxy, the filepath is locked until the asset is created
         template<ValidAssetType T>
         WARP_ATTR_NODISCARD AssetProxy CreateAsset(const std::string& filepath)
         {
-            AssetProxy proxy = GetAssetProxy(filepath);
-
-            // If found cached proxy in manager's cache tables
-            if (proxy.IsValid())
-            {
-                if (proxy.Type != T::StaticType)
+            return m_filepathCache.Modify(filepath, [this, &filepath](FilepathCache::Shard& shard)
                 {
-                    WARP_LOG_ERROR("AssetManager::CreateAsset() -> Wrong type is requested for the filepath. Perhaps internal resource?");
-                    WARP_ASSERT(false);
-                    return AssetProxy();
-                }
-
-                // Early return cached proxy
-                return proxy;
-            }
-
-            proxy = CreateAsset<T>();
-            WARP_ASSERT(proxy.IsValid());
-
-            m_filepathCache[filepath] = proxy;
-            return proxy;
+                    auto it = shard.find(filepath);
+
+                    // If found cached proxy in manager's cache tables. Proxies of destroyed assets are replaced
+                    if (it != shard.end() && IsAlive(it->second))
+                    {
+                        if (it->second.Type != T::StaticType)
+                        {
+                            WARP_LOG_ERROR("AssetManager::CreateAsset() -> Wrong type is requested for the filepath. Perhaps internal resource?");
+                            WARP_ASSERT(false);
+                            return AssetProxy();
+                        }
+
+                        // Early return cached proxy
+                        return it->second;
+                    }
+
+                    // The registry logs why it failed. Nothing is cached then, thus the next call for the filepath tries again
+                    AssetProxy proxy = CreateAsset<T>();
+                    if (!proxy.IsValid())
+                    {
+                        return proxy;
+                    }
+
+                    // Assets created for the same filepath keep their Guid across runs
+                    if (m_assetDatabase)
+                    {
+                        T* asset = GetAs<T>(proxy);
+                        Guid guid = m_assetDatabase->Register(T::StaticType, filepath, asset->GetGuid());
+                        if (guid != asset->GetGuid())
+                        {
+                            m_assetDatabase->UnbindProxy(asset->GetGuid(), proxy);
+                            asset->m_Guid = guid;
+                            m_assetDatabase->BindProxy(guid, proxy);
+                        }
+                    }
+
+                    shard.insert_or_assign(filepath, proxy);
+                    return proxy;
+                });
         }
 
-        // Destroys an asset with the associated proxy
+        // Associates one more filepath (or any unique name) with an existing asset, thus GetAssetProxy() finds the asset by either of them
+        // Used for assets imported from identical content under different names. Returns false if the name is already taken or the proxy is invalid
+        bool AddFilepathAlias(const std::string& filepath, AssetProxy proxy);
+
+        // Destroys an asset with the associated proxy regardless of its references
         // returns an updated proxy (empty or invalid proxy)
         WARP_ATTR_NODISCARD AssetProxy DestroyAsset(AssetProxy proxy);
 
+        // Destroys the asset only if nothing references it. The check and the mark are a single atomic exchange on the references, and once it passes
+        // AddRef() fails for the asset, thus nobody can reference it while it is being destroyed. onDestroy(proxy) runs right before the asset is destroyed,
+        // for releasing whatever refers to the asset from outside (e.g. its descriptors). Returns false if the asset is referenced or already destroyed
+        bool DestroyIfUnreferenced(AssetProxy proxy, const std::function<void(AssetProxy)>& onDestroy = nullptr);
+
+        // Strong references of an asset, see AssetHandle. Handles may be copied and dropped on any thread
+        // AddRef() returns false if the proxy is not valid or its asset is being destroyed. Release() of the last reference queues the asset for TakeReleasedAssets()
+        bool AddRef(AssetProxy proxy);
+        void Release(AssetProxy proxy);
+        uint32_t GetNumRefs(AssetProxy proxy) const;
+
+        // Moves out assets whose last reference was dropped since the previous call. Assets are not destroyed here, as GPU may still use them
+        // Assets may be referenced again before they are destroyed, thus they should be destroyed with DestroyIfUnreferenced()
+        void TakeReleasedAssets(std::vector<AssetProxy>& releasedAssets);
+
+        // Logs the number of live assets, references and unreferenced assets for every asset type. Meant for tracking down leaks
+        void LogLiveHandles() const;
+
         // Tries to get a proxy for the associated asset's unique ID. This may be usefull to check if an asset is indeed associated with this manager
         // Returns empty asset if there is no proxy, thus no asset, associated with the provided ID parameter
         WARP_ATTR_NODISCARD AssetProxy GetAssetProxy(uint32_t ID);
 
-        // Tries to find an asset proxy by filepath (or whatever unique name you want basically) using two levels of indirection
-        // Firstly, manager will search for a Guid associated with filepath provided
-        // Secondly, if any Guid was found, searches for asset proxy in the proxy table for the Guid found
+        // Tries to find an asset proxy by filepath (or whatever unique name you want basically)
         // Returns valid asset proxy if successfully found associated asset, otherwise returns invalid proxy
-        //
-        // (14.02.2024) -> Maybe two levels of indirection via Guid are obsolete and may be replaced by one?
         WARP_ATTR_NODISCARD AssetProxy GetAssetProxy(const std::string& filepath);
 
+        // Resolves a Guid of a created asset through the asset database, without hashing any strings. Meant for cooked data that refers to assets by Guid
+        // Returns invalid proxy if there is no database or the asset was not created (or was already destroyed)
+        WARP_ATTR_NODISCARD AssetProxy GetAssetProxy(const Guid& guid);
+
+        // The database is not owned and should outlive the manager. Assets created before it was set are not bound to their Guids
+        inline void SetAssetDatabase(AssetDatabase* database) { m_assetDatabase = database; }
+        inline AssetDatabase* GetAssetDatabase() const { return m_assetDatabase; }
+
         // A very quick search of an asset (linear O(1) essentially, just an array lookup). As of 31/12/23 performs checks on whether the asset proxy is valid
         // And if the proxy is not valid - nullptr is returned
         // In debug configuration only assertions are performed to check whether to proxy is valid and can be used to retrieve an asset
+        // Wait-free, it takes no locks and may run alongside CreateAsset() on other threads
         template<ValidAssetType T>
         T* GetAs(AssetProxy proxy)
         {
@@ -145,19 +210,35 @@ namespace Warp
         }
 
     private:
+        using FilepathCache = ShardedHashMap<std::string, AssetProxy>;
+
+        // Returns true if the proxy refers to an asset that was not destroyed yet, nor is being destroyed
+        bool IsAlive(const AssetProxy& proxy) const;
+
         // Asset registry should not delete asset handles when they are destroyed,
         // but instead should free the place for the asset handles that will be created later
-
-        // TODO: Rewrite registry to use memorypools instead of vectors
+        //
+        // Assets are constructed in place inside of fixed-size chunks. Chunks are never moved or freed until Reset(), thus assets have stable addresses
+        // and assets allocated one after another are next to each other in memory. Every slot keeps the ID and the generation of its asset,
+        // so validating a proxy does not touch the asset itself. Destroyed slots are linked into an intrusive free list and reused first
+        //
+        // Chunks are found through a two-level table. Tables and chunks are allocated on demand and published atomically, so are slot tags,
+        // thus IsValid() and GetAsset() take no locks. Tables cover the whole 32-bit index range, the registry grows until the indices run out
+        // Allocation and destruction are serialized with a mutex
         template<ValidAssetType T>
         class Registry
         {
         public:
+            static constexpr uint32_t NumAssetsPerChunk = 64;
+            static constexpr uint32_t NumChunksPerTable = 16384; // 1048576 assets per table
+            static constexpr uint32_t MaxChunkTables = 4096;
+
             Registry() = default;
-            explicit Registry(uint32_t numAssets)
-            {
-                AssetContainer.reserve(numAssets);
-            }
+
+            Registry(const Registry&) = delete;
+            Registry& operator=(const Registry&) = delete;
+
+            ~Registry() { Reset(); }
 
             WARP_ATTR_NODISCARD AssetProxy AllocateAsset(uint32_t ID);
             WARP_ATTR_NODISCARD AssetProxy DestroyAsset(AssetProxy proxy);
@@ -173,16 +254,73 @@ namespace Warp
             // If it does - ignore it anyways. This method would only be called on shutdown anyways
             void Reset();
 
-            // This is how we store assets... insane, right? Allocation? Lmao it is indeed an ALLOCATION
-            struct AssetAllocation
+            // ID of the asset that occupies the slot in the low half, generation of the slot in the high half
+            // A single word is compared against the proxy, thus readers never see an ID of one asset with the generation of another
+            static constexpr uint64_t MakeTag(uint32_t ID, uint32_t generation) { return (uint64_t(generation) << 32) | ID; }
+            static constexpr uint32_t GetTagID(uint64_t tag) { return static_cast<uint32_t>(tag); }
+            static constexpr uint32_t GetTagGeneration(uint64_t tag) { return static_cast<uint32_t>(tag >> 32); }
+
+            // References are kept next to the generation of the slot in the same way, see Slot::Refs
+            static constexpr uint64_t MakeRefs(uint32_t numRefs, uint32_t generation) { return MakeTag(numRefs, generation); }
+            static constexpr uint32_t GetRefCount(uint64_t refs) { return GetTagID(refs); }
+
+            struct Slot
             {
-                bool IsOccupied() const { return Ptr != nullptr; }
-                void Destroy() { Ptr.reset(); }
+                bool IsOccupied() const { return GetTagID(Tag.load(std::memory_order_acquire)) != Asset::InvalidID; }
+
+                // Stored once the asset is constructed, thus readers that see the ID also see the asset. Generation is incremented whenever the asset is destroyed
+                std::atomic<uint64_t> Tag = MakeTag(Asset::InvalidID, 0);
+                uint32_t NextFree = Asset::InvalidID; // Next slot of the free list, valid for free slots only. Guarded by the mutex
 
-                std::unique_ptr<T> Ptr;
+                // Strong references of the asset in the low half, see AssetHandle. Generation of the slot in the high half, changed along with the tag.
+                // References are changed with a compare-exchange against the generation of the proxy, thus they never land on an asset that reused the slot
+                std::atomic<uint64_t> Refs = MakeRefs(0, 0);
             };
-            std::vector<AssetAllocation> AssetContainer;
-            std::queue<uint32_t> FreedProxies;
+
+            struct Chunk
+            {
+                T* GetAsset(uint32_t slotIndex) { return std::launder(reinterpret_cast<T*>(Storage + slotIndex * sizeof(T))); }
+
+                Slot Slots[NumAssetsPerChunk];
+                alignas(T) std::byte Storage[NumAssetsPerChunk * sizeof(T)];
+            };
+
+            struct ChunkTable
+            {
+                std::array<std::atomic<Chunk*>, NumChunksPerTable> Chunks = {};
+            };
+
+            static_assert(uint64_t(NumAssetsPerChunk) * NumChunksPerTable * MaxChunkTables == uint64_t(1) << 32, "Chunk tables should cover every index");
+
+            // Reference count of an asset that DestroyIfUnreferenced() is destroying. References cannot be taken anymore
+            static constexpr uint32_t DestroyingNumRefs = uint32_t(-1);
+
+            // AddRef() returns false if the proxy is not valid or the asset is being destroyed. Release() returns true if it dropped the last reference
+            // Neither takes the mutex, copying and dropping handles is a compare-exchange on the references of the slot
+            bool AddRef(AssetProxy proxy);
+            bool Release(AssetProxy proxy);
+            uint32_t GetNumRefs(AssetProxy proxy) const;
+
+            // Returns true and makes AddRef() fail for the asset if nothing references it. The caller is expected to destroy the asset afterwards
+            bool MarkDestroying(AssetProxy proxy);
+            bool IsDestroying(AssetProxy proxy) const { return IsValid(proxy) && GetSlot(proxy.Index).Refs.load(std::memory_order_relaxed) == MakeRefs(DestroyingNumRefs, proxy.Generation); }
+
+            // Returns nullptr if the chunk was not published yet
+            inline Chunk* FindChunk(uint32_t chunkIndex) const
+            {
+                ChunkTable* table = ChunkTables[chunkIndex / NumChunksPerTable].load(std::memory_order_acquire);
+                return table ? table->Chunks[chunkIndex % NumChunksPerTable].load(std::memory_order_acquire) : nullptr;
+            }
+
+            // Index should belong to a chunk that was already published
+            inline Chunk* GetChunk(uint32_t index) const { return FindChunk(index / NumAssetsPerChunk); }
+            inline Slot& GetSlot(uint32_t index) const { return GetChunk(index)->Slots[index % NumAssetsPerChunk]; }
+
+            std::array<std::atomic<ChunkTable*>, MaxChunkTables> ChunkTables = {};
+            std::atomic<uint32_t> NumSlots = 0; // Slots that were ever handed out. Slots past it in the last chunk were never used
+
+            std::mutex Mutex;
+            uint32_t FreeListHead = Asset::InvalidID;
         };
 
         template<ValidAssetType T>
@@ -209,39 +347,76 @@ namespace Warp
             registry->Reset();
         }
 
+        template<ValidAssetType T>
+        void LogLiveHandles() const;
+
         Registry<MaterialAsset> m_materialRegistry;
         Registry<MeshAsset> m_meshRegistry;
         Registry<TextureAsset> m_textureRegistry;
 
+        std::mutex m_releasedAssetsMutex;
+        std::vector<AssetProxy> m_releasedAssets;
+
+        AssetDatabase* m_assetDatabase = nullptr;
+
         AssetIDGenerator m_IDGenerator;
-        std::unordered_map<uint32_t, AssetProxy> m_proxyTable;
-        std::unordered_map<std::string, AssetProxy> m_filepathCache;
+        ShardedHashMap<uint32_t, AssetProxy> m_proxyTable;
+        FilepathCache m_filepathCache;
     };
 
     template<ValidAssetType T>
     inline AssetProxy AssetManager::Registry<T>::AllocateAsset(uint32_t ID)
     {
+        std::lock_guard lock(Mutex);
+
         AssetProxy proxy = AssetProxy();
         proxy.Type = T::StaticType;
         proxy.ID = ID;
 
-        if (!FreedProxies.empty())
+        if (FreeListHead != Asset::InvalidID)
         {
-            proxy.Index = FreedProxies.front();
-            FreedProxies.pop();
-
-            WARP_ASSERT(proxy.Index < AssetContainer.size() && !AssetContainer[proxy.Index].Ptr);
+            proxy.Index = FreeListHead;
+            FreeListHead = GetSlot(proxy.Index).NextFree;
         }
         else
         {
-            proxy.Index = static_cast<uint32_t>(AssetContainer.size()); // Cast is safe for now (and probs forever)
-            AssetContainer.emplace_back(); // emplace empty allocation that we will fill later
+            // The last index is the invalid one
+            uint32_t index = NumSlots.load(std::memory_order_relaxed);
+            if (index == Asset::InvalidID)
+            {
+                WARP_LOG_ERROR("AssetManager::Registry::AllocateAsset -> Ran out of indices for assets of type {}", GetAssetTypeName(T::StaticType));
+                return AssetProxy();
+            }
+
+            uint32_t chunkIndex = index / NumAssetsPerChunk;
+            std::atomic<ChunkTable*>& table = ChunkTables[chunkIndex / NumChunksPerTable];
+            if (!table.load(std::memory_order_relaxed))
+            {
+                table.store(std::make_unique<ChunkTable>().release(), std::memory_order_release);
+            }
+
+            std::atomic<Chunk*>& chunk = table.load(std::memory_order_relaxed)->Chunks[chunkIndex % NumChunksPerTable];
+            if (!chunk.load(std::memory_order_relaxed))
+            {
+                // Slots are initialized, storage is left as it is
+                chunk.store(std::make_unique_for_overwrite<Chunk>().release(), std::memory_order_release);
+            }
+
+            proxy.Index = index;
+            NumSlots.store(index + 1, std::memory_order_release);
         }
 
+        Slot& slot = GetSlot(proxy.Index);
+        WARP_ASSERT(!slot.IsOccupied());
+
         // Assume that valid asset would always take in uint32_t ID as a single constructor parameter
-        AssetContainer[proxy.Index] = AssetAllocation{
-            .Ptr = std::make_unique<T>(ID),
-        };
+        std::construct_at(GetChunk(proxy.Index)->GetAsset(proxy.Index % NumAssetsPerChunk), ID);
+
+        slot.NextFree = Asset::InvalidID;
+
+        proxy.Generation = GetTagGeneration(slot.Tag.load(std::memory_order_relaxed));
+        slot.Refs.store(MakeRefs(0, proxy.Generation), std::memory_order_relaxed);
+        slot.Tag.store(MakeTag(ID, proxy.Generation), std::memory_order_release);
 
         WARP_ASSERT(IsValid(proxy));
         return proxy;
@@ -250,6 +425,8 @@ namespace Warp
     template<ValidAssetType T>
     inline AssetProxy AssetManager::Registry<T>::DestroyAsset(AssetProxy proxy)
     {
+        std::lock_guard lock(Mutex);
+
         // Ensure that the asset for this proxy is still alive
         if (!IsValid(proxy))
         {
@@ -259,42 +436,128 @@ namespace Warp
             return AssetProxy();
         }
 
-        AssetAllocation& allocation = AssetContainer[proxy.Index];
+        // Bumping the generation invalidates every proxy that is still pointing into the slot
+        Slot& slot = GetSlot(proxy.Index);
+        slot.Tag.store(MakeTag(Asset::InvalidID, proxy.Generation + 1), std::memory_order_release);
+        slot.Refs.store(MakeRefs(0, proxy.Generation + 1), std::memory_order_relaxed);
 
-        // reset the ptr and add index to freed indices
-        allocation.Ptr.reset();
-        FreedProxies.push(proxy.Index);
+        std::destroy_at(GetChunk(proxy.Index)->GetAsset(proxy.Index % NumAssetsPerChunk));
+
+        slot.NextFree = FreeListHead;
+        FreeListHead = proxy.Index;
 
         return AssetProxy(); // Just return invalid proxy
     }
 
     template<ValidAssetType T>
-    inline bool AssetManager::Registry<T>::IsValid(AssetProxy proxy) const
+    inline bool AssetManager::Registry<T>::AddRef(AssetProxy proxy)
     {
-        if (!proxy.IsValid())
+        if (!IsValid(proxy))
         {
             return false;
         }
 
-        if (proxy.Type != T::StaticType)
+        // The slot may be marked, destroyed and reused after the validation. The generation in the references catches that, the exchange fails then
+        std::atomic<uint64_t>& refs = GetSlot(proxy.Index).Refs;
+        uint64_t current = refs.load(std::memory_order_relaxed);
+        do
+        {
+            if (GetTagGeneration(current) != proxy.Generation || GetRefCount(current) == DestroyingNumRefs)
+            {
+                return false;
+            }
+        }
+        // New references are made from existing ones (or from the asset owner), nothing has to be ordered against them
+        while (!refs.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    template<ValidAssetType T>
+    inline bool AssetManager::Registry<T>::Release(AssetProxy proxy)
+    {
+        if (!IsValid(proxy))
         {
             return false;
         }
 
-        // Check if there is ANY asset assosiated with the current proxy
-        if (proxy.Index >= AssetContainer.size() || !AssetContainer[proxy.Index].Ptr)
+        // Not a plain decrement, DestroyAsset() may have reset the references of the slot while the handle was held
+        std::atomic<uint64_t>& refs = GetSlot(proxy.Index).Refs;
+        uint64_t current = refs.load(std::memory_order_relaxed);
+        do
+        {
+            if (GetTagGeneration(current) != proxy.Generation)
+            {
+                return false;
+            }
+
+            if (GetRefCount(current) == 0 || GetRefCount(current) == DestroyingNumRefs)
+            {
+                WARP_ASSERT(false, "Released an asset that has no references");
+                return false;
+            }
+        }
+        // Whoever destroys the asset after the last release should see every write made while it was referenced
+        while (!refs.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        return GetRefCount(current) == 1;
+    }
+
+    template<ValidAssetType T>
+    inline uint32_t AssetManager::Registry<T>::GetNumRefs(AssetProxy proxy) const
+    {
+        if (!IsValid(proxy))
+        {
+            return 0;
+        }
+
+        uint64_t refs = GetSlot(proxy.Index).Refs.load(std::memory_order_relaxed);
+        if (GetTagGeneration(refs) != proxy.Generation)
+        {
+            return 0;
+        }
+
+        uint32_t numRefs = GetRefCount(refs);
+        return numRefs != DestroyingNumRefs ? numRefs : 0;
+    }
+
+    template<ValidAssetType T>
+    inline bool AssetManager::Registry<T>::MarkDestroying(AssetProxy proxy)
+    {
+        std::lock_guard lock(Mutex);
+        if (!IsValid(proxy))
         {
             return false;
         }
 
-        // Now check unique IDs to be the same to ensure we are trying to access the same asset
-        const AssetAllocation& allocation = AssetContainer[proxy.Index];
-        if (proxy.ID != allocation.Ptr->GetID())
+        // Acquire pairs with the release of the last reference, thus the destroyer sees every write made while the asset was referenced
+        uint64_t expected = MakeRefs(0, proxy.Generation);
+        return GetSlot(proxy.Index).Refs.compare_exchange_strong(expected, MakeRefs(DestroyingNumRefs, proxy.Generation), std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    template<ValidAssetType T>
+    inline bool AssetManager::Registry<T>::IsValid(AssetProxy proxy) const
+    {
+        if (!proxy.IsValid())
         {
             return false;
         }
 
-        return true;
+        if (proxy.Type != T::StaticType)
+        {
+            return false;
+        }
+
+        // Check if there is ANY asset assosiated with the current proxy
+        const Chunk* chunk = FindChunk(proxy.Index / NumAssetsPerChunk);
+        if (!chunk)
+        {
+            return false;
+        }
+
+        // Now check unique IDs and generations to be the same to ensure we are trying to access the same asset
+        const Slot& slot = chunk->Slots[proxy.Index % NumAssetsPerChunk];
+        return slot.Tag.load(std::memory_order_acquire) == MakeTag(proxy.ID, proxy.Generation);
     }
 
     template<ValidAssetType T>
@@ -308,29 +571,77 @@ namespace Warp
                 WARP_ASSERT(false);
             }
         );
-        const AssetAllocation& allocation = AssetContainer[proxy.Index];
-        return allocation.Ptr.get();
+        return GetChunk(proxy.Index)->GetAsset(proxy.Index % NumAssetsPerChunk);
     }
 
     template<ValidAssetType T>
     inline void AssetManager::Registry<T>::Reset()
     {
-        for (AssetAllocation& allocation : AssetContainer)
+        std::lock_guard lock(Mutex);
+
+        uint32_t numSlots = NumSlots.load(std::memory_order_relaxed);
+        for (uint32_t index = 0; index < numSlots; ++index)
         {
-            if (allocation.IsOccupied())
+            Slot& slot = GetSlot(index);
+            if (slot.IsOccupied())
             {
-                T* asset = allocation.Ptr.get();
+                T* asset = GetChunk(index)->GetAsset(index % NumAssetsPerChunk);
                 WARP_LOG_WARN("AssetManager::Registry::Reset -> Destroying asset of type {} (ID: {})", GetAssetTypeName(asset->GetType()), asset->GetID());
 
-                // Release allocations' internal memory
-                // NOTE: In fact, it is not mandatory to destroy asset allocations manually as they are RAII std::unique_ptr
-                // Although just do it for future. We might use arena allocators at some point in time
-                allocation.Destroy();
+                // Assets live in chunk storage, thus they are not destroyed along with the chunks
+                slot.Tag.store(MakeTag(Asset::InvalidID, 0), std::memory_order_release);
+                std::destroy_at(asset);
             }
         }
 
-        AssetContainer.clear();
-        std::queue<uint32_t>().swap(FreedProxies);
+        for (std::atomic<ChunkTable*>& table : ChunkTables)
+        {
+            std::unique_ptr<ChunkTable> tableToDelete(table.exchange(nullptr, std::memory_order_acq_rel));
+            if (!tableToDelete)
+            {
+                continue;
+            }
+
+            for (std::atomic<Chunk*>& chunk : tableToDelete->Chunks)
+            {
+                delete chunk.exchange(nullptr, std::memory_order_acq_rel);
+            }
+        }
+
+        NumSlots.store(0, std::memory_order_relaxed);
+        FreeListHead = Asset::InvalidID;
+    }
+
+    template<ValidAssetType T>
+    inline void AssetManager::LogLiveHandles() const
+    {
+        const Registry<T>* registry = GetRegistry<T>();
+
+        uint32_t numAssets = 0;
+        uint32_t numUnreferenced = 0;
+        uint64_t numRefs = 0;
+        uint32_t numSlots = registry->NumSlots.load(std::memory_order_acquire);
+        for (uint32_t index = 0; index < numSlots; ++index)
+        {
+            const auto& slot = registry->GetSlot(index);
+            if (!slot.IsOccupied())
+            {
+                continue;
+            }
+
+            uint32_t slotNumRefs = Registry<T>::GetRefCount(slot.Refs.load(std::memory_order_relaxed));
+            if (slotNumRefs == Registry<T>::DestroyingNumRefs)
+            {
+                continue;
+            }
+
+            ++numAssets;
+            numRefs += slotNumRefs;
+            numUnreferenced += slotNumRefs == 0 ? 1 : 0;
+        }
+
+        WARP_LOG_INFO("AssetManager -> {}: {} live assets, {} handles, {} assets without handles",
+            GetAssetTypeName(T::StaticType), numAssets, numRefs, numUnreferenced);
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "DerivedDataCache.h"
+
+#include <string>
+
+#include "../Core/Assert.h"
+#include "../Util/Logger.h"
+#include "../Util/MappedFile.h"
+
+namespace Warp
+{
+
+    static constexpr std::string_view DerivedDataTypeNames[eDerivedDataType_NumTypes] = {
+        "Mesh",
+        "Texture",
+    };
+
+    DerivedDataCache::DerivedDataCache(const std::filesystem::path& directory)
+    {
+        std::error_code ec;
+        for (std::string_view typeName : DerivedDataTypeNames)
+        {
+            std::filesystem::create_directories(directory / typeName, ec);
+            if (ec)
+            {
+                WARP_LOG_ERROR("DerivedDataCache -> Failed to create \'{}\': {}. Cache is disabled", (directory / typeName).string(), ec.message());
+                return;
+            }
+        }
+
+        m_directory = directory;
+        WARP_LOG_INFO("DerivedDataCache -> Using \'{}\'", m_directory.string());
+    }
+
+    bool DerivedDataCache::HashFile(Hasher128& hasher, const std::filesystem::path& filepath)
+    {
+        MappedFile file(filepath);
+        if (!file.IsValid())
+        {
+            return false;
+        }
+
+        // Length prefix keeps the key unambiguous when several files are hashed one after another
+        uint64_t numBytes = file.GetSize();
+        hasher.UpdateValue(numBytes);
+        hasher.Update(file.GetData(), file.GetSize());
+        return true;
+    }
+
+    bool DerivedDataCache::HashFileStamp(Hasher128& hasher, const std::filesystem::path& filepath)
+    {
+        std::error_code ec;
+        uint64_t numBytes = std::filesystem::file_size(filepath, ec);
+        if (ec)
+        {
+            return false;
+        }
+
+        std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(filepath, ec);
+        if (ec)
+        {
+            return false;
+        }
+
+        hasher.UpdateValue(numBytes);
+        hasher.UpdateValue(static_cast<int64_t>(lastWriteTime.time_since_epoch().count()));
+        return true;
+    }
+
+    std::filesystem::path DerivedDataCache::GetFilepath(EDerivedDataType type, const Hash128& key, std::string_view extension) const
+    {
+        WARP_ASSERT(IsEnabled());
+        WARP_ASSERT(type < eDerivedDataType_NumTypes);
+        return m_directory / DerivedDataTypeNames[type] / (key.ToString() + std::string(extension));
+    }
+
+    void DerivedDataCache::RecordHit(EDerivedDataType type, double milliseconds)
+    {
+        std::lock_guard lock(m_statsMutex);
+        ++m_stats[type].NumHits;
+        m_stats[type].HitMilliseconds += milliseconds;
+    }
+
+    void DerivedDataCache::RecordMiss(EDerivedDataType type, double milliseconds)
+    {
+        std::lock_guard lock(m_statsMutex);
+        ++m_stats[type].NumMisses;
+        m_stats[type].MissMilliseconds += milliseconds;
+    }
+
+    DerivedDataCache::Stats DerivedDataCache::GetStats(EDerivedDataType type) const
+    {
+        std::lock_guard lock(m_statsMutex);
+        return m_stats[type];
+    }
+
+    void DerivedDataCache::LogStats() const
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < eDerivedDataType_NumTypes; ++i)
+        {
+            Stats stats = GetStats(static_cast<EDerivedDataType>(i));
+            if (stats.NumHits == 0 && stats.NumMisses == 0)
+            {
+                continue;
+            }
+
+            WARP_LOG_INFO("DerivedDataCache -> {}: {} hits ({:.2f} ms), {} misses ({:.2f} ms)",
+                DerivedDataTypeNames[i], stats.NumHits, stats.HitMilliseconds, stats.NumMisses, stats.MissMilliseconds);
+
+            // Savings can only be estimated if both hits and misses happened during this run
+            // Otherwise compare hit time of this run with miss time of the first run
+            if (stats.NumHits > 0 && stats.NumMisses > 0)
+            {
+                double averageHit = stats.HitMilliseconds / stats.NumHits;
+                double averageMiss = stats.MissMilliseconds / stats.NumMisses;
+                WARP_LOG_INFO("DerivedDataCache -> {}: ~{:.2f} ms saved", DerivedDataTypeNames[i], (averageMiss - averageHit) * stats.NumHits);
+            }
+        }
+    }
+
+}
\ No newline at end of file
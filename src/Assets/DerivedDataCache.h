@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+
+#include "../Util/Hash.h"
+
+namespace Warp
+{
+
+    enum EDerivedDataType
+    {
+        eDerivedDataType_Mesh = 0,
+        eDerivedDataType_Texture,
+        eDerivedDataType_NumTypes,
+    };
+
+    // Persistent on-disk cache of importer outputs (cooked meshes, processed images), which lives across application runs
+    //
+    // Entries are content-addressed: importers build a key from their sources along with import settings and their own version,
+    // so any change of the source or of the importer automatically results in a different entry. Stale entries are never overwritten or invalidated, they are just no longer referenced
+    // Small sources are hashed byte by byte, large ones (such as glTF buffers) by their size and last write time, so that a hit does not read them
+    // Entries are written into temporary files first and then renamed, thus a crash never leaves a truncated entry behind
+    class DerivedDataCache
+    {
+    public:
+        struct Stats
+        {
+            uint32_t NumHits = 0;
+            uint32_t NumMisses = 0;
+
+            // Wall time spent on loading cached entries and on importing from sources (including writing of entries) respectively
+            double HitMilliseconds = 0.0;
+            double MissMilliseconds = 0.0;
+        };
+
+        // Default-constructed cache is disabled, importers then always import from sources
+        DerivedDataCache() = default;
+        explicit DerivedDataCache(const std::filesystem::path& directory);
+
+        DerivedDataCache(const DerivedDataCache&) = delete;
+        DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+        inline bool IsEnabled() const { return !m_directory.empty(); }
+
+        // Feeds the whole content of the file into the hasher. Returns false if the file cannot be read
+        static bool HashFile(Hasher128& hasher, const std::filesystem::path& filepath);
+
+        // Feeds the size and the last write time of the file into the hasher without reading it. Returns false if the file does not exist
+        static bool HashFileStamp(Hasher128& hasher, const std::filesystem::path& filepath);
+
+        // Returns the path of an entry for the key. The entry may not exist yet
+        std::filesystem::path GetFilepath(EDerivedDataType type, const Hash128& key, std::string_view extension) const;
+
+        // Importers may run on several threads, thus stats are guarded
+        void RecordHit(EDerivedDataType type, double milliseconds);
+        void RecordMiss(EDerivedDataType type, double milliseconds);
+
+        Stats GetStats(EDerivedDataType type) const;
+
+        // Prints hits, misses and the estimated time saved for every type of derived data
+        void LogStats() const;
+
+    private:
+        std::filesystem::path m_directory;
+
+        mutable std::mutex m_statsMutex;
+        std::array<Stats, eDerivedDataType_NumTypes> m_stats;
+    };
+
+}
\ No newline at end of file
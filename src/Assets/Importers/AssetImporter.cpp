@@ -11,9 +11,12 @@ namespace Warp
         switch (format)
         {
         case EAssetFormat::Gltf: return ".gltf";
+        case EAssetFormat::Glb: return ".glb";
+        case EAssetFormat::WMesh: return ".wmesh";
         case EAssetFormat::Bmp: return ".bmp";
         case EAssetFormat::Png: return ".png";
         case EAssetFormat::Jpeg: return ".jpeg";
+        case EAssetFormat::Dds: return ".dds";
         case EAssetFormat::Unknown: WARP_ATTR_FALLTHROUGH;
         default: WARP_ASSERT(false); return "";
         }
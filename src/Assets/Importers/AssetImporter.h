@@ -10,21 +10,28 @@ namespace Warp
     {
         Unknown,
         Gltf,
+        Glb,
+        WMesh,
         Bmp,
         Png,
         Jpeg,
+        Dds,
     };
 
     const char* FileExtentionFromFormat(EAssetFormat format);
 
     class AssetManager;
+    class DerivedDataCache;
 
     class AssetImporter
     {
     public:
         AssetImporter() = default;
-        AssetImporter(AssetManager* assetManager)
+
+        // Derived data cache is optional. Without it importers always import from source files
+        AssetImporter(AssetManager* assetManager, DerivedDataCache* derivedDataCache = nullptr)
             : m_assetManager(assetManager)
+            , m_derivedDataCache(derivedDataCache)
         {
         }
 
@@ -37,6 +44,7 @@ namespace Warp
         }
 
         inline AssetManager* GetAssetManager() const { return m_assetManager; }
+        inline DerivedDataCache* GetDerivedDataCache() const { return m_derivedDataCache; }
 
     protected:
         inline void AddFormat(const std::string& extension, EAssetFormat format)
@@ -46,6 +54,7 @@ namespace Warp
 
         std::map<std::string, EAssetFormat> m_supportedFormats;
         AssetManager* m_assetManager = nullptr;
+        DerivedDataCache* m_derivedDataCache = nullptr;
     };
 
 }
\ No newline at end of file
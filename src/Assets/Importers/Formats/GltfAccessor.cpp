@@ -0,0 +1,290 @@
+#include "GltfAccessor.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <emmintrin.h>
+
+#include "../../../Core/Assert.h"
+#include "../../../Util/Logger.h"
+
+namespace Warp::GltfImporter
+{
+
+    static const std::byte* GetViewData(const cgltf_buffer_view* view)
+    {
+        return reinterpret_cast<const std::byte*>(cgltf_buffer_view_data(view));
+    }
+
+    // Checks that numElements elements of elementSize bytes, placed stride bytes apart starting at offset, are inside of the view
+    static bool IsValidViewRange(const cgltf_buffer_view* view, size_t offset, size_t stride, size_t elementSize, size_t numElements)
+    {
+        if (numElements == 0)
+        {
+            return true;
+        }
+
+        if (offset > view->size || elementSize > view->size - offset || (numElements > 1 && stride < elementSize))
+        {
+            return false;
+        }
+
+        // Written this way to not overflow on absurd counts
+        return numElements == 1 || (numElements - 1) <= (view->size - offset - elementSize) / stride;
+    }
+
+    static bool IsValidAccessor(const cgltf_accessor* accessor, size_t elementSize)
+    {
+        // Accessors without a buffer view are filled with zeros (and then with sparse values, if any)
+        const cgltf_buffer_view* view = accessor->buffer_view;
+        if (view && (!GetViewData(view) || !IsValidViewRange(view, accessor->offset, accessor->stride, elementSize, accessor->count)))
+        {
+            return false;
+        }
+
+        if (!accessor->is_sparse)
+        {
+            return true;
+        }
+
+        // Sparse indices and values are always tightly packed
+        const cgltf_accessor_sparse& sparse = accessor->sparse;
+        size_t indexSize = cgltf_component_size(sparse.indices_component_type);
+        return indexSize != 0 &&
+            sparse.indices_buffer_view && GetViewData(sparse.indices_buffer_view) &&
+            sparse.values_buffer_view && GetViewData(sparse.values_buffer_view) &&
+            IsValidViewRange(sparse.indices_buffer_view, sparse.indices_byte_offset, indexSize, indexSize, sparse.count) &&
+            IsValidViewRange(sparse.values_buffer_view, sparse.values_byte_offset, elementSize, elementSize, sparse.count);
+    }
+
+    // Reads an unsigned integer of the component type, the source may be unaligned
+    static uint32_t ReadUnsigned(const std::byte* src, cgltf_component_type componentType)
+    {
+        switch (componentType)
+        {
+        case cgltf_component_type_r_8u: return static_cast<uint32_t>(*reinterpret_cast<const uint8_t*>(src));
+        case cgltf_component_type_r_16u: { uint16_t value; std::memcpy(&value, src, sizeof(value)); return value; }
+        case cgltf_component_type_r_32u: { uint32_t value; std::memcpy(&value, src, sizeof(value)); return value; }
+        default: WARP_ASSERT(false, "Not an unsigned integer component type"); return 0;
+        }
+    }
+
+    // Invokes func(elementIndex, value) for every sparse element of the accessor, where value points to elementSize bytes
+    // Returns false if any sparse index is out of range. Expects the accessor to be validated
+    template<typename Func>
+    static bool ForEachSparseElement(const cgltf_accessor* accessor, size_t elementSize, Func&& func)
+    {
+        const cgltf_accessor_sparse& sparse = accessor->sparse;
+        size_t indexSize = cgltf_component_size(sparse.indices_component_type);
+        const std::byte* indices = GetViewData(sparse.indices_buffer_view) + sparse.indices_byte_offset;
+        const std::byte* values = GetViewData(sparse.values_buffer_view) + sparse.values_byte_offset;
+
+        for (size_t i = 0; i < sparse.count; ++i)
+        {
+            uint32_t elementIndex = ReadUnsigned(indices + i * indexSize, sparse.indices_component_type);
+            if (elementIndex >= accessor->count)
+            {
+                return false;
+            }
+
+            func(elementIndex, values + i * elementSize);
+        }
+        return true;
+    }
+
+    // Copies count elements of elementSize bytes, which are srcStride bytes apart, into tightly packed dest
+    static void CopyStridedElements(std::byte* dest, const std::byte* src, size_t srcStride, size_t elementSize, size_t count)
+    {
+        if (srcStride == elementSize)
+        {
+            std::memcpy(dest, src, count * elementSize);
+            return;
+        }
+
+        // Interleaved vertices. Common element sizes are moved with a single SSE load/store pair instead of a memcpy call per element
+        switch (elementSize)
+        {
+        case 8: // float2
+            for (size_t i = 0; i < count; ++i)
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + i * 8), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * srcStride)));
+            }
+            break;
+        case 12: // float3
+            if (count > 0)
+            {
+                // A 16-byte move also touches the first 4 bytes of the next element both in source and in dest.
+                // That is safe for every element but the last one, which is copied exactly. Dest bytes are overwritten by the next iteration
+                for (size_t i = 0; i + 1 < count; ++i)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 12), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * srcStride)));
+                }
+                std::memcpy(dest + (count - 1) * 12, src + (count - 1) * srcStride, 12);
+            }
+            break;
+        case 16: // float4
+            for (size_t i = 0; i < count; ++i)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 16), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * srcStride)));
+            }
+            break;
+        default:
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::memcpy(dest + i * elementSize, src + i * srcStride, elementSize);
+            }
+            break;
+        }
+    }
+
+    bool ReadAccessorFloats(const cgltf_accessor* accessor, uint32_t numComponents, std::span<float> dest)
+    {
+        if (cgltf_num_components(accessor->type) != numComponents || dest.size() != accessor->count * numComponents)
+        {
+            WARP_LOG_ERROR("GltfImporter::ReadAccessorFloats -> Accessor does not match the requested layout");
+            return false;
+        }
+
+        if (!IsValidAccessor(accessor, cgltf_calc_size(accessor->type, accessor->component_type)))
+        {
+            WARP_LOG_ERROR("GltfImporter::ReadAccessorFloats -> Accessor is out of bounds of its buffer views");
+            return false;
+        }
+
+        if (accessor->component_type != cgltf_component_type_r_32f)
+        {
+            // Quantized attributes need per-component conversion anyway. cgltf does it and handles sparse storage as well
+            if (cgltf_accessor_unpack_floats(accessor, dest.data(), dest.size()) != dest.size())
+            {
+                return false;
+            }
+
+            // cgltf divides signed normalized values by their maximum, the spec clamps the smallest value to -1 as well
+            if (accessor->normalized && (accessor->component_type == cgltf_component_type_r_8 || accessor->component_type == cgltf_component_type_r_16))
+            {
+                for (float& value : dest)
+                {
+                    value = std::max(value, -1.0f);
+                }
+            }
+            return true;
+        }
+
+        size_t elementSize = numComponents * sizeof(float);
+        std::byte* destBytes = reinterpret_cast<std::byte*>(dest.data());
+        if (accessor->buffer_view)
+        {
+            CopyStridedElements(destBytes, GetViewData(accessor->buffer_view) + accessor->offset, accessor->stride, elementSize, accessor->count);
+        }
+        else
+        {
+            std::fill(dest.begin(), dest.end(), 0.0f);
+        }
+
+        if (accessor->is_sparse &&
+            !ForEachSparseElement(accessor, elementSize, [destBytes, elementSize](size_t elementIndex, const std::byte* value)
+                {
+                    std::memcpy(destBytes + elementIndex * elementSize, value, elementSize);
+                }))
+        {
+            WARP_LOG_ERROR("GltfImporter::ReadAccessorFloats -> Sparse index is out of range");
+            return false;
+        }
+
+        return true;
+    }
+
+    template<typename IndexType>
+    static bool ReadAccessorIndicesImpl(const cgltf_accessor* accessor, uint32_t numVertices, std::span<IndexType> dest)
+    {
+        size_t indexSize = cgltf_component_size(accessor->component_type);
+        if (accessor->type != cgltf_type_scalar || indexSize == 0 || accessor->component_type == cgltf_component_type_r_32f || dest.size() != accessor->count)
+        {
+            WARP_LOG_ERROR("GltfImporter::ReadAccessorIndices -> Accessor does not contain indices");
+            return false;
+        }
+
+        if (!IsValidAccessor(accessor, indexSize))
+        {
+            WARP_LOG_ERROR("GltfImporter::ReadAccessorIndices -> Accessor is out of bounds of its buffer views");
+            return false;
+        }
+
+        // Largest index that was read, checked before narrowing so that wide indices cannot wrap into range
+        uint32_t maxIndex = 0;
+        if (accessor->buffer_view)
+        {
+            const std::byte* src = GetViewData(accessor->buffer_view) + accessor->offset;
+            size_t stride = accessor->stride;
+
+            auto convert = [&dest, &maxIndex, src, stride]<typename SrcType>()
+            {
+                if constexpr (std::is_same_v<SrcType, IndexType>)
+                {
+                    if (stride == sizeof(SrcType))
+                    {
+                        std::memcpy(dest.data(), src, dest.size() * sizeof(IndexType));
+                        maxIndex = dest.empty() ? 0 : *std::max_element(dest.begin(), dest.end());
+                        return;
+                    }
+                }
+
+                for (size_t i = 0; i < dest.size(); ++i)
+                {
+                    SrcType index;
+                    std::memcpy(&index, src + i * stride, sizeof(SrcType));
+                    maxIndex = std::max<uint32_t>(maxIndex, index);
+                    dest[i] = static_cast<IndexType>(index);
+                }
+            };
+
+            switch (accessor->component_type)
+            {
+            case cgltf_component_type_r_8u: convert.template operator()<uint8_t>(); break;
+            case cgltf_component_type_r_16u: convert.template operator()<uint16_t>(); break;
+            case cgltf_component_type_r_32u: convert.template operator()<uint32_t>(); break;
+            default: WARP_LOG_ERROR("GltfImporter::ReadAccessorIndices -> Indices should be unsigned integers"); return false;
+            }
+        }
+        else
+        {
+            std::fill(dest.begin(), dest.end(), IndexType(0));
+        }
+
+        uint32_t maxSparseIndex = 0;
+        cgltf_component_type componentType = accessor->component_type;
+        if (accessor->is_sparse &&
+            !ForEachSparseElement(accessor, indexSize, [&dest, &maxSparseIndex, componentType](size_t elementIndex, const std::byte* value)
+                {
+                    uint32_t index = ReadUnsigned(value, componentType);
+                    maxSparseIndex = std::max(maxSparseIndex, index);
+                    dest[elementIndex] = static_cast<IndexType>(index);
+                }))
+        {
+            WARP_LOG_ERROR("GltfImporter::ReadAccessorIndices -> Sparse index is out of range");
+            return false;
+        }
+
+        // Indices that sparse values replace are checked as well, a file that has them out of range is malformed anyway
+        maxIndex = std::max(maxIndex, maxSparseIndex);
+        if (!dest.empty() && maxIndex >= numVertices)
+        {
+            WARP_LOG_ERROR("GltfImporter::ReadAccessorIndices -> Index {} is out of range of {} vertices", maxIndex, numVertices);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ReadAccessorIndices(const cgltf_accessor* accessor, uint32_t numVertices, std::span<uint16_t> dest)
+    {
+        return ReadAccessorIndicesImpl(accessor, numVertices, dest);
+    }
+
+    bool ReadAccessorIndices(const cgltf_accessor* accessor, uint32_t numVertices, std::span<uint32_t> dest)
+    {
+        return ReadAccessorIndicesImpl(accessor, numVertices, dest);
+    }
+
+}
\ No newline at end of file
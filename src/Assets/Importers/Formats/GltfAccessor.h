@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include <cgltf.h>
+
+// Extraction of glTF accessors into tightly packed arrays
+// https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#accessors
+//
+// Accessors may point into interleaved buffer views (byteStride), start at an offset inside of the view and be sparse,
+// all of which is handled here in a single pass over the source data. Every function validates accessor's ranges against its buffer views,
+// thus malformed files fail gracefully instead of reading out of bounds
+namespace Warp::GltfImporter
+{
+
+    // De-interleaves accessor's elements of numComponents floats into dest and applies sparse substitution if any
+    // dest should hold exactly accessor->count * numComponents floats
+    //
+    // 32-bit float components are copied as-is, normalized and integer components (KHR_mesh_quantization) are converted to floats
+    // Returns false if the accessor type does not have numComponents components or if the accessor is malformed
+    bool ReadAccessorFloats(const cgltf_accessor* accessor, uint32_t numComponents, std::span<float> dest);
+
+    // Reads accessor's indices of any unsigned component type into dest and applies sparse substitution if any
+    // dest should hold exactly accessor->count indices
+    //
+    // Returns false if any index is not below numVertices, thus every index that is read fits into dest as long as
+    // the width of dest is chosen based on the number of vertices
+    bool ReadAccessorIndices(const cgltf_accessor* accessor, uint32_t numVertices, std::span<uint16_t> dest);
+    bool ReadAccessorIndices(const cgltf_accessor* accessor, uint32_t numVertices, std::span<uint32_t> dest);
+
+}
\ No newline at end of file
@@ -3,22 +3,39 @@
 #define CGLTF_IMPLEMENTATION
 #include <cgltf.h>
 
-// TODO: Warp Asset Loader does not support sparse GLTF accessors currently. Will be removed asap
-#define WAL_GLTF_SPARSE_NOIMPL(accessor) { if (accessor->is_sparse) { WARP_YIELD_NOIMPL(); } }
-
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <format>
 #include <array>
+#include <limits>
+#include <memory>
+#include <span>
 #include <string>
+#include <variant>
 #include <vector>
 
+#include "../../../Util/MappedFile.h"
 #include "../../../Util/String.h"
+#include "../../../Util/ThreadPool.h"
+#include "../../../Util/Timer.h"
+
+#include "GltfAccessor.h"
+#include "WMeshFormat.h"
 
 #include "../../AssetManager.h"
+#include "../../DerivedDataCache.h"
 #include "../../MaterialAsset.h"
 #include "../../MeshAsset.h"
+#include "../../MeshStatistics.h"
+#include "../../VertexQuantization.h"
 
 #include "../../../Math/Math.h"
+#include "../../../Math/MeshSimplification.h"
+#include "../../../Math/TangentFrames.h"
 #include "../../../Util/Logger.h"
 #include "../../../Core/Assert.h"
 #include "../../../Renderer/Vertex.h"
@@ -35,7 +52,7 @@ namespace Warp
         // written in a way to support texture caching, as this was intended for MeshImporter, but I was wrong by doing so... Write caching please
 
         // WARP Remarks: (Maybe do not?) We convert gltf's Vec4 tangents to Vec3 tangents/bitangents here
-        // WARP Remarks: (TODO) We currently only do 32-bit indices and if they were 16-bit initially we just convert them
+        // WARP Remarks: Indices are 16-bit whenever the submesh has few enough vertices, no matter which component type glTF uses
         struct StaticMesh
         {
             using ESubmeshProperties = uint16_t;
@@ -45,18 +62,67 @@ namespace Warp
                 eSubmeshProperty_HasMaterial = 1,
             };
 
+            // Location of a processed stream inside of the payload of the mesh asset, see StaticMesh_WriteSubmeshPayload()
+            struct StreamRange
+            {
+                size_t Offset = 0;
+                size_t NumElements = 0;
+            };
+
             struct Submesh
             {
                 template<typename T>
                 using AttributeArray = std::array<T, eVertexAttribute_NumAttributes>;
 
+                // Primitive is collected while walking the node hierarchy, its geometry is read right before the submesh is processed
+                cgltf_primitive* SourcePrimitive = nullptr;
+                Math::Matrix LocalToModel;
+
                 uint32_t NumVertices = 0;
                 AttributeArray<std::vector<std::byte>> Attributes = {};
                 AttributeArray<uint32_t> AttributeStrides = {};
+                AttributeArray<EVertexEncoding> AttributeEncodings = {};
+                PositionBounds Bounds; // Only valid if streams are quantized
+
+                size_t GetNumIndices() const { return std::visit([](const auto& indices) { return indices.size(); }, Indices); }
+
+                // Holds 16-bit indices if every vertex is addressable with them, see StaticMesh_ProcessAttributes()
+                std::variant<std::vector<uint16_t>, std::vector<uint32_t>> Indices;
 
-                // TODO: We currently only do 32-bit indices and if they were 16-bit initially we just convert them
-                // This should be changed and 16-bit indices should be supported
-                std::vector<uint32_t> Indices;
+                struct Lod
+                {
+                    std::vector<DirectX::Meshlet> Meshlets;
+                    std::vector<uint8_t> UniqueVertexIndices;
+                    std::vector<DirectX::MeshletTriangle> PrimitiveIndices;
+                    std::vector<DirectX::CullData> MeshletCullData;
+                    uint32_t NumTriangles = 0;
+                    float Error = 0.0f;
+
+                    StreamRange MeshletRange;
+                    StreamRange UniqueVertexIndexRange;
+                    StreamRange PrimitiveIndexRange;
+                    StreamRange MeshletCullDataRange;
+                };
+
+                // Filled by StaticMesh_OptimizeSubmesh(), Lods[0] is the full detail level
+                // Unique vertex indices of every level have the same width as Indices had
+                std::vector<Lod> Lods;
+                uint32_t UniqueVertexIndexStride = 0;
+                EMeshletSize MeshletSize = eMeshletSize_128;
+                DirectX::BoundingSphere BoundingSphere;
+
+                // Filled by StaticMesh_OptimizeSubmesh() only if StaticMeshImportDesc::ReportStatistics is set
+                struct Statistics
+                {
+                    VertexCacheStatistics SourceVertexCache;
+                    VertexCacheStatistics OptimizedVertexCache;
+                    MeshletStatistics Meshlets; // Of the full detail level
+                    VertexQuantizationError Quantization; // Only measured if StaticMeshImportDesc::QuantizeVertices is set as well
+                };
+                Statistics Stats;
+
+                // Streams are released once they are written into the payload, only their ranges are kept
+                AttributeArray<StreamRange> AttributeRanges = {};
 
                 ESubmeshProperties Properties = eSubmeshProperty_None;
             };
@@ -65,28 +131,295 @@ namespace Warp
 
             std::string Name;
             std::vector<Submesh> Submeshes;
-            std::vector<AssetProxy> SubmeshMaterials;
+            std::vector<AssetHandle> SubmeshMaterials;
+        };
+
+        // Parsed .gltf/.glb file along with the memory its buffers point to
+        // The whole file is mapped once. cgltf parses JSON straight from the mapping and the GLB binary chunk is used in-place as buffer 0,
+        // thus embedded images are decoded from the mapping without a copy. Texture imports keep the file alive until their images are decoded
+        struct GltfFile
+        {
+            GltfFile() = default;
+
+            GltfFile(const GltfFile&) = delete;
+            GltfFile& operator=(const GltfFile&) = delete;
+
+            ~GltfFile()
+            {
+                if (Data)
+                {
+                    cgltf_free(Data);
+                }
+            }
+
+            std::string Filepath;
+            std::filesystem::path Folder;
+            MappedFile Mapping;
+            std::vector<MappedFile> BufferMappings; // External buffers (.bin) by buffer index, invalid for other buffers
+            cgltf_data* Data = nullptr;
+            bool AreBuffersLoaded = false; // Only JSON is parsed until LoadGltfBuffers()
         };
 
-        struct StaticMeshImportDesc
+        // Appends processed streams in the layout of MeshPayload, every stream starts at MeshPayload::Alignment
+        // Streams are either kept in memory or spilled into an anonymous temporary file, see StaticMeshImportDesc::LowMemoryImport
+        class PayloadWriter
         {
-            // Determines whether or not to generate tangents and bitangents (binormals)
-            bool GenerateTangents = false;
+        public:
+            // Returns false if the temporary file cannot be created, the writer keeps streams in memory in that case
+            bool OpenSpillFile()
+            {
+                m_spillFile.reset(std::tmpfile());
+                return m_spillFile != nullptr;
+            }
+
+            // In-memory streams are written into a single allocation of this size, which later becomes the payload as-is
+            void Reserve(size_t numBytes)
+            {
+                if (!m_spillFile)
+                {
+                    m_bytes.reserve(numBytes);
+                }
+            }
+
+            template<typename T>
+            StaticMesh::StreamRange Append(const std::vector<T>& stream)
+            {
+                size_t numBytes = stream.size() * sizeof(T);
+                if (numBytes == 0)
+                {
+                    return StaticMesh::StreamRange();
+                }
+
+                StaticMesh::StreamRange range = StaticMesh::StreamRange{ .Offset = m_size, .NumElements = stream.size() };
+                size_t numPaddedBytes = MeshPayload::AlignUp(numBytes);
+                if (m_spillFile)
+                {
+                    static constexpr std::byte Padding[MeshPayload::Alignment] = {};
+                    m_isSpillValid = m_isSpillValid &&
+                        std::fwrite(stream.data(), 1, numBytes, m_spillFile.get()) == numBytes &&
+                        std::fwrite(Padding, 1, numPaddedBytes - numBytes, m_spillFile.get()) == numPaddedBytes - numBytes;
+                }
+                else
+                {
+                    m_bytes.resize(m_size + numPaddedBytes);
+                    std::memcpy(m_bytes.data() + m_size, stream.data(), numBytes);
+                }
+
+                m_size += numPaddedBytes;
+                return range;
+            }
+
+            // Moves written streams into the payload. Returns false if the spill file could not be written or read back
+            bool Finalize(MeshPayload& payload)
+            {
+                if (!m_spillFile)
+                {
+                    payload = MeshPayload(std::move(m_bytes));
+                    return true;
+                }
+
+                bool result = m_isSpillValid;
+                if (result)
+                {
+                    payload = MeshPayload(m_size);
+                    std::rewind(m_spillFile.get());
+                    result = std::fread(payload.GetMutableBytes().data(), 1, m_size, m_spillFile.get()) == m_size;
+                }
+
+                m_spillFile.reset();
+                return result;
+            }
+
+        private:
+            struct FileCloser
+            {
+                void operator()(std::FILE* file) const { std::fclose(file); }
+            };
+
+            std::unique_ptr<std::FILE, FileCloser> m_spillFile;
+            std::vector<std::byte> m_bytes;
+            size_t m_size = 0;
+            bool m_isSpillValid = true;
         };
 
+        // Maps the file and parses its JSON, buffers are not touched. Enough to build the derived data key and to walk the scene
+        static std::shared_ptr<GltfFile> ParseGltfFile(const std::string& filepath);
+
+        // Maps external buffers and decodes data URI buffers of a parsed file. Does nothing if they are loaded already
+        static bool LoadGltfBuffers(GltfFile& file);
+
+        // Same as ParseGltfFile() followed by LoadGltfBuffers()
+        static std::shared_ptr<GltfFile> OpenGltfFile(const std::string& filepath);
+
         static Math::Matrix GetLocalToModel(cgltf_node* node);
 
-        static AssetProxy StaticMesh_ImportTextureFromView(const std::filesystem::path& folder, cgltf_image* img, TextureImporter* importer);
-        static AssetProxy StaticMesh_ImportSubmeshMaterial(const std::filesystem::path& folder, cgltf_material* glTFMaterial, TextureImporter* importer);
+        // Returns Unknown if the image is not of a format supported by the texture importer
+        static EAssetFormat GetImageFormatFromMimeType(std::string_view mimeType);
+
+        // Imports an image from a buffer view or a data URI. The texture is registered under TextureImporter::MakeEmbeddedImagePath()
+        static AssetProxy StaticMesh_ImportEmbeddedImage(const std::shared_ptr<GltfFile>& file, size_t imageIndex, ETextureUsage usage, TextureImporter* importer);
+        static AssetProxy StaticMesh_ImportTextureFromView(const std::shared_ptr<GltfFile>& file, cgltf_image* img, ETextureUsage usage, TextureImporter* importer);
+        static AssetProxy StaticMesh_ImportSubmeshMaterial(const std::shared_ptr<GltfFile>& file, cgltf_material* glTFMaterial, TextureImporter* importer);
+
+        // Attributes are de-interleaved into tightly packed arrays, see GltfAccessor.h. AttributeType should consist of floats
+        template<typename AttributeType>
+        static bool StaticMesh_FillAttributesFromAccessor(std::vector<AttributeType>& dest, cgltf_accessor* accessor);
+
+        template<typename AttributeType>
+        static bool StaticMesh_FillAttributeBytesFromAccessor(std::vector<std::byte>& dest, uint32_t& stride, cgltf_accessor* accessor);
+
+        template<typename IndexType>
+        static bool StaticMesh_FillIndicesFromAccessor(std::vector<IndexType>& dest, uint32_t numVertices, cgltf_accessor* accessor);
+
+        // Walks the node hierarchy, imports materials and collects primitives of submeshes without reading their geometry
+        // Loads buffers of the parsed file and returns it, it should be kept alive until every submesh is read with StaticMesh_ProcessAttributes()
+        static std::shared_ptr<GltfFile> StaticMesh_ImportFromFile(std::shared_ptr<GltfFile> file, StaticMesh& mesh, const StaticMeshImportDesc& importDesc, TextureImporter* importer);
+
+        // Returns false if the primitive could not be read, the submesh should be discarded in that case
+        static bool StaticMesh_ProcessAttributes(StaticMesh::Submesh& submesh, const Math::Matrix& localToModel, const StaticMeshImportDesc& desc, cgltf_primitive* primitive);
+        static void StaticMesh_ProcessNode(StaticMesh& mesh, const std::shared_ptr<GltfFile>& file, const StaticMeshImportDesc& desc, cgltf_node* node, TextureImporter* importer);
+
+        // Imports materials and collects primitives of a single glTF mesh, whose vertices are going to be transformed by localToModel
+        static void StaticMesh_CollectMesh(StaticMesh& mesh, const std::shared_ptr<GltfFile>& file, cgltf_mesh* glTFMsh, const Math::Matrix& localToModel, TextureImporter* importer);
+
+        struct SceneNode
+        {
+            cgltf_node* Node;
+            uint32_t ParentIndex;
+        };
+
+        // Appends every node of the subtree, parents before children
+        static void CollectSceneNodes(cgltf_node* node, uint32_t parentIndex, std::vector<SceneNode>& nodes);
+
+        // Validates, cleans and optimizes the submesh in-place and generates meshlets of its levels of detail. Returns false if the submesh is unusable
+        // Only touches its own arguments, thus it is safe to process several submeshes concurrently
+        static bool StaticMesh_OptimizeSubmesh(StaticMesh::Submesh& submesh, const StaticMeshImportDesc& desc, std::string_view meshName, size_t submeshIndex);
+
+        // Does the actual work of StaticMesh_OptimizeSubmesh() for indices of the submesh, which are released afterwards
+        template<typename IndexType>
+        static bool StaticMesh_OptimizeSubmeshWithIndices(StaticMesh::Submesh& submesh, std::vector<IndexType>& indices, const StaticMeshImportDesc& desc, std::string_view meshName, size_t submeshIndex);
+
+        // Generates meshlets and their cull data for a level of detail. Adjacency is optional
+        template<typename IndexType>
+        static bool StaticMesh_BuildLodMeshlets(const StaticMesh::Submesh& submesh, std::span<const IndexType> indices, const uint32_t* adjacency,
+            StaticMesh::Submesh::Lod& lod, std::string_view meshName, size_t submeshIndex);
+
+        // Appends simplified levels of detail to the submesh, each one is simplified from the previous one. Expects the full detail level to be built
+        template<typename IndexType>
+        static void StaticMesh_GenerateLods(StaticMesh::Submesh& submesh, std::span<const IndexType> indices, const StaticMeshImportDesc& desc, std::string_view meshName, size_t submeshIndex);
+
+        // Replaces float streams of the submesh with quantized ones. Expects the submesh to be optimized, as the rest of the import works with floats
+        // If measureError is set, the error of quantization is stored in statistics of the submesh
+        static void StaticMesh_QuantizeSubmesh(StaticMesh::Submesh& submesh, bool measureError);
+
+        // Logs statistics of every valid submesh and their sum. Expects submeshes to be optimized with StaticMeshImportDesc::ReportStatistics
+        static void StaticMesh_ReportStatistics(const StaticMesh& mesh, std::span<const uint8_t> validSubmeshes, bool isQuantized);
+
+        // Reads, validates, optimizes and quantizes a single collected submesh. Returns false if the submesh should be discarded
+        static bool StaticMesh_ProcessSubmesh(StaticMesh& importedMesh, size_t submeshIndex, const StaticMeshImportDesc& importDesc);
+
+        // Packs processed submeshes into the payload of the mesh asset, unless they were spilled into payloadWriter already, and builds the asset
+        // Returns false if the payload could not be built
+        static bool StaticMesh_FinishMesh(StaticMesh& importedMesh, std::span<const uint8_t> validSubmeshes, PayloadWriter& payloadWriter, bool isSpilled,
+            const StaticMeshImportDesc& importDesc, MeshAsset& mesh);
+
+        // Reads, processes and packs every collected submesh of every mesh into its mesh asset. isProcessed is set for every mesh whose payload was built
+        // Submeshes of all meshes are processed with a single thread pool. Drops its reference to the file once the last submesh has been read,
+        // so callers pass their last reference when done with the file
+        static void StaticMesh_Process(std::span<StaticMesh> importedMeshes, std::shared_ptr<GltfFile> file, const StaticMeshImportDesc& importDesc,
+            std::span<MeshAsset* const> meshes, std::span<uint8_t> isProcessed);
+
+        // Same as above for a single mesh. Returns false if the payload could not be built
+        static bool StaticMesh_Process(StaticMesh& importedMesh, std::shared_ptr<GltfFile> file, const StaticMeshImportDesc& importDesc, MeshAsset& mesh);
+
+        // Number of payload bytes that StaticMesh_WriteSubmeshPayload() writes for the submesh
+        static size_t StaticMesh_GetPayloadSize(const StaticMesh::Submesh& submesh);
+
+        // Appends every stream of the processed submesh to the writer, records their ranges and releases them right away
+        static void StaticMesh_WriteSubmeshPayload(StaticMesh::Submesh& submesh, PayloadWriter& writer);
+
+        // Points submeshes of the mesh asset into its payload, which holds streams of every valid submesh written by StaticMesh_WriteSubmeshPayload()
+        static void StaticMesh_BuildMeshAsset(StaticMesh& importedMesh, std::span<const uint8_t> validSubmeshes, MeshAsset& mesh);
+
+        std::shared_ptr<GltfFile> ParseGltfFile(const std::string& filepath)
+        {
+            std::shared_ptr<GltfFile> file = std::make_shared<GltfFile>();
+            file->Filepath = filepath;
+            file->Folder = std::filesystem::path(filepath).parent_path();
+            if (!file->Mapping.Open(filepath))
+            {
+                WARP_LOG_ERROR("GltfImporter::ParseGltfFile -> Failed to map \'{}\'", filepath);
+                return nullptr;
+            }
+
+            // Both .gltf and .glb are detected by cgltf from the contents
+            cgltf_options options = {};
+            cgltf_result result = cgltf_parse(&options, file->Mapping.GetData(), file->Mapping.GetSize(), &file->Data);
+            if (result != cgltf_result_success)
+            {
+                WARP_LOG_ERROR("GltfImporter::ParseGltfFile -> Failed to parse glTF model at \'{}\'", filepath);
+                return nullptr;
+            }
+
+            return file;
+        }
+
+        bool LoadGltfBuffers(GltfFile& file)
+        {
+            if (file.AreBuffersLoaded)
+            {
+                return true;
+            }
+
+            // External buffers are mapped rather than read into memory, so that geometry of huge scenes stays out of private memory
+            // Pages are brought in while primitives are read and can be dropped by the OS afterwards
+            cgltf_data* data = file.Data;
+            file.BufferMappings.resize(data->buffers_count);
+            for (size_t i = 0; i < data->buffers_count; ++i)
+            {
+                cgltf_buffer& buffer = data->buffers[i];
+                if (buffer.data || !buffer.uri || std::strncmp(buffer.uri, "data:", 5) == 0 || std::strstr(buffer.uri, "://"))
+                {
+                    continue;
+                }
+
+                std::string decodedUri = buffer.uri;
+                decodedUri.resize(cgltf_decode_uri(decodedUri.data()));
+                MappedFile& mapping = file.BufferMappings[i];
+                if (!mapping.Open(file.Folder / decodedUri) || mapping.GetSize() < buffer.size)
+                {
+                    WARP_LOG_ERROR("GltfImporter::LoadGltfBuffers -> Failed to map buffer \'{}\' of \'{}\'", decodedUri, file.Filepath);
+                    return false;
+                }
+
+                // Accessors are only ever read from, thus read-only pages are fine
+                buffer.data = const_cast<std::byte*>(mapping.GetData());
+                buffer.data_free_method = cgltf_data_free_method_none;
+            }
+
+            // Buffer 0 of .glb files points to the binary chunk inside of the mapping, only data URI buffers are loaded here
+            // cgltf_load_buffers() skips buffers that already have data
+            cgltf_options options = {};
+            if (cgltf_load_buffers(&options, data, file.Filepath.data()) != cgltf_result_success)
+            {
+                WARP_LOG_ERROR("GltfImporter::LoadGltfBuffers -> Failed to load buffers for glTF model at \'{}\'", file.Filepath);
+                return false;
+            }
 
-        template<typename AttributeType, cgltf_component_type ReqType>
-        static void StaticMesh_FillAttributesFromAccessor(std::vector<AttributeType>& dest, cgltf_accessor* accessor);
+            file.AreBuffersLoaded = true;
+            return true;
+        }
 
-        template<typename AttributeType, cgltf_component_type ReqType>
-        static void StaticMesh_FillAttributeBytesFromAccessor(std::vector<std::byte>& dest, uint32_t& stride, cgltf_accessor* accessor);
+        std::shared_ptr<GltfFile> OpenGltfFile(const std::string& filepath)
+        {
+            std::shared_ptr<GltfFile> file = ParseGltfFile(filepath);
+            if (!file || !LoadGltfBuffers(*file))
+            {
+                return nullptr;
+            }
 
-        static void StaticMesh_ProcessAttributes(StaticMesh::Submesh& submesh, const Math::Matrix& localToModel, const StaticMeshImportDesc& desc, cgltf_primitive* primitive);
-        static void StaticMesh_ProcessNode(StaticMesh& mesh, const std::filesystem::path& folder, const StaticMeshImportDesc& desc, cgltf_node* node, TextureImporter* importer);
+            return file;
+        }
 
         Math::Matrix GetLocalToModel(cgltf_node* node)
         {
@@ -107,27 +440,121 @@ namespace Warp
             return LocalToModel;
         }
 
-        AssetProxy StaticMesh_ImportTextureFromView(const std::filesystem::path& folder, cgltf_image* img, TextureImporter* importer)
+        EAssetFormat GetImageFormatFromMimeType(std::string_view mimeType)
         {
-            if (!importer || !img)
+            // glTF core only allows PNG and JPEG, DDS comes from MSFT_texture_dds
+            if (mimeType == "image/png") return EAssetFormat::Png;
+            if (mimeType == "image/jpeg") return EAssetFormat::Jpeg;
+            if (mimeType == "image/vnd-ms.dds") return EAssetFormat::Dds;
+            return EAssetFormat::Unknown;
+        }
+
+        AssetProxy StaticMesh_ImportEmbeddedImage(const std::shared_ptr<GltfFile>& file, size_t imageIndex, ETextureUsage usage, TextureImporter* importer)
+        {
+            const cgltf_image& img = file->Data->images[imageIndex];
+            std::string imagePath = TextureImporter::MakeEmbeddedImagePath(file->Filepath, imageIndex);
+
+            // Embedded images are shared between materials the same way as files are
+            AssetProxy proxy = importer->GetAssetManager()->GetAssetProxy(imagePath);
+            if (proxy.IsValid())
+            {
+                return proxy;
+            }
+
+            std::span<const std::byte> bytes;
+            std::shared_ptr<const void> storage;
+            std::string_view mimeType = img.mime_type ? img.mime_type : std::string_view();
+            if (img.buffer_view)
+            {
+                // Decoded straight from the buffer, which is the mapping itself for .glb files
+                const cgltf_buffer_view* view = img.buffer_view;
+                const void* viewData = cgltf_buffer_view_data(view);
+                if (!viewData || view->offset > view->buffer->size || view->size > view->buffer->size - view->offset)
+                {
+                    WARP_LOG_ERROR("GltfImporter::StaticMesh_ImportEmbeddedImage -> Buffer view of \'{}\' is out of bounds", imagePath);
+                    return AssetProxy();
+                }
+
+                bytes = std::span(reinterpret_cast<const std::byte*>(viewData), view->size);
+                storage = file;
+            }
+            else if (img.uri && std::strncmp(img.uri, "data:", 5) == 0)
+            {
+                // data:[<mime type>];base64,<data>. This is the only case where the encoded image has to be copied
+                std::string_view uri = img.uri;
+                size_t separator = uri.find(";base64,");
+                if (separator == std::string_view::npos)
+                {
+                    WARP_LOG_ERROR("GltfImporter::StaticMesh_ImportEmbeddedImage -> Only base64 data URIs are supported for \'{}\'", imagePath);
+                    return AssetProxy();
+                }
+
+                if (mimeType.empty())
+                {
+                    mimeType = uri.substr(5, separator - 5);
+                }
+
+                std::string_view base64 = uri.substr(separator + 8);
+                size_t numPaddingChars = base64.ends_with("==") ? 2 : base64.ends_with('=') ? 1 : 0;
+                size_t numBytes = base64.size() / 4 * 3;
+                numBytes = numBytes > numPaddingChars ? numBytes - numPaddingChars : 0;
+
+                void* decoded = nullptr;
+                cgltf_options options = {};
+                if (numBytes == 0 || cgltf_load_buffer_base64(&options, numBytes, base64.data(), &decoded) != cgltf_result_success)
+                {
+                    WARP_LOG_ERROR("GltfImporter::StaticMesh_ImportEmbeddedImage -> Failed to decode data URI of \'{}\'", imagePath);
+                    return AssetProxy();
+                }
+
+                // Default cgltf allocator is malloc
+                bytes = std::span(static_cast<const std::byte*>(decoded), numBytes);
+                storage = std::shared_ptr<const void>(decoded, [](const void* ptr) { std::free(const_cast<void*>(ptr)); });
+            }
+            else
+            {
+                WARP_LOG_ERROR("GltfImporter::StaticMesh_ImportEmbeddedImage -> \'{}\' is not embedded", imagePath);
+                return AssetProxy();
+            }
+
+            EAssetFormat format = GetImageFormatFromMimeType(mimeType);
+            if (format == EAssetFormat::Unknown)
             {
+                WARP_LOG_ERROR("GltfImporter::StaticMesh_ImportEmbeddedImage -> Unsupported image type \'{}\' of \'{}\'", mimeType, imagePath);
                 return AssetProxy();
             }
 
-            if (img->buffer_view)
+            // TODO: GenerateMips is always true? How to get around this one?
+            return importer->ImportFromMemoryAsync(imagePath, format, bytes, std::move(storage), TextureImportDesc{ .GenerateMips = true, .Usage = usage });
+        }
+
+        AssetProxy StaticMesh_ImportTextureFromView(const std::shared_ptr<GltfFile>& file, cgltf_image* img, ETextureUsage usage, TextureImporter* importer)
+        {
+            if (!importer || !img)
             {
-                // Load from memory (glb meshes)
-                WARP_YIELD_NOIMPL();
-                const char* mimeType = img->mime_type;
                 return AssetProxy();
             }
+
+            if (img->buffer_view || (img->uri && std::strncmp(img->uri, "data:", 5) == 0))
+            {
+                // Load from memory (glb meshes and data URIs)
+                size_t imageIndex = cgltf_image_index(file->Data, img);
+                AssetProxy proxy = StaticMesh_ImportEmbeddedImage(file, imageIndex, usage, importer);
+                if (!proxy.IsValid())
+                {
+                    WARP_LOG_ERROR("GltfImporter::StaticMesh_ImportTextureFromView -> Failed to import embedded image {} of \'{}\'", imageIndex, file->Filepath);
+                }
+
+                return proxy;
+            }
             else
             {
                 WARP_ASSERT(img->uri);
-                std::string imagePath = (folder / img->uri).string();
+                std::string imagePath = (file->Folder / img->uri).string();
 
                 // TODO: GenerateMips is always true? How to get around this one?
-                AssetProxy proxy = importer->ImportFromFile(imagePath, TextureImportDesc{ .GenerateMips = true });
+                // Textures are decoded in background, the mesh gets placeholders that become resident once uploaded
+                AssetProxy proxy = importer->ImportFromFileAsync(imagePath, TextureImportDesc{ .GenerateMips = true, .Usage = usage });
                 if (!proxy.IsValid())
                 {
                     WARP_LOG_ERROR("GltfImporter::StaticMesh_ImportTextureFromView -> Failed to import a texture \'{}\' from view", imagePath);
@@ -140,7 +567,7 @@ namespace Warp
         // TODO: https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html - reevaluate metallic-roughness
         // TODO (01.04.2024): Would be nice to revisit this one. What if we have more scene formats supported (fbx, obj, etc.)? Would it be appropriate
         // To write a separate material importer and pass it here rather than passing raw AssetManager?
-        AssetProxy StaticMesh_ImportSubmeshMaterial(const std::filesystem::path& folder, cgltf_material* glTFMaterial, TextureImporter* importer)
+        AssetProxy StaticMesh_ImportSubmeshMaterial(const std::shared_ptr<GltfFile>& file, cgltf_material* glTFMaterial, TextureImporter* importer)
         {
             if (!importer || !importer->GetAssetManager() || !glTFMaterial)
             {
@@ -169,7 +596,7 @@ namespace Warp
             {
                 // Create BaseColor asset using texture loader
                 cgltf_image* img = m.base_color_texture.texture->image;
-                material->AlbedoMap = StaticMesh_ImportTextureFromView(folder, img, importer);
+                material->AlbedoMap = AssetHandle(manager, StaticMesh_ImportTextureFromView(file, img, eTextureUsage_Albedo, importer));
             }
             else
             {
@@ -181,7 +608,7 @@ namespace Warp
                 // As of glTF 2.0 metallic-roughness texture is RGBA texture with green channel for roughness and blue for metalness
                 // thus it is g/b -> roughness/metalness
                 cgltf_image* img = m.metallic_roughness_texture.texture->image;
-                material->RoughnessMetalnessMap = StaticMesh_ImportTextureFromView(folder, img, importer);
+                material->RoughnessMetalnessMap = AssetHandle(manager, StaticMesh_ImportTextureFromView(file, img, eTextureUsage_RoughnessMetalness, importer));
             }
             else
             {
@@ -191,51 +618,54 @@ namespace Warp
             if (glTFMaterial->normal_texture.texture != nullptr)
             {
                 cgltf_image* img = glTFMaterial->normal_texture.texture->image;
-                material->NormalMap = StaticMesh_ImportTextureFromView(folder, img, importer);
+                material->NormalMap = AssetHandle(manager, StaticMesh_ImportTextureFromView(file, img, eTextureUsage_Normal, importer));
             }
 
             return proxy;
         }
 
-        template<typename AttributeType, cgltf_component_type ReqType>
-        void StaticMesh_FillAttributesFromAccessor(std::vector<AttributeType>& dest, cgltf_accessor* accessor)
+        template<typename AttributeType>
+        bool StaticMesh_FillAttributesFromAccessor(std::vector<AttributeType>& dest, cgltf_accessor* accessor)
         {
-            static constexpr size_t AttributeSize = sizeof(AttributeType);
-            WARP_ASSERT(accessor->stride == AttributeSize && accessor->component_type == ReqType);
-
-            cgltf_buffer_view* bufferView = accessor->buffer_view;
-
-            // TODO: Check if this is reliable enough in all cases
-            size_t sz = accessor->count * AttributeSize;
-            const void* buf = bufferView->data ? bufferView->data : bufferView->buffer->data; WARP_ASSERT(buf);
-            const void* src = static_cast<const std::byte*>(buf) + bufferView->offset;
+            static constexpr uint32_t NumComponents = sizeof(AttributeType) / sizeof(float);
+            static_assert(sizeof(AttributeType) == NumComponents * sizeof(float));
 
             dest.clear();
             dest.resize(accessor->count);
-            std::memcpy(dest.data(), src, sz);
+            return ReadAccessorFloats(accessor, NumComponents, std::span<float>(reinterpret_cast<float*>(dest.data()), dest.size() * NumComponents));
         }
 
-        template<typename AttributeType, cgltf_component_type ReqType>
-        void StaticMesh_FillAttributeBytesFromAccessor(std::vector<std::byte>& dest, uint32_t& stride, cgltf_accessor* accessor)
+        template<typename AttributeType>
+        bool StaticMesh_FillAttributeBytesFromAccessor(std::vector<std::byte>& dest, uint32_t& stride, cgltf_accessor* accessor)
         {
-            WARP_ASSERT(accessor->stride == sizeof(AttributeType), accessor->component_type == ReqType);
-            cgltf_buffer_view* bufferView = accessor->buffer_view;
-
-            // TODO: Check if this is reliable enough in all cases
-            size_t sz = accessor->count * accessor->stride;
-            const void* buf = bufferView->data ? bufferView->data : bufferView->buffer->data; WARP_ASSERT(buf);
-            const void* src = static_cast<const std::byte*>(buf) + bufferView->offset;
+            static constexpr uint32_t NumComponents = sizeof(AttributeType) / sizeof(float);
+            static_assert(sizeof(AttributeType) == NumComponents * sizeof(float));
 
             dest.clear();
-            dest.resize(sz);
-            std::memcpy(dest.data(), src, sz);
+            dest.resize(accessor->count * sizeof(AttributeType));
+            stride = sizeof(AttributeType);
+            return ReadAccessorFloats(accessor, NumComponents, std::span<float>(reinterpret_cast<float*>(dest.data()), accessor->count * NumComponents));
+        }
 
-            // TODO: Safety checks?
-            stride = static_cast<uint32_t>(accessor->stride);
+        template<typename IndexType>
+        bool StaticMesh_FillIndicesFromAccessor(std::vector<IndexType>& dest, uint32_t numVertices, cgltf_accessor* accessor)
+        {
+            dest.clear();
+            dest.resize(accessor->count);
+            return ReadAccessorIndices(accessor, numVertices, std::span<IndexType>(dest));
         }
 
-        void StaticMesh_ProcessAttributes(StaticMesh::Submesh& submesh, const Math::Matrix& localToModel, const StaticMeshImportDesc& desc, cgltf_primitive* primitive)
+        bool StaticMesh_ProcessAttributes(StaticMesh::Submesh& submesh, const Math::Matrix& localToModel, const StaticMeshImportDesc& desc, cgltf_primitive* primitive)
         {
+            // Width of indices depends on the number of vertices, thus it is known before indices are read
+            for (size_t attributeIndex = 0; attributeIndex < primitive->attributes_count; ++attributeIndex)
+            {
+                if (primitive->attributes[attributeIndex].type == cgltf_attribute_type_position)
+                {
+                    submesh.NumVertices = static_cast<uint32_t>(primitive->attributes[attributeIndex].data->count);
+                }
+            }
+
             cgltf_accessor* indices = primitive->indices;
             if (!indices)
             {
@@ -246,19 +676,15 @@ namespace Warp
             }
             else
             {
-                WAL_GLTF_SPARSE_NOIMPL(indices);
-                if (indices->component_type == cgltf_component_type_r_16u)
+                // 0xFFFF is reserved by DirectXMesh as an unused index and its 16-bit functions reject meshes of 65535 vertices or more
+                bool result = submesh.NumVertices < std::numeric_limits<uint16_t>::max() ?
+                    StaticMesh_FillIndicesFromAccessor(submesh.Indices.emplace<std::vector<uint16_t>>(), submesh.NumVertices, indices) :
+                    StaticMesh_FillIndicesFromAccessor(submesh.Indices.emplace<std::vector<uint32_t>>(), submesh.NumVertices, indices);
+                if (!result)
                 {
-                    // if u16, manually convert u16 to u32
-                    std::vector<uint16_t> indices16;
-                    StaticMesh_FillAttributesFromAccessor<uint16_t, cgltf_component_type_r_16u>(indices16, indices);
-                    submesh.Indices.reserve(indices16.size());
-                    for (uint16_t i : indices16)
-                    {
-                        submesh.Indices.push_back(static_cast<uint32_t>(i));
-                    }
+                    WARP_LOG_ERROR("GltfMeshLoader -> Failed to read indices");
+                    return false;
                 }
-                else StaticMesh_FillAttributesFromAccessor<uint32_t, cgltf_component_type_r_32u>(submesh.Indices, indices);
             }
 
             // From glTF 2.0 spec https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#geometry-overview
@@ -273,14 +699,13 @@ namespace Warp
                 // Process attribute
                 cgltf_attribute& attribute = primitive->attributes[attributeIndex];
                 cgltf_accessor* accessor = attribute.data; WARP_ASSERT(accessor);
-                WAL_GLTF_SPARSE_NOIMPL(accessor);
+
+                bool result = true;
                 switch (attribute.type)
                 {
                 case cgltf_attribute_type_position:
                 {
-                    submesh.NumVertices = static_cast<uint32_t>(accessor->count);
-
-                    StaticMesh_FillAttributeBytesFromAccessor<Math::Vector3, cgltf_component_type_r_32f>(
+                    result = StaticMesh_FillAttributeBytesFromAccessor<Math::Vector3>(
                         submesh.Attributes[eVertexAttribute_Positions],
                         submesh.AttributeStrides[eVertexAttribute_Positions], accessor);
 
@@ -289,21 +714,28 @@ namespace Warp
 
                     // TODO: Calculate center of the mesh, calculate the length of the mesh for AABB
                 };  break;
-                case cgltf_attribute_type_normal: StaticMesh_FillAttributeBytesFromAccessor<Math::Vector3, cgltf_component_type_r_32f>(
+                case cgltf_attribute_type_normal: result = StaticMesh_FillAttributeBytesFromAccessor<Math::Vector3>(
                     submesh.Attributes[eVertexAttribute_Normals],
                     submesh.AttributeStrides[eVertexAttribute_Normals], accessor); break;
 
-                case cgltf_attribute_type_texcoord: StaticMesh_FillAttributeBytesFromAccessor<Math::Vector2, cgltf_component_type_r_32f>(
+                // Only the first set of texture coordinates is used
+                case cgltf_attribute_type_texcoord: if (attribute.index == 0) result = StaticMesh_FillAttributeBytesFromAccessor<Math::Vector2>(
                     submesh.Attributes[eVertexAttribute_TextureCoords],
                     submesh.AttributeStrides[eVertexAttribute_TextureCoords], accessor); break;
 
-                case cgltf_attribute_type_tangent: StaticMesh_FillAttributesFromAccessor<Math::Vector4, cgltf_component_type_r_32f>(gltfTangents, accessor); break;
+                case cgltf_attribute_type_tangent: result = StaticMesh_FillAttributesFromAccessor<Math::Vector4>(gltfTangents, accessor); break;
                 default: break; // just skip
                 }
+
+                if (!result)
+                {
+                    WARP_LOG_ERROR("GltfMeshLoader -> Failed to read attribute \'{}\'", attribute.name ? attribute.name : "Unknown");
+                    return false;
+                }
             }
 
             uint32_t numVertices = submesh.NumVertices;
-            uint32_t numIndices = static_cast<uint32_t>(submesh.Indices.size());
+            uint32_t numIndices = static_cast<uint32_t>(submesh.GetNumIndices());
 
             // Sanity checks
             WARP_ASSERT(numVertices > 0 && numIndices > 0);
@@ -363,41 +795,22 @@ namespace Warp
                 {
                     Math::Vector2* meshUvs = reinterpret_cast<Math::Vector2*>(submesh.Attributes[eVertexAttribute_TextureCoords].data());
 
-                    uint32_t numPrimitives = numIndices / 3;
-                    for (uint32_t i = 0; i < numPrimitives; ++i)
-                    {
-                        uint32_t i0 = submesh.Indices[i * 3 + 0];
-                        uint32_t i1 = submesh.Indices[i * 3 + 1];
-                        uint32_t i2 = submesh.Indices[i * 3 + 2];
-
-                        const Math::Vector3& pos0 = meshPositions[i0];
-                        const Math::Vector3& pos1 = meshPositions[i1];
-                        const Math::Vector3& pos2 = meshPositions[i2];
-                        Math::Vector3 deltaPos1 = pos1 - pos0;
-                        Math::Vector3 deltaPos2 = pos2 - pos0;
-
-                        const Math::Vector2& uv0 = meshUvs[i0];
-                        const Math::Vector2& uv1 = meshUvs[i1];
-                        const Math::Vector2& uv2 = meshUvs[i2];
-                        Math::Vector2 deltaUv1 = uv1 - uv0;
-                        Math::Vector2 deltaUv2 = uv2 - uv0;
-
-                        float r = 1.0f / (deltaUv1.x * deltaUv2.y - deltaUv1.y * deltaUv2.x);
-                        Math::Vector3 tangent = (deltaPos1 * deltaUv2.y - deltaPos2 * deltaUv1.y) * r;
-                        Math::Vector3 bitangent = (deltaPos2 * deltaUv1.x - deltaPos1 * deltaUv2.x) * r;
-
-                        meshTangents[i0] += tangent;
-                        meshTangents[i1] += tangent;
-                        meshTangents[i2] += tangent;
-                        meshBitangents[i0] += bitangent;
-                        meshBitangents[i1] += bitangent;
-                        meshBitangents[i2] += bitangent;
-                    }
-
-                    for (uint32_t i = 0; i < numVertices; ++i)
+                    // Vectorized kernel is selected at runtime, high-poly meshes spend most of the attribute processing time here
+                    // Indices have not been validated yet (see StaticMesh_OptimizeSubmesh()), the kernels check them on their own
+                    bool areIndicesValid = std::visit([&](const auto& indices)
+                        {
+                            return Math::ComputeTangentFrames(
+                                std::span<const Math::Vector3>(meshPositions, numVertices),
+                                std::span<const Math::Vector2>(meshUvs, numVertices),
+                                std::span(indices),
+                                std::span<Math::Vector3>(meshTangents, numVertices),
+                                std::span<Math::Vector3>(meshBitangents, numVertices));
+                        }, submesh.Indices);
+
+                    if (!areIndicesValid)
                     {
-                        meshTangents[i].Normalize();
-                        meshBitangents[i].Normalize();
+                        WARP_LOG_ERROR("GltfMeshLoader -> Primitive has indices out of range of its {} vertices", numVertices);
+                        return false;
                     }
                 }
             }
@@ -416,9 +829,38 @@ namespace Warp
                     meshNormals, sizeof(Math::Vector3),
                     numVertices, localToModel);
             }
+
+            return true;
+        }
+
+        void StaticMesh_CollectMesh(StaticMesh& mesh, const std::shared_ptr<GltfFile>& file, cgltf_mesh* glTFMsh, const Math::Matrix& localToModel, TextureImporter* importer)
+        {
+            // TODO: What if two different nodes? Will take the name of the latest one?
+            // TODO: 05.03.24 -> I used "Unknown" as a placeholder if we dont have a name. Handle this in a better way please
+            mesh.Name = glTFMsh->name ? glTFMsh->name : "Unknown";
+            for (size_t primitiveIndex = 0; primitiveIndex < glTFMsh->primitives_count; ++primitiveIndex)
+            {
+                StaticMesh::Submesh& submesh = mesh.Submeshes.emplace_back();
+                AssetHandle& submeshMaterial = mesh.SubmeshMaterials.emplace_back(); // We always emplace back a material, even if none
+                submesh.Properties = StaticMesh::eSubmeshProperty_None;
+
+                cgltf_primitive& primitive = glTFMsh->primitives[primitiveIndex];
+                cgltf_primitive_type type = primitive.type;
+                cgltf_material* glTFMaterial = primitive.material;
+                if (glTFMaterial)
+                {
+                    submesh.Properties |= StaticMesh::eSubmeshProperty_HasMaterial;
+                    submeshMaterial = AssetHandle(importer ? importer->GetAssetManager() : nullptr, StaticMesh_ImportSubmeshMaterial(file, glTFMaterial, importer));
+                }
+
+                // We only use triangles for now. Will be removed in FAR future. This is just in case
+                WARP_ASSERT(type == cgltf_primitive_type_triangles);
+                submesh.SourcePrimitive = &primitive;
+                submesh.LocalToModel = localToModel;
+            }
         }
 
-        void StaticMesh_ProcessNode(StaticMesh& mesh, const std::filesystem::path& folder, const StaticMeshImportDesc& desc, cgltf_node* node, TextureImporter* importer)
+        void StaticMesh_ProcessNode(StaticMesh& mesh, const std::shared_ptr<GltfFile>& file, const StaticMeshImportDesc& desc, cgltf_node* node, TextureImporter* importer)
         {
             Math::Matrix LocalToModel = GetLocalToModel(node);
 
@@ -430,28 +872,7 @@ namespace Warp
                     WARP_LOG_INFO("GltfMeshLoader -> Processing glTF mesh node \'{}\'", node->name);
                 }
 
-                // TODO: What if two different nodes? Will take the name of the latest one?
-                // TODO: 05.03.24 -> I used "Unknown" as a placeholder if we dont have a name. Handle this in a better way please
-                mesh.Name = glTFMsh->name ? glTFMsh->name : "Unknown";
-                for (size_t primitiveIndex = 0; primitiveIndex < glTFMsh->primitives_count; ++primitiveIndex)
-                {
-                    StaticMesh::Submesh& submesh = mesh.Submeshes.emplace_back();
-                    AssetProxy& submeshMaterial = mesh.SubmeshMaterials.emplace_back(); // We always emplace back a material, even if none
-                    submesh.Properties = StaticMesh::eSubmeshProperty_None;
-
-                    cgltf_primitive& primitive = glTFMsh->primitives[primitiveIndex];
-                    cgltf_primitive_type type = primitive.type;
-                    cgltf_material* glTFMaterial = primitive.material;
-                    if (glTFMaterial)
-                    {
-                        submesh.Properties |= StaticMesh::eSubmeshProperty_HasMaterial;
-                        submeshMaterial = StaticMesh_ImportSubmeshMaterial(folder, glTFMaterial, importer);
-                    }
-
-                    // We only use triangles for now. Will be removed in FAR future. This is just in case
-                    WARP_ASSERT(type == cgltf_primitive_type_triangles);
-                    StaticMesh_ProcessAttributes(submesh, LocalToModel, desc, &primitive);
-                }
+                StaticMesh_CollectMesh(mesh, file, glTFMsh, LocalToModel, importer);
             }
             else
             {
@@ -464,30 +885,29 @@ namespace Warp
             // Process all its children
             for (size_t i = 0; i < node->children_count; ++i)
             {
-                StaticMesh_ProcessNode(mesh, folder, desc, node->children[i], importer);
+                StaticMesh_ProcessNode(mesh, file, desc, node->children[i], importer);
             }
         }
 
-        void StaticMesh_ImportFromFile(const std::string& filepath, StaticMesh& mesh, const StaticMeshImportDesc& importDesc, TextureImporter* importer)
+        void CollectSceneNodes(cgltf_node* node, uint32_t parentIndex, std::vector<SceneNode>& nodes)
         {
-            cgltf_data* data = nullptr;
-            cgltf_options options = {};
-            cgltf_result result = cgltf_parse_file(&options, filepath.data(), &data);
-            if (result != cgltf_result_success)
+            uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(SceneNode{ .Node = node, .ParentIndex = parentIndex });
+
+            for (size_t i = 0; i < node->children_count; ++i)
             {
-                WARP_LOG_ERROR("Failed to parse GLTF model at {}", filepath);
-                return;
+                CollectSceneNodes(node->children[i], nodeIndex, nodes);
             }
+        }
 
-            // Load bin buffers as well
-            result = cgltf_load_buffers(&options, data, filepath.data());
-            if (result != cgltf_result_success)
+        std::shared_ptr<GltfFile> StaticMesh_ImportFromFile(std::shared_ptr<GltfFile> file, StaticMesh& mesh, const StaticMeshImportDesc& importDesc, TextureImporter* importer)
+        {
+            if (!LoadGltfBuffers(*file))
             {
-                WARP_LOG_ERROR("Failed to parse buffers for GLTF model at {}", filepath);
-                return;
+                return nullptr;
             }
 
-            std::filesystem::path folder = std::filesystem::path(filepath).parent_path();
+            cgltf_data* data = file->Data;
             for (size_t i = 0; i < data->scenes_count; ++i)
             {
                 cgltf_scene& scene = data->scenes[i];
@@ -502,77 +922,31 @@ namespace Warp
                     cgltf_node* node = scene.nodes[nodeIndex];
 
                     // Process mesh
-                    GltfImporter::StaticMesh_ProcessNode(mesh, folder, importDesc, node, importer);
+                    GltfImporter::StaticMesh_ProcessNode(mesh, file, importDesc, node, importer);
                 }
             }
 
-            cgltf_free(data);
-        }
-    }
-
-    AssetProxy MeshImporter::ImportStaticMeshFromGltfFile(const std::string& filepath)
-    {
-        AssetManager* manager = GetAssetManager();
-        AssetProxy proxy = manager->GetAssetProxy(filepath);
-        if (proxy.IsValid())
-        {
-            WARP_ASSERT(proxy.Type == EAssetType::Mesh);
-            WARP_LOG_INFO("MeshImporter::ImportStaticMeshFromGltfFile -> Returning cached asset at \'{}\'", filepath);
-            return proxy;
-        }
-
-        proxy = manager->CreateAsset<MeshAsset>(filepath);
-        if (!proxy.IsValid())
-        {
-            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to create mesh asset for static glTF mesh at \'{}\'", filepath);
-            return proxy;
+            return file;
         }
 
-        MeshAsset* mesh = manager->GetAs<MeshAsset>(proxy);
-
-        // TODO: StaticMeshImportDesc is hardcoded and predefined now -> maybe change it? 
-        GltfImporter::StaticMesh importedMesh;
-        GltfImporter::StaticMeshImportDesc desc = GltfImporter::StaticMeshImportDesc{ .GenerateTangents = true };
-        GltfImporter::StaticMesh_ImportFromFile(filepath, importedMesh, desc, &m_textureImporter);
-
-        if (!importedMesh.IsValid())
+        bool StaticMesh_OptimizeSubmesh(StaticMesh::Submesh& submesh, const StaticMeshImportDesc& desc, std::string_view meshName, size_t submeshIndex)
         {
-            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to import static mesh at \'{}\'", filepath);
-            return proxy;
+            return std::visit([&](auto& indices) { return StaticMesh_OptimizeSubmeshWithIndices(submesh, indices, desc, meshName, submeshIndex); }, submesh.Indices);
         }
 
-        // Convertion GltfImporter::StaticMesh -> MeshAsset
-        size_t numSubmeshes = importedMesh.Submeshes.size();
-        mesh->Name = importedMesh.Name;
-        mesh->Submeshes.reserve(numSubmeshes);
-        mesh->SubmeshMaterials.reserve(numSubmeshes);
-
-        // https://github.com/microsoft/DirectXMesh/wiki/DirectXMesh
-        // TODO: Add mesh optimization
-
-        // Process every submesh of imported mesh
-        for (size_t submeshIndex = 0; submeshIndex < numSubmeshes; ++submeshIndex)
+        template<typename IndexType>
+        bool StaticMesh_OptimizeSubmeshWithIndices(StaticMesh::Submesh& submesh, std::vector<IndexType>& indexBuffer, const StaticMeshImportDesc& desc, std::string_view meshName, size_t submeshIndex)
         {
-            GltfImporter::StaticMesh::Submesh& srcSubmesh = importedMesh.Submeshes[submeshIndex];
-
-            Submesh submesh;
-            submesh.NumVertices = srcSubmesh.NumVertices;
-            for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
-            {
-                submesh.Attributes[attributeIndex] = std::move(srcSubmesh.Attributes[attributeIndex]);
-                submesh.AttributeStrides[attributeIndex] = srcSubmesh.AttributeStrides[attributeIndex];
-            }
-
-            AssetProxy materialProxy = std::move(importedMesh.SubmeshMaterials[submeshIndex]);
-
             // Mesh optimization and meshlet generation
-            uint32_t numIndices = static_cast<uint32_t>(srcSubmesh.Indices.size());
-            uint32_t numVertices = submesh.GetNumVertices();
+            // Every DirectXMesh function below has an overload for both 16-bit and 32-bit indices
+            uint32_t numIndices = static_cast<uint32_t>(indexBuffer.size());
+            uint32_t numVertices = submesh.NumVertices;
             uint32_t numFaces = numIndices / 3;
-            uint32_t* indices = srcSubmesh.Indices.data();
+            IndexType* indices = indexBuffer.data();
             Math::Vector3* meshPositions = reinterpret_cast<Math::Vector3*>(submesh.Attributes[eVertexAttribute_Positions].data());
 
             bool isMeshValid = true;
+            submesh.MeshletSize = desc.MeshletSize;
 
             // Show warnings on mesh validation
 #if 1
@@ -605,9 +979,15 @@ namespace Warp
             }
 #endif
 
-            WARP_ASSERT(submesh.HasAttributes(eVertexAttribute_Positions));
+            WARP_ASSERT(!submesh.Attributes[eVertexAttribute_Positions].empty());
             WARP_ASSERT(numIndices > 0);
 
+            // Indices are only known to be in range once the submesh is validated
+            if (isMeshValid && desc.ReportStatistics)
+            {
+                submesh.Stats.SourceVertexCache = AnalyzeVertexCache(std::span<const IndexType>(indexBuffer), numVertices);
+            }
+
             std::vector<uint32_t> adjacency(numIndices);
 
             if (isMeshValid)
@@ -667,42 +1047,985 @@ namespace Warp
 
             if (isMeshValid)
             {
-                hr = DirectX::ComputeMeshlets(
-                    indices, numIndices / 3,
-                    meshPositions, submesh.GetNumVertices(),
-                    adjacency.data(),
-                    submesh.Meshlets, submesh.UniqueVertexIndices, submesh.PrimitiveIndices);
-
-                if (FAILED(hr))
-                {
-                    isMeshValid = false;
-                    WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to compute meshlets for a static mesh \'{}\', submeshIndex {}", mesh->Name, submeshIndex);
-                }
+                // ComputeMeshlets() writes unique vertex indices of the same width as the input indices
+                submesh.UniqueVertexIndexStride = sizeof(IndexType);
+                isMeshValid = StaticMesh_BuildLodMeshlets(submesh, std::span<const IndexType>(indexBuffer), adjacency.data(), submesh.Lods.emplace_back(), meshName, submeshIndex);
             }
 
-            if (!isMeshValid)
+            if (isMeshValid && desc.ReportStatistics)
             {
-                // TODO: 05.03.24 -> We CANNOT delete asset proxies as they are SHARED! Meaning that if we delete 1 material proxy ALL others will become invalid!
-                // This should not be the case and asset proxies should become ref-counted. Added to roadmap today
-                // https://trello.com/c/wz9KmvlS/26-make-asset-proxies-ref-counted
-                /*if (materialProxy.IsValid())
-                {
-                    WARP_LOG_INFO("Failed to validate a mesh -> Destroying material asset");
-                    materialProxy = GetAssetManager()->DestroyAsset(materialProxy);
-                }*/
+                const StaticMesh::Submesh::Lod& lod = submesh.Lods.front();
+                submesh.Stats.OptimizedVertexCache = AnalyzeVertexCache(std::span<const IndexType>(indexBuffer), numVertices);
+                submesh.Stats.Meshlets = AnalyzeMeshlets(lod.Meshlets, lod.UniqueVertexIndices, submesh.UniqueVertexIndexStride,
+                    numVertices, submesh.AttributeStrides[eVertexAttribute_Positions], submesh.MeshletSize);
+            }
 
-                continue;
+            if (isMeshValid)
+            {
+                // Bounds come from float positions, before quantization
+                DirectX::BoundingSphere::CreateFromPoints(submesh.BoundingSphere, numVertices, meshPositions, sizeof(Math::Vector3));
+                StaticMesh_GenerateLods(submesh, std::span<const IndexType>(indexBuffer), desc, meshName, submeshIndex);
             }
 
-            mesh->Submeshes.emplace_back(submesh);
-            mesh->SubmeshMaterials.emplace_back(materialProxy);
+            // Indices are no longer needed as meshlets reference vertices directly. Release them as soon as possible as other workers are still running
+            std::vector<IndexType>().swap(indexBuffer);
+            return isMeshValid;
         }
 
-        // Shrink capacity to size, do not waste extra memory for no reason (This is static mesh)
-        mesh->Submeshes.shrink_to_fit();
-        mesh->SubmeshMaterials.shrink_to_fit();
+        template<typename IndexType>
+        bool StaticMesh_BuildLodMeshlets(const StaticMesh::Submesh& submesh, std::span<const IndexType> indices, const uint32_t* adjacency,
+            StaticMesh::Submesh::Lod& lod, std::string_view meshName, size_t submeshIndex)
+        {
+            const Math::Vector3* meshPositions = reinterpret_cast<const Math::Vector3*>(submesh.Attributes[eVertexAttribute_Positions].data());
+            uint32_t numVertices = submesh.NumVertices;
+            uint32_t meshletMaxElements = GetMeshletMaxElements(submesh.MeshletSize);
+
+            HRESULT hr = DirectX::ComputeMeshlets(
+                indices.data(), indices.size() / 3,
+                meshPositions, numVertices,
+                adjacency,
+                lod.Meshlets, lod.UniqueVertexIndices, lod.PrimitiveIndices,
+                meshletMaxElements, meshletMaxElements);
 
-        return proxy;
+            if (FAILED(hr))
+            {
+                WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to compute meshlets for a static mesh \'{}\', submeshIndex {}", meshName, submeshIndex);
+                return false;
+            }
+
+            // glTF front faces are counter-clockwise, which is what DirectXMesh expects by default
+            lod.MeshletCullData.resize(lod.Meshlets.size());
+            hr = DirectX::ComputeCullData(
+                meshPositions, numVertices,
+                lod.Meshlets.data(), lod.Meshlets.size(),
+                reinterpret_cast<const IndexType*>(lod.UniqueVertexIndices.data()), lod.UniqueVertexIndices.size() / sizeof(IndexType),
+                lod.PrimitiveIndices.data(), lod.PrimitiveIndices.size(),
+                lod.MeshletCullData.data());
+
+            if (FAILED(hr))
+            {
+                WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to compute meshlet cull data for a static mesh \'{}\', submeshIndex {}", meshName, submeshIndex);
+                return false;
+            }
+
+            lod.NumTriangles = static_cast<uint32_t>(indices.size() / 3);
+            return true;
+        }
+
+        template<typename IndexType>
+        void StaticMesh_GenerateLods(StaticMesh::Submesh& submesh, std::span<const IndexType> indices, const StaticMeshImportDesc& desc, std::string_view meshName, size_t submeshIndex)
+        {
+            std::span<const Math::Vector3> positions = std::span<const Math::Vector3>(
+                reinterpret_cast<const Math::Vector3*>(submesh.Attributes[eVertexAttribute_Positions].data()), submesh.NumVertices);
+            float maxError = desc.LodMaxRelativeError * submesh.BoundingSphere.Radius;
+
+            std::vector<IndexType> previousIndices(indices.begin(), indices.end());
+            std::vector<IndexType> lodIndices;
+            std::vector<uint32_t> adjacency;
+            std::vector<uint32_t> faceRemap;
+            while (submesh.Lods.size() < desc.MaxNumLods)
+            {
+                // Every level is simplified from the previous one, thus errors of levels add up
+                float previousError = submesh.Lods.back().Error;
+                size_t previousNumIndices = previousIndices.size();
+                size_t targetNumIndices = static_cast<size_t>(previousNumIndices / 3 * desc.LodTriangleRatio) * 3;
+                Math::MeshSimplifyResult result = Math::SimplifyMesh(positions, std::span<const IndexType>(previousIndices), targetNumIndices, maxError - previousError, lodIndices);
+
+                // Levels that did not get at least half of the requested reduction cost memory for little gain. This happens once
+                // the error bound is reached or once the remaining vertices are locked (seams, borders)
+                if (lodIndices.empty() || lodIndices.size() > (previousNumIndices + targetNumIndices) / 2)
+                {
+                    break;
+                }
+
+                // Simplification leaves triangles in place, reorder them for the vertex cache same as the full detail level
+                size_t numFaces = lodIndices.size() / 3;
+                adjacency.resize(lodIndices.size());
+                faceRemap.resize(numFaces);
+                HRESULT hr = DirectX::GenerateAdjacencyAndPointReps(lodIndices.data(), numFaces, positions.data(), positions.size(), 0.0f, nullptr, adjacency.data());
+                if (SUCCEEDED(hr))
+                {
+                    hr = DirectX::OptimizeFaces(lodIndices.data(), numFaces, adjacency.data(), faceRemap.data());
+                }
+                if (SUCCEEDED(hr))
+                {
+                    hr = DirectX::ReorderIBAndAdjacency(lodIndices.data(), numFaces, adjacency.data(), faceRemap.data());
+                }
+                if (FAILED(hr))
+                {
+                    WARP_LOG_WARN("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to optimize LOD {} of \'{}\', submeshIndex {}", submesh.Lods.size(), meshName, submeshIndex);
+                    break;
+                }
+
+                StaticMesh::Submesh::Lod lod;
+                if (!StaticMesh_BuildLodMeshlets(submesh, std::span<const IndexType>(lodIndices), adjacency.data(), lod, meshName, submeshIndex))
+                {
+                    break;
+                }
+
+                lod.Error = previousError + result.Error;
+                submesh.Lods.push_back(std::move(lod));
+                std::swap(previousIndices, lodIndices);
+            }
+
+            if (!desc.ReportStatistics)
+            {
+                return;
+            }
+
+            // Single line per submesh, e.g. "LOD0 1000 | LOD1 500 (50.0%, error 0.0012) | ..."
+            const StaticMesh::Submesh::Lod& fullDetailLod = submesh.Lods.front();
+            std::string report = std::format("LOD0 {}", fullDetailLod.NumTriangles);
+            for (size_t lodIndex = 1; lodIndex < submesh.Lods.size(); ++lodIndex)
+            {
+                const StaticMesh::Submesh::Lod& lod = submesh.Lods[lodIndex];
+                report += std::format(" | LOD{} {} ({:.1f}%, error {:.4g})", lodIndex, lod.NumTriangles, 100.0f * lod.NumTriangles / fullDetailLod.NumTriangles, lod.Error);
+            }
+            WARP_LOG_INFO("MeshImporter::ImportStaticMeshFromGltfFile -> \'{}\' submesh {} triangles: {}", meshName, submeshIndex, report);
+        }
+
+        void StaticMesh_QuantizeSubmesh(StaticMesh::Submesh& submesh, bool measureError)
+        {
+            auto getStream = [&submesh]<typename T>(EVertexAttribute attribute) -> std::span<const T>
+                {
+                    const std::vector<std::byte>& attributes = submesh.Attributes[attribute];
+                    WARP_ASSERT(attributes.empty() || submesh.AttributeStrides[attribute] == sizeof(T));
+                    return std::span<const T>(reinterpret_cast<const T*>(attributes.data()), attributes.size() / sizeof(T));
+                };
+
+            std::span<const Math::Vector3> positions = getStream.template operator()<Math::Vector3>(eVertexAttribute_Positions);
+            std::span<const Math::Vector3> normals = getStream.template operator()<Math::Vector3>(eVertexAttribute_Normals);
+            std::span<const Math::Vector2> texCoords = getStream.template operator()<Math::Vector2>(eVertexAttribute_TextureCoords);
+            std::span<const Math::Vector3> tangents = getStream.template operator()<Math::Vector3>(eVertexAttribute_Tangents);
+            std::span<const Math::Vector3> bitangents = getStream.template operator()<Math::Vector3>(eVertexAttribute_Bitangents);
+
+            StaticMesh::Submesh::AttributeArray<std::vector<std::byte>> encoded;
+            submesh.Bounds = ComputePositionBounds(positions);
+            EncodePositionsUnorm16(positions, submesh.Bounds, encoded[eVertexAttribute_Positions]);
+            if (!normals.empty())
+            {
+                EncodeUnitVectorsOct16(normals, encoded[eVertexAttribute_Normals]);
+            }
+
+            if (!texCoords.empty())
+            {
+                EncodeTexCoordsHalf(texCoords, encoded[eVertexAttribute_TextureCoords]);
+            }
+
+            if (!tangents.empty())
+            {
+                EncodeUnitVectorsOct16(tangents, encoded[eVertexAttribute_Tangents]);
+            }
+
+            // Bitangents are reconstructed from normals and tangents, only their handedness is stored
+            if (!bitangents.empty() && !normals.empty() && !tangents.empty())
+            {
+                EncodeBitangentSigns(normals, tangents, bitangents, encoded[eVertexAttribute_Bitangents]);
+            }
+
+            // Both streams are viewed as submeshes of a mesh asset, which is what decoders work with. Vertices are in the same order in both
+            if (measureError)
+            {
+                auto makeView = [&submesh](const StaticMesh::Submesh::AttributeArray<std::vector<std::byte>>& streams, bool isQuantized)
+                    {
+                        Submesh view;
+                        view.NumVertices = submesh.NumVertices;
+                        for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+                        {
+                            EVertexAttribute attribute = static_cast<EVertexAttribute>(attributeIndex);
+                            view.Attributes[attribute] = streams[attribute];
+                            view.AttributeEncodings[attribute] = isQuantized ? GetQuantizedEncoding(attribute) : eVertexEncoding_Float;
+                            view.AttributeStrides[attribute] = isQuantized ? GetVertexStride(attribute, view.AttributeEncodings[attribute]) : submesh.AttributeStrides[attribute];
+                        }
+
+                        if (isQuantized)
+                        {
+                            view.PositionsMin = submesh.Bounds.Min;
+                            view.PositionsExtent = submesh.Bounds.Extent;
+                        }
+                        return view;
+                    };
+
+                submesh.Stats.Quantization = MeasureQuantizationError(makeView(submesh.Attributes, false), makeView(encoded, true));
+            }
+
+            for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+            {
+                EVertexAttribute attribute = static_cast<EVertexAttribute>(attributeIndex);
+                EVertexEncoding encoding = GetQuantizedEncoding(attribute);
+                submesh.Attributes[attribute] = std::move(encoded[attribute]);
+                submesh.AttributeStrides[attribute] = submesh.Attributes[attribute].empty() ? 0 : GetVertexStride(attribute, encoding);
+                submesh.AttributeEncodings[attribute] = encoding;
+            }
+
+            // Bounding spheres were computed from float positions, decoded positions may move by up to half of the quantization step
+            float maxPositionError = submesh.Bounds.GetMaxError();
+            for (StaticMesh::Submesh::Lod& lod : submesh.Lods)
+            {
+                for (DirectX::CullData& cullData : lod.MeshletCullData)
+                {
+                    cullData.BoundingSphere.Radius += maxPositionError;
+                }
+            }
+        }
+
+        void StaticMesh_ReportStatistics(const StaticMesh& mesh, std::span<const uint8_t> validSubmeshes, bool isQuantized)
+        {
+            // e.g. "ACMR 1.42 -> 0.71, ATVR 2.31 -> 1.15 | 12 meshlets, fill 94.1% verts 98.4% prims, duplication 1.18, overfetch 1.43"
+            // Quantized meshes append their largest errors, e.g. " | quantization error position 0.0001, normal 0.003 deg, uv 0.0002, ..."
+            auto formatStatistics = [isQuantized](const StaticMesh::Submesh::Statistics& stats) -> std::string
+                {
+                    std::string report = std::format("ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f} | {} meshlets, fill {:.1f}% verts {:.1f}% prims, duplication {:.3f}, overfetch {:.3f}",
+                        stats.SourceVertexCache.GetAcmr(), stats.OptimizedVertexCache.GetAcmr(),
+                        stats.SourceVertexCache.GetAtvr(), stats.OptimizedVertexCache.GetAtvr(),
+                        stats.Meshlets.NumMeshlets, 100.0f * stats.Meshlets.GetVertexFill(), 100.0f * stats.Meshlets.GetPrimitiveFill(),
+                        stats.Meshlets.GetVertexDuplication(), stats.Meshlets.GetOverfetch());
+
+                    if (isQuantized)
+                    {
+                        const VertexQuantizationError& error = stats.Quantization;
+                        report += std::format(" | quantization error position {:.4g}, normal {:.3g} deg, uv {:.4g}, tangent {:.3g} deg, bitangent {:.3g} deg",
+                            error.MaxPositionError, error.MaxNormalError, error.MaxTexCoordError, error.MaxTangentError, error.MaxBitangentError);
+                    }
+                    return report;
+                };
+
+            StaticMesh::Submesh::Statistics total;
+            uint32_t numReportedSubmeshes = 0;
+            for (size_t submeshIndex = 0; submeshIndex < mesh.Submeshes.size(); ++submeshIndex)
+            {
+                if (!validSubmeshes[submeshIndex])
+                {
+                    continue;
+                }
+
+                const StaticMesh::Submesh& submesh = mesh.Submeshes[submeshIndex];
+                WARP_LOG_INFO("MeshImporter::ImportStaticMeshFromGltfFile -> \'{}\' submesh {} ({}-element meshlets): {}",
+                    mesh.Name, submeshIndex, GetMeshletMaxElements(submesh.MeshletSize), formatStatistics(submesh.Stats));
+
+                total.SourceVertexCache += submesh.Stats.SourceVertexCache;
+                total.OptimizedVertexCache += submesh.Stats.OptimizedVertexCache;
+                total.Meshlets += submesh.Stats.Meshlets;
+                total.Quantization.Merge(submesh.Stats.Quantization);
+                ++numReportedSubmeshes;
+            }
+
+            WARP_LOG_INFO("MeshImporter::ImportStaticMeshFromGltfFile -> \'{}\' total of {} submeshes: {}", mesh.Name, numReportedSubmeshes, formatStatistics(total));
+        }
+
+        bool StaticMesh_ProcessSubmesh(StaticMesh& importedMesh, size_t submeshIndex, const StaticMeshImportDesc& importDesc)
+        {
+            StaticMesh::Submesh& submesh = importedMesh.Submeshes[submeshIndex];
+            bool isRead = StaticMesh_ProcessAttributes(submesh, submesh.LocalToModel, importDesc, submesh.SourcePrimitive);
+            submesh.SourcePrimitive = nullptr;
+            if (!isRead)
+            {
+                WARP_LOG_WARN("GltfMeshLoader -> Skipping submesh {} of \'{}\'", submeshIndex, importedMesh.Name);
+                return false;
+            }
+
+            if (!StaticMesh_OptimizeSubmesh(submesh, importDesc, importedMesh.Name, submeshIndex))
+            {
+                return false;
+            }
+
+            if (importDesc.QuantizeVertices)
+            {
+                StaticMesh_QuantizeSubmesh(submesh, importDesc.ReportStatistics);
+            }
+            return true;
+        }
+
+        bool StaticMesh_FinishMesh(StaticMesh& importedMesh, std::span<const uint8_t> validSubmeshes, PayloadWriter& payloadWriter, bool isSpilled,
+            const StaticMeshImportDesc& importDesc, MeshAsset& mesh)
+        {
+            size_t numSubmeshes = importedMesh.Submeshes.size();
+            if (importDesc.ReportStatistics)
+            {
+                StaticMesh_ReportStatistics(importedMesh, validSubmeshes, importDesc.QuantizeVertices);
+            }
+
+            // In-memory streams are copied into an exactly sized allocation one submesh at a time, releasing each one right after
+            if (!isSpilled)
+            {
+                size_t payloadSize = 0;
+                for (size_t submeshIndex = 0; submeshIndex < numSubmeshes; ++submeshIndex)
+                {
+                    payloadSize += validSubmeshes[submeshIndex] ? StaticMesh_GetPayloadSize(importedMesh.Submeshes[submeshIndex]) : 0;
+                }
+
+                payloadWriter.Reserve(payloadSize);
+                for (size_t submeshIndex = 0; submeshIndex < numSubmeshes; ++submeshIndex)
+                {
+                    if (validSubmeshes[submeshIndex])
+                    {
+                        StaticMesh_WriteSubmeshPayload(importedMesh.Submeshes[submeshIndex], payloadWriter);
+                    }
+                }
+            }
+
+            if (!payloadWriter.Finalize(mesh.Payload))
+            {
+                WARP_LOG_ERROR("StaticMesh_Process -> Failed to read back spilled submeshes of \'{}\'", mesh.Name);
+                return false;
+            }
+
+            StaticMesh_BuildMeshAsset(importedMesh, validSubmeshes, mesh);
+            return true;
+        }
+
+        void StaticMesh_Process(std::span<StaticMesh> importedMeshes, std::shared_ptr<GltfFile> file, const StaticMeshImportDesc& importDesc,
+            std::span<MeshAsset* const> meshes, std::span<uint8_t> isProcessed)
+        {
+            WARP_ASSERT(importedMeshes.size() == meshes.size() && meshes.size() == isProcessed.size());
+            size_t numMeshes = importedMeshes.size();
+
+            // https://github.com/microsoft/DirectXMesh/wiki/DirectXMesh
+            // Submeshes are independent from each other, so reading, optimization and meshlet generation is done as a task per submesh
+            // Every task only touches its own submesh, which keeps the order of MeshAsset::Submeshes the same as in the source file
+            // Tasks of every mesh go into a single list, thus files with many small meshes keep every worker busy as well
+            struct SubmeshTask
+            {
+                uint32_t MeshIndex;
+                uint32_t SubmeshIndex;
+            };
+
+            std::vector<SubmeshTask> tasks;
+            std::vector<std::vector<uint8_t>> validSubmeshes(numMeshes); // Not std::vector<bool> as workers write to neighbouring elements concurrently
+            for (size_t meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+            {
+                size_t numSubmeshes = importedMeshes[meshIndex].Submeshes.size();
+                meshes[meshIndex]->Name = importedMeshes[meshIndex].Name;
+                validSubmeshes[meshIndex].resize(numSubmeshes, false);
+                isProcessed[meshIndex] = false;
+                for (size_t submeshIndex = 0; submeshIndex < numSubmeshes; ++submeshIndex)
+                {
+                    tasks.push_back(SubmeshTask{ .MeshIndex = static_cast<uint32_t>(meshIndex), .SubmeshIndex = static_cast<uint32_t>(submeshIndex) });
+                }
+            }
+
+            // Geometry is read inside of the task, so that unprocessed streams only exist for submeshes that are being processed
+            // Quantization is the last step, everything before it works with float streams
+            auto processTask = [&](size_t taskIndex)
+                {
+                    const SubmeshTask& task = tasks[taskIndex];
+                    validSubmeshes[task.MeshIndex][task.SubmeshIndex] = StaticMesh_ProcessSubmesh(importedMeshes[task.MeshIndex], task.SubmeshIndex, importDesc);
+                };
+
+            uint32_t numThreads = importDesc.NumWorkerThreads == 0 ? ThreadPool::GetDefaultNumThreads() : importDesc.NumWorkerThreads;
+            numThreads = std::min(numThreads, static_cast<uint32_t>(tasks.size()));
+            std::unique_ptr<ThreadPool> threadPool = numThreads > 1 ? std::make_unique<ThreadPool>(numThreads) : nullptr;
+
+            // Low memory imports process a batch of submeshes per worker at a time and spill them right away, into a file per mesh
+            // Otherwise every submesh is processed at once, which balances the load between workers better
+            std::vector<PayloadWriter> payloadWriters(numMeshes);
+            std::vector<uint8_t> isSpilled(numMeshes, false);
+
+            // Meshes are finished in order as soon as their last submesh is processed, which also closes their spill files
+            size_t numFinishedMeshes = 0;
+            auto finishMeshes = [&](size_t numMeshesToFinish)
+                {
+                    for (; numFinishedMeshes < numMeshesToFinish; ++numFinishedMeshes)
+                    {
+                        size_t meshIndex = numFinishedMeshes;
+                        isProcessed[meshIndex] = StaticMesh_FinishMesh(importedMeshes[meshIndex], validSubmeshes[meshIndex], payloadWriters[meshIndex],
+                            isSpilled[meshIndex], importDesc, *meshes[meshIndex]);
+                    }
+                };
+
+            size_t batchSize = importDesc.LowMemoryImport ? std::max<size_t>(numThreads, 1) : tasks.size();
+            for (size_t batchBegin = 0; batchBegin < tasks.size(); batchBegin += batchSize)
+            {
+                size_t batchEnd = std::min(batchBegin + batchSize, tasks.size());
+                for (size_t taskIndex = batchBegin; taskIndex < batchEnd && importDesc.LowMemoryImport; ++taskIndex)
+                {
+                    uint32_t meshIndex = tasks[taskIndex].MeshIndex;
+                    if (tasks[taskIndex].SubmeshIndex == 0)
+                    {
+                        isSpilled[meshIndex] = payloadWriters[meshIndex].OpenSpillFile();
+                        if (!isSpilled[meshIndex])
+                        {
+                            WARP_LOG_WARN("StaticMesh_Process -> Failed to create a spill file, \'{}\' is imported in memory", importedMeshes[meshIndex].Name);
+                        }
+                    }
+                }
+
+                if (!threadPool)
+                {
+                    for (size_t taskIndex = batchBegin; taskIndex < batchEnd; ++taskIndex)
+                    {
+                        processTask(taskIndex);
+                    }
+                }
+                else
+                {
+                    threadPool->ParallelFor(static_cast<uint32_t>(batchEnd - batchBegin), [&](uint32_t i)
+                        {
+                            processTask(batchBegin + i);
+                        });
+                }
+
+                // Every accessor has been read. cgltf data and buffer mappings are released, unless embedded textures are still decoded from them
+                if (batchEnd == tasks.size())
+                {
+                    file.reset();
+                }
+
+                for (size_t taskIndex = batchBegin; taskIndex < batchEnd; ++taskIndex)
+                {
+                    const SubmeshTask& task = tasks[taskIndex];
+                    if (isSpilled[task.MeshIndex] && validSubmeshes[task.MeshIndex][task.SubmeshIndex])
+                    {
+                        StaticMesh_WriteSubmeshPayload(importedMeshes[task.MeshIndex].Submeshes[task.SubmeshIndex], payloadWriters[task.MeshIndex]);
+                    }
+                }
+
+                finishMeshes(batchEnd == tasks.size() ? numMeshes : tasks[batchEnd].MeshIndex);
+            }
+
+            // The loop above does not run if none of the meshes has a submesh
+            file.reset();
+            finishMeshes(numMeshes);
+        }
+
+        bool StaticMesh_Process(StaticMesh& importedMesh, std::shared_ptr<GltfFile> file, const StaticMeshImportDesc& importDesc, MeshAsset& mesh)
+        {
+            MeshAsset* meshes[] = { &mesh };
+            uint8_t isProcessed = false;
+            StaticMesh_Process(std::span<StaticMesh>(&importedMesh, 1), std::move(file), importDesc, meshes, std::span<uint8_t>(&isProcessed, 1));
+            return isProcessed;
+        }
+
+        size_t StaticMesh_GetPayloadSize(const StaticMesh::Submesh& submesh)
+        {
+            size_t payloadSize = 0;
+            for (const std::vector<std::byte>& attributes : submesh.Attributes)
+            {
+                payloadSize += MeshPayload::AlignUp(attributes.size());
+            }
+
+            for (const StaticMesh::Submesh::Lod& lod : submesh.Lods)
+            {
+                payloadSize += MeshPayload::AlignUp(lod.Meshlets.size() * sizeof(DirectX::Meshlet));
+                payloadSize += MeshPayload::AlignUp(lod.UniqueVertexIndices.size() * sizeof(uint8_t));
+                payloadSize += MeshPayload::AlignUp(lod.PrimitiveIndices.size() * sizeof(DirectX::MeshletTriangle));
+                payloadSize += MeshPayload::AlignUp(lod.MeshletCullData.size() * sizeof(DirectX::CullData));
+            }
+            return payloadSize;
+        }
+
+        void StaticMesh_WriteSubmeshPayload(StaticMesh::Submesh& submesh, PayloadWriter& writer)
+        {
+            for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+            {
+                submesh.AttributeRanges[attributeIndex] = writer.Append(submesh.Attributes[attributeIndex]);
+                std::vector<std::byte>().swap(submesh.Attributes[attributeIndex]);
+            }
+
+            for (StaticMesh::Submesh::Lod& lod : submesh.Lods)
+            {
+                lod.MeshletRange = writer.Append(lod.Meshlets);
+                lod.UniqueVertexIndexRange = writer.Append(lod.UniqueVertexIndices);
+                lod.PrimitiveIndexRange = writer.Append(lod.PrimitiveIndices);
+                lod.MeshletCullDataRange = writer.Append(lod.MeshletCullData);
+                std::vector<DirectX::Meshlet>().swap(lod.Meshlets);
+                std::vector<uint8_t>().swap(lod.UniqueVertexIndices);
+                std::vector<DirectX::MeshletTriangle>().swap(lod.PrimitiveIndices);
+                std::vector<DirectX::CullData>().swap(lod.MeshletCullData);
+            }
+        }
+
+        void StaticMesh_BuildMeshAsset(StaticMesh& importedMesh, std::span<const uint8_t> validSubmeshes, MeshAsset& mesh)
+        {
+            size_t numSubmeshes = importedMesh.Submeshes.size();
+            WARP_ASSERT(validSubmeshes.size() == numSubmeshes);
+
+            std::span<const std::byte> payloadBytes = mesh.Payload.GetBytes();
+            auto getView = [payloadBytes]<typename T>(const StaticMesh::StreamRange& range) -> std::span<const T>
+            {
+                if (range.NumElements == 0)
+                {
+                    return std::span<const T>();
+                }
+
+                WARP_ASSERT(range.Offset + range.NumElements * sizeof(T) <= payloadBytes.size());
+                return std::span<const T>(reinterpret_cast<const T*>(payloadBytes.data() + range.Offset), range.NumElements);
+            };
+
+            mesh.Submeshes.reserve(numSubmeshes);
+            mesh.SubmeshMaterials.reserve(numSubmeshes);
+            for (size_t submeshIndex = 0; submeshIndex < numSubmeshes; ++submeshIndex)
+            {
+                if (!validSubmeshes[submeshIndex])
+                {
+                    // Material of the submesh is released along with the imported mesh, as nothing else refers to it
+                    continue;
+                }
+
+                const StaticMesh::Submesh& srcSubmesh = importedMesh.Submeshes[submeshIndex];
+                Submesh& submesh = mesh.Submeshes.emplace_back();
+                submesh.NumVertices = srcSubmesh.NumVertices;
+                for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+                {
+                    submesh.Attributes[attributeIndex] = getView.template operator()<std::byte>(srcSubmesh.AttributeRanges[attributeIndex]);
+                    submesh.AttributeStrides[attributeIndex] = srcSubmesh.AttributeStrides[attributeIndex];
+                    submesh.AttributeEncodings[attributeIndex] = srcSubmesh.AttributeEncodings[attributeIndex];
+                }
+
+                submesh.PositionsMin = srcSubmesh.Bounds.Min;
+                submesh.PositionsExtent = srcSubmesh.Bounds.Extent;
+
+                submesh.UniqueVertexIndexStride = srcSubmesh.UniqueVertexIndexStride;
+                submesh.MeshletSize = srcSubmesh.MeshletSize;
+                submesh.BoundingSphere = srcSubmesh.BoundingSphere;
+                submesh.Lods.resize(srcSubmesh.Lods.size());
+                for (size_t lodIndex = 0; lodIndex < srcSubmesh.Lods.size(); ++lodIndex)
+                {
+                    const StaticMesh::Submesh::Lod& srcLod = srcSubmesh.Lods[lodIndex];
+                    SubmeshLod& lod = submesh.Lods[lodIndex];
+                    lod.Meshlets = getView.template operator()<DirectX::Meshlet>(srcLod.MeshletRange);
+                    lod.UniqueVertexIndices = getView.template operator()<uint8_t>(srcLod.UniqueVertexIndexRange);
+                    lod.PrimitiveIndices = getView.template operator()<DirectX::MeshletTriangle>(srcLod.PrimitiveIndexRange);
+                    lod.MeshletCullData = getView.template operator()<DirectX::CullData>(srcLod.MeshletCullDataRange);
+                    lod.NumTriangles = srcLod.NumTriangles;
+                    lod.Error = srcLod.Error;
+                }
+
+                mesh.SubmeshMaterials.emplace_back(std::move(importedMesh.SubmeshMaterials[submeshIndex]));
+            }
+
+            // Shrink capacity to size, do not waste extra memory for no reason (This is static mesh)
+            mesh.Submeshes.shrink_to_fit();
+            mesh.SubmeshMaterials.shrink_to_fit();
+        }
+    }
+
+    AssetProxy MeshImporter::ImportStaticMeshFromGltfFile(std::shared_ptr<GltfImporter::GltfFile> file, const StaticMeshImportDesc& importDesc)
+    {
+        const std::string filepath = file->Filepath;
+        AssetManager* manager = GetAssetManager();
+        AssetProxy proxy = manager->GetAssetProxy(filepath);
+        if (proxy.IsValid())
+        {
+            WARP_ASSERT(proxy.Type == EAssetType::Mesh);
+            WARP_LOG_INFO("MeshImporter::ImportStaticMeshFromGltfFile -> Returning cached asset at \'{}\'", filepath);
+            return proxy;
+        }
+
+        proxy = manager->CreateAsset<MeshAsset>(filepath);
+        if (!proxy.IsValid())
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to create mesh asset for static glTF mesh at \'{}\'", filepath);
+            return proxy;
+        }
+
+        MeshAsset* mesh = manager->GetAs<MeshAsset>(proxy);
+
+        GltfImporter::StaticMesh importedMesh;
+        file = GltfImporter::StaticMesh_ImportFromFile(std::move(file), importedMesh, importDesc, &m_textureImporter);
+
+        if (!file || !importedMesh.IsValid())
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to import static mesh at \'{}\'", filepath);
+            return proxy;
+        }
+
+        if (!GltfImporter::StaticMesh_Process(importedMesh, std::move(file), importDesc, *mesh))
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFile -> Failed to process static mesh at \'{}\'", filepath);
+        }
+        return proxy;
+    }
+
+    std::vector<StaticMeshInstance> MeshImporter::ImportStaticMeshInstancesFromFile(const std::string& filepath, const StaticMeshImportDesc& importDesc)
+    {
+        StaticMeshScene scene = ImportStaticMeshSceneFromFile(filepath, importDesc);
+
+        // Parents come before children, thus their transforms are already resolved
+        std::vector<Math::Matrix> nodeToScene(scene.Nodes.size());
+        std::vector<StaticMeshInstance> instances;
+        for (size_t nodeIndex = 0; nodeIndex < scene.Nodes.size(); ++nodeIndex)
+        {
+            StaticMeshSceneNode& node = scene.Nodes[nodeIndex];
+            nodeToScene[nodeIndex] = node.ParentIndex == StaticMeshSceneNode::InvalidIndex ? node.LocalToParent : node.LocalToParent * nodeToScene[node.ParentIndex];
+            if (node.Mesh.IsValid())
+            {
+                instances.push_back(StaticMeshInstance{ .Name = std::move(node.Name), .Mesh = node.Mesh, .InstanceToScene = nodeToScene[nodeIndex] });
+            }
+        }
+
+        return instances;
+    }
+
+    StaticMeshScene MeshImporter::ImportStaticMeshSceneFromFile(const std::string& filepath, const StaticMeshImportDesc& importDesc)
+    {
+        EAssetFormat format = GetFormat(std::filesystem::path(filepath).extension().string());
+        if (format != EAssetFormat::Gltf && format != EAssetFormat::Glb)
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshSceneFromFile -> Only glTF files have scenes, \'{}\' is not one", filepath);
+            return {};
+        }
+
+        // Buffers are loaded only once a mesh misses the derived data cache
+        std::shared_ptr<GltfImporter::GltfFile> file = GltfImporter::ParseGltfFile(filepath);
+        if (!file)
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshSceneFromFile -> Failed to open \'{}\'", filepath);
+            return {};
+        }
+
+        // Every mesh of the file shares the key of the file and adds its index to it
+        Hasher128 baseKey;
+        DerivedDataCache* derivedDataCache = GetDerivedDataCache();
+        bool useCache = derivedDataCache && derivedDataCache->IsEnabled();
+        if (useCache && !MakeGltfDerivedDataHasher(*file, importDesc, baseKey))
+        {
+            WARP_LOG_WARN("MeshImporter::ImportStaticMeshSceneFromFile -> Failed to hash sources of '{}', bypassing derived data cache", filepath);
+            useCache = false;
+        }
+
+        cgltf_data* data = file->Data;
+        std::vector<GltfImporter::SceneNode> sceneNodes;
+        sceneNodes.reserve(data->nodes_count);
+        for (size_t sceneIndex = 0; sceneIndex < data->scenes_count; ++sceneIndex)
+        {
+            const cgltf_scene& gltfScene = data->scenes[sceneIndex];
+            for (size_t nodeIndex = 0; nodeIndex < gltfScene.nodes_count; ++nodeIndex)
+            {
+                GltfImporter::CollectSceneNodes(gltfScene.nodes[nodeIndex], StaticMeshSceneNode::InvalidIndex, sceneNodes);
+            }
+        }
+
+        // Nodes are walked first, so that every mesh they reference is known before any of them is processed
+        static constexpr size_t InvalidIndex = std::numeric_limits<size_t>::max();
+        std::vector<size_t> nodeMeshIndices(sceneNodes.size(), InvalidIndex);
+        std::vector<size_t> meshSlots(data->meshes_count, InvalidIndex); // Mesh indices to uniqueMeshIndices
+        std::vector<size_t> uniqueMeshIndices;
+
+        StaticMeshScene scene;
+        scene.Nodes.resize(sceneNodes.size());
+        for (size_t nodeIndex = 0; nodeIndex < sceneNodes.size(); ++nodeIndex)
+        {
+            cgltf_node* gltfNode = sceneNodes[nodeIndex].Node;
+            StaticMeshSceneNode& node = scene.Nodes[nodeIndex];
+            node.ParentIndex = sceneNodes[nodeIndex].ParentIndex;
+            node.LocalToParent = GltfImporter::GetLocalToModel(gltfNode);
+            if (gltfNode->name)
+            {
+                node.Name = gltfNode->name;
+            }
+
+            if (!gltfNode->mesh)
+            {
+                continue;
+            }
+
+            size_t meshIndex = cgltf_mesh_index(data, gltfNode->mesh);
+            if (meshSlots[meshIndex] == InvalidIndex)
+            {
+                meshSlots[meshIndex] = uniqueMeshIndices.size();
+                uniqueMeshIndices.push_back(meshIndex);
+            }
+            nodeMeshIndices[nodeIndex] = meshIndex;
+        }
+
+        // Every mesh is imported once, no matter how many nodes reference it. This was the last use of the file
+        size_t numMeshes = data->meshes_count;
+        std::vector<AssetProxy> meshes = ImportStaticMeshesFromGltfFile(std::move(file), uniqueMeshIndices, importDesc, useCache ? &baseKey : nullptr);
+
+        size_t numInstances = 0;
+        for (size_t nodeIndex = 0; nodeIndex < scene.Nodes.size(); ++nodeIndex)
+        {
+            if (nodeMeshIndices[nodeIndex] == InvalidIndex)
+            {
+                continue;
+            }
+
+            StaticMeshSceneNode& node = scene.Nodes[nodeIndex];
+            node.Mesh = meshes[meshSlots[nodeMeshIndices[nodeIndex]]];
+            if (node.Mesh.IsValid())
+            {
+                ++numInstances;
+                if (node.Name.empty())
+                {
+                    node.Name = GetAssetManager()->GetAs<MeshAsset>(node.Mesh)->Name;
+                }
+            }
+        }
+
+        WARP_LOG_INFO("MeshImporter::ImportStaticMeshSceneFromFile -> \'{}\' has {} nodes with {} instances of {} meshes", filepath, scene.Nodes.size(), numInstances, numMeshes);
+        return scene;
+    }
+
+    std::string MeshImporter::MakeGltfMeshPath(std::string_view filepath, size_t meshIndex)
+    {
+        return std::format("{}#mesh{}", filepath, meshIndex);
+    }
+
+    std::vector<AssetProxy> MeshImporter::ImportStaticMeshesFromGltfFile(std::shared_ptr<GltfImporter::GltfFile> file, std::span<const size_t> meshIndices,
+        const StaticMeshImportDesc& importDesc, const Hasher128* baseKey)
+    {
+        AssetManager* manager = GetAssetManager();
+        DerivedDataCache* derivedDataCache = GetDerivedDataCache();
+
+        // Meshes that are neither imported yet nor cooked are collected first and then processed together
+        struct PendingMesh
+        {
+            size_t Slot; // Index into meshIndices
+            std::string AssetPath;
+            std::filesystem::path CookedFilepath;
+            double CollectMilliseconds;
+        };
+
+        // Cooked meshes reference textures relative to the source, the file itself is released before they are cooked
+        const std::filesystem::path sourceFolder = file->Folder;
+
+        std::vector<AssetProxy> proxies(meshIndices.size());
+        std::vector<PendingMesh> pendingMeshes;
+        std::vector<GltfImporter::StaticMesh> importedMeshes;
+        std::vector<MeshAsset*> meshes;
+        importedMeshes.reserve(meshIndices.size());
+        for (size_t slot = 0; slot < meshIndices.size(); ++slot)
+        {
+            size_t meshIndex = meshIndices[slot];
+            std::string assetPath = MakeGltfMeshPath(file->Filepath, meshIndex);
+            AssetProxy proxy = manager->GetAssetProxy(assetPath);
+            if (proxy.IsValid())
+            {
+                WARP_ASSERT(proxy.Type == EAssetType::Mesh);
+                proxies[slot] = proxy;
+                continue;
+            }
+
+            Timer timer;
+            std::filesystem::path cookedFilepath;
+            if (baseKey)
+            {
+                Hasher128 hasher = *baseKey;
+                hasher.UpdateValue(static_cast<uint64_t>(meshIndex));
+                cookedFilepath = derivedDataCache->GetFilepath(eDerivedDataType_Mesh, hasher.Finalize(), ".wmesh");
+
+                std::error_code ec;
+                if (std::filesystem::exists(cookedFilepath, ec))
+                {
+                    proxy = ImportStaticMeshFromWMeshFile(cookedFilepath.string(), assetPath);
+                    if (proxy.IsValid())
+                    {
+                        derivedDataCache->RecordHit(eDerivedDataType_Mesh, timer.GetElapsedMilliseconds());
+                        UploadStaticMesh(manager->GetAs<MeshAsset>(proxy));
+                        proxies[slot] = proxy;
+                        continue;
+                    }
+
+                    WARP_LOG_WARN("MeshImporter::ImportStaticMeshesFromGltfFile -> Failed to load cached '{}', importing from source", cookedFilepath.string());
+                }
+            }
+
+            if (!GltfImporter::LoadGltfBuffers(*file))
+            {
+                WARP_LOG_ERROR("MeshImporter::ImportStaticMeshesFromGltfFile -> Failed to load buffers of '{}' for mesh {}", file->Filepath, meshIndex);
+                continue;
+            }
+
+            // Vertices stay in the space of the mesh, nodes place it with their instance transforms
+            GltfImporter::StaticMesh importedMesh;
+            GltfImporter::StaticMesh_CollectMesh(importedMesh, file, &file->Data->meshes[meshIndex], Math::Matrix::Identity, &m_textureImporter);
+            if (!importedMesh.IsValid())
+            {
+                WARP_LOG_ERROR("MeshImporter::ImportStaticMeshesFromGltfFile -> Mesh {} of '{}' has no primitives", meshIndex, file->Filepath);
+                continue;
+            }
+
+            proxy = manager->CreateAsset<MeshAsset>(assetPath);
+            if (!proxy.IsValid())
+            {
+                WARP_LOG_ERROR("MeshImporter::ImportStaticMeshesFromGltfFile -> Failed to create mesh asset for '{}'", assetPath);
+                continue;
+            }
+
+            proxies[slot] = proxy;
+            importedMeshes.push_back(std::move(importedMesh));
+            meshes.push_back(manager->GetAs<MeshAsset>(proxy));
+            pendingMeshes.push_back(PendingMesh{
+                .Slot = slot,
+                .AssetPath = std::move(assetPath),
+                .CookedFilepath = std::move(cookedFilepath),
+                .CollectMilliseconds = timer.GetElapsedMilliseconds(),
+                });
+        }
+
+        // Submeshes of every pending mesh share the workers, the file is released once the last of them is read
+        Timer processTimer;
+        std::vector<uint8_t> isProcessed(pendingMeshes.size(), false);
+        GltfImporter::StaticMesh_Process(importedMeshes, std::move(file), importDesc, meshes, isProcessed);
+        double processMillisecondsPerMesh = pendingMeshes.empty() ? 0.0 : processTimer.GetElapsedMilliseconds() / pendingMeshes.size();
+
+        for (size_t pendingIndex = 0; pendingIndex < pendingMeshes.size(); ++pendingIndex)
+        {
+            const PendingMesh& pending = pendingMeshes[pendingIndex];
+            if (!isProcessed[pendingIndex])
+            {
+                WARP_LOG_ERROR("MeshImporter::ImportStaticMeshesFromGltfFile -> Failed to process '{}'", pending.AssetPath);
+                continue;
+            }
+
+            if (baseKey)
+            {
+                Timer cookTimer;
+                CookStaticMesh(proxies[pending.Slot], pending.CookedFilepath.string(), sourceFolder);
+                derivedDataCache->RecordMiss(eDerivedDataType_Mesh, pending.CollectMilliseconds + processMillisecondsPerMesh + cookTimer.GetElapsedMilliseconds());
+            }
+
+            UploadStaticMesh(meshes[pendingIndex]);
+        }
+
+        return proxies;
+    }
+
+    AssetProxy MeshImporter::ImportGltfEmbeddedTexture(const std::string& imagePath, ETextureUsage usage)
+    {
+        AssetProxy proxy = GetAssetManager()->GetAssetProxy(imagePath);
+        if (proxy.IsValid())
+        {
+            WARP_ASSERT(proxy.Type == EAssetType::Texture);
+            return proxy;
+        }
+
+        std::string containerPath;
+        size_t imageIndex = 0;
+        if (!TextureImporter::ParseEmbeddedImagePath(imagePath, containerPath, imageIndex))
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportGltfEmbeddedTexture -> \'{}\' is not a path of an embedded image", imagePath);
+            return AssetProxy();
+        }
+
+        // Textures of a cooked mesh come one after another, do not parse the same container for each of them
+        std::shared_ptr<GltfImporter::GltfFile> file = m_lastGltfFile.lock();
+        if (!file || file->Filepath != containerPath)
+        {
+            file = GltfImporter::OpenGltfFile(containerPath);
+            if (!file)
+            {
+                return AssetProxy();
+            }
+            m_lastGltfFile = file;
+        }
+
+        if (imageIndex >= file->Data->images_count)
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportGltfEmbeddedTexture -> \'{}\' has no image {}", containerPath, imageIndex);
+            return AssetProxy();
+        }
+
+        return GltfImporter::StaticMesh_ImportEmbeddedImage(file, imageIndex, usage, &m_textureImporter);
+    }
+
+    AssetProxy MeshImporter::ImportStaticMeshFromGltfFileCached(const std::string& filepath, const StaticMeshImportDesc& importDesc)
+    {
+        // Do not parse a mesh that was already imported during this run
+        AssetProxy proxy = GetAssetManager()->GetAssetProxy(filepath);
+        if (proxy.IsValid())
+        {
+            WARP_ASSERT(proxy.Type == EAssetType::Mesh);
+            return proxy;
+        }
+
+        Timer timer;
+
+        // Only JSON is parsed here, buffers are loaded on a miss
+        std::shared_ptr<GltfImporter::GltfFile> file = GltfImporter::ParseGltfFile(filepath);
+        if (!file)
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromGltfFileCached -> Failed to open '{}'", filepath);
+            return AssetProxy();
+        }
+
+        DerivedDataCache* derivedDataCache = GetDerivedDataCache();
+        if (!derivedDataCache || !derivedDataCache->IsEnabled())
+        {
+            return ImportStaticMeshFromGltfFile(std::move(file), importDesc);
+        }
+
+        Hasher128 hasher;
+        if (!MakeGltfDerivedDataHasher(*file, importDesc, hasher))
+        {
+            WARP_LOG_WARN("MeshImporter::ImportStaticMeshFromGltfFileCached -> Failed to hash sources of '{}', bypassing derived data cache", filepath);
+            return ImportStaticMeshFromGltfFile(std::move(file), importDesc);
+        }
+
+        std::filesystem::path cookedFilepath = derivedDataCache->GetFilepath(eDerivedDataType_Mesh, hasher.Finalize(), ".wmesh");
+
+        std::error_code ec;
+        if (std::filesystem::exists(cookedFilepath, ec))
+        {
+            proxy = ImportStaticMeshFromWMeshFile(cookedFilepath.string(), filepath);
+            if (proxy.IsValid())
+            {
+                derivedDataCache->RecordHit(eDerivedDataType_Mesh, timer.GetElapsedMilliseconds());
+                return proxy;
+            }
+
+            // Corrupted or outdated entry. It is overwritten below
+            WARP_LOG_WARN("MeshImporter::ImportStaticMeshFromGltfFileCached -> Failed to load cached '{}', importing from source", cookedFilepath.string());
+        }
+
+        proxy = ImportStaticMeshFromGltfFile(std::move(file), importDesc);
+        if (proxy.IsValid())
+        {
+            CookStaticMesh(proxy, cookedFilepath.string(), std::filesystem::path(filepath).parent_path());
+            derivedDataCache->RecordMiss(eDerivedDataType_Mesh, timer.GetElapsedMilliseconds());
+        }
+
+        return proxy;
+    }
+
+    bool MeshImporter::MakeGltfDerivedDataHasher(const GltfImporter::GltfFile& file, const StaticMeshImportDesc& importDesc, Hasher128& hasher)
+    {
+        // The location of the source is not a part of the key, thus copies of the source share entries. Cooked meshes reference textures
+        // relative to the source, see CookStaticMesh()
+        // Tangents, quantization, LOD and meshlet settings affect cooked data, number of threads and statistics do not
+        hasher.UpdateValue(MeshImporter::DerivedDataVersion);
+        hasher.UpdateValue(WMesh::Version);
+        hasher.UpdateValue(static_cast<uint32_t>(importDesc.GenerateTangents));
+        hasher.UpdateValue(static_cast<uint32_t>(importDesc.QuantizeVertices));
+        hasher.UpdateValue(importDesc.MaxNumLods);
+        hasher.UpdateValue(std::bit_cast<uint32_t>(importDesc.LodTriangleRatio));
+        hasher.UpdateValue(std::bit_cast<uint32_t>(importDesc.LodMaxRelativeError));
+        hasher.UpdateValue(static_cast<uint32_t>(importDesc.MeshletSize));
+        return HashGltfSourceFiles(file, hasher);
+    }
+
+    bool MeshImporter::HashGltfSourceFiles(const GltfImporter::GltfFile& file, Hasher128& hasher)
+    {
+        // JSON is small and already mapped, thus it is hashed as is. Length prefix keeps the key unambiguous
+        const cgltf_data* data = file.Data;
+        hasher.UpdateValue(static_cast<uint64_t>(data->json_size));
+        hasher.Update(data->json, data->json_size);
+
+        // Binary chunk of .glb files lies in the file itself
+        if (data->bin && !DerivedDataCache::HashFileStamp(hasher, file.Filepath))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < data->buffers_count; ++i)
+        {
+            // Data URIs are stored inside of the JSON, which is already hashed
+            const char* uri = data->buffers[i].uri;
+            if (!uri || std::strncmp(uri, "data:", 5) == 0)
+            {
+                continue;
+            }
+
+            std::string decodedUri = uri;
+            decodedUri.resize(cgltf_decode_uri(decodedUri.data()));
+            if (!DerivedDataCache::HashFileStamp(hasher, file.Folder / decodedUri))
+            {
+                return false;
+            }
+        }
+
+        return true;
     }
 
 }
\ No newline at end of file
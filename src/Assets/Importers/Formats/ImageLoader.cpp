@@ -1,14 +1,37 @@
 #include "ImageLoader.h"
+#include "MipGenerator.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <vector>
 
 #include "../../../Util/String.h"
 #include "../../../Util/Logger.h"
+#include "../../../Util/ThreadPool.h"
 #include "../../../Core/Assert.h"
 
 namespace Warp::ImageLoader
 {
 
+    static Image MakeImage(DirectX::ScratchImage&& image, std::string_view name, bool generateMips)
+    {
+        Image result = Image{
+            .Filepath = std::string(name),
+            .DxImage = std::move(image)
+        };
+
+        // Loaders know nothing about the content, importers that do generate mips themselves (see GenerateMips())
+        if (generateMips && !GenerateMips(result, MipGenerationDesc(), nullptr))
+        {
+            return Image();
+        }
+
+        return result;
+    }
+
     Image LoadWICFromFile(std::string_view filepath, bool generateMips)
     {
         using namespace DirectX;
@@ -22,29 +45,354 @@ namespace Warp::ImageLoader
             return Image();
         }
 
-        if (generateMips)
+        return MakeImage(std::move(image), filepath, generateMips);
+    }
+
+    size_t Image::GetPixelsSize() const
+    {
+        if (!IsMapped())
+        {
+            return DxImage.GetPixelsSize();
+        }
+
+        size_t size = 0;
+        for (const DirectX::Image& image : MappedImages)
+        {
+            size += image.slicePitch;
+        }
+        return size;
+    }
+
+    // Size of the magic number and DDS_HEADER, followed by DDS_HEADER_DXT10 if the pixel format is 'DX10'
+    static constexpr size_t DDSHeaderSize = sizeof(uint32_t) + 124;
+    static constexpr size_t DDSHeaderDXT10Size = 20;
+    static constexpr size_t DDSPixelFormatFourCCOffset = sizeof(uint32_t) + 80;
+    static constexpr uint32_t DDSFourCCDX10 = 0x30315844; // 'DX10'
+
+    // Lays out subresources the way they are stored in DDS files and ScratchImage: every array item (cube face) with all of its mips,
+    // every mip of a volume with all of its slices. Returns false if the file is too short, which means DirectXTex would expand the pixels
+    static bool MapDDSSubresources(const MappedFile& mapping, const DirectX::TexMetadata& metadata, std::vector<DirectX::Image>& images)
+    {
+        using namespace DirectX;
+
+        uint32_t fourCC = 0;
+        std::memcpy(&fourCC, mapping.GetData() + DDSPixelFormatFourCCOffset, sizeof(fourCC));
+        size_t offset = DDSHeaderSize + (fourCC == DDSFourCCDX10 ? DDSHeaderDXT10Size : 0);
+
+        images.clear();
+        for (size_t item = 0; item < metadata.arraySize; ++item)
         {
-            ScratchImage mipChain;
-            hr = GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), TEX_FILTER_DEFAULT, 0, mipChain);
-            if (FAILED(hr))
+            size_t width = metadata.width;
+            size_t height = metadata.height;
+            size_t depth = metadata.depth;
+            for (size_t mip = 0; mip < metadata.mipLevels; ++mip)
             {
-                WARP_LOG_ERROR("Failed to generate mip levels for {}", filepath);
-                return Image();
+                size_t rowPitch = 0;
+                size_t slicePitch = 0;
+                if (FAILED(ComputePitch(metadata.format, width, height, rowPitch, slicePitch, CP_FLAGS_NONE)))
+                {
+                    return false;
+                }
+
+                for (size_t slice = 0; slice < depth; ++slice)
+                {
+                    if (offset + slicePitch > mapping.GetSize())
+                    {
+                        return false;
+                    }
+
+                    // DirectXTex never writes through pixels of images that are only uploaded
+                    images.push_back(DirectX::Image{
+                        .width = width,
+                        .height = height,
+                        .format = metadata.format,
+                        .rowPitch = rowPitch,
+                        .slicePitch = slicePitch,
+                        .pixels = const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(mapping.GetData() + offset))
+                        });
+                    offset += slicePitch;
+                }
+
+                width = std::max<size_t>(width / 2, 1);
+                height = std::max<size_t>(height / 2, 1);
+                depth = std::max<size_t>(depth / 2, 1);
             }
+        }
 
-            image = std::move(mipChain);
+        return true;
+    }
+
+    Image LoadDDSFromFile(std::string_view filepath, bool generateMips)
+    {
+        using namespace DirectX;
+
+        MappedFile mapping;
+        if (!mapping.Open(std::filesystem::path(StringToWString(filepath))))
+        {
+            WARP_LOG_ERROR("Failed to map image file {}", filepath);
+            return Image();
         }
 
-        return Image{
-            .Filepath = std::string(filepath),
-            .DxImage = std::move(image)
+        // Only headers are parsed here
+        TexMetadata metadata;
+        HRESULT hr = GetMetadataFromDDSMemory(mapping.GetData(), mapping.GetSize(), DDS_FLAGS_NONE, metadata);
+        if (FAILED(hr) || mapping.GetSize() < DDSHeaderSize)
+        {
+            WARP_LOG_ERROR("Failed to load image from {}", filepath);
+            return Image();
+        }
+
+        // DDS files usually come with mips already
+        bool needsMips = generateMips && metadata.mipLevels == 1 && !IsCompressed(metadata.format);
+        std::vector<DirectX::Image> images;
+        if (needsMips || !MapDDSSubresources(mapping, metadata, images))
+        {
+            // Decoded from the mapping, the file is not read twice
+            return LoadDDSFromMemory(mapping.GetBytes(), filepath, generateMips);
+        }
+
+        Image image;
+        image.Filepath = std::string(filepath);
+        image.Mapping = std::move(mapping);
+        image.MappedMetadata = metadata;
+        image.MappedImages = std::move(images);
+        return image;
+    }
+
+    Image LoadWICFromMemory(std::span<const std::byte> bytes, std::string_view name, bool generateMips)
+    {
+        using namespace DirectX;
+
+        // WIC decodes from a stream over the memory, the encoded image is not copied
+        ScratchImage image;
+        HRESULT hr = LoadFromWICMemory(bytes.data(), bytes.size(), WIC_FLAGS_NONE, nullptr, image);
+        if (FAILED(hr))
+        {
+            WARP_LOG_ERROR("Failed to load image from memory of {}", name);
+            return Image();
+        }
+
+        return MakeImage(std::move(image), name, generateMips);
+    }
+
+    Image LoadDDSFromMemory(std::span<const std::byte> bytes, std::string_view name, bool generateMips)
+    {
+        using namespace DirectX;
+
+        ScratchImage image;
+        HRESULT hr = LoadFromDDSMemory(bytes.data(), bytes.size(), DDS_FLAGS_NONE, nullptr, image);
+        if (FAILED(hr))
+        {
+            WARP_LOG_ERROR("Failed to load image from memory of {}", name);
+            return Image();
+        }
+
+        return MakeImage(std::move(image), name, generateMips);
+    }
+
+    bool CopyMappedImage(Image& image)
+    {
+        using namespace DirectX;
+
+        if (!image.IsMapped())
+        {
+            return true;
+        }
+
+        ScratchImage copy;
+        if (FAILED(copy.Initialize(image.MappedMetadata)))
+        {
+            WARP_LOG_ERROR("Failed to allocate a copy of {}", image.Filepath);
+            return false;
+        }
+
+        // Both follow the same order of subresources, see MapDDSSubresources()
+        WARP_ASSERT(copy.GetImageCount() == image.MappedImages.size());
+        for (size_t i = 0; i < image.MappedImages.size(); ++i)
+        {
+            const DirectX::Image& src = image.MappedImages[i];
+            const DirectX::Image& dst = copy.GetImages()[i];
+            WARP_ASSERT(src.slicePitch == dst.slicePitch);
+            std::memcpy(dst.pixels, src.pixels, src.slicePitch);
+        }
+
+        image.DxImage = std::move(copy);
+        image.MappedImages.clear();
+        image.Mapping.Close();
+        return true;
+    }
+
+    bool SaveDDSToFile(const Image& image, std::string_view filepath)
+    {
+        using namespace DirectX;
+
+        WARP_ASSERT(image.IsValid());
+
+        // Write into a temporary file first and rename it afterwards, so that a crash never leaves a truncated .dds behind
+        std::filesystem::path tempFilepath = std::filesystem::path(StringToWString(filepath)).concat(L".tmp");
+        HRESULT hr = SaveToDDSFile(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DDS_FLAGS_NONE, tempFilepath.c_str());
+        if (FAILED(hr))
+        {
+            WARP_LOG_ERROR("Failed to save image to {}", filepath);
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempFilepath, std::filesystem::path(StringToWString(filepath)), ec);
+        if (ec)
+        {
+            WARP_LOG_ERROR("Failed to move saved image to {}: {}", filepath, ec.message());
+            std::filesystem::remove(tempFilepath, ec);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool CompressImage(Image& image, DXGI_FORMAT format, ThreadPool* threadPool)
+    {
+        using namespace DirectX;
+
+        WARP_ASSERT(image.IsValid() && !image.IsMapped() && IsCompressed(format));
+
+        const TexMetadata& metadata = image.DxImage.GetMetadata();
+        if (IsCompressed(metadata.format))
+        {
+            return true;
+        }
+
+        // D3D12 requires the top level of block-compressed textures to consist of whole blocks
+        static constexpr size_t BlockSize = 4;
+        if (metadata.width % BlockSize != 0 || metadata.height % BlockSize != 0)
+        {
+            WARP_LOG_WARN("Size of {} is not a multiple of {}, it stays uncompressed", image.Filepath, BlockSize);
+            return false;
+        }
+
+        TexMetadata compressedMetadata = metadata;
+        compressedMetadata.format = format;
+
+        ScratchImage compressed;
+        if (FAILED(compressed.Initialize(compressedMetadata)))
+        {
+            WARP_LOG_ERROR("Failed to allocate compressed image for {}", image.Filepath);
+            return false;
+        }
+
+        // Strips of 64 block rows. Small mips are a single strip each
+        static constexpr size_t StripHeight = 64 * BlockSize;
+        struct Strip
+        {
+            size_t ImageIndex;
+            size_t FirstRow;
+            size_t NumRows;
         };
+
+        std::vector<Strip> strips;
+        for (size_t imageIndex = 0; imageIndex < image.DxImage.GetImageCount(); ++imageIndex)
+        {
+            size_t height = image.DxImage.GetImages()[imageIndex].height;
+            for (size_t firstRow = 0; firstRow < height; firstRow += StripHeight)
+            {
+                strips.push_back(Strip{ .ImageIndex = imageIndex, .FirstRow = firstRow, .NumRows = std::min(StripHeight, height - firstRow) });
+            }
+        }
+
+        std::atomic<bool> isFailed = false;
+        auto compressStrip = [&](uint32_t stripIndex)
+            {
+                const Strip& strip = strips[stripIndex];
+                const DirectX::Image& src = image.DxImage.GetImages()[strip.ImageIndex];
+                const DirectX::Image& dst = compressed.GetImages()[strip.ImageIndex];
+
+                DirectX::Image srcStrip = src;
+                srcStrip.height = strip.NumRows;
+                srcStrip.slicePitch = src.rowPitch * strip.NumRows;
+                srcStrip.pixels = src.pixels + strip.FirstRow * src.rowPitch;
+
+                ScratchImage dstStrip;
+                if (FAILED(Compress(srcStrip, format, TEX_COMPRESS_DEFAULT, TEX_THRESHOLD_DEFAULT, dstStrip)))
+                {
+                    isFailed.store(true, std::memory_order_relaxed);
+                    return;
+                }
+
+                // Rows of compressed images are rows of blocks
+                const DirectX::Image* blocks = dstStrip.GetImages();
+                size_t firstBlockRow = strip.FirstRow / BlockSize;
+                size_t numBlockRows = (strip.NumRows + BlockSize - 1) / BlockSize;
+                WARP_ASSERT(blocks->rowPitch == dst.rowPitch);
+                std::memcpy(dst.pixels + firstBlockRow * dst.rowPitch, blocks->pixels, numBlockRows * dst.rowPitch);
+            };
+
+        if (threadPool)
+        {
+            threadPool->ParallelFor(static_cast<uint32_t>(strips.size()), compressStrip);
+        }
+        else
+        {
+            for (uint32_t stripIndex = 0; stripIndex < strips.size(); ++stripIndex)
+            {
+                compressStrip(stripIndex);
+            }
+        }
+
+        if (isFailed)
+        {
+            WARP_LOG_ERROR("Failed to compress {}", image.Filepath);
+            return false;
+        }
+
+        image.DxImage = std::move(compressed);
+        return true;
     }
 
-    Image LoadDDSFromFile(std::string_view filepath, bool generateMips)
+    bool SwizzleGreenBlueToRedGreen(const Image& image, Image& dest)
+    {
+        using namespace DirectX;
+
+        WARP_ASSERT(image.IsValid() && !image.IsMapped());
+
+        ScratchImage swizzled;
+        HRESULT hr = TransformImage(image.DxImage.GetImages(), image.DxImage.GetImageCount(), image.DxImage.GetMetadata(),
+            [](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t width, size_t)
+            {
+                for (size_t i = 0; i < width; ++i)
+                {
+                    outPixels[i] = XMVectorSwizzle<XM_SWIZZLE_Y, XM_SWIZZLE_Z, XM_SWIZZLE_W, XM_SWIZZLE_W>(inPixels[i]);
+                }
+            }, swizzled);
+        if (FAILED(hr))
+        {
+            WARP_LOG_ERROR("Failed to swizzle channels of {}", image.Filepath);
+            return false;
+        }
+
+        dest.Filepath = image.Filepath;
+        dest.DxImage = std::move(swizzled);
+        dest.Flags = image.Flags;
+        return true;
+    }
+
+    bool IsChannelZero(const Image& image, uint32_t channel)
     {
-        WARP_YIELD_NOIMPL();
-        return Image();
+        using namespace DirectX;
+
+        WARP_ASSERT(image.IsValid() && !image.IsMapped() && channel < 4);
+
+        // Half of an 8-bit step, so that quantization noise of encoded images still counts as zero
+        static constexpr float Epsilon = 0.5f / 255.0f;
+
+        bool isZero = true;
+        HRESULT hr = EvaluateImage(*image.DxImage.GetImage(0, 0, 0),
+            [&isZero, channel](const XMVECTOR* pixels, size_t width, size_t)
+            {
+                for (size_t i = 0; i < width && isZero; ++i)
+                {
+                    isZero = XMVectorGetByIndex(pixels[i], channel) <= Epsilon;
+                }
+            });
+        return SUCCEEDED(hr) && isZero;
     }
 
 }
\ No newline at end of file
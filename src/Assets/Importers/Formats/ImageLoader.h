@@ -1,10 +1,19 @@
 #pragma once
 
+#include <cstddef>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 #include <DirectXTex/DirectXTex.h>
 
 #include "../../../Core/Defines.h"
+#include "../../../Util/MappedFile.h"
+
+namespace Warp
+{
+    class ThreadPool;
+}
 
 namespace Warp::ImageLoader
 {
@@ -25,9 +34,17 @@ namespace Warp::ImageLoader
         eImageFlag_InternalStorage = 1,
     };
 
+    // Pixels either live in DxImage or, for DDS files loaded with LoadDDSFromFile(), straight in the mapped file
+    // Use GetMetadata() and GetImages() to read pixels regardless of where they live
     struct Image
     {
-        bool IsValid() const { return DxImage.GetImages() != nullptr; }
+        bool IsValid() const { return GetImages() != nullptr; }
+        bool IsMapped() const { return Mapping.IsValid(); }
+
+        const DirectX::TexMetadata& GetMetadata() const { return IsMapped() ? MappedMetadata : DxImage.GetMetadata(); }
+        const DirectX::Image* GetImages() const { return IsMapped() ? MappedImages.data() : DxImage.GetImages(); }
+        size_t GetImageCount() const { return IsMapped() ? MappedImages.size() : DxImage.GetImageCount(); }
+        size_t GetPixelsSize() const;
 
         // Filepath cannot be empty. It does not necessarily represent a valid filesystem's path though
         // If an image has eImageFlag_InternalStorage selected it will not represent a valid filesystem's path
@@ -40,9 +57,41 @@ namespace Warp::ImageLoader
 
         // Custom Image flags
         EImageFlags Flags = eImageFlag_None;
+
+        // Subresources of a mapped image point into Mapping, thus it must outlive them. Nothing is copied
+        MappedFile Mapping;
+        DirectX::TexMetadata MappedMetadata = {};
+        std::vector<DirectX::Image> MappedImages;
     };
 
     Image LoadWICFromFile(std::string_view filepath, bool generateMips);
+
+    // Maps the file and points subresources of the image straight into the mapping, so that they are uploaded without any copies
+    // Falls back to decoding into DxImage if the file needs processing: legacy formats that DirectXTex expands, or mips to generate
     Image LoadDDSFromFile(std::string_view filepath, bool generateMips);
 
+    // Decode images that are stored inside of other files (e.g. .glb) straight from memory, nothing is written to disk
+    // name is only used for the Filepath of the image and in logs
+    Image LoadWICFromMemory(std::span<const std::byte> bytes, std::string_view name, bool generateMips);
+    Image LoadDDSFromMemory(std::span<const std::byte> bytes, std::string_view name, bool generateMips);
+
+    // Copies pixels of a mapped image into DxImage and releases the mapping, so that the image can be processed. Does nothing for other images
+    bool CopyMappedImage(Image& image);
+
+    // Writes the image with all its subresources into a .dds file. Used to store processed images, so that they can be loaded back without any processing
+    bool SaveDDSToFile(const Image& image, std::string_view filepath);
+
+    // Processing functions below expect pixels in DxImage, see CopyMappedImage()
+
+    // Block-compresses every subresource into format (one of BC1-BC7). Subresources are split into strips of block rows,
+    // which are compressed across the workers of threadPool, so that a single large mip is spread over every core. threadPool may be nullptr
+    // Returns false if the image cannot be compressed (e.g. its size is not a multiple of the block size), the image is left untouched then
+    bool CompressImage(Image& image, DXGI_FORMAT format, ThreadPool* threadPool);
+
+    // Moves green and blue channels into red and green, which are the only channels BC5 stores. Writes the result into dest
+    bool SwizzleGreenBlueToRedGreen(const Image& image, Image& dest);
+
+    // Returns true if the channel (0 is red, 3 is alpha) is zero in every texel of the top mip
+    bool IsChannelZero(const Image& image, uint32_t channel);
+
 }
\ No newline at end of file
@@ -0,0 +1,472 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numbers>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+
+#include "../../../Util/Logger.h"
+#include "../../../Util/ThreadPool.h"
+#include "../../../Core/Assert.h"
+
+namespace Warp::ImageLoader
+{
+
+    // Mips smaller than this are filtered on the calling thread, splitting them costs more than it saves
+    static constexpr size_t MinParallelTexels = 256 * 256;
+    static constexpr uint32_t RowsPerTask = 32;
+
+    // Half-width of the Kaiser filter in destination texels and its shape parameter
+    static constexpr float KaiserWidth = 3.0f;
+    static constexpr float KaiserAlpha = 4.0f;
+
+    // Alpha scales tried while searching for the one that preserves coverage
+    static constexpr float MaxAlphaScale = 4.0f;
+    static constexpr uint32_t NumAlphaScaleSteps = 10;
+
+    // Taps of a separable 1D filter for every destination texel. Every texel has the same number of taps, indices are clamped to the edges
+    struct FilterTaps
+    {
+        uint32_t NumTaps = 0;
+        std::vector<uint32_t> Indices; // NumTaps per destination texel
+        std::vector<float> Weights;
+    };
+
+    static bool IsFilteredHere(DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Modified Bessel function of the first kind of order 0
+    static float BesselI0(float x)
+    {
+        float sum = 1.0f;
+        float term = 1.0f;
+        float halfX = x * 0.5f;
+        for (uint32_t k = 1; k < 32 && term > sum * 1e-7f; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    static float EvaluateKaiser(float x)
+    {
+        if (std::abs(x) >= KaiserWidth)
+        {
+            return 0.0f;
+        }
+
+        float sinc = x == 0.0f ? 1.0f : std::sin(std::numbers::pi_v<float> * x) / (std::numbers::pi_v<float> * x);
+        float t = x / KaiserWidth;
+        return sinc * BesselI0(KaiserAlpha * std::sqrt(1.0f - t * t)) / BesselI0(KaiserAlpha);
+    }
+
+    // Odd sizes do not halve evenly, e.g. 5 -> 2 is a 2.5 times reduction. Taps are placed by texel centers, thus such levels are not shifted
+    static FilterTaps MakeFilterTaps(EMipFilter filter, uint32_t srcSize, uint32_t dstSize)
+    {
+        FilterTaps taps;
+        if (srcSize == dstSize)
+        {
+            // Dimensions that already reached 1 texel are copied as they are
+            taps.NumTaps = 1;
+            taps.Weights.assign(dstSize, 1.0f);
+            taps.Indices.resize(dstSize);
+            for (uint32_t i = 0; i < dstSize; ++i)
+            {
+                taps.Indices[i] = i;
+            }
+            return taps;
+        }
+
+        // Radius is in source texels
+        float scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+        float radius = filter == eMipFilter_Box ? scale * 0.5f : KaiserWidth * scale;
+
+        taps.NumTaps = static_cast<uint32_t>(std::ceil(radius * 2.0f)) + 1;
+        taps.Indices.resize(static_cast<size_t>(taps.NumTaps) * dstSize);
+        taps.Weights.resize(static_cast<size_t>(taps.NumTaps) * dstSize);
+        for (uint32_t dst = 0; dst < dstSize; ++dst)
+        {
+            float center = (dst + 0.5f) * scale;
+            int32_t first = static_cast<int32_t>(std::floor(center - radius));
+
+            uint32_t* indices = &taps.Indices[static_cast<size_t>(dst) * taps.NumTaps];
+            float* weights = &taps.Weights[static_cast<size_t>(dst) * taps.NumTaps];
+            float sum = 0.0f;
+            for (uint32_t tap = 0; tap < taps.NumTaps; ++tap)
+            {
+                int32_t src = first + static_cast<int32_t>(tap);
+                float weight = 0.0f;
+                if (filter == eMipFilter_Box)
+                {
+                    // Fraction of the source texel covered by the destination texel
+                    weight = std::max(0.0f, std::min(src + 1.0f, center + radius) - std::max(static_cast<float>(src), center - radius));
+                }
+                else
+                {
+                    weight = EvaluateKaiser((src + 0.5f - center) / scale);
+                }
+
+                indices[tap] = static_cast<uint32_t>(std::clamp<int32_t>(src, 0, static_cast<int32_t>(srcSize) - 1));
+                weights[tap] = weight;
+                sum += weight;
+            }
+
+            for (uint32_t tap = 0; tap < taps.NumTaps; ++tap)
+            {
+                weights[tap] /= sum;
+            }
+        }
+
+        return taps;
+    }
+
+    // Invokes func(firstRow, lastRow) over ranges of rows, across the workers if the level is large enough
+    static void ForEachRowRange(uint32_t numRows, size_t numTexels, ThreadPool* threadPool, const std::function<void(uint32_t, uint32_t)>& func)
+    {
+        uint32_t numTasks = (numRows + RowsPerTask - 1) / RowsPerTask;
+        if (!threadPool || numTasks <= 1 || numTexels < MinParallelTexels)
+        {
+            func(0, numRows);
+            return;
+        }
+
+        threadPool->ParallelFor(numTasks, [&](uint32_t task)
+            {
+                uint32_t firstRow = task * RowsPerTask;
+                func(firstRow, std::min(firstRow + RowsPerTask, numRows));
+            });
+    }
+
+    static const std::array<float, 256>& GetSrgbToLinearTable()
+    {
+        static const std::array<float, 256> table = []
+            {
+                std::array<float, 256> values;
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    float srgb = i / 255.0f;
+                    values[i] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+                }
+                return values;
+            }();
+        return table;
+    }
+
+    // Texels are filtered as float4 in linear space. Both RGBA and BGRA keep alpha last, other channels are filtered the same way
+    struct MipLevel
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        std::vector<DirectX::XMVECTOR> Texels;
+    };
+
+    // Level that a mip is filtered from. The top level stays in 8 bits and is decoded row by row, lower ones are the previous mip in float
+    struct MipSource
+    {
+        const DirectX::Image* Encoded = nullptr;
+        const MipLevel* Decoded = nullptr;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+    };
+
+    static void DecodeRow(const DirectX::Image& src, const MipGenerationDesc& desc, bool isSrgb, uint32_t y, DirectX::XMVECTOR* texels)
+    {
+        using namespace DirectX;
+
+        const std::array<float, 256>& srgbToLinear = GetSrgbToLinearTable();
+
+        const uint8_t* row = src.pixels + y * src.rowPitch;
+        for (uint32_t x = 0; x < static_cast<uint32_t>(src.width); ++x)
+        {
+            const uint8_t* texel = row + x * 4;
+            XMVECTOR value = isSrgb ?
+                XMVectorSet(srgbToLinear[texel[0]], srgbToLinear[texel[1]], srgbToLinear[texel[2]], texel[3] / 255.0f) :
+                PackedVector::XMLoadUByteN4(reinterpret_cast<const PackedVector::XMUBYTEN4*>(texel));
+
+            if (desc.IsNormalMap)
+            {
+                value = XMVectorSelect(value, XMVectorMultiplyAdd(value, g_XMTwo, g_XMNegativeOne), g_XMSelect1110);
+            }
+            texels[x] = value;
+        }
+    }
+
+    static void EncodeRows(const MipLevel& level, const MipGenerationDesc& desc, bool isSrgb, float alphaScale,
+        uint32_t firstRow, uint32_t lastRow, const DirectX::Image& dst)
+    {
+        using namespace DirectX;
+
+        XMVECTOR scale = XMVectorSet(1.0f, 1.0f, 1.0f, alphaScale);
+        for (uint32_t y = firstRow; y < lastRow; ++y)
+        {
+            uint8_t* row = dst.pixels + y * dst.rowPitch;
+            const XMVECTOR* texels = &level.Texels[static_cast<size_t>(y) * level.Width];
+            for (uint32_t x = 0; x < level.Width; ++x)
+            {
+                XMVECTOR value = XMVectorMultiply(texels[x], scale);
+                if (desc.IsNormalMap)
+                {
+                    value = XMVectorSelect(value, XMVectorMultiplyAdd(value, g_XMOneHalf, g_XMOneHalf), g_XMSelect1110);
+                }
+
+                // Kaiser rings below 0 and above 1 near sharp edges
+                value = XMVectorSaturate(value);
+                if (isSrgb)
+                {
+                    value = XMColorRGBToSRGB(value);
+                }
+
+                PackedVector::XMStoreUByteN4(reinterpret_cast<PackedVector::XMUBYTEN4*>(row + x * 4), value);
+            }
+        }
+    }
+
+    static void FilterRow(const DirectX::XMVECTOR* srcRow, const FilterTaps& taps, uint32_t dstWidth, DirectX::XMVECTOR* dstRow)
+    {
+        using namespace DirectX;
+
+        for (uint32_t x = 0; x < dstWidth; ++x)
+        {
+            const uint32_t* indices = &taps.Indices[static_cast<size_t>(x) * taps.NumTaps];
+            const float* weights = &taps.Weights[static_cast<size_t>(x) * taps.NumTaps];
+
+            XMVECTOR sum = XMVectorZero();
+            for (uint32_t tap = 0; tap < taps.NumTaps; ++tap)
+            {
+                sum = XMVectorMultiplyAdd(srcRow[indices[tap]], XMVectorReplicate(weights[tap]), sum);
+            }
+            dstRow[x] = sum;
+        }
+    }
+
+    // Rows of a destination mip are filtered one at a time. Source rows are filtered horizontally on demand into a ring of NumTaps rows,
+    // which always holds every row that the vertical taps of a destination row reach, as those are consecutive source rows
+    // Thus neither the decoded top level nor the horizontally filtered level exist in full, only a few rows per task
+    static void FilterRows(const MipSource& src, const FilterTaps& horizontalTaps, const FilterTaps& verticalTaps,
+        const MipGenerationDesc& desc, bool isSrgb, uint32_t firstRow, uint32_t lastRow, MipLevel& dst)
+    {
+        using namespace DirectX;
+
+        std::vector<XMVECTOR> decodedRow(src.Encoded ? src.Width : 0);
+        std::vector<XMVECTOR> ring(static_cast<size_t>(verticalTaps.NumTaps) * dst.Width);
+        std::vector<uint32_t> ringRows(verticalTaps.NumTaps, UINT32_MAX);
+
+        for (uint32_t y = firstRow; y < lastRow; ++y)
+        {
+            XMVECTOR* dstRow = &dst.Texels[static_cast<size_t>(y) * dst.Width];
+            std::fill_n(dstRow, dst.Width, XMVectorZero());
+
+            const uint32_t* indices = &verticalTaps.Indices[static_cast<size_t>(y) * verticalTaps.NumTaps];
+            const float* weights = &verticalTaps.Weights[static_cast<size_t>(y) * verticalTaps.NumTaps];
+            for (uint32_t tap = 0; tap < verticalTaps.NumTaps; ++tap)
+            {
+                uint32_t srcY = indices[tap];
+                uint32_t slot = srcY % verticalTaps.NumTaps;
+                XMVECTOR* filteredRow = &ring[static_cast<size_t>(slot) * dst.Width];
+                if (ringRows[slot] != srcY)
+                {
+                    const XMVECTOR* srcRow = nullptr;
+                    if (src.Encoded)
+                    {
+                        DecodeRow(*src.Encoded, desc, isSrgb, srcY, decodedRow.data());
+                        srcRow = decodedRow.data();
+                    }
+                    else
+                    {
+                        srcRow = &src.Decoded->Texels[static_cast<size_t>(srcY) * src.Width];
+                    }
+
+                    FilterRow(srcRow, horizontalTaps, dst.Width, filteredRow);
+                    ringRows[slot] = srcY;
+                }
+
+                XMVECTOR weight = XMVectorReplicate(weights[tap]);
+                for (uint32_t x = 0; x < dst.Width; ++x)
+                {
+                    dstRow[x] = XMVectorMultiplyAdd(filteredRow[x], weight, dstRow[x]);
+                }
+            }
+
+            if (desc.IsNormalMap)
+            {
+                // Averaged vectors get shorter where normals diverge. Vectors that cancel out entirely point straight up
+                for (uint32_t x = 0; x < dst.Width; ++x)
+                {
+                    XMVECTOR value = dstRow[x];
+                    XMVECTOR normal = XMVector3Normalize(value);
+                    normal = XMVectorSelect(g_XMIdentityR2, normal, XMVectorGreater(XMVector3LengthSq(value), XMVectorReplicate(1e-12f)));
+                    dstRow[x] = XMVectorSelect(value, normal, g_XMSelect1110);
+                }
+            }
+        }
+    }
+
+    // Alpha is stored last in both RGBA and BGRA and is decoded as value / 255 either way
+    static float ComputeAlphaCoverage(const DirectX::Image& image, float threshold)
+    {
+        size_t numCovered = 0;
+        for (size_t y = 0; y < image.height; ++y)
+        {
+            const uint8_t* row = image.pixels + y * image.rowPitch;
+            for (size_t x = 0; x < image.width; ++x)
+            {
+                numCovered += row[x * 4 + 3] / 255.0f >= threshold ? 1 : 0;
+            }
+        }
+        return static_cast<float>(numCovered) / static_cast<float>(image.width * image.height);
+    }
+
+    static float ComputeAlphaCoverage(const MipLevel& level, float alphaScale, float threshold)
+    {
+        size_t numCovered = 0;
+        for (const DirectX::XMVECTOR& texel : level.Texels)
+        {
+            numCovered += DirectX::XMVectorGetW(texel) * alphaScale >= threshold ? 1 : 0;
+        }
+        return static_cast<float>(numCovered) / static_cast<float>(level.Texels.size());
+    }
+
+    // Coverage only grows with the scale, thus the scale is found with a binary search
+    static float FindAlphaScale(const MipLevel& level, float threshold, float coverage)
+    {
+        float minScale = 0.0f;
+        float maxScale = MaxAlphaScale;
+        for (uint32_t step = 0; step < NumAlphaScaleSteps; ++step)
+        {
+            float scale = (minScale + maxScale) * 0.5f;
+            if (ComputeAlphaCoverage(level, scale, threshold) < coverage)
+            {
+                minScale = scale;
+            }
+            else
+            {
+                maxScale = scale;
+            }
+        }
+        return (minScale + maxScale) * 0.5f;
+    }
+
+    // Every mip is filtered from the previous one, which is kept in float, so that rounding does not accumulate down the chain
+    // Alpha scaling is only applied to stored texels for the same reason
+    static void GenerateItemMips(const DirectX::Image* mips, size_t numMips, const MipGenerationDesc& desc, bool isSrgb, ThreadPool* threadPool)
+    {
+        bool preservesCoverage = desc.AlphaCoverageThreshold > 0.0f;
+        float coverage = preservesCoverage ? ComputeAlphaCoverage(mips[0], desc.AlphaCoverageThreshold) : 0.0f;
+
+        MipLevel src;
+        MipLevel dst;
+        for (size_t mip = 1; mip < numMips; ++mip)
+        {
+            const DirectX::Image& dstImage = mips[mip];
+            uint32_t width = static_cast<uint32_t>(dstImage.width);
+            uint32_t height = static_cast<uint32_t>(dstImage.height);
+
+            MipSource source = mip == 1 ?
+                MipSource{ .Encoded = &mips[0], .Width = static_cast<uint32_t>(mips[0].width), .Height = static_cast<uint32_t>(mips[0].height) } :
+                MipSource{ .Decoded = &src, .Width = src.Width, .Height = src.Height };
+
+            FilterTaps horizontalTaps = MakeFilterTaps(desc.Filter, source.Width, width);
+            FilterTaps verticalTaps = MakeFilterTaps(desc.Filter, source.Height, height);
+
+            dst.Width = width;
+            dst.Height = height;
+            dst.Texels.resize(static_cast<size_t>(width) * height);
+            ForEachRowRange(height, static_cast<size_t>(source.Width) * source.Height, threadPool, [&](uint32_t firstRow, uint32_t lastRow)
+                {
+                    FilterRows(source, horizontalTaps, verticalTaps, desc, isSrgb, firstRow, lastRow, dst);
+                });
+
+            float alphaScale = preservesCoverage ? FindAlphaScale(dst, desc.AlphaCoverageThreshold, coverage) : 1.0f;
+            ForEachRowRange(height, dst.Texels.size(), threadPool, [&](uint32_t firstRow, uint32_t lastRow)
+                {
+                    EncodeRows(dst, desc, isSrgb, alphaScale, firstRow, lastRow, dstImage);
+                });
+
+            std::swap(src, dst);
+        }
+    }
+
+    bool GenerateMips(Image& image, const MipGenerationDesc& desc, ThreadPool* threadPool)
+    {
+        using namespace DirectX;
+
+        WARP_ASSERT(image.IsValid());
+
+        if (image.GetMetadata().mipLevels != 1 || IsCompressed(image.GetMetadata().format))
+        {
+            return true;
+        }
+
+        if (!CopyMappedImage(image))
+        {
+            return false;
+        }
+
+        const TexMetadata& metadata = image.DxImage.GetMetadata();
+
+        // Volumes are filtered across slices as well, that is left to DirectXTex
+        if (!IsFilteredHere(metadata.format) || metadata.dimension != TEX_DIMENSION_TEXTURE2D)
+        {
+            ScratchImage mipChain;
+            HRESULT hr = DirectX::GenerateMipMaps(image.DxImage.GetImages(), image.DxImage.GetImageCount(), metadata, TEX_FILTER_DEFAULT, 0, mipChain);
+            if (FAILED(hr))
+            {
+                WARP_LOG_ERROR("Failed to generate mip levels for {}", image.Filepath);
+                return false;
+            }
+
+            image.DxImage = std::move(mipChain);
+            return true;
+        }
+
+        // Full chain down to 1x1
+        size_t numMips = 1;
+        for (size_t size = std::max(metadata.width, metadata.height); size > 1; size /= 2)
+        {
+            ++numMips;
+        }
+
+        TexMetadata mipMetadata = metadata;
+        mipMetadata.mipLevels = numMips;
+
+        ScratchImage mipChain;
+        if (FAILED(mipChain.Initialize(mipMetadata)))
+        {
+            WARP_LOG_ERROR("Failed to allocate mip levels for {}", image.Filepath);
+            return false;
+        }
+
+        bool isSrgb = desc.IsSrgb || IsSRGB(metadata.format);
+        for (size_t item = 0; item < metadata.arraySize; ++item)
+        {
+            // Top levels share the format and the width, thus they have the same pitches
+            const DirectX::Image* src = image.DxImage.GetImage(0, item, 0);
+            const DirectX::Image* mips = mipChain.GetImage(0, item, 0);
+            WARP_ASSERT(src->slicePitch == mips->slicePitch);
+            std::memcpy(mips->pixels, src->pixels, src->slicePitch);
+
+            GenerateItemMips(mips, numMips, desc, isSrgb, threadPool);
+        }
+
+        image.DxImage = std::move(mipChain);
+        return true;
+    }
+
+}
\ No newline at end of file
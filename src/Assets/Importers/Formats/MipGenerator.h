@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ImageLoader.h"
+
+namespace Warp
+{
+    class ThreadPool;
+}
+
+namespace Warp::ImageLoader
+{
+
+    enum EMipFilter
+    {
+        eMipFilter_Box = 0, // Averages source texels covered by a destination texel. Cheapest, but blurs lower mips
+        eMipFilter_Kaiser, // Kaiser-windowed sinc. Keeps lower mips sharper at the cost of more taps
+    };
+
+    struct MipGenerationDesc
+    {
+        EMipFilter Filter = eMipFilter_Box;
+
+        // Color channels hold sRGB values even if the format is UNORM, thus they are filtered in linear space. Alpha is always linear
+        // Images with an _SRGB format are filtered in linear space regardless
+        bool IsSrgb = false;
+
+        // Color channels hold unit vectors mapped to [0, 1]. Filtered vectors are renormalized in every mip
+        bool IsNormalMap = false;
+
+        // If not 0, alpha of every mip is scaled so that the fraction of texels with alpha above the threshold matches the top mip
+        // Keeps alpha-tested cutouts (foliage, fences) from thinning out in the distance
+        float AlphaCoverageThreshold = 0.0f;
+    };
+
+    // Generates a full mip chain for images that come with a single mip level
+    // 8-bit RGBA and BGRA images are filtered here. Rows of large mips are split across workers of threadPool, which may be nullptr
+    // Other uncompressed formats fall back to DirectX::GenerateMipMaps() and ignore desc. Block-compressed images are left as they are
+    bool GenerateMips(Image& image, const MipGenerationDesc& desc, ThreadPool* threadPool);
+
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../../../Renderer/Vertex.h"
+#include "../../../Util/Guid.h"
+
+// .wmesh is Warp's cooked representation of a MeshAsset
+// It stores the final output of the mesh importer (optimized SoA vertex streams, meshlets and material references),
+// so that loading it is a matter of mapping the file and pointing submesh views into the mapping
+//
+// File layout (every section and every stream starts at WMesh::Alignment):
+//   FileHeader
+//   SubmeshHeader[FileHeader::NumSubmeshes]
+//   LodHeader[FileHeader::NumLods], levels of every submesh are stored next to each other
+//   MaterialHeader[FileHeader::NumMaterials]
+//   String data (mesh name, texture paths), not null-terminated
+//   Payload (MeshPayload of the asset, copied as-is)
+//
+// All offsets are absolute offsets from the beginning of the file. The format is little-endian and is not meant to be portable
+namespace Warp::WMesh
+{
+
+    static constexpr uint32_t Magic = 0x48534D57; // "WMSH"
+
+    // Bump the version whenever the layout of any structure below or the layout of the payload changes
+    // Loaders reject files with different version, forcing them to be cooked again
+    static constexpr uint32_t Version = 7;
+
+    static constexpr uint64_t Alignment = 16;
+    static constexpr uint32_t InvalidMaterialIndex = uint32_t(-1);
+
+    inline constexpr uint64_t AlignUp(uint64_t value) { return (value + Alignment - 1) & ~(Alignment - 1); }
+
+    struct ByteRange
+    {
+        uint64_t Offset = 0;
+        uint64_t NumBytes = 0;
+    };
+
+    struct FileHeader
+    {
+        uint32_t Magic = WMesh::Magic;
+        uint32_t Version = WMesh::Version;
+        uint64_t FileSize = 0;
+
+        uint32_t NumSubmeshes = 0;
+        uint32_t NumMaterials = 0;
+        uint64_t SubmeshTableOffset = 0;
+        uint64_t MaterialTableOffset = 0;
+
+        uint32_t NumLods = 0;
+        uint32_t Reserved = 0;
+        uint64_t LodTableOffset = 0;
+
+        ByteRange Name;
+        ByteRange Payload;
+    };
+
+    struct SubmeshHeader
+    {
+        uint32_t NumVertices = 0;
+        uint32_t MaterialIndex = InvalidMaterialIndex;
+
+        // Rounded up to an even number of elements to keep following ranges 8-byte aligned without implicit padding
+        uint32_t AttributeStrides[(eVertexAttribute_NumAttributes + 1) & ~1] = {};
+        uint32_t AttributeEncodings[(eVertexAttribute_NumAttributes + 1) & ~1] = {}; // EVertexEncoding
+
+        ByteRange Attributes[eVertexAttribute_NumAttributes];
+
+        uint32_t UniqueVertexIndexStride = 0; // 2 or 4 bytes, the same for every level of detail
+
+        // Levels of detail of the submesh are LodHeaders [FirstLod, FirstLod + NumLods), the first one is the full detail level
+        uint32_t FirstLod = 0;
+        uint32_t NumLods = 0;
+        uint32_t MeshletSize = 0; // EMeshletSize, bounds vertex and primitive counts of every meshlet
+
+        float BoundingSphere[4] = {}; // Center and radius in model space
+
+        // Bounds that quantized positions are relative to, see Submesh::GetPositionDequantizeMatrix()
+        float PositionsMin[3] = {};
+        float PositionsExtent[3] = {};
+    };
+
+    struct LodHeader
+    {
+        ByteRange Meshlets;
+        ByteRange UniqueVertexIndices;
+        ByteRange PrimitiveIndices;
+        ByteRange MeshletCullData; // DirectX::CullData per meshlet
+
+        uint32_t NumTriangles = 0;
+        float Error = 0.0f;
+    };
+
+    struct MaterialHeader
+    {
+        float Albedo[4] = {};
+        float RoughnessMetalness[2] = {};
+
+        // UTF-8 paths of source textures relative to the folder of the source mesh, which is the folder of .wmesh file unless it is an entry
+        // of the derived data cache. Empty range means no texture
+        ByteRange AlbedoMap;
+        ByteRange NormalMap;
+        ByteRange RoughnessMetalnessMap;
+
+        // Guids of the textures when the mesh was cooked. Textures that are already loaded are resolved by them, the paths are used otherwise
+        Guid AlbedoMapGuid;
+        Guid NormalMapGuid;
+        Guid RoughnessMetalnessMapGuid;
+    };
+
+    static_assert(sizeof(FileHeader) % 8 == 0 && sizeof(SubmeshHeader) % 8 == 0 && sizeof(LodHeader) % 8 == 0 && sizeof(MaterialHeader) % 8 == 0,
+        "WMesh headers should not contain implicit tail padding");
+
+}
@@ -0,0 +1,591 @@
+#include "../MeshImporter.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "WMeshFormat.h"
+
+#include "../../AssetManager.h"
+#include "../../MaterialAsset.h"
+#include "../../MeshAsset.h"
+#include "../../TextureAsset.h"
+
+#include "../../../Util/Logger.h"
+#include "../../../Util/MappedFile.h"
+#include "../../../Core/Assert.h"
+
+namespace Warp
+{
+
+    namespace WMeshImporter
+    {
+        // Returns true if the range lies within the file and starts at aligned offset
+        static bool IsValidRange(const WMesh::ByteRange& range, uint64_t fileSize);
+
+        // Performs bounds checks of every table and every stream, and of every index that shaders read through, see IsValidLod()
+        // Does not touch vertex streams
+        static const WMesh::FileHeader* ValidateFile(const MappedFile& mapping, std::string_view filepath);
+
+        // Mesh shaders read unique vertex indices and vertex streams through meshlets without bounds checks, thus a corrupted file should
+        // not get that far. Checks that meshlets lie within the streams of the level and that every index lies within the submesh
+        // Streams of the level should already be known to be within the file
+        static bool IsValidLod(const MappedFile& mapping, const WMesh::SubmeshHeader& submesh, const WMesh::LodHeader& lod);
+
+        template<typename T>
+        static std::span<const T> GetView(const MappedFile& mapping, const WMesh::ByteRange& range);
+
+        static std::string_view GetString(const MappedFile& mapping, const WMesh::ByteRange& range);
+
+        static AssetProxy ImportMaterial(const std::filesystem::path& folder, const MappedFile& mapping, const WMesh::MaterialHeader& header, MeshImporter* importer);
+
+        // Textures that are already loaded are found by their Guid, without hashing their paths
+        // Textures that were embedded into .gltf/.glb are re-imported from their container, see TextureImporter::MakeEmbeddedImagePath()
+        static AssetProxy ImportTexture(const std::filesystem::path& folder, std::string_view relativePath, const Guid& guid, ETextureUsage usage,
+            MeshImporter* importer);
+
+        bool IsValidRange(const WMesh::ByteRange& range, uint64_t fileSize)
+        {
+            if (range.NumBytes == 0)
+            {
+                return true;
+            }
+
+            return range.Offset % WMesh::Alignment == 0 && range.Offset <= fileSize && range.NumBytes <= fileSize - range.Offset;
+        }
+
+        const WMesh::FileHeader* ValidateFile(const MappedFile& mapping, std::string_view filepath)
+        {
+            uint64_t fileSize = mapping.GetSize();
+            if (fileSize < sizeof(WMesh::FileHeader))
+            {
+                WARP_LOG_ERROR("WMeshImporter -> \'{}\' is too small to be a .wmesh file", filepath);
+                return nullptr;
+            }
+
+            const WMesh::FileHeader* header = reinterpret_cast<const WMesh::FileHeader*>(mapping.GetData());
+            if (header->Magic != WMesh::Magic)
+            {
+                WARP_LOG_ERROR("WMeshImporter -> \'{}\' is not a .wmesh file", filepath);
+                return nullptr;
+            }
+
+            if (header->Version != WMesh::Version)
+            {
+                WARP_LOG_WARN("WMeshImporter -> \'{}\' was cooked with version {}, expected version {}. It should be cooked again", filepath, header->Version, WMesh::Version);
+                return nullptr;
+            }
+
+            if (header->FileSize != fileSize)
+            {
+                WARP_LOG_ERROR("WMeshImporter -> \'{}\' is truncated", filepath);
+                return nullptr;
+            }
+
+            WMesh::ByteRange submeshTable = WMesh::ByteRange{ header->SubmeshTableOffset, uint64_t(header->NumSubmeshes) * sizeof(WMesh::SubmeshHeader) };
+            WMesh::ByteRange lodTable = WMesh::ByteRange{ header->LodTableOffset, uint64_t(header->NumLods) * sizeof(WMesh::LodHeader) };
+            WMesh::ByteRange materialTable = WMesh::ByteRange{ header->MaterialTableOffset, uint64_t(header->NumMaterials) * sizeof(WMesh::MaterialHeader) };
+            if (!IsValidRange(submeshTable, fileSize) || !IsValidRange(lodTable, fileSize) || !IsValidRange(materialTable, fileSize) ||
+                !IsValidRange(header->Payload, fileSize))
+            {
+                WARP_LOG_ERROR("WMeshImporter -> \'{}\' has corrupted tables", filepath);
+                return nullptr;
+            }
+
+            for (const WMesh::SubmeshHeader& submesh : GetView<WMesh::SubmeshHeader>(mapping, submeshTable))
+            {
+                bool isValid = submesh.MaterialIndex == WMesh::InvalidMaterialIndex || submesh.MaterialIndex < header->NumMaterials;
+                bool isQuantized = submesh.AttributeEncodings[eVertexAttribute_Positions] != eVertexEncoding_Float;
+                for (size_t i = 0; i < eVertexAttribute_NumAttributes; ++i)
+                {
+                    // Either every stream is quantized or none is, as shaders decode them under a single flag
+                    EVertexAttribute attribute = static_cast<EVertexAttribute>(i);
+                    EVertexEncoding encoding = static_cast<EVertexEncoding>(submesh.AttributeEncodings[i]);
+                    isValid = isValid && encoding == (isQuantized ? GetQuantizedEncoding(attribute) : eVertexEncoding_Float);
+
+                    // Missing attributes have empty ranges, present ones should cover every vertex
+                    const WMesh::ByteRange& attributes = submesh.Attributes[i];
+                    isValid = isValid && IsValidRange(attributes, fileSize) && (attributes.NumBytes == 0 ||
+                        (attributes.NumBytes == GetVertexStreamSize(attribute, encoding, submesh.NumVertices) &&
+                            submesh.AttributeStrides[i] == GetVertexStride(attribute, encoding)));
+                }
+
+                isValid = isValid &&
+                    (submesh.UniqueVertexIndexStride == sizeof(uint16_t) || submesh.UniqueVertexIndexStride == sizeof(uint32_t)) &&
+                    submesh.MeshletSize < eMeshletSize_NumSizes &&
+                    submesh.NumLods > 0 && submesh.FirstLod <= header->NumLods && submesh.NumLods <= header->NumLods - submesh.FirstLod;
+
+                std::span<const WMesh::LodHeader> lods = isValid ?
+                    GetView<WMesh::LodHeader>(mapping, lodTable).subspan(submesh.FirstLod, submesh.NumLods) : std::span<const WMesh::LodHeader>();
+                for (const WMesh::LodHeader& lod : lods)
+                {
+                    isValid = isValid &&
+                        lod.UniqueVertexIndices.NumBytes % submesh.UniqueVertexIndexStride == 0 &&
+                        IsValidRange(lod.Meshlets, fileSize) &&
+                        IsValidRange(lod.UniqueVertexIndices, fileSize) &&
+                        IsValidRange(lod.PrimitiveIndices, fileSize) &&
+                        IsValidRange(lod.MeshletCullData, fileSize) &&
+                        lod.Meshlets.NumBytes % sizeof(DirectX::Meshlet) == 0 &&
+                        lod.PrimitiveIndices.NumBytes % sizeof(DirectX::MeshletTriangle) == 0 &&
+                        lod.MeshletCullData.NumBytes == lod.Meshlets.NumBytes / sizeof(DirectX::Meshlet) * sizeof(DirectX::CullData) &&
+                        IsValidLod(mapping, submesh, lod);
+                }
+
+                if (!isValid)
+                {
+                    WARP_LOG_ERROR("WMeshImporter -> \'{}\' has corrupted submesh streams", filepath);
+                    return nullptr;
+                }
+            }
+
+            return header;
+        }
+
+        bool IsValidLod(const MappedFile& mapping, const WMesh::SubmeshHeader& submesh, const WMesh::LodHeader& lod)
+        {
+            const uint32_t maxElements = GetMeshletMaxElements(static_cast<EMeshletSize>(submesh.MeshletSize));
+            const uint64_t numUniqueVertexIndices = lod.UniqueVertexIndices.NumBytes / submesh.UniqueVertexIndexStride;
+            std::span<const DirectX::MeshletTriangle> primitives = GetView<DirectX::MeshletTriangle>(mapping, lod.PrimitiveIndices);
+            for (const DirectX::Meshlet& meshlet : GetView<DirectX::Meshlet>(mapping, lod.Meshlets))
+            {
+                if (meshlet.VertCount > maxElements || meshlet.PrimCount > maxElements ||
+                    uint64_t(meshlet.VertOffset) + meshlet.VertCount > numUniqueVertexIndices ||
+                    uint64_t(meshlet.PrimOffset) + meshlet.PrimCount > primitives.size())
+                {
+                    return false;
+                }
+
+                // Primitives index into unique vertex indices of their meshlet
+                for (const DirectX::MeshletTriangle& primitive : primitives.subspan(meshlet.PrimOffset, meshlet.PrimCount))
+                {
+                    if (primitive.i0 >= meshlet.VertCount || primitive.i1 >= meshlet.VertCount || primitive.i2 >= meshlet.VertCount)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            // Indices are little-endian, thus copying the low bytes of a 16-bit index is enough
+            std::span<const uint8_t> uniqueVertexIndices = GetView<uint8_t>(mapping, lod.UniqueVertexIndices);
+            for (size_t offset = 0; offset < uniqueVertexIndices.size(); offset += submesh.UniqueVertexIndexStride)
+            {
+                uint32_t vertexIndex = 0;
+                std::memcpy(&vertexIndex, uniqueVertexIndices.data() + offset, submesh.UniqueVertexIndexStride);
+                if (vertexIndex >= submesh.NumVertices)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        template<typename T>
+        std::span<const T> GetView(const MappedFile& mapping, const WMesh::ByteRange& range)
+        {
+            if (range.NumBytes == 0)
+            {
+                return std::span<const T>();
+            }
+
+            WARP_ASSERT(range.NumBytes % sizeof(T) == 0);
+            return std::span<const T>(reinterpret_cast<const T*>(mapping.GetData() + range.Offset), range.NumBytes / sizeof(T));
+        }
+
+        std::string_view GetString(const MappedFile& mapping, const WMesh::ByteRange& range)
+        {
+            std::span<const char> chars = GetView<char>(mapping, range);
+            return std::string_view(chars.data(), chars.size());
+        }
+
+        AssetProxy ImportTexture(const std::filesystem::path& folder, std::string_view relativePath, const Guid& guid, ETextureUsage usage,
+            MeshImporter* importer)
+        {
+            if (relativePath.empty())
+            {
+                return AssetProxy();
+            }
+
+            std::filesystem::path imageFilepath = (folder / std::filesystem::path(relativePath)).lexically_normal();
+
+            // Guids are stable across runs only with the asset database, the lookup simply misses without it
+            // Entries of the derived data cache are shared by copies of the source, the Guid is only trusted if it is the texture of this copy
+            AssetManager* manager = importer->GetAssetManager();
+            AssetProxy cachedProxy = guid.IsValid() ? manager->GetAssetProxy(guid) : AssetProxy();
+            TextureAsset* cachedTexture = cachedProxy.Type == EAssetType::Texture ? manager->GetAs<TextureAsset>(cachedProxy) : nullptr;
+            if (cachedTexture && std::filesystem::path(cachedTexture->Filepath).lexically_normal() == imageFilepath)
+            {
+                return cachedProxy;
+            }
+
+            std::string imagePath = imageFilepath.string();
+
+            std::string containerPath;
+            size_t imageIndex = 0;
+            bool isEmbedded = TextureImporter::ParseEmbeddedImagePath(imagePath, containerPath, imageIndex);
+            if (isEmbedded)
+            {
+                std::string extension = std::filesystem::path(containerPath).extension().string();
+                isEmbedded = extension == ".gltf" || extension == ".glb";
+            }
+
+            // Same as for glTF, mips are always generated for material textures and textures are imported asynchronously
+            AssetProxy proxy = isEmbedded ?
+                importer->ImportGltfEmbeddedTexture(imagePath, usage) :
+                importer->GetTextureImporter().ImportFromFileAsync(imagePath, TextureImportDesc{ .GenerateMips = true, .Usage = usage });
+            if (!proxy.IsValid())
+            {
+                WARP_LOG_ERROR("WMeshImporter::ImportTexture -> Failed to import a texture \'{}\'", imagePath);
+            }
+
+            return proxy;
+        }
+
+        AssetProxy ImportMaterial(const std::filesystem::path& folder, const MappedFile& mapping, const WMesh::MaterialHeader& header, MeshImporter* importer)
+        {
+            AssetManager* manager = importer->GetAssetManager();
+            AssetProxy proxy = manager->CreateAsset<MaterialAsset>();
+            if (!proxy.IsValid())
+            {
+                WARP_LOG_ERROR("WMeshImporter::ImportMaterial -> Failed to create a material asset");
+                return proxy;
+            }
+
+            MaterialAsset* material = manager->GetAs<MaterialAsset>(proxy);
+            material->Albedo = Math::Vector4(header.Albedo);
+            material->RoughnessMetalness = Math::Vector2(header.RoughnessMetalness);
+            material->AlbedoMap = AssetHandle(manager,
+                ImportTexture(folder, GetString(mapping, header.AlbedoMap), header.AlbedoMapGuid, eTextureUsage_Albedo, importer));
+            material->NormalMap = AssetHandle(manager,
+                ImportTexture(folder, GetString(mapping, header.NormalMap), header.NormalMapGuid, eTextureUsage_Normal, importer));
+            material->RoughnessMetalnessMap = AssetHandle(manager,
+                ImportTexture(folder, GetString(mapping, header.RoughnessMetalnessMap), header.RoughnessMetalnessMapGuid, eTextureUsage_RoughnessMetalness, importer));
+            return proxy;
+        }
+    }
+
+    AssetProxy MeshImporter::ImportStaticMeshFromWMeshFile(const std::string& filepath, const std::string& assetFilepath)
+    {
+        AssetManager* manager = GetAssetManager();
+        AssetProxy proxy = manager->GetAssetProxy(assetFilepath);
+        if (proxy.IsValid())
+        {
+            WARP_ASSERT(proxy.Type == EAssetType::Mesh);
+            WARP_LOG_INFO("MeshImporter::ImportStaticMeshFromWMeshFile -> Returning cached asset at \'{}\'", assetFilepath);
+            return proxy;
+        }
+
+        MappedFile mapping(filepath);
+        if (!mapping.IsValid())
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromWMeshFile -> Failed to map \'{}\'", filepath);
+            return AssetProxy();
+        }
+
+        // Validate before creating an asset, we do not want to leave half-initialized assets behind
+        const WMesh::FileHeader* header = WMeshImporter::ValidateFile(mapping, filepath);
+        if (!header)
+        {
+            return AssetProxy();
+        }
+
+        proxy = manager->CreateAsset<MeshAsset>(assetFilepath);
+        if (!proxy.IsValid())
+        {
+            WARP_LOG_ERROR("MeshImporter::ImportStaticMeshFromWMeshFile -> Failed to create mesh asset for \'{}\'", filepath);
+            return proxy;
+        }
+
+        MeshAsset* mesh = manager->GetAs<MeshAsset>(proxy);
+        mesh->Name = WMeshImporter::GetString(mapping, header->Name);
+
+        if (AssetDatabase* database = manager->GetAssetDatabase())
+        {
+            database->SetCookedPath(mesh->GetGuid(), filepath);
+        }
+
+        std::filesystem::path folder = std::filesystem::path(assetFilepath).parent_path();
+        std::span<const WMesh::MaterialHeader> materialHeaders = WMeshImporter::GetView<WMesh::MaterialHeader>(mapping,
+            WMesh::ByteRange{ header->MaterialTableOffset, uint64_t(header->NumMaterials) * sizeof(WMesh::MaterialHeader) });
+
+        // Materials that no submesh refers to are released along with this array
+        std::vector<AssetHandle> materials;
+        materials.reserve(materialHeaders.size());
+        for (const WMesh::MaterialHeader& materialHeader : materialHeaders)
+        {
+            materials.emplace_back(manager, WMeshImporter::ImportMaterial(folder, mapping, materialHeader, this));
+        }
+
+        std::span<const WMesh::SubmeshHeader> submeshHeaders = WMeshImporter::GetView<WMesh::SubmeshHeader>(mapping,
+            WMesh::ByteRange{ header->SubmeshTableOffset, uint64_t(header->NumSubmeshes) * sizeof(WMesh::SubmeshHeader) });
+
+        std::span<const WMesh::LodHeader> lodHeaders = WMeshImporter::GetView<WMesh::LodHeader>(mapping,
+            WMesh::ByteRange{ header->LodTableOffset, uint64_t(header->NumLods) * sizeof(WMesh::LodHeader) });
+
+        // No parsing here, views are pointed straight into the mapping
+        mesh->Submeshes.resize(submeshHeaders.size());
+        mesh->SubmeshMaterials.resize(submeshHeaders.size());
+        for (size_t submeshIndex = 0; submeshIndex < submeshHeaders.size(); ++submeshIndex)
+        {
+            const WMesh::SubmeshHeader& submeshHeader = submeshHeaders[submeshIndex];
+            Submesh& submesh = mesh->Submeshes[submeshIndex];
+            submesh.NumVertices = submeshHeader.NumVertices;
+            for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+            {
+                submesh.Attributes[attributeIndex] = WMeshImporter::GetView<std::byte>(mapping, submeshHeader.Attributes[attributeIndex]);
+                submesh.AttributeStrides[attributeIndex] = submeshHeader.AttributeStrides[attributeIndex];
+                submesh.AttributeEncodings[attributeIndex] = static_cast<EVertexEncoding>(submeshHeader.AttributeEncodings[attributeIndex]);
+            }
+
+            submesh.PositionsMin = Math::Vector3(submeshHeader.PositionsMin);
+            submesh.PositionsExtent = Math::Vector3(submeshHeader.PositionsExtent);
+
+            submesh.UniqueVertexIndexStride = submeshHeader.UniqueVertexIndexStride;
+            submesh.MeshletSize = static_cast<EMeshletSize>(submeshHeader.MeshletSize);
+            submesh.BoundingSphere = DirectX::BoundingSphere(
+                DirectX::XMFLOAT3(submeshHeader.BoundingSphere[0], submeshHeader.BoundingSphere[1], submeshHeader.BoundingSphere[2]), submeshHeader.BoundingSphere[3]);
+
+            submesh.Lods.resize(submeshHeader.NumLods);
+            for (uint32_t lodIndex = 0; lodIndex < submeshHeader.NumLods; ++lodIndex)
+            {
+                const WMesh::LodHeader& lodHeader = lodHeaders[submeshHeader.FirstLod + lodIndex];
+                SubmeshLod& lod = submesh.Lods[lodIndex];
+                lod.Meshlets = WMeshImporter::GetView<DirectX::Meshlet>(mapping, lodHeader.Meshlets);
+                lod.UniqueVertexIndices = WMeshImporter::GetView<uint8_t>(mapping, lodHeader.UniqueVertexIndices);
+                lod.PrimitiveIndices = WMeshImporter::GetView<DirectX::MeshletTriangle>(mapping, lodHeader.PrimitiveIndices);
+                lod.MeshletCullData = WMeshImporter::GetView<DirectX::CullData>(mapping, lodHeader.MeshletCullData);
+                lod.NumTriangles = lodHeader.NumTriangles;
+                lod.Error = lodHeader.Error;
+            }
+
+            if (submeshHeader.MaterialIndex != WMesh::InvalidMaterialIndex)
+            {
+                mesh->SubmeshMaterials[submeshIndex] = materials[submeshHeader.MaterialIndex];
+            }
+        }
+
+        // The mapping does not move in memory when ownership is transferred, thus views stay valid
+        mesh->Payload = MeshPayload(std::move(mapping));
+        return proxy;
+    }
+
+    bool MeshImporter::CookStaticMesh(AssetProxy proxy, const std::string& cookedFilepath)
+    {
+        return CookStaticMesh(proxy, cookedFilepath, std::filesystem::path(cookedFilepath).parent_path());
+    }
+
+    bool MeshImporter::CookStaticMesh(AssetProxy proxy, const std::string& cookedFilepath, const std::filesystem::path& textureFolder)
+    {
+        AssetManager* manager = GetAssetManager();
+        MeshAsset* mesh = manager->GetAs<MeshAsset>(proxy);
+        if (!mesh)
+        {
+            WARP_LOG_ERROR("MeshImporter::CookStaticMesh -> Invalid mesh proxy");
+            return false;
+        }
+
+        // String offsets are relative to the beginning of the string section until the layout is known
+        std::string strings;
+        auto addString = [&strings](std::string_view str) -> WMesh::ByteRange
+            {
+                WMesh::ByteRange range = WMesh::ByteRange{ .Offset = strings.size(), .NumBytes = str.size() };
+                strings.append(str);
+
+                // Keep every string aligned, so that the validation of ranges stays uniform
+                strings.resize(WMesh::AlignUp(strings.size()), '\0');
+                return range;
+            };
+
+        auto addTexturePath = [&addString, &textureFolder, manager](AssetProxy textureProxy) -> WMesh::ByteRange
+            {
+                TextureAsset* texture = manager->GetAs<TextureAsset>(textureProxy);
+                if (!texture || texture->Filepath.empty())
+                {
+                    return WMesh::ByteRange();
+                }
+
+                // Prefer relative paths, so that cooked assets can be moved along with their sources
+                std::filesystem::path texturePath = std::filesystem::path(texture->Filepath);
+                std::filesystem::path relativePath = texturePath.lexically_relative(textureFolder);
+                return addString((relativePath.empty() ? texturePath : relativePath).generic_string());
+            };
+
+        auto getTextureGuid = [manager](AssetProxy textureProxy) -> Guid
+            {
+                TextureAsset* texture = manager->GetAs<TextureAsset>(textureProxy);
+                return texture ? texture->GetGuid() : Guid();
+            };
+
+        WMesh::FileHeader header;
+        header.Name = addString(mesh->Name);
+
+        // Submeshes may share materials, thus we deduplicate them by asset ID
+        std::vector<WMesh::MaterialHeader> materialHeaders;
+        std::unordered_map<uint32_t, uint32_t> materialIndices;
+        std::vector<WMesh::SubmeshHeader> submeshHeaders(mesh->GetNumSubmeshes());
+        for (uint32_t submeshIndex = 0; submeshIndex < mesh->GetNumSubmeshes(); ++submeshIndex)
+        {
+            AssetProxy materialProxy = mesh->SubmeshMaterials[submeshIndex];
+            MaterialAsset* material = manager->GetAs<MaterialAsset>(materialProxy);
+            if (!material)
+            {
+                continue;
+            }
+
+            auto [it, inserted] = materialIndices.try_emplace(materialProxy.ID, static_cast<uint32_t>(materialHeaders.size()));
+            if (inserted)
+            {
+                WMesh::MaterialHeader& materialHeader = materialHeaders.emplace_back();
+                std::memcpy(materialHeader.Albedo, &material->Albedo, sizeof(materialHeader.Albedo));
+                std::memcpy(materialHeader.RoughnessMetalness, &material->RoughnessMetalness, sizeof(materialHeader.RoughnessMetalness));
+                materialHeader.AlbedoMap = addTexturePath(material->AlbedoMap);
+                materialHeader.NormalMap = addTexturePath(material->NormalMap);
+                materialHeader.RoughnessMetalnessMap = addTexturePath(material->RoughnessMetalnessMap);
+                materialHeader.AlbedoMapGuid = getTextureGuid(material->AlbedoMap);
+                materialHeader.NormalMapGuid = getTextureGuid(material->NormalMap);
+                materialHeader.RoughnessMetalnessMapGuid = getTextureGuid(material->RoughnessMetalnessMap);
+            }
+
+            submeshHeaders[submeshIndex].MaterialIndex = it->second;
+        }
+
+        std::vector<WMesh::LodHeader> lodHeaders;
+        for (uint32_t submeshIndex = 0; submeshIndex < mesh->GetNumSubmeshes(); ++submeshIndex)
+        {
+            submeshHeaders[submeshIndex].FirstLod = static_cast<uint32_t>(lodHeaders.size());
+            submeshHeaders[submeshIndex].NumLods = mesh->Submeshes[submeshIndex].GetNumLods();
+            lodHeaders.resize(lodHeaders.size() + mesh->Submeshes[submeshIndex].GetNumLods());
+        }
+
+        // Now the layout is known
+        header.NumSubmeshes = static_cast<uint32_t>(submeshHeaders.size());
+        header.NumLods = static_cast<uint32_t>(lodHeaders.size());
+        header.NumMaterials = static_cast<uint32_t>(materialHeaders.size());
+        header.SubmeshTableOffset = WMesh::AlignUp(sizeof(WMesh::FileHeader));
+        header.LodTableOffset = WMesh::AlignUp(header.SubmeshTableOffset + submeshHeaders.size() * sizeof(WMesh::SubmeshHeader));
+        header.MaterialTableOffset = WMesh::AlignUp(header.LodTableOffset + lodHeaders.size() * sizeof(WMesh::LodHeader));
+
+        uint64_t stringsOffset = WMesh::AlignUp(header.MaterialTableOffset + materialHeaders.size() * sizeof(WMesh::MaterialHeader));
+        std::span<const std::byte> payload = mesh->Payload.GetBytes();
+        header.Payload = WMesh::ByteRange{ .Offset = WMesh::AlignUp(stringsOffset + strings.size()), .NumBytes = payload.size() };
+        header.FileSize = header.Payload.Offset + header.Payload.NumBytes;
+
+        auto relocateString = [stringsOffset](WMesh::ByteRange& range)
+            {
+                if (range.NumBytes != 0)
+                {
+                    range.Offset += stringsOffset;
+                }
+            };
+
+        relocateString(header.Name);
+        for (WMesh::MaterialHeader& materialHeader : materialHeaders)
+        {
+            relocateString(materialHeader.AlbedoMap);
+            relocateString(materialHeader.NormalMap);
+            relocateString(materialHeader.RoughnessMetalnessMap);
+        }
+
+        // Payload is written as-is, thus stream ranges are offsets of submesh views inside of the payload
+        auto getPayloadRange = [&header, mesh](std::span<const std::byte> view) -> WMesh::ByteRange
+            {
+                if (view.empty())
+                {
+                    return WMesh::ByteRange();
+                }
+
+                return WMesh::ByteRange{ .Offset = header.Payload.Offset + mesh->Payload.GetOffsetOf(view), .NumBytes = view.size() };
+            };
+
+        for (uint32_t submeshIndex = 0; submeshIndex < mesh->GetNumSubmeshes(); ++submeshIndex)
+        {
+            const Submesh& submesh = mesh->Submeshes[submeshIndex];
+            WMesh::SubmeshHeader& submeshHeader = submeshHeaders[submeshIndex];
+            submeshHeader.NumVertices = submesh.NumVertices;
+            for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+            {
+                submeshHeader.AttributeStrides[attributeIndex] = submesh.AttributeStrides[attributeIndex];
+                submeshHeader.AttributeEncodings[attributeIndex] = submesh.AttributeEncodings[attributeIndex];
+                submeshHeader.Attributes[attributeIndex] = getPayloadRange(submesh.Attributes[attributeIndex]);
+            }
+
+            submeshHeader.UniqueVertexIndexStride = submesh.UniqueVertexIndexStride;
+            submeshHeader.MeshletSize = submesh.MeshletSize;
+            for (uint32_t lodIndex = 0; lodIndex < submesh.GetNumLods(); ++lodIndex)
+            {
+                const SubmeshLod& lod = submesh.Lods[lodIndex];
+                WMesh::LodHeader& lodHeader = lodHeaders[submeshHeader.FirstLod + lodIndex];
+                lodHeader.Meshlets = getPayloadRange(std::as_bytes(lod.Meshlets));
+                lodHeader.UniqueVertexIndices = getPayloadRange(std::as_bytes(lod.UniqueVertexIndices));
+                lodHeader.PrimitiveIndices = getPayloadRange(std::as_bytes(lod.PrimitiveIndices));
+                lodHeader.MeshletCullData = getPayloadRange(std::as_bytes(lod.MeshletCullData));
+                lodHeader.NumTriangles = lod.NumTriangles;
+                lodHeader.Error = lod.Error;
+            }
+
+            const DirectX::BoundingSphere& sphere = submesh.BoundingSphere;
+            submeshHeader.BoundingSphere[0] = sphere.Center.x;
+            submeshHeader.BoundingSphere[1] = sphere.Center.y;
+            submeshHeader.BoundingSphere[2] = sphere.Center.z;
+            submeshHeader.BoundingSphere[3] = sphere.Radius;
+            std::memcpy(submeshHeader.PositionsMin, &submesh.PositionsMin, sizeof(submeshHeader.PositionsMin));
+            std::memcpy(submeshHeader.PositionsExtent, &submesh.PositionsExtent, sizeof(submeshHeader.PositionsExtent));
+        }
+
+        // Write into a temporary file first and rename it afterwards, so that a crash never leaves a truncated .wmesh behind
+        std::filesystem::path tempFilepath = std::filesystem::path(cookedFilepath).concat(".tmp");
+        {
+            std::ofstream file(tempFilepath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                WARP_LOG_ERROR("MeshImporter::CookStaticMesh -> Failed to open \'{}\' for writing", tempFilepath.string());
+                return false;
+            }
+
+            auto writeAt = [&file](uint64_t offset, const void* data, size_t numBytes)
+                {
+                    // Zero-fill the alignment gap
+                    static constexpr char Zeros[WMesh::Alignment] = {};
+                    uint64_t position = static_cast<uint64_t>(file.tellp());
+                    WARP_ASSERT(offset >= position && offset - position < WMesh::Alignment);
+                    file.write(Zeros, static_cast<std::streamsize>(offset - position));
+                    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(numBytes));
+                };
+
+            writeAt(0, &header, sizeof(header));
+            writeAt(header.SubmeshTableOffset, submeshHeaders.data(), submeshHeaders.size() * sizeof(WMesh::SubmeshHeader));
+            writeAt(header.LodTableOffset, lodHeaders.data(), lodHeaders.size() * sizeof(WMesh::LodHeader));
+            writeAt(header.MaterialTableOffset, materialHeaders.data(), materialHeaders.size() * sizeof(WMesh::MaterialHeader));
+            writeAt(stringsOffset, strings.data(), strings.size());
+            writeAt(header.Payload.Offset, payload.data(), payload.size());
+
+            if (!file)
+            {
+                WARP_LOG_ERROR("MeshImporter::CookStaticMesh -> Failed to write \'{}\'", tempFilepath.string());
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempFilepath, cookedFilepath, ec);
+        if (ec)
+        {
+            WARP_LOG_ERROR("MeshImporter::CookStaticMesh -> Failed to move cooked mesh to \'{}\': {}", cookedFilepath, ec.message());
+            std::filesystem::remove(tempFilepath, ec);
+            return false;
+        }
+
+        if (AssetDatabase* database = manager->GetAssetDatabase())
+        {
+            database->SetCookedPath(mesh->GetGuid(), cookedFilepath);
+        }
+
+        WARP_LOG_INFO("MeshImporter::CookStaticMesh -> Cooked \'{}\' into \'{}\' ({} bytes)", mesh->Name, cookedFilepath, header.FileSize);
+        return true;
+    }
+
+}
\ No newline at end of file
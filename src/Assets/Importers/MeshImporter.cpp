@@ -1,6 +1,7 @@
 #include "MeshImporter.h"
 
 #include <filesystem>
+#include <vector>
 
 #include "../../Core/Application.h"
 
@@ -17,7 +18,7 @@
 namespace Warp
 {
 
-    AssetProxy MeshImporter::ImportStaticMeshFromFile(const std::string& filepath)
+    AssetProxy MeshImporter::ImportStaticMeshFromFile(const std::string& filepath, const StaticMeshImportDesc& importDesc)
     {
         EAssetFormat format = GetFormat(std::filesystem::path(filepath).extension().string());
         if (format == EAssetFormat::Unknown)
@@ -30,7 +31,11 @@ namespace Warp
         switch (format)
         {
         case EAssetFormat::Gltf:
-            proxy = ImportStaticMeshFromGltfFile(filepath);
+        case EAssetFormat::Glb:
+            proxy = ImportStaticMeshFromGltfFileCached(filepath, importDesc);
+            break;
+        case EAssetFormat::WMesh:
+            proxy = ImportStaticMeshFromWMeshFile(filepath, filepath);
             break;
         default: WARP_ASSERT(false, "Shouldnt happen"); return AssetProxy();
         }
@@ -41,7 +46,18 @@ namespace Warp
             return AssetProxy();
         }
 
-        MeshAsset* mesh = GetAssetManager()->GetAs<MeshAsset>(proxy);
+        UploadStaticMesh(GetAssetManager()->GetAs<MeshAsset>(proxy));
+        return proxy;
+    }
+
+    void MeshImporter::UploadStaticMesh(MeshAsset* mesh)
+    {
+        // There is no renderer without an application, meshes only keep their CPU streams then
+        if (!Application::Exists())
+        {
+            return;
+        }
+
         uint32_t numSubmeshes = mesh->GetNumSubmeshes();
 
         // Process every submesh
@@ -58,14 +74,32 @@ namespace Warp
             static constexpr uint32_t UVIndexStride = sizeof(uint8_t);
             static constexpr uint32_t PrimitiveIndicesStride = sizeof(DirectX::MeshletTriangle);
 
-            size_t meshletsInBytes = submesh.Meshlets.size() * MeshletStride;
-            size_t uniqueVertexIndicesInBytes = submesh.UniqueVertexIndices.size() * UVIndexStride;
-            size_t primitiveIndicesInBytes = submesh.PrimitiveIndices.size() * PrimitiveIndicesStride;
+            struct LodSizes
+            {
+                size_t MeshletsInBytes;
+                size_t UniqueVertexIndicesInBytes;
+                size_t PrimitiveIndicesInBytes;
+            };
+
+            std::vector<LodSizes> lodSizes(submesh.GetNumLods());
+            bool isValid = !lodSizes.empty();
+            for (uint32_t lodIndex = 0; lodIndex < submesh.GetNumLods(); ++lodIndex)
+            {
+                const SubmeshLod& lod = submesh.Lods[lodIndex];
+                LodSizes& sizes = lodSizes[lodIndex];
+                sizes.MeshletsInBytes = lod.Meshlets.size() * MeshletStride;
+
+                // Shaders read unique vertex indices as 4-byte words, thus an odd number of 16-bit indices is padded
+                // This never reads past the stream, as every stream of MeshPayload is padded to MeshPayload::Alignment
+                sizes.UniqueVertexIndicesInBytes = (lod.UniqueVertexIndices.size() * UVIndexStride + 3) & ~size_t(3);
+                sizes.PrimitiveIndicesInBytes = lod.PrimitiveIndices.size() * PrimitiveIndicesStride;
+                isValid = isValid && sizes.MeshletsInBytes != 0 && sizes.UniqueVertexIndicesInBytes != 0 && sizes.PrimitiveIndicesInBytes != 0;
+            }
 
             // Sanity-check. If invalid submesh - continue
-            if (meshletsInBytes == 0 || uniqueVertexIndicesInBytes == 0 || primitiveIndicesInBytes == 0)
+            if (!isValid)
             {
-                WARP_LOG_WARN("MeshImporter::ImportStaticMeshFromFile -> Invalid meshlet data for \'{}\' mesh (submesh index {})", mesh->Name, submeshIndex);
+                WARP_LOG_WARN("MeshImporter::UploadStaticMesh -> Invalid meshlet data for \'{}\' mesh (submesh index {})", mesh->Name, submeshIndex);
                 continue;
             }
 
@@ -73,18 +107,22 @@ namespace Warp
             // The COPY flags (COPY_DEST and COPY_SOURCE) used as initial states represent states in the 3D/Compute type class. 
             // To use a resource initially on a Copy queue it should start in the COMMON state. 
             // The COMMON state can be used for all usages on a Copy queue using the implicit state transitions. 
-            submesh.MeshletBuffer = RHIBuffer(Device,
-                D3D12_HEAP_TYPE_DEFAULT,
-                D3D12_RESOURCE_STATE_COMMON,
-                D3D12_RESOURCE_FLAG_NONE, meshletsInBytes);
-            submesh.UniqueVertexIndicesBuffer = RHIBuffer(Device,
-                D3D12_HEAP_TYPE_DEFAULT,
-                D3D12_RESOURCE_STATE_COMMON,
-                D3D12_RESOURCE_FLAG_NONE, uniqueVertexIndicesInBytes);
-            submesh.PrimitiveIndicesBuffer = RHIBuffer(Device,
-                D3D12_HEAP_TYPE_DEFAULT,
-                D3D12_RESOURCE_STATE_COMMON,
-                D3D12_RESOURCE_FLAG_NONE, primitiveIndicesInBytes);
+            for (uint32_t lodIndex = 0; lodIndex < submesh.GetNumLods(); ++lodIndex)
+            {
+                SubmeshLod& lod = submesh.Lods[lodIndex];
+                lod.MeshletBuffer = RHIBuffer(Device,
+                    D3D12_HEAP_TYPE_DEFAULT,
+                    D3D12_RESOURCE_STATE_COMMON,
+                    D3D12_RESOURCE_FLAG_NONE, lodSizes[lodIndex].MeshletsInBytes);
+                lod.UniqueVertexIndicesBuffer = RHIBuffer(Device,
+                    D3D12_HEAP_TYPE_DEFAULT,
+                    D3D12_RESOURCE_STATE_COMMON,
+                    D3D12_RESOURCE_FLAG_NONE, lodSizes[lodIndex].UniqueVertexIndicesInBytes);
+                lod.PrimitiveIndicesBuffer = RHIBuffer(Device,
+                    D3D12_HEAP_TYPE_DEFAULT,
+                    D3D12_RESOURCE_STATE_COMMON,
+                    D3D12_RESOURCE_FLAG_NONE, lodSizes[lodIndex].PrimitiveIndicesInBytes);
+            }
 
             // Now perform resource copying from UPLOAD heap to DEFAULT heap (our mesh resource)
             RHICopyCommandContext& copyContext = renderer->GetCopyContext();
@@ -102,24 +140,26 @@ namespace Warp
                         continue;
                     }
 
-                    uint32_t stride = submesh.AttributeStrides[i];
-                    size_t sizeInBytes = submesh.GetNumVertices() * stride;
+                    // Shaders read attributes as 4-byte words. Quantized streams may be shorter than that, the payload is padded anyway
+                    size_t sizeInBytes = (submesh.Attributes[i].size() + 3) & ~size_t(3);
                     submesh.Resources[i] = RHIBuffer(Device, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_NONE, sizeInBytes);
 
                     copyContext.UploadToBuffer(&submesh.Resources[i], submesh.Attributes[i].data(), sizeInBytes);
                 }
 
-                copyContext.UploadToBuffer(&submesh.MeshletBuffer, submesh.Meshlets.data(), meshletsInBytes);
-                copyContext.UploadToBuffer(&submesh.UniqueVertexIndicesBuffer, submesh.UniqueVertexIndices.data(), uniqueVertexIndicesInBytes);
-                copyContext.UploadToBuffer(&submesh.PrimitiveIndicesBuffer, submesh.PrimitiveIndices.data(), primitiveIndicesInBytes);
+                for (uint32_t lodIndex = 0; lodIndex < submesh.GetNumLods(); ++lodIndex)
+                {
+                    SubmeshLod& lod = submesh.Lods[lodIndex];
+                    copyContext.UploadToBuffer(&lod.MeshletBuffer, lod.Meshlets.data(), lodSizes[lodIndex].MeshletsInBytes);
+                    copyContext.UploadToBuffer(&lod.UniqueVertexIndicesBuffer, lod.UniqueVertexIndices.data(), lodSizes[lodIndex].UniqueVertexIndicesInBytes);
+                    copyContext.UploadToBuffer(&lod.PrimitiveIndicesBuffer, lod.PrimitiveIndices.data(), lodSizes[lodIndex].PrimitiveIndicesInBytes);
+                }
             }
             copyContext.Close();
 
             UINT64 fenceValue = copyContext.Execute(false);
             copyContext.EndCopy(fenceValue);
         }
-
-        return proxy;
     }
 
 }
\ No newline at end of file
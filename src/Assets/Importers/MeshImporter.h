@@ -1,11 +1,88 @@
 #pragma once
 
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "AssetImporter.h"
 #include "TextureImporter.h"
 
+#include "../MeshAsset.h"
+#include "../../Math/Math.h"
+#include "../../Util/Hash.h"
+
 namespace Warp
 {
 
+    namespace GltfImporter
+    {
+        struct GltfFile;
+    }
+
+    struct StaticMeshImportDesc
+    {
+        // Determines whether or not to generate tangents and bitangents (binormals)
+        bool GenerateTangents = true;
+
+        // Number of worker threads that optimize submeshes and generate meshlets in parallel
+        // 0 means one worker per hardware thread, 1 effectively makes the import single-threaded
+        uint32_t NumWorkerThreads = 0;
+
+        // Bounds memory of huge scenes. Submeshes are read and processed a batch of NumWorkerThreads at a time and spilled into a temporary file
+        // right after, so that besides the resulting mesh only the batch is in memory. Costs an extra write and read of the processed geometry
+        bool LowMemoryImport = false;
+
+        // Stores vertex streams in compact encodings (see VertexQuantization.h), which takes 20 bytes per vertex instead of 56
+        bool QuantizeVertices = false;
+
+        // Maximum number of levels of detail per submesh, including the full detail level. 1 disables simplification
+        uint32_t MaxNumLods = 4;
+
+        // Every level aims for this fraction of triangles of the previous level
+        float LodTriangleRatio = 0.5f;
+
+        // Simplification error that no level may exceed, relative to the bounding sphere radius of the submesh
+        // The chain ends early once simplifying further would exceed it
+        float LodMaxRelativeError = 0.05f;
+
+        // Upper bound of vertices and primitives per meshlet, see EMeshletSize
+        EMeshletSize MeshletSize = eMeshletSize_128;
+
+        // Logs vertex cache efficiency before and after optimization and meshlet utilization of every submesh, see MeshStatistics.h
+        // Quantized meshes log the largest error of every stream as well, see MeasureQuantizationError()
+        // Triangle counts and errors of every level of detail are logged as well
+        // Does not affect the output. Meshes that come from the derived data cache are not processed, thus not reported either
+        bool ReportStatistics = false;
+    };
+
+    // A node of a scene that references a mesh. Meshes that several nodes share are imported once, see MeshImporter::ImportStaticMeshInstancesFromFile()
+    struct StaticMeshInstance
+    {
+        std::string Name;
+        AssetProxy Mesh;
+        Math::Matrix InstanceToScene;
+    };
+
+    // A node of the scene hierarchy with its transform relative to the parent, see MeshImporter::ImportStaticMeshSceneFromFile()
+    struct StaticMeshSceneNode
+    {
+        static constexpr uint32_t InvalidIndex = uint32_t(-1);
+
+        std::string Name;
+        AssetProxy Mesh; // Invalid for nodes that only group and transform their children
+        uint32_t ParentIndex = InvalidIndex;
+        Math::Matrix LocalToParent;
+    };
+
+    struct StaticMeshScene
+    {
+        // Parents always come before their children
+        std::vector<StaticMeshSceneNode> Nodes;
+    };
+
     // TODO: We should provide importer with asset type to import with
     // for example ImportStaticMeshFromFile(const std::string& filepath); -> ImportStaticMeshFromFile(const std::string& filepath, EAssetFormat format);
     // responsibility of determining format of the asset is up to user
@@ -14,20 +91,76 @@ namespace Warp
     {
     public:
         MeshImporter() = default;
-        MeshImporter(AssetManager* assetManager)
-            : AssetImporter(assetManager)
-            , m_textureImporter(assetManager)
+        MeshImporter(AssetManager* assetManager, DerivedDataCache* derivedDataCache = nullptr)
+            : AssetImporter(assetManager, derivedDataCache)
+            , m_textureImporter(assetManager, derivedDataCache)
         {
             // Add importer's supported formats here
             AddFormat(".gltf", EAssetFormat::Gltf);
+            AddFormat(".glb", EAssetFormat::Glb);
+            AddFormat(".wmesh", EAssetFormat::WMesh);
         }
 
-        AssetProxy ImportStaticMeshFromFile(const std::string& filepath);
+        // Part of the derived data key. Bump it whenever processing of meshes changes, so that stale cooked meshes are not used
+        static constexpr uint32_t DerivedDataVersion = 6;
+
+        AssetProxy ImportStaticMeshFromFile(const std::string& filepath, const StaticMeshImportDesc& importDesc = StaticMeshImportDesc());
+
+        // Unlike ImportStaticMeshFromFile(), which bakes every node into a single mesh, imports every mesh of the file once in its own space
+        // and returns one instance per node that references it, so that memory scales with unique meshes instead of nodes. Only .gltf/.glb files
+        // Meshes are registered under MakeGltfMeshPath() and cooked separately
+        std::vector<StaticMeshInstance> ImportStaticMeshInstancesFromFile(const std::string& filepath, const StaticMeshImportDesc& importDesc = StaticMeshImportDesc());
+
+        // Same as ImportStaticMeshInstancesFromFile() but keeps the node hierarchy with local transforms, including nodes without meshes
+        StaticMeshScene ImportStaticMeshSceneFromFile(const std::string& filepath, const StaticMeshImportDesc& importDesc = StaticMeshImportDesc());
+
+        static std::string MakeGltfMeshPath(std::string_view filepath, size_t meshIndex);
+
+        // Writes the CPU representation of an imported mesh into a .wmesh file, which can later be imported with ImportStaticMeshFromFile
+        // Materials are stored as references to source textures, thus textures must have been imported from files
+        bool CookStaticMesh(AssetProxy proxy, const std::string& cookedFilepath);
+
+        // Same as above, but texture paths are stored relative to textureFolder instead of the folder of the cooked file
+        // Entries of the derived data cache are shared by every copy of their source, thus their textures are relative to the source
+        bool CookStaticMesh(AssetProxy proxy, const std::string& cookedFilepath, const std::filesystem::path& textureFolder);
+
+        // Material textures are imported asynchronously with this importer, see TextureImporter::UploadReadyTextures()
+        inline TextureImporter& GetTextureImporter() { return m_textureImporter; }
+
+        // Imports an image that is stored inside of a .gltf/.glb file (buffer view or data URI)
+        // imagePath is in the form of TextureImporter::MakeEmbeddedImagePath(), which is what such textures are registered under
+        AssetProxy ImportGltfEmbeddedTexture(const std::string& imagePath, ETextureUsage usage);
 
     private:
-        AssetProxy ImportStaticMeshFromGltfFile(const std::string& filepath);
+        // Looks up the cooked mesh in the derived data cache and imports it from the source file on a miss, cooking it for the next runs
+        AssetProxy ImportStaticMeshFromGltfFileCached(const std::string& filepath, const StaticMeshImportDesc& importDesc);
+        AssetProxy ImportStaticMeshFromGltfFile(std::shared_ptr<GltfImporter::GltfFile> file, const StaticMeshImportDesc& importDesc);
+
+        // Imports meshes of an opened file in their own space and returns a proxy per mesh index, which is invalid if the mesh failed
+        // Submeshes of meshes that miss the cache are processed together, the file is released once the last of them is read
+        // baseKey is the derived data key of the file, nullptr bypasses the cache
+        std::vector<AssetProxy> ImportStaticMeshesFromGltfFile(std::shared_ptr<GltfImporter::GltfFile> file, std::span<const size_t> meshIndices,
+            const StaticMeshImportDesc& importDesc, const Hasher128* baseKey);
+
+        // Derived data key of the parsed file with every setting that affects cooked meshes. Returns false if the sources could not be hashed
+        bool MakeGltfDerivedDataHasher(const GltfImporter::GltfFile& file, const StaticMeshImportDesc& importDesc, Hasher128& hasher);
+
+        // Feeds JSON of the file and the size and write time of every buffer it references into the hasher, buffers are not read
+        // Images are cached separately by the texture importer
+        bool HashGltfSourceFiles(const GltfImporter::GltfFile& file, Hasher128& hasher);
+
+        // Import desc is ignored, .wmesh files are already processed
+        // The asset is registered under assetFilepath, which is the path of the source file if .wmesh comes from the derived data cache
+        // Texture paths are relative to the folder of assetFilepath, see CookStaticMesh()
+        AssetProxy ImportStaticMeshFromWMeshFile(const std::string& filepath, const std::string& assetFilepath);
+
+        // Creates GPU buffers of every submesh and uploads meshlets and vertex streams into them. Does nothing without an application
+        void UploadStaticMesh(MeshAsset* mesh);
 
         TextureImporter m_textureImporter;
+
+        // Container of the last imported embedded texture. It stays alive only while its textures are being decoded
+        std::weak_ptr<GltfImporter::GltfFile> m_lastGltfFile;
     };
 
 }
\ No newline at end of file
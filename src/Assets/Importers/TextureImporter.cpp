@@ -1,89 +1,813 @@
 #include "TextureImporter.h"
 
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
+#include <format>
 
 #include "../../Core/Application.h"
 #include "../../Util/Logger.h"
 #include "../../Core/Assert.h"
 
 #include "../../Renderer/Renderer.h"
+#include "../../Renderer/TextureStreamer.h"
 #include "../../Util/String.h"
+#include "../../Util/Timer.h"
 
-#include "Formats/ImageLoader.h"
 #include "../AssetManager.h"
+#include "../DerivedDataCache.h"
 
 #include "../../WinWrap.h"
 
 namespace Warp
 {
 
+    TextureImporter::~TextureImporter()
+    {
+        {
+            std::lock_guard lock(m_asyncMutex);
+            m_stopping = true;
+        }
+
+        // Unblock workers that wait for a free slot in the queue and let them finish
+        m_readyImageRemoved.notify_all();
+        m_threadPool.reset();
+    }
+
     AssetProxy TextureImporter::ImportFromFile(const std::string& filepath, const TextureImportDesc& importDesc)
+    {
+        EAssetFormat format = GetImportFormat(filepath);
+        if (format == EAssetFormat::Unknown)
+        {
+            return AssetProxy();
+        }
+
+        AssetManager* manager = GetAssetManager();
+        ImageSource source = ImageSource{ .Filepath = filepath };
+        ContentEntry content;
+        {
+            std::unique_lock lock(m_contentMutex);
+            AssetProxy proxy = manager->GetAssetProxy(filepath);
+            if (proxy.IsValid())
+            {
+                WARP_ASSERT(proxy.Type == EAssetType::Texture, "This should only be texture! Nothing else");
+                WARP_LOG_INFO("TextureImporter::ImportFromFile -> Returning cached asset proxy for a texture \'{}\'", filepath);
+                return proxy;
+            }
+
+            proxy = FindDuplicate(source, importDesc, content, lock);
+            if (proxy.IsValid())
+            {
+                return proxy;
+            }
+        }
+
+        CreateThreadPools(false);
+
+        // Decoded without the lock. The same file imported from two threads at once may be decoded twice, only the first one is kept
+        ImageLoader::Image image = LoadImage(source, format, importDesc);
+        if (!image.IsValid())
+        {
+            WARP_LOG_ERROR("TextureImporter::ImportFromFile -> Failed to load image from file \'{}\'", filepath);
+            return AssetProxy();
+        }
+
+        AssetProxy proxy;
+        TextureAsset* asset = nullptr;
+        {
+            std::lock_guard lock(m_contentMutex);
+            proxy = manager->GetAssetProxy(filepath);
+            if (proxy.IsValid())
+            {
+                return proxy;
+            }
+
+            proxy = manager->CreateAsset<TextureAsset>(filepath);
+            if (!proxy.IsValid())
+            {
+                WARP_LOG_ERROR("TextureImporter::ImportFromFile -> Failed to create texture asset for \'{}\'", filepath);
+                return proxy;
+            }
+
+            asset = manager->GetAs<TextureAsset>(proxy);
+            asset->Filepath = filepath;
+            AddContent(std::move(content), proxy);
+            m_textureSizes[proxy.ID] = image.GetPixelsSize();
+        }
+
+        // TODO: (14.02.2024) -> Singleton... meh
+        if (m_textureStreamer)
+        {
+            image = m_textureStreamer->AddTexture(proxy, std::move(image), importDesc.Usage);
+        }
+
+        RHICopyCommandContext& copyContext = Application::Get().GetRenderer()->GetCopyContext();
+        copyContext.BeginCopy();
+        copyContext.Open();
+        {
+            CreateTextureResources(asset, image, importDesc.Usage, copyContext);
+        }
+        copyContext.Close();
+
+        UINT64 fenceValue = copyContext.Execute(false);
+        copyContext.EndCopy(fenceValue);
+
+        return proxy;
+    }
+
+    AssetProxy TextureImporter::ImportFromFileAsync(const std::string& filepath, const TextureImportDesc& importDesc)
+    {
+        EAssetFormat format = GetImportFormat(filepath);
+        if (format == EAssetFormat::Unknown)
+        {
+            return AssetProxy();
+        }
+
+        return ImportAsync(ImageSource{ .Filepath = filepath }, format, importDesc);
+    }
+
+    AssetProxy TextureImporter::ImportFromMemoryAsync(const std::string& name, EAssetFormat format,
+        std::span<const std::byte> bytes, std::shared_ptr<const void> storage, const TextureImportDesc& importDesc)
+    {
+        if (!WinWrap::ScopedCOMLibrary::IsInitialized())
+        {
+            WARP_LOG_ERROR("TextureImporter::ImportFromMemoryAsync -> COM Library is not initialized!");
+            return AssetProxy();
+        }
+
+        if (bytes.empty() || format == EAssetFormat::Unknown)
+        {
+            WARP_LOG_ERROR("TextureImporter::ImportFromMemoryAsync -> Nothing to decode for \'{}\'", name);
+            return AssetProxy();
+        }
+
+        return ImportAsync(ImageSource{ .Filepath = name, .Bytes = bytes, .Storage = std::move(storage) }, format, importDesc);
+    }
+
+    std::string TextureImporter::MakeEmbeddedImagePath(std::string_view containerPath, size_t imageIndex)
+    {
+        return std::format("{}#{}", containerPath, imageIndex);
+    }
+
+    bool TextureImporter::ParseEmbeddedImagePath(std::string_view path, std::string& containerPath, size_t& imageIndex)
+    {
+        // Regular files may contain '#' as well, thus the whole suffix should be an index
+        size_t separator = path.rfind('#');
+        if (separator == std::string_view::npos || separator == 0 || separator + 1 == path.size())
+        {
+            return false;
+        }
+
+        std::string_view index = path.substr(separator + 1);
+        auto [end, ec] = std::from_chars(index.data(), index.data() + index.size(), imageIndex);
+        if (ec != std::errc() || end != index.data() + index.size())
+        {
+            return false;
+        }
+
+        containerPath = path.substr(0, separator);
+        return true;
+    }
+
+    AssetProxy TextureImporter::ImportAsync(ImageSource source, EAssetFormat format, const TextureImportDesc& importDesc)
+    {
+        // Placeholders are registered under the filepath as well, thus textures shared between materials are decoded only once
+        // Registration happens under the lock of the last lookup, thus a source imported from several threads at once is registered once as well
+        AssetManager* manager = GetAssetManager();
+        AssetProxy proxy;
+        {
+            std::unique_lock lock(m_contentMutex);
+            proxy = manager->GetAssetProxy(source.Filepath);
+            if (proxy.IsValid())
+            {
+                WARP_ASSERT(proxy.Type == EAssetType::Texture, "This should only be texture! Nothing else");
+                return proxy;
+            }
+
+            ContentEntry content;
+            proxy = FindDuplicate(source, importDesc, content, lock);
+            if (proxy.IsValid())
+            {
+                return proxy;
+            }
+
+            proxy = manager->CreateAsset<TextureAsset>(source.Filepath);
+            if (!proxy.IsValid())
+            {
+                WARP_LOG_ERROR("TextureImporter::ImportAsync -> Failed to create texture asset for \'{}\'", source.Filepath);
+                return proxy;
+            }
+
+            manager->GetAs<TextureAsset>(proxy)->Filepath = source.Filepath;
+            AddContent(std::move(content), proxy);
+        }
+
+        CreateThreadPools(true);
+        {
+            std::lock_guard lock(m_asyncMutex);
+            ++m_numPendingImports;
+        }
+
+        // Workers do not need to initialize COM for WIC. The main thread initializes it as multithreaded, thus workers implicitly join the MTA
+        // Workers never touch the asset manager, the proxy is only passed through to the uploader. The asset database is synchronized on its own
+        m_threadPool->Submit([this, proxy, source = std::move(source), format, importDesc]() mutable
+            {
+                {
+                    // Do not decode anything if the importer is being destroyed
+                    std::lock_guard lock(m_asyncMutex);
+                    if (m_stopping)
+                    {
+                        return;
+                    }
+                }
+
+                ImageLoader::Image image = LoadImage(source, format, importDesc);
+                if (!image.IsValid())
+                {
+                    WARP_LOG_ERROR("TextureImporter::ImportAsync -> Failed to load image \'{}\'", source.Filepath);
+                }
+
+                // Encoded image is no longer needed, let the container go before waiting for a free slot
+                source.Storage.reset();
+
+                std::unique_lock lock(m_asyncMutex);
+                m_readyImageRemoved.wait(lock, [this] { return m_stopping || m_readyImages.size() < MaxNumReadyImages; });
+                if (m_stopping)
+                {
+                    return;
+                }
+
+                m_readyImages.push_back(ReadyImage{ .Proxy = proxy, .Image = std::move(image), .Usage = importDesc.Usage });
+                m_readyImageAdded.notify_one();
+            });
+
+        return proxy;
+    }
+
+    uint32_t TextureImporter::UploadReadyTextures()
+    {
+        std::deque<ReadyImage> readyImages;
+        {
+            std::lock_guard lock(m_asyncMutex);
+            readyImages.swap(m_readyImages);
+            m_numPendingImports -= static_cast<uint32_t>(readyImages.size());
+        }
+
+        if (readyImages.empty())
+        {
+            return 0;
+        }
+
+        // Queue has been emptied, every blocked worker may proceed
+        m_readyImageRemoved.notify_all();
+
+        // There is no renderer without an application. Images are dropped and their textures stay placeholders
+        if (!Application::Exists())
+        {
+            return 0;
+        }
+
+        AssetManager* manager = GetAssetManager();
+        RHICopyCommandContext& copyContext = Application::Get().GetRenderer()->GetCopyContext();
+
+        // Every ready image is uploaded within a single submission, instead of a round trip per texture
+        uint32_t numUploaded = 0;
+        copyContext.BeginCopy();
+        copyContext.Open();
+        for (ReadyImage& readyImage : readyImages)
+        {
+            TextureAsset* asset = manager->GetAs<TextureAsset>(readyImage.Proxy);
+            if (!asset || !readyImage.Image.IsValid())
+            {
+                // Failed imports stay as non-resident placeholders, renderer treats them as missing textures
+                continue;
+            }
+
+            {
+                std::lock_guard lock(m_contentMutex);
+                m_textureSizes[readyImage.Proxy.ID] = readyImage.Image.GetPixelsSize();
+            }
+
+            if (m_textureStreamer)
+            {
+                readyImage.Image = m_textureStreamer->AddTexture(readyImage.Proxy, std::move(readyImage.Image), readyImage.Usage);
+            }
+
+            CreateTextureResources(asset, readyImage.Image, readyImage.Usage, copyContext);
+            ++numUploaded;
+        }
+        copyContext.Close();
+
+        UINT64 fenceValue = copyContext.Execute(false);
+        copyContext.EndCopy(fenceValue);
+
+        // Images can be released right away, their pixels have been copied into upload buffers while recording
+        return numUploaded;
+    }
+
+    void TextureImporter::WaitForPendingImports()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock lock(m_asyncMutex);
+                m_readyImageAdded.wait(lock, [this] { return m_numPendingImports == 0 || !m_readyImages.empty(); });
+                if (m_numPendingImports == 0)
+                {
+                    return;
+                }
+            }
+
+            UploadReadyTextures();
+        }
+    }
+
+    TextureImporter::DeduplicationStats TextureImporter::GetDeduplicationStats() const
+    {
+        std::lock_guard lock(m_contentMutex);
+        DeduplicationStats stats = m_removedStats;
+        for (const auto& [numBytes, entries] : m_contentIndex)
+        {
+            for (const ContentEntry& entry : entries)
+            {
+                stats.NumDuplicates += entry.NumDuplicates;
+                stats.SourceBytesSaved += entry.NumDuplicates * numBytes;
+
+                auto it = m_textureSizes.find(entry.Proxy.ID);
+                if (it != m_textureSizes.end())
+                {
+                    stats.TextureBytesSaved += entry.NumDuplicates * it->second;
+                }
+            }
+        }
+        return stats;
+    }
+
+    void TextureImporter::LogDeduplicationStats() const
+    {
+        DeduplicationStats stats = GetDeduplicationStats();
+        if (stats.NumDuplicates == 0)
+        {
+            return;
+        }
+
+        WARP_LOG_INFO("TextureImporter -> {} duplicate textures: {} source bytes and {} texture bytes saved",
+            stats.NumDuplicates, stats.SourceBytesSaved, stats.TextureBytesSaved);
+    }
+
+    void TextureImporter::RemoveTexture(AssetProxy proxy)
+    {
+        std::lock_guard lock(m_contentMutex);
+
+        size_t textureSize = 0;
+        if (auto it = m_textureSizes.find(proxy.ID); it != m_textureSizes.end())
+        {
+            textureSize = it->second;
+            m_textureSizes.erase(it);
+        }
+
+        auto sizeIt = m_contentSizes.find(proxy.ID);
+        if (sizeIt == m_contentSizes.end())
+        {
+            return;
+        }
+
+        uint64_t numBytes = sizeIt->second;
+        m_contentSizes.erase(sizeIt);
+
+        auto it = m_contentIndex.find(numBytes);
+        WARP_ASSERT(it != m_contentIndex.end());
+        std::erase_if(it->second, [this, proxy, numBytes, textureSize](const ContentEntry& entry)
+            {
+                if (entry.Proxy.ID != proxy.ID)
+                {
+                    return false;
+                }
+
+                m_removedStats.NumDuplicates += entry.NumDuplicates;
+                m_removedStats.SourceBytesSaved += entry.NumDuplicates * numBytes;
+                m_removedStats.TextureBytesSaved += entry.NumDuplicates * textureSize;
+                return true;
+            });
+
+        if (it->second.empty())
+        {
+            m_contentIndex.erase(it);
+        }
+    }
+
+    void TextureImporter::CreateThreadPools(bool withDecodingPool)
+    {
+        std::lock_guard lock(m_asyncMutex);
+        if (withDecodingPool && !m_threadPool)
+        {
+            m_threadPool = std::make_unique<ThreadPool>();
+        }
+
+        if (!m_compressionThreadPool)
+        {
+            m_compressionThreadPool = std::make_unique<ThreadPool>();
+        }
+    }
+
+    // Same as DerivedDataCache::HashFile(), thus embedded images and files with the same bytes are duplicates as well
+    static bool HashContent(const std::string& filepath, std::span<const std::byte> bytes, Hash128& hash)
+    {
+        Hasher128 hasher;
+        if (filepath.empty())
+        {
+            hasher.UpdateValue(static_cast<uint64_t>(bytes.size()));
+            hasher.Update(bytes.data(), bytes.size());
+        }
+        else if (!DerivedDataCache::HashFile(hasher, filepath))
+        {
+            return false;
+        }
+
+        hash = hasher.Finalize();
+        return true;
+    }
+
+    AssetProxy TextureImporter::FindDuplicate(const ImageSource& source, const TextureImportDesc& importDesc, ContentEntry& entry, std::unique_lock<std::mutex>& lock)
+    {
+        AssetManager* manager = GetAssetManager();
+        auto isCandidate = [manager, &importDesc](const ContentEntry& candidate)
+            {
+                return candidate.Desc.GenerateMips == importDesc.GenerateMips && candidate.Desc.Usage == importDesc.Usage &&
+                    manager->IsValid<TextureAsset>(candidate.Proxy);
+            };
+
+        // Other imports go on while the size is queried (or embedded bytes are hashed right away, as they are gone once the image is decoded)
+        entry = ContentEntry{ .Desc = importDesc };
+        lock.unlock();
+        bool isReadable = true;
+        if (source.Bytes.empty())
+        {
+            std::error_code ec;
+            entry.Filepath = source.Filepath;
+            entry.NumBytes = std::filesystem::file_size(source.Filepath, ec);
+            isReadable = !ec;
+        }
+        else
+        {
+            entry.NumBytes = source.Bytes.size();
+            entry.IsHashed = HashContent(entry.Filepath, source.Bytes, entry.ContentHash);
+        }
+        lock.lock();
+
+        if (!isReadable)
+        {
+            entry = ContentEntry();
+            return AssetProxy();
+        }
+
+        if (AssetProxy proxy = manager->GetAssetProxy(source.Filepath); proxy.IsValid())
+        {
+            return proxy;
+        }
+
+        // Both sides are hashed only once there is something with the same size to compare against. Candidates are copied out,
+        // as their entries may be removed while files are hashed, and their hashes are stored once the lock is taken again
+        struct UnhashedCandidate
+        {
+            uint32_t ID;
+            std::string Filepath;
+            Hash128 ContentHash;
+            bool IsHashed = false;
+        };
+
+        std::vector<UnhashedCandidate> unhashedCandidates;
+        auto it = m_contentIndex.find(entry.NumBytes);
+        if (it == m_contentIndex.end() || std::none_of(it->second.begin(), it->second.end(), isCandidate))
+        {
+            return AssetProxy();
+        }
+
+        for (const ContentEntry& candidate : it->second)
+        {
+            if (isCandidate(candidate) && !candidate.IsHashed && !candidate.Filepath.empty())
+            {
+                unhashedCandidates.push_back(UnhashedCandidate{ .ID = candidate.Proxy.ID, .Filepath = candidate.Filepath });
+            }
+        }
+
+        if (!entry.IsHashed || !unhashedCandidates.empty())
+        {
+            lock.unlock();
+            if (!entry.IsHashed)
+            {
+                entry.IsHashed = HashContent(entry.Filepath, source.Bytes, entry.ContentHash);
+            }
+
+            for (UnhashedCandidate& candidate : unhashedCandidates)
+            {
+                candidate.IsHashed = HashContent(candidate.Filepath, {}, candidate.ContentHash);
+            }
+            lock.lock();
+
+            if (!entry.IsHashed)
+            {
+                return AssetProxy();
+            }
+
+            if (AssetProxy proxy = manager->GetAssetProxy(source.Filepath); proxy.IsValid())
+            {
+                return proxy;
+            }
+        }
+
+        // Entries added meanwhile from sources of unique sizes are not hashed yet. At worst such a source is imported twice
+        it = m_contentIndex.find(entry.NumBytes);
+        if (it == m_contentIndex.end())
+        {
+            return AssetProxy();
+        }
+
+        for (ContentEntry& candidate : it->second)
+        {
+            if (!isCandidate(candidate))
+            {
+                continue;
+            }
+
+            if (!candidate.IsHashed)
+            {
+                auto hashed = std::find_if(unhashedCandidates.begin(), unhashedCandidates.end(),
+                    [&candidate](const UnhashedCandidate& unhashed) { return unhashed.ID == candidate.Proxy.ID; });
+                if (hashed != unhashedCandidates.end())
+                {
+                    candidate.IsHashed = hashed->IsHashed;
+                    candidate.ContentHash = hashed->ContentHash;
+                }
+            }
+
+            if (candidate.IsHashed && candidate.ContentHash == entry.ContentHash)
+            {
+                manager->AddFilepathAlias(source.Filepath, candidate.Proxy);
+                ++candidate.NumDuplicates;
+
+                WARP_LOG_INFO("TextureImporter::FindDuplicate -> \'{}\' has the same content as \'{}\', it is imported once",
+                    source.Filepath, manager->GetAs<TextureAsset>(candidate.Proxy)->Filepath);
+                return candidate.Proxy;
+            }
+        }
+
+        return AssetProxy();
+    }
+
+    void TextureImporter::AddContent(ContentEntry&& entry, AssetProxy proxy)
+    {
+        if (entry.NumBytes == 0)
+        {
+            return;
+        }
+
+        entry.Proxy = proxy;
+        m_contentSizes[proxy.ID] = entry.NumBytes;
+        m_contentIndex[entry.NumBytes].push_back(std::move(entry));
+    }
+
+    EAssetFormat TextureImporter::GetImportFormat(const std::string& filepath)
     {
         // 17.04.24 -> Check if COM library is available at runtime. If not - bail out and yell
         // TODO: Bad decision to do such checks. You never know when you want to support other platforms
         if (!WinWrap::ScopedCOMLibrary::IsInitialized())
         {
-            WARP_LOG_ERROR("TextureImporter::ImportFromFile -> COM Library is not initialized!");
-            return AssetProxy();
+            WARP_LOG_ERROR("TextureImporter::GetImportFormat -> COM Library is not initialized!");
+            return EAssetFormat::Unknown;
         }
 
         EAssetFormat format = GetFormat(std::filesystem::path(filepath).extension().string());
         if (format == EAssetFormat::Unknown)
         {
             WARP_LOG_ERROR("Failed to load {} as the extension is unsupported", filepath);
-            return AssetProxy();
         }
 
-        AssetManager* manager = GetAssetManager();
-        AssetProxy proxy = manager->GetAssetProxy(filepath);
-        if (proxy.IsValid())
+        return format;
+    }
+
+    ImageLoader::Image TextureImporter::LoadImage(const ImageSource& source, EAssetFormat format, const TextureImportDesc& importDesc) const
+    {
+        Timer timer;
+
+        const std::string& filepath = source.Filepath;
+        bool isEmbedded = !source.Bytes.empty();
+
+        // Decoded images with generated mips are cached as .dds, compressed ones are cached after compression
+        // DDS sources are loaded directly if they are not compressed here, there is nothing to save on them
+        DerivedDataCache* derivedDataCache = GetDerivedDataCache();
+        std::filesystem::path cachedFilepath;
+        if (derivedDataCache && derivedDataCache->IsEnabled() && (format != EAssetFormat::Dds || importDesc.Usage != eTextureUsage_Default))
         {
-            WARP_ASSERT(proxy.Type == EAssetType::Texture, "This should only be texture! Nothing else");
-            WARP_LOG_INFO("TextureImporter::ImportFromFile -> Returning cached asset proxy for a texture \'{}\'", filepath);
-            return proxy;
+            Hasher128 hasher;
+            hasher.UpdateValue(TextureImporter::DerivedDataVersion);
+            hasher.UpdateValue(static_cast<uint32_t>(importDesc.GenerateMips));
+            hasher.UpdateValue(static_cast<uint32_t>(importDesc.Usage));
+
+            // Embedded images are keyed by their encoded bytes, which are already in memory
+            if (isEmbedded)
+            {
+                hasher.Update(source.Bytes.data(), source.Bytes.size());
+                cachedFilepath = derivedDataCache->GetFilepath(eDerivedDataType_Texture, hasher.Finalize(), ".dds");
+            }
+            else if (DerivedDataCache::HashFile(hasher, filepath))
+            {
+                cachedFilepath = derivedDataCache->GetFilepath(eDerivedDataType_Texture, hasher.Finalize(), ".dds");
+            }
         }
 
         ImageLoader::Image image;
+        std::error_code ec;
+        if (!cachedFilepath.empty() && std::filesystem::exists(cachedFilepath, ec))
+        {
+            image = ImageLoader::LoadDDSFromFile(cachedFilepath.string(), false);
+            image.Filepath = filepath;
+        }
+
+        bool isCacheHit = image.IsValid();
+        if (!isCacheHit)
+        {
+            switch (format)
+            {
+            case EAssetFormat::Bmp:
+            case EAssetFormat::Png:
+            case EAssetFormat::Jpeg:
+                image = isEmbedded ?
+                    ImageLoader::LoadWICFromMemory(source.Bytes, filepath, false) :
+                    ImageLoader::LoadWICFromFile(filepath, false);
+                break;
+            case EAssetFormat::Dds:
+                image = isEmbedded ?
+                    ImageLoader::LoadDDSFromMemory(source.Bytes, filepath, false) :
+                    ImageLoader::LoadDDSFromFile(filepath, false);
+                break;
+            default: WARP_ASSERT(false, "Shouldn't happen"); break;
+            }
+
+            // Mips are filtered according to the usage here rather than by loaders, which know nothing about the content
+            if (image.IsValid() && importDesc.GenerateMips && image.GetMetadata().mipLevels == 1 && !DirectX::IsCompressed(image.GetMetadata().format))
+            {
+                Timer mipTimer;
+                if (!ImageLoader::CopyMappedImage(image) ||
+                    !ImageLoader::GenerateMips(image, GetMipGenerationDesc(image, importDesc.Usage), m_compressionThreadPool.get()))
+                {
+                    return ImageLoader::Image();
+                }
+
+                WARP_LOG_INFO("TextureImporter::LoadImage -> Generated {} mips of '{}' in {:.2f} ms",
+                    image.GetMetadata().mipLevels, filepath, mipTimer.GetElapsedMilliseconds());
+            }
+
+            // Mips are generated from uncompressed texels, thus compression comes last
+            if (image.IsValid())
+            {
+                CompressImage(image, importDesc.Usage);
+            }
+        }
+
+        if (image.IsValid() && !cachedFilepath.empty())
+        {
+            bool isCached = isCacheHit;
+            if (isCacheHit)
+            {
+                derivedDataCache->RecordHit(eDerivedDataType_Texture, timer.GetElapsedMilliseconds());
+            }
+            else
+            {
+                // The saved file is mapped back, so that pixels kept for streaming live in the page cache instead of the heap
+                if (ImageLoader::SaveDDSToFile(image, cachedFilepath.string()))
+                {
+                    isCached = true;
+                    ImageLoader::Image mapped = ImageLoader::LoadDDSFromFile(cachedFilepath.string(), false);
+                    if (mapped.IsValid())
+                    {
+                        mapped.Filepath = filepath;
+                        image = std::move(mapped);
+                    }
+                }
+                derivedDataCache->RecordMiss(eDerivedDataType_Texture, timer.GetElapsedMilliseconds());
+            }
+
+            // The texture asset may not be created yet, thus the source is registered here and the asset takes its Guid once it is
+            AssetDatabase* database = GetAssetManager()->GetAssetDatabase();
+            if (isCached && database)
+            {
+                database->SetCookedPath(database->Register(EAssetType::Texture, filepath), cachedFilepath.string());
+            }
+        }
+
+        return image;
+    }
+
+    DXGI_FORMAT TextureImporter::GetCompressedFormat(const ImageLoader::Image& image, ETextureUsage usage)
+    {
+        switch (usage)
+        {
+        case eTextureUsage_Default: return DXGI_FORMAT_UNKNOWN;
+        case eTextureUsage_Albedo: return image.DxImage.IsAlphaAllOpaque() ? DXGI_FORMAT_BC1_UNORM : DXGI_FORMAT_BC7_UNORM;
+        case eTextureUsage_Normal: return DXGI_FORMAT_BC5_UNORM;
+        case eTextureUsage_RoughnessMetalness: return ImageLoader::IsChannelZero(image, 2) ? DXGI_FORMAT_BC4_UNORM : DXGI_FORMAT_BC5_UNORM;
+        default: WARP_ASSERT(false, "Shouldn't happen"); return DXGI_FORMAT_UNKNOWN;
+        }
+    }
+
+    ImageLoader::MipGenerationDesc TextureImporter::GetMipGenerationDesc(const ImageLoader::Image& image, ETextureUsage usage)
+    {
+        // glTF discards texels with alpha below 0.5 in masked materials unless it states otherwise
+        static constexpr float AlphaCutoff = 0.5f;
+
+        switch (usage)
+        {
+        case eTextureUsage_Default: return ImageLoader::MipGenerationDesc{ .Filter = ImageLoader::eMipFilter_Box };
+        case eTextureUsage_Albedo: return ImageLoader::MipGenerationDesc{
+            .Filter = ImageLoader::eMipFilter_Kaiser,
+            .IsSrgb = true,
+            .AlphaCoverageThreshold = image.DxImage.IsAlphaAllOpaque() ? 0.0f : AlphaCutoff };
+        case eTextureUsage_Normal: return ImageLoader::MipGenerationDesc{ .Filter = ImageLoader::eMipFilter_Box, .IsNormalMap = true };
+        case eTextureUsage_RoughnessMetalness: return ImageLoader::MipGenerationDesc{ .Filter = ImageLoader::eMipFilter_Box };
+        default: WARP_ASSERT(false, "Shouldn't happen"); return ImageLoader::MipGenerationDesc();
+        }
+    }
+
+    UINT TextureImporter::GetShaderComponentMapping(ETextureUsage usage, DXGI_FORMAT format)
+    {
+        if (usage != eTextureUsage_RoughnessMetalness)
+        {
+            return D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        }
+
         switch (format)
         {
-        case EAssetFormat::Bmp:
-        case EAssetFormat::Png:
-        case EAssetFormat::Jpeg:
-            image = ImageLoader::LoadWICFromFile(filepath, importDesc.GenerateMips);
-            break;
-        default: WARP_ASSERT(false, "Shouldn't happen"); break;
+        case DXGI_FORMAT_BC5_UNORM: return D3D12_ENCODE_SHADER_4_COMPONENT_MAPPING(
+            D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_1,
+            D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_1);
+        case DXGI_FORMAT_BC4_UNORM: return D3D12_ENCODE_SHADER_4_COMPONENT_MAPPING(
+            D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_1);
+        default: return D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
         }
+    }
 
-        if (!image.IsValid())
+    void TextureImporter::CompressImage(ImageLoader::Image& image, ETextureUsage usage) const
+    {
+        if (usage == eTextureUsage_Default || DirectX::IsCompressed(image.GetMetadata().format) || !ImageLoader::CopyMappedImage(image))
         {
-            WARP_LOG_ERROR("TextureImporter::ImportFromFile -> Failed to load image from file \'{}\'", filepath);
-            return AssetProxy();
+            return;
+        }
+
+        DXGI_FORMAT format = GetCompressedFormat(image, usage);
+        if (format == DXGI_FORMAT_UNKNOWN)
+        {
+            return;
+        }
+
+        Timer timer;
+        size_t uncompressedSize = image.GetPixelsSize();
+
+        // Channels are only moved if compression succeeds, uncompressed images keep the layout of the source
+        // ImageLoader::CompressImage() leaves the image untouched on failure
+        if (usage == eTextureUsage_RoughnessMetalness)
+        {
+            ImageLoader::Image swizzled;
+            if (!ImageLoader::SwizzleGreenBlueToRedGreen(image, swizzled) || !ImageLoader::CompressImage(swizzled, format, m_compressionThreadPool.get()))
+            {
+                return;
+            }
+            image = std::move(swizzled);
+        }
+        else if (!ImageLoader::CompressImage(image, format, m_compressionThreadPool.get()))
+        {
+            return;
         }
 
-        proxy = manager->CreateAsset<TextureAsset>(filepath);
-        TextureAsset* asset = manager->GetAs<TextureAsset>(proxy);
+        WARP_LOG_INFO("TextureImporter::CompressImage -> Compressed '{}' into {} ({} -> {} bytes) in {:.2f} ms",
+            image.Filepath, static_cast<uint32_t>(format), uncompressedSize, image.GetPixelsSize(), timer.GetElapsedMilliseconds());
+    }
 
+    void TextureImporter::CreateTextureResources(TextureAsset* asset, const ImageLoader::Image& image, ETextureUsage usage, RHICopyCommandContext& copyContext)
+    {
         // TODO: (14.02.2024) -> Singleton... meh
         Renderer* renderer = Application::Get().GetRenderer();
         RHIDevice* Device = renderer->GetDevice();
 
-        const DirectX::TexMetadata& metadata = image.DxImage.GetMetadata();
+        // Misc flags of DirectXTex (e.g. cubemaps) are not resource flags, textures are only ever sampled
+        const DirectX::TexMetadata& metadata = image.GetMetadata();
         D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC();
         switch (metadata.dimension)
         {
         case DirectX::TEX_DIMENSION_TEXTURE1D: desc = CD3DX12_RESOURCE_DESC::Tex1D(metadata.format, metadata.width,
             static_cast<UINT16>(metadata.arraySize),
-            static_cast<UINT16>(metadata.mipLevels),
-            (D3D12_RESOURCE_FLAGS)metadata.miscFlags); break;
+            static_cast<UINT16>(metadata.mipLevels)); break;
         case DirectX::TEX_DIMENSION_TEXTURE2D: desc = CD3DX12_RESOURCE_DESC::Tex2D(metadata.format, metadata.width, static_cast<UINT>(metadata.height),
             static_cast<UINT16>(metadata.arraySize),
-            static_cast<UINT16>(metadata.mipLevels), 1U, 0U,
-            (D3D12_RESOURCE_FLAGS)metadata.miscFlags); break;
+            static_cast<UINT16>(metadata.mipLevels)); break;
         case DirectX::TEX_DIMENSION_TEXTURE3D: desc = CD3DX12_RESOURCE_DESC::Tex3D(metadata.format, metadata.width, static_cast<UINT>(metadata.height),
             static_cast<UINT16>(metadata.depth),
-            static_cast<UINT16>(metadata.mipLevels),
-            (D3D12_RESOURCE_FLAGS)metadata.miscFlags); break;
+            static_cast<UINT16>(metadata.mipLevels)); break;
         default: WARP_ASSERT(false); break;
         }
 
@@ -94,32 +818,71 @@ namespace Warp
         }
 
         asset->SrvAllocation = Device->GetViewHeap()->Allocate(1);
-        asset->Srv = RHIShaderResourceView(Device, &asset->Texture, nullptr, asset->SrvAllocation);
 
-        // Upload an image to an asset's texture
-        std::vector<D3D12_SUBRESOURCE_DATA> subresources;
-        for (size_t i = 0; i < image.DxImage.GetImageCount(); ++i)
+        // Remapped textures and cubemaps need an explicit view, the default one fits everything else
+        UINT componentMapping = GetShaderComponentMapping(usage, metadata.format);
+        bool isRemapped = componentMapping != D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING && metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE2D && metadata.arraySize == 1;
+        if (isRemapped || metadata.IsCubemap())
         {
-            auto subImage = image.DxImage.GetImages()[i];
-            subresources.push_back(D3D12_SUBRESOURCE_DATA{
-                .pData = subImage.pixels,
-                .RowPitch = (LONG_PTR)subImage.rowPitch,
-                .SlicePitch = (LONG_PTR)subImage.slicePitch
-                });
+            D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+            srvDesc.Format = metadata.format;
+            srvDesc.Shader4ComponentMapping = isRemapped ? componentMapping : D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            if (!metadata.IsCubemap())
+            {
+                srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+                srvDesc.Texture2D = D3D12_TEX2D_SRV{
+                    .MostDetailedMip = 0,
+                    .MipLevels = UINT(-1),
+                    .PlaneSlice = 0,
+                    .ResourceMinLODClamp = 0.0f,
+                };
+            }
+            else if (metadata.arraySize == 6)
+            {
+                srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+                srvDesc.TextureCube = D3D12_TEXCUBE_SRV{
+                    .MostDetailedMip = 0,
+                    .MipLevels = UINT(-1),
+                    .ResourceMinLODClamp = 0.0f,
+                };
+            }
+            else
+            {
+                srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBEARRAY;
+                srvDesc.TextureCubeArray = D3D12_TEXCUBE_ARRAY_SRV{
+                    .MostDetailedMip = 0,
+                    .MipLevels = UINT(-1),
+                    .First2DArrayFace = 0,
+                    .NumCubes = static_cast<UINT>(metadata.arraySize / 6),
+                    .ResourceMinLODClamp = 0.0f,
+                };
+            }
+            asset->Srv = RHIShaderResourceView(Device, &asset->Texture, &srvDesc, asset->SrvAllocation);
         }
-
-        RHICopyCommandContext& copyContext = renderer->GetCopyContext();
-        copyContext.BeginCopy();
-        copyContext.Open();
+        else
         {
-            copyContext.UploadSubresources(&asset->Texture, subresources, 0);
+            asset->Srv = RHIShaderResourceView(Device, &asset->Texture, nullptr, asset->SrvAllocation);
         }
-        copyContext.Close();
 
-        UINT64 fenceValue = copyContext.Execute(false);
-        copyContext.EndCopy(fenceValue);
+        // Upload an image to an asset's texture. Subresources of mapped DDS files are read straight from the mapping
+        // D3D12 orders subresources by array item and mip, just like DirectXTex. Volumes have a single subresource per mip though,
+        // which spans every slice of the mip, as slices are stored one after another
+        std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+        subresources.reserve(metadata.arraySize * metadata.mipLevels);
+        for (size_t item = 0; item < metadata.arraySize; ++item)
+        {
+            for (size_t mip = 0; mip < metadata.mipLevels; ++mip)
+            {
+                const DirectX::Image& subImage = image.GetImages()[metadata.ComputeIndex(mip, item, 0)];
+                subresources.push_back(D3D12_SUBRESOURCE_DATA{
+                    .pData = subImage.pixels,
+                    .RowPitch = (LONG_PTR)subImage.rowPitch,
+                    .SlicePitch = (LONG_PTR)subImage.slicePitch
+                    });
+            }
+        }
 
-        return proxy;
+        copyContext.UploadSubresources(&asset->Texture, subresources, 0);
     }
 
 }
\ No newline at end of file
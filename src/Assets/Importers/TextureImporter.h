@@ -1,30 +1,210 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 #include "AssetImporter.h"
+#include "Formats/ImageLoader.h"
+#include "Formats/MipGenerator.h"
+
+#include "../../Util/Hash.h"
+#include "../../Util/ThreadPool.h"
 
 namespace Warp
 {
 
+    struct TextureAsset;
+    class RHICopyCommandContext;
+    class TextureStreamer;
+
+    // Material slot a texture is sampled in. Decides the block-compressed format of the texture
+    enum ETextureUsage : uint32_t
+    {
+        eTextureUsage_Default = 0, // Kept uncompressed
+        eTextureUsage_Albedo, // BC1 if opaque, BC7 otherwise
+        eTextureUsage_Normal, // BC5, shaders reconstruct Z
+        eTextureUsage_RoughnessMetalness, // BC5, or BC4 if there is no metalness. Channels are restored by the SRV, see GetShaderComponentMapping()
+        eTextureUsage_NumUsages,
+    };
+
     struct TextureImportDesc
     {
         bool GenerateMips = false;
+        ETextureUsage Usage = eTextureUsage_Default;
     };
 
     class TextureImporter : public AssetImporter
     {
     public:
         TextureImporter() = default;
-        TextureImporter(AssetManager* assetManager)
-            : AssetImporter(assetManager)
+        TextureImporter(AssetManager* assetManager, DerivedDataCache* derivedDataCache = nullptr)
+            : AssetImporter(assetManager, derivedDataCache)
         {
             // Add importer's supported formats here
             AddFormat(".bmp", EAssetFormat::Bmp);
             AddFormat(".png", EAssetFormat::Png);
             AddFormat(".jpg", EAssetFormat::Jpeg);
             AddFormat(".jpeg", EAssetFormat::Jpeg);
+            AddFormat(".dds", EAssetFormat::Dds);
         }
 
+        TextureImporter(const TextureImporter&) = delete;
+        TextureImporter& operator=(const TextureImporter&) = delete;
+
+        // Waits for the decoding tasks that are still running, their images are dropped
+        ~TextureImporter();
+
+        // Part of the derived data key. Bump it whenever processing of images changes, so that stale cached images are not used
+        static constexpr uint32_t DerivedDataVersion = 3;
+
+        // Maximum number of decoded images waiting for the upload. Decoding workers block when the queue is full,
+        // which bounds the memory held by decoded images if the uploader falls behind
+        static constexpr size_t MaxNumReadyImages = 16;
+
+        // Decodes, processes and uploads the texture before returning
         AssetProxy ImportFromFile(const std::string& filepath, const TextureImportDesc& importDesc);
+
+        // Returns a placeholder proxy immediately. The image is decoded and processed on worker threads afterwards
+        // The placeholder is a valid TextureAsset that is not resident (see TextureAsset::IsResident()) until UploadReadyTextures() picks its image up
+        AssetProxy ImportFromFileAsync(const std::string& filepath, const TextureImportDesc& importDesc);
+
+        // Same as ImportFromFileAsync(), but for an encoded image that is stored inside of another file (e.g. embedded into .glb)
+        // The image is decoded straight from bytes. storage owns the memory of bytes and is kept alive until decoding is finished
+        // name is the key of the asset in the asset manager, see MakeEmbeddedImagePath()
+        AssetProxy ImportFromMemoryAsync(const std::string& name, EAssetFormat format,
+            std::span<const std::byte> bytes, std::shared_ptr<const void> storage, const TextureImportDesc& importDesc);
+
+        // Embedded images are named after their container and their index inside of it, e.g. "Assets/Scene.glb#3"
+        // The name is stored as the filepath of the texture asset, thus cooked meshes can find the image again
+        static std::string MakeEmbeddedImagePath(std::string_view containerPath, size_t imageIndex);
+
+        // Returns false if the path was not created by MakeEmbeddedImagePath()
+        static bool ParseEmbeddedImagePath(std::string_view path, std::string& containerPath, size_t& imageIndex);
+
+        // Returns DXGI_FORMAT_UNKNOWN if images of the usage stay uncompressed. Expects pixels in DxImage, see ImageLoader::CopyMappedImage()
+        static DXGI_FORMAT GetCompressedFormat(const ImageLoader::Image& image, ETextureUsage usage);
+
+        // Albedo is filtered in linear space with a Kaiser filter and keeps alpha coverage of cutouts, normal maps are renormalized
+        // Expects pixels in DxImage, see ImageLoader::CopyMappedImage()
+        static ImageLoader::MipGenerationDesc GetMipGenerationDesc(const ImageLoader::Image& image, ETextureUsage usage);
+
+        // Compressed roughness-metalness images store roughness in red and metalness in green (if any). The SRV maps them back to green and blue,
+        // where glTF has them, so that shaders do not depend on the format of the texture. Expects such images to be compressed by this importer
+        static UINT GetShaderComponentMapping(ETextureUsage usage, DXGI_FORMAT format);
+
+        // Creates GPU texture and its SRV and records the upload of the image into an open copy context
+        // Previous texture and SRV of the asset are overwritten, callers that replace textures in use should keep them alive until the GPU is done
+        static void CreateTextureResources(TextureAsset* asset, const ImageLoader::Image& image, ETextureUsage usage, RHICopyCommandContext& copyContext);
+
+        // Imported textures hand their full mip chains to the streamer and only upload the initial mips. nullptr keeps every mip resident
+        inline void SetTextureStreamer(TextureStreamer* streamer) { m_textureStreamer = streamer; }
+
+        // Uploads every image that has been decoded so far within a single copy submission and makes their textures resident
+        // Should be called from the thread that owns the copy context. Returns the number of textures that became resident
+        // Without an application the images are taken from the queue and dropped, see Application::Exists()
+        uint32_t UploadReadyTextures();
+
+        // Blocks until every asynchronous import has finished, uploading textures as they get ready
+        void WaitForPendingImports();
+
+        inline bool HasPendingImports() const { std::lock_guard lock(m_asyncMutex); return m_numPendingImports > 0; }
+
+        struct DeduplicationStats
+        {
+            uint32_t NumDuplicates = 0; // Imports that were resolved to a texture imported from identical bytes
+            size_t SourceBytesSaved = 0; // Encoded bytes that were not decoded again
+            size_t TextureBytesSaved = 0; // Processed texels that were not uploaded again. Only counts textures that have been uploaded
+        };
+
+        DeduplicationStats GetDeduplicationStats() const;
+        void LogDeduplicationStats() const;
+
+        // Forgets the content and the size of a texture that is being destroyed, thus later imports of the same bytes do not resolve to it
+        // Stats of its duplicates are kept. Called by AssetReleaseQueue for every destroyed texture, others are ignored
+        void RemoveTexture(AssetProxy proxy);
+
+    private:
+        // Returns the format of the file or EAssetFormat::Unknown if it cannot be imported
+        EAssetFormat GetImportFormat(const std::string& filepath);
+
+        // Image is either a file, or a memory block inside of another file if Bytes are not empty
+        struct ImageSource
+        {
+            std::string Filepath; // Embedded images use the name created with MakeEmbeddedImagePath()
+            std::span<const std::byte> Bytes;
+            std::shared_ptr<const void> Storage; // Owns the memory of Bytes
+        };
+
+        // Identical sources (e.g. placeholder images copied under different names) are imported once. Content is only hashed once another
+        // source of the same size and desc shows up, thus unique textures cost a file size query. The index is guarded by m_contentMutex
+        struct ContentEntry
+        {
+            AssetProxy Proxy;
+            TextureImportDesc Desc;
+            std::string Filepath; // Empty for embedded sources, which are hashed right away as their bytes are in memory
+            uint64_t NumBytes = 0;
+            Hash128 ContentHash;
+            bool IsHashed = false;
+            uint32_t NumDuplicates = 0;
+        };
+
+        // Returns a texture imported from the same bytes with the same desc, if there is one. Otherwise fills entry, which should be
+        // added with AddContent() once the asset exists. Returns invalid proxy and leaves entry empty if the source cannot be read
+        // Expects lock to hold m_contentMutex. Files are read with the lock released, thus the source may be imported by another thread meanwhile,
+        // in which case its texture is returned. The lock is held again on return, so that the caller registers the asset under the same lock
+        AssetProxy FindDuplicate(const ImageSource& source, const TextureImportDesc& importDesc, ContentEntry& entry, std::unique_lock<std::mutex>& lock);
+
+        // Expects m_contentMutex to be locked by the caller
+        void AddContent(ContentEntry&& entry, AssetProxy proxy);
+
+        // Creates the compression pool, and the decoding pool if asked to, unless they exist already. Safe to call from any importing thread
+        void CreateThreadPools(bool withDecodingPool);
+
+        // Registers a placeholder asset and schedules decoding of the image on the thread pool
+        AssetProxy ImportAsync(ImageSource source, EAssetFormat format, const TextureImportDesc& importDesc);
+
+        // Decodes the image (or fetches it from the derived data cache) and processes it. Does not touch the asset manager, thus it is safe to call from workers
+        ImageLoader::Image LoadImage(const ImageSource& source, EAssetFormat format, const TextureImportDesc& importDesc) const;
+
+        // Block-compresses the image according to its usage. Images that cannot be compressed are left as they are
+        void CompressImage(ImageLoader::Image& image, ETextureUsage usage) const;
+
+        struct ReadyImage
+        {
+            AssetProxy Proxy;
+            ImageLoader::Image Image; // Invalid if decoding failed
+            ETextureUsage Usage;
+        };
+
+        TextureStreamer* m_textureStreamer = nullptr;
+
+        // Imports may be started from several threads, e.g. while meshes of a scene import their materials
+        mutable std::mutex m_contentMutex;
+        std::unordered_map<uint64_t, std::vector<ContentEntry>> m_contentIndex; // Sizes of sources in bytes to sources
+        std::unordered_map<uint32_t, uint64_t> m_contentSizes; // Asset IDs to the keys of their entries in m_contentIndex
+        std::unordered_map<uint32_t, size_t> m_textureSizes; // Asset IDs to processed texels of uploaded textures
+        DeduplicationStats m_removedStats; // Duplicates of textures that have been removed
+
+        // Pools are created on first use under m_asyncMutex (see CreateThreadPools()) and never replaced afterwards, thus they are used without it
+        std::unique_ptr<ThreadPool> m_threadPool; // Created on first async import
+
+        // Mip generation and compression split every image across these workers. Decoding workers wait for them, thus they cannot share a pool
+        std::unique_ptr<ThreadPool> m_compressionThreadPool; // Created on first import
+
+        mutable std::mutex m_asyncMutex;
+        std::condition_variable m_readyImageAdded;
+        std::condition_variable m_readyImageRemoved;
+        std::deque<ReadyImage> m_readyImages;
+        uint32_t m_numPendingImports = 0; // Imports that were not picked up by the uploader yet
+        bool m_stopping = false;
     };
 
 }
\ No newline at end of file
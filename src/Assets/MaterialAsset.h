@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Asset.h"
+#include "AssetHandle.h"
 #include "../Math/Math.h"
 
 namespace Warp
@@ -18,9 +19,10 @@ namespace Warp
         bool HasNormalMap() const { return NormalMap.IsValid(); }
         bool HasRoughnessMetalnessMap() const { return RoughnessMetalnessMap.IsValid(); }
 
-        AssetProxy AlbedoMap;
-        AssetProxy NormalMap;
-        AssetProxy RoughnessMetalnessMap;
+        // Materials keep their textures alive
+        AssetHandle AlbedoMap;
+        AssetHandle NormalMap;
+        AssetHandle RoughnessMetalnessMap;
 
         Math::Vector4 Albedo;
         Math::Vector2 RoughnessMetalness;
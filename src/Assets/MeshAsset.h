@@ -1,20 +1,75 @@
 #pragma once
 
 #include <array>
+#include <span>
+#include <vector>
 #include <DirectXMesh/DirectXMesh.h>
 
 #include "Asset.h"
+#include "AssetHandle.h"
+#include "../Math/Math.h"
 #include "../Renderer/RHI/Resource.h"
 #include "../Renderer/Vertex.h"
+#include "../Util/MappedFile.h"
 
 namespace Warp
 {
 
-    struct Submesh
+    // Upper bound of both unique vertices and primitives per meshlet. Mesh shaders are compiled for every size, see Renderer::InitBase()
+    // Larger meshlets share more vertices between triangles, smaller ones are culled at a finer granularity
+    enum EMeshletSize : uint32_t
+    {
+        eMeshletSize_64 = 0,
+        eMeshletSize_128,
+        eMeshletSize_256,
+        eMeshletSize_NumSizes,
+    };
+
+    inline constexpr uint32_t GetMeshletMaxElements(EMeshletSize size) { return 64u << size; }
+
+    // A level of detail of a submesh. Every level indexes the vertex streams of its submesh, as simplification only collapses
+    // vertices into other existing vertices, thus levels only differ in meshlets. See Math/MeshSimplification.h
+    struct SubmeshLod
     {
         uint32_t GetNumMeshlets() const { return static_cast<uint32_t>(Meshlets.size()); }
+
+        std::span<const DirectX::Meshlet> Meshlets;
+        std::span<const uint8_t> UniqueVertexIndices;
+        std::span<const DirectX::MeshletTriangle> PrimitiveIndices;
+
+        // Bounding sphere and normal cone of each meshlet, MeshletCullData[i] belongs to Meshlets[i]. In model space
+        // Kept as a separate stream, so that culling does not touch meshlets themselves. See Math/MeshletCulling.h
+        std::span<const DirectX::CullData> MeshletCullData;
+
+        uint32_t NumTriangles = 0;
+
+        // Upper bound of the model space distance between this level and the full detail level, 0 for the full detail level
+        float Error = 0.0f;
+
+        RHIBuffer MeshletBuffer;
+        RHIBuffer UniqueVertexIndicesBuffer;
+        RHIBuffer PrimitiveIndicesBuffer;
+    };
+
+    struct Submesh
+    {
+        uint32_t GetNumLods() const { return static_cast<uint32_t>(Lods.size()); }
         uint32_t GetNumVertices() const { return NumVertices; }
         bool HasAttributes(size_t index) const { return !Attributes[index].empty(); }
+        bool Has16BitUniqueVertexIndices() const { return UniqueVertexIndexStride == sizeof(uint16_t); }
+
+        // Streams are either all quantized or all stored as floats, see StaticMeshImportDesc::QuantizeVertices
+        bool HasQuantizedAttributes() const { return AttributeEncodings[eVertexAttribute_Positions] != eVertexEncoding_Float; }
+
+        // Transforms unorm positions into model space, identity if positions are not quantized
+        Math::Matrix GetPositionDequantizeMatrix() const
+        {
+            if (!HasQuantizedAttributes())
+            {
+                return Math::Matrix::Identity;
+            }
+            return Math::Matrix::CreateScale(PositionsExtent) * Math::Matrix::CreateTranslation(PositionsMin);
+        }
 
         uint32_t NumVertices = 0;
 
@@ -22,17 +77,78 @@ namespace Warp
         using AttributeArray = std::array<T, eVertexAttribute_NumAttributes>;
 
         // SoA representation of mesh vertices
-        AttributeArray<std::vector<std::byte>> Attributes;
+        // CPU-side streams do not own memory, they are views into the MeshPayload of the owning MeshAsset
+        AttributeArray<std::span<const std::byte>> Attributes;
         AttributeArray<uint32_t>  AttributeStrides{};
+        AttributeArray<EVertexEncoding> AttributeEncodings{}; // Strides match encodings, see GetVertexStride()
         AttributeArray<RHIBuffer> Resources;
 
-        std::vector<DirectX::Meshlet> Meshlets;
-        std::vector<uint8_t> UniqueVertexIndices;
-        std::vector<DirectX::MeshletTriangle> PrimitiveIndices;
+        // Bounds that quantized positions are relative to. Model space position is PositionsMin + PositionsExtent * unorm
+        Math::Vector3 PositionsMin;
+        Math::Vector3 PositionsExtent;
 
-        RHIBuffer MeshletBuffer;
-        RHIBuffer UniqueVertexIndicesBuffer;
-        RHIBuffer PrimitiveIndicesBuffer;
+        uint32_t UniqueVertexIndexStride = sizeof(uint32_t); // Submeshes with fewer than 65535 vertices use 16-bit indices
+        EMeshletSize MeshletSize = eMeshletSize_128; // The same for every level of detail
+
+        // Model space bounds of the submesh, used to estimate the screen space error of its levels of detail
+        DirectX::BoundingSphere BoundingSphere;
+
+        // Lods[0] is the full detail level, every next one is coarser. There is always at least one level
+        std::vector<SubmeshLod> Lods;
+    };
+
+    // Contiguous CPU memory that stores every stream of every submesh of a mesh, each stream starts at MeshPayload::Alignment
+    // Imported meshes own a heap allocation, cooked meshes (.wmesh) keep their file mapped and submeshes view the mapping directly
+    class MeshPayload
+    {
+    public:
+        static constexpr size_t Alignment = 16;
+
+        static constexpr size_t AlignUp(size_t numBytes) { return (numBytes + Alignment - 1) & ~(Alignment - 1); }
+
+        MeshPayload() = default;
+
+        // Allocates numBytes of zero-initialized heap memory that is filled by the importer
+        explicit MeshPayload(size_t numBytes)
+            : m_storage(numBytes)
+            , m_bytes(m_storage)
+        {
+        }
+
+        // Takes ownership of memory filled by the importer
+        explicit MeshPayload(std::vector<std::byte>&& storage)
+            : m_storage(std::move(storage))
+            , m_bytes(m_storage)
+        {
+        }
+
+        // Takes ownership of the mapping. The whole mapped file is considered a payload
+        explicit MeshPayload(MappedFile&& mapping)
+            : m_mapping(std::move(mapping))
+            , m_bytes(m_mapping.GetBytes())
+        {
+        }
+
+        MeshPayload(const MeshPayload&) = delete;
+        MeshPayload& operator=(const MeshPayload&) = delete;
+
+        // Moving both vector and mapping keeps the underlying memory in place, thus views stay valid
+        MeshPayload(MeshPayload&&) noexcept = default;
+        MeshPayload& operator=(MeshPayload&&) noexcept = default;
+
+        inline bool IsMapped() const { return m_mapping.IsValid(); }
+        inline std::span<const std::byte> GetBytes() const { return m_bytes; }
+
+        // Only heap payloads are writable. Mapped payloads are read-only
+        inline std::span<std::byte> GetMutableBytes() { return m_storage; }
+
+        // Returns an offset of the view inside of the payload
+        inline size_t GetOffsetOf(std::span<const std::byte> view) const { return static_cast<size_t>(view.data() - m_bytes.data()); }
+
+    private:
+        std::vector<std::byte> m_storage;
+        MappedFile m_mapping;
+        std::span<const std::byte> m_bytes;
     };
 
     struct MeshAsset : Asset
@@ -44,9 +160,13 @@ namespace Warp
         uint32_t GetNumSubmeshes() const { return static_cast<uint32_t>(Submeshes.size()); }
 
         // It is safe to assume that Submeshes.size() == SubmeshMaterials.size();
+        // Meshes keep their materials alive
         std::string Name;
         std::vector<Submesh> Submeshes;
-        std::vector<AssetProxy> SubmeshMaterials;
+        std::vector<AssetHandle> SubmeshMaterials;
+
+        // Backing memory of CPU-side submesh streams. Should outlive Submeshes
+        MeshPayload Payload;
     };
 
 }
\ No newline at end of file
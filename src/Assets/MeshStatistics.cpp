@@ -0,0 +1,143 @@
+#include "MeshStatistics.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "../Core/Assert.h"
+
+namespace Warp
+{
+
+    template<typename IndexType>
+    static VertexCacheStatistics AnalyzeVertexCacheImpl(std::span<const IndexType> indices, uint32_t numVertices, uint32_t cacheSize)
+    {
+        WARP_ASSERT(cacheSize > 0);
+
+        VertexCacheStatistics statistics;
+        statistics.NumTriangles = indices.size() / 3;
+        statistics.NumVertices = numVertices;
+
+        // A vertex is in the FIFO cache until cacheSize misses happened since it was inserted, its own miss included
+        // Timestamps start far enough in the past for every vertex to miss on its first use
+        std::vector<uint64_t> insertedAt(numVertices, 0);
+        const uint64_t firstMiss = uint64_t(cacheSize) + 1;
+        uint64_t numMisses = firstMiss;
+        for (size_t i = 0; i < statistics.NumTriangles * 3; ++i)
+        {
+            IndexType index = indices[i];
+            WARP_ASSERT(index < numVertices);
+            if (numMisses - insertedAt[index] > cacheSize)
+            {
+                insertedAt[index] = numMisses++;
+            }
+        }
+
+        statistics.NumTransformedVertices = numMisses - firstMiss;
+        return statistics;
+    }
+
+    VertexCacheStatistics& VertexCacheStatistics::operator+=(const VertexCacheStatistics& other)
+    {
+        NumTransformedVertices += other.NumTransformedVertices;
+        NumTriangles += other.NumTriangles;
+        NumVertices += other.NumVertices;
+        return *this;
+    }
+
+    VertexCacheStatistics AnalyzeVertexCache(std::span<const uint16_t> indices, uint32_t numVertices, uint32_t cacheSize)
+    {
+        return AnalyzeVertexCacheImpl(indices, numVertices, cacheSize);
+    }
+
+    VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t numVertices, uint32_t cacheSize)
+    {
+        return AnalyzeVertexCacheImpl(indices, numVertices, cacheSize);
+    }
+
+    MeshletStatistics& MeshletStatistics::operator+=(const MeshletStatistics& other)
+    {
+        NumMeshlets += other.NumMeshlets;
+        NumMeshletSlots += other.NumMeshletSlots;
+        NumMeshletVertices += other.NumMeshletVertices;
+        NumMeshletPrimitives += other.NumMeshletPrimitives;
+        NumVertices += other.NumVertices;
+        NumFetchedBytes += other.NumFetchedBytes;
+        NumStreamBytes += other.NumStreamBytes;
+        return *this;
+    }
+
+    MeshletStatistics AnalyzeMeshlets(
+        std::span<const DirectX::Meshlet> meshlets,
+        std::span<const uint8_t> uniqueVertexIndices,
+        uint32_t uniqueVertexIndexStride,
+        uint32_t numVertices,
+        uint32_t positionStride,
+        EMeshletSize meshletSize,
+        uint32_t cacheLineSize)
+    {
+        WARP_ASSERT(uniqueVertexIndexStride == sizeof(uint16_t) || uniqueVertexIndexStride == sizeof(uint32_t));
+        WARP_ASSERT(cacheLineSize > 0);
+
+        MeshletStatistics statistics;
+        statistics.NumMeshlets = meshlets.size();
+        statistics.NumMeshletSlots = meshlets.size() * GetMeshletMaxElements(meshletSize);
+        statistics.NumVertices = numVertices;
+        statistics.NumStreamBytes = uint64_t(numVertices) * positionStride;
+
+        // Cache lines touched by the current meshlet. A position may straddle two lines
+        std::vector<uint64_t> cacheLines;
+        for (const DirectX::Meshlet& meshlet : meshlets)
+        {
+            statistics.NumMeshletVertices += meshlet.VertCount;
+            statistics.NumMeshletPrimitives += meshlet.PrimCount;
+
+            cacheLines.clear();
+            for (uint32_t i = 0; i < meshlet.VertCount; ++i)
+            {
+                size_t offset = size_t(meshlet.VertOffset + i) * uniqueVertexIndexStride;
+                WARP_ASSERT(offset + uniqueVertexIndexStride <= uniqueVertexIndices.size());
+
+                uint32_t vertexIndex;
+                if (uniqueVertexIndexStride == sizeof(uint16_t))
+                {
+                    uint16_t index16;
+                    std::memcpy(&index16, uniqueVertexIndices.data() + offset, sizeof(index16));
+                    vertexIndex = index16;
+                }
+                else
+                {
+                    std::memcpy(&vertexIndex, uniqueVertexIndices.data() + offset, sizeof(vertexIndex));
+                }
+
+                uint64_t firstByte = uint64_t(vertexIndex) * positionStride;
+                for (uint64_t line = firstByte / cacheLineSize; line <= (firstByte + positionStride - 1) / cacheLineSize; ++line)
+                {
+                    cacheLines.push_back(line);
+                }
+            }
+
+            std::sort(cacheLines.begin(), cacheLines.end());
+            size_t numUniqueLines = std::unique(cacheLines.begin(), cacheLines.end()) - cacheLines.begin();
+            statistics.NumFetchedBytes += uint64_t(numUniqueLines) * cacheLineSize;
+        }
+
+        return statistics;
+    }
+
+    MeshletStatistics AnalyzeMeshlets(const Submesh& submesh, uint32_t lodIndex, uint32_t cacheLineSize)
+    {
+        WARP_ASSERT(lodIndex < submesh.GetNumLods());
+
+        const SubmeshLod& lod = submesh.Lods[lodIndex];
+        return AnalyzeMeshlets(
+            lod.Meshlets,
+            lod.UniqueVertexIndices,
+            submesh.UniqueVertexIndexStride,
+            submesh.GetNumVertices(),
+            submesh.AttributeStrides[eVertexAttribute_Positions],
+            submesh.MeshletSize,
+            cacheLineSize);
+    }
+
+}
\ No newline at end of file
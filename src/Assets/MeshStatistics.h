@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <DirectXMesh/DirectXMesh.h>
+
+#include "MeshAsset.h"
+
+// Measurements of how well index and meshlet data of a submesh suits the GPU. Used by the mesh importer to report the outcome
+// of optimization, see StaticMeshImportDesc::ReportStatistics. Statistics keep raw counts, so that they can be summed over submeshes
+namespace Warp
+{
+
+    // The cache size that DirectXMesh::OptimizeFaces() optimizes for by default, so that reports measure what the importer optimized for
+    static constexpr uint32_t DefaultVertexCacheSize = DirectX::OPTFACES_V_DEFAULT;
+
+    struct VertexCacheStatistics
+    {
+        // Average cache miss ratio, vertex shader invocations per triangle. 0.5 is the limit for large regular grids, 3 is the worst case
+        float GetAcmr() const { return NumTriangles == 0 ? 0.0f : static_cast<float>(NumTransformedVertices) / NumTriangles; }
+
+        // Average transformed vertex ratio, vertex shader invocations per vertex. 1 is ideal
+        float GetAtvr() const { return NumVertices == 0 ? 0.0f : static_cast<float>(NumTransformedVertices) / NumVertices; }
+
+        VertexCacheStatistics& operator+=(const VertexCacheStatistics& other);
+
+        uint64_t NumTransformedVertices = 0;
+        uint64_t NumTriangles = 0;
+        uint64_t NumVertices = 0;
+    };
+
+    // Simulates a FIFO post-transform vertex cache of cacheSize entries over the triangle list
+    VertexCacheStatistics AnalyzeVertexCache(std::span<const uint16_t> indices, uint32_t numVertices, uint32_t cacheSize = DefaultVertexCacheSize);
+    VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t numVertices, uint32_t cacheSize = DefaultVertexCacheSize);
+
+    struct MeshletStatistics
+    {
+        // Average number of unique vertices and primitives per meshlet relative to the meshlet size. 1 means every meshlet is full
+        float GetVertexFill() const { return NumMeshletSlots == 0 ? 0.0f : static_cast<float>(NumMeshletVertices) / NumMeshletSlots; }
+        float GetPrimitiveFill() const { return NumMeshletSlots == 0 ? 0.0f : static_cast<float>(NumMeshletPrimitives) / NumMeshletSlots; }
+
+        // Vertices shaded by mesh shaders per vertex of the submesh. Vertices shared between meshlets are shaded by each of them, 1 is ideal
+        float GetVertexDuplication() const { return NumVertices == 0 ? 0.0f : static_cast<float>(NumMeshletVertices) / NumVertices; }
+
+        // Bytes of the position stream fetched per byte of the stream, 1 is ideal
+        // Every meshlet is assumed to fetch whole cache lines on its own, as meshlets run on different thread groups
+        float GetOverfetch() const { return NumStreamBytes == 0 ? 0.0f : static_cast<float>(NumFetchedBytes) / NumStreamBytes; }
+
+        MeshletStatistics& operator+=(const MeshletStatistics& other);
+
+        uint64_t NumMeshlets = 0;
+        uint64_t NumMeshletSlots = 0; // Meshlets times their maximum number of vertices (primitives)
+        uint64_t NumMeshletVertices = 0;
+        uint64_t NumMeshletPrimitives = 0;
+        uint64_t NumVertices = 0;
+        uint64_t NumFetchedBytes = 0;
+        uint64_t NumStreamBytes = 0;
+    };
+
+    static constexpr uint32_t DefaultCacheLineSize = 64;
+
+    // uniqueVertexIndices are 16-bit or 32-bit depending on uniqueVertexIndexStride. positionStride is the size of a position in bytes
+    MeshletStatistics AnalyzeMeshlets(
+        std::span<const DirectX::Meshlet> meshlets,
+        std::span<const uint8_t> uniqueVertexIndices,
+        uint32_t uniqueVertexIndexStride,
+        uint32_t numVertices,
+        uint32_t positionStride,
+        EMeshletSize meshletSize,
+        uint32_t cacheLineSize = DefaultCacheLineSize);
+
+    // Same as above for a level of detail of an imported or cooked submesh
+    MeshletStatistics AnalyzeMeshlets(const Submesh& submesh, uint32_t lodIndex, uint32_t cacheLineSize = DefaultCacheLineSize);
+
+}
\ No newline at end of file
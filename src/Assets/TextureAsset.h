@@ -16,6 +16,12 @@ namespace Warp
 
         TextureAsset(uint32_t ID) : Asset(ID, StaticType) {}
 
+        // Asynchronously imported textures are placeholders until their image is uploaded. Non-resident textures should be treated as missing
+        inline bool IsResident() const { return Texture.IsValid(); }
+
+        // Source file the texture was imported from. Used to reference textures from cooked assets
+        std::string Filepath;
+
         RHITexture Texture;
         RHIDescriptorAllocation SrvAllocation;
         RHIShaderResourceView Srv;
@@ -0,0 +1,345 @@
+#include "VertexQuantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <DirectXPackedVector.h>
+
+#include "../Core/Assert.h"
+
+namespace Warp
+{
+
+    static constexpr float Unorm16Max = 65535.0f;
+    static constexpr float Snorm16Max = 32767.0f;
+
+    // Streams of the payload are not guaranteed to be aligned to their elements, thus every read goes through memcpy
+    template<typename T>
+    static T LoadElement(std::span<const std::byte> stream, size_t offset)
+    {
+        WARP_ASSERT(offset + sizeof(T) <= stream.size());
+        T value;
+        std::memcpy(&value, stream.data() + offset, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    static void StoreElement(std::vector<std::byte>& stream, size_t offset, const T& value)
+    {
+        std::memcpy(stream.data() + offset, &value, sizeof(T));
+    }
+
+    static float GetAngleInDegrees(const Math::Vector3& a, const Math::Vector3& b)
+    {
+        float lengths = a.Length() * b.Length();
+        if (lengths == 0.0f)
+        {
+            return 0.0f;
+        }
+
+        float cosine = Math::Clamp(a.Dot(b) / lengths, -1.0f, 1.0f);
+        return std::acos(cosine) * (180.0f / Math::Pi);
+    }
+
+    float PositionBounds::GetMaxError() const
+    {
+        // Half of the quantization step along every axis
+        return (Extent * (0.5f / Unorm16Max)).Length();
+    }
+
+    PositionBounds ComputePositionBounds(std::span<const Math::Vector3> positions)
+    {
+        if (positions.empty())
+        {
+            return PositionBounds();
+        }
+
+        Math::Vector3 min = positions[0];
+        Math::Vector3 max = positions[0];
+        for (const Math::Vector3& position : positions)
+        {
+            min = Math::Vector3::Min(min, position);
+            max = Math::Vector3::Max(max, position);
+        }
+        return PositionBounds{ .Min = min, .Extent = max - min };
+    }
+
+    uint32_t EncodeOct16(const Math::Vector3& v)
+    {
+        auto pack = [](float x, float y) -> uint32_t
+            {
+                int16_t ix = static_cast<int16_t>(Math::Clamp(x, -Snorm16Max, Snorm16Max));
+                int16_t iy = static_cast<int16_t>(Math::Clamp(y, -Snorm16Max, Snorm16Max));
+                return uint32_t(uint16_t(ix)) | (uint32_t(uint16_t(iy)) << 16);
+            };
+
+        float l1 = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+        if (l1 == 0.0f)
+        {
+            return pack(0.0f, 0.0f);
+        }
+
+        // Project the sphere onto the octahedron and then onto the xy plane, folding the lower hemisphere over the diagonals
+        float px = v.x / l1;
+        float py = v.y / l1;
+        if (v.z <= 0.0f)
+        {
+            float fx = (1.0f - std::abs(py)) * (px >= 0.0f ? 1.0f : -1.0f);
+            float fy = (1.0f - std::abs(px)) * (py >= 0.0f ? 1.0f : -1.0f);
+            px = fx;
+            py = fy;
+        }
+
+        // Rounding to the nearest value is not always the closest direction, try every neighbour
+        float x = std::floor(px * Snorm16Max);
+        float y = std::floor(py * Snorm16Max);
+        Math::Vector3 direction = v / v.Length();
+
+        uint32_t best = 0;
+        float bestCosine = -std::numeric_limits<float>::infinity();
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            uint32_t candidate = pack(x + float(i & 1), y + float(i >> 1));
+            float cosine = DecodeOct16(candidate).Dot(direction);
+            if (cosine > bestCosine)
+            {
+                best = candidate;
+                bestCosine = cosine;
+            }
+        }
+        return best;
+    }
+
+    Math::Vector3 DecodeOct16(uint32_t encoded)
+    {
+        float x = std::max(float(int16_t(encoded & 0xFFFF)) / Snorm16Max, -1.0f);
+        float y = std::max(float(int16_t(encoded >> 16)) / Snorm16Max, -1.0f);
+
+        Math::Vector3 v = Math::Vector3(x, y, 1.0f - std::abs(x) - std::abs(y));
+        if (v.z < 0.0f)
+        {
+            v.x = (1.0f - std::abs(y)) * (x > 0.0f ? 1.0f : -1.0f);
+            v.y = (1.0f - std::abs(x)) * (y > 0.0f ? 1.0f : -1.0f);
+        }
+
+        v.Normalize();
+        return v;
+    }
+
+    uint32_t EncodeHalf2(const Math::Vector2& v)
+    {
+        return uint32_t(DirectX::PackedVector::XMConvertFloatToHalf(v.x)) | (uint32_t(DirectX::PackedVector::XMConvertFloatToHalf(v.y)) << 16);
+    }
+
+    Math::Vector2 DecodeHalf2(uint32_t encoded)
+    {
+        return Math::Vector2(
+            DirectX::PackedVector::XMConvertHalfToFloat(static_cast<DirectX::PackedVector::HALF>(encoded & 0xFFFF)),
+            DirectX::PackedVector::XMConvertHalfToFloat(static_cast<DirectX::PackedVector::HALF>(encoded >> 16)));
+    }
+
+    void EncodePositionsUnorm16(std::span<const Math::Vector3> positions, const PositionBounds& bounds, std::vector<std::byte>& dest)
+    {
+        dest.resize(GetVertexStreamSize(eVertexAttribute_Positions, eVertexEncoding_Unorm16, static_cast<uint32_t>(positions.size())));
+
+        // Flat axes have zero extent, everything on them decodes to the minimum
+        Math::Vector3 scale;
+        scale.x = bounds.Extent.x > 0.0f ? Unorm16Max / bounds.Extent.x : 0.0f;
+        scale.y = bounds.Extent.y > 0.0f ? Unorm16Max / bounds.Extent.y : 0.0f;
+        scale.z = bounds.Extent.z > 0.0f ? Unorm16Max / bounds.Extent.z : 0.0f;
+
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            Math::Vector3 unorm = (positions[i] - bounds.Min) * scale;
+            uint16_t encoded[4] = {
+                static_cast<uint16_t>(Math::Clamp(std::round(unorm.x), 0.0f, Unorm16Max)),
+                static_cast<uint16_t>(Math::Clamp(std::round(unorm.y), 0.0f, Unorm16Max)),
+                static_cast<uint16_t>(Math::Clamp(std::round(unorm.z), 0.0f, Unorm16Max)),
+                0,
+            };
+            StoreElement(dest, i * sizeof(encoded), encoded);
+        }
+    }
+
+    void EncodeUnitVectorsOct16(std::span<const Math::Vector3> vectors, std::vector<std::byte>& dest)
+    {
+        dest.resize(GetVertexStreamSize(eVertexAttribute_Normals, eVertexEncoding_Oct16, static_cast<uint32_t>(vectors.size())));
+        for (size_t i = 0; i < vectors.size(); ++i)
+        {
+            StoreElement(dest, i * sizeof(uint32_t), EncodeOct16(vectors[i]));
+        }
+    }
+
+    void EncodeTexCoordsHalf(std::span<const Math::Vector2> texCoords, std::vector<std::byte>& dest)
+    {
+        dest.resize(GetVertexStreamSize(eVertexAttribute_TextureCoords, eVertexEncoding_Half, static_cast<uint32_t>(texCoords.size())));
+        for (size_t i = 0; i < texCoords.size(); ++i)
+        {
+            StoreElement(dest, i * sizeof(uint32_t), EncodeHalf2(texCoords[i]));
+        }
+    }
+
+    void EncodeBitangentSigns(
+        std::span<const Math::Vector3> normals,
+        std::span<const Math::Vector3> tangents,
+        std::span<const Math::Vector3> bitangents,
+        std::vector<std::byte>& dest)
+    {
+        WARP_ASSERT(normals.size() == tangents.size() && normals.size() == bitangents.size());
+
+        uint32_t numVertices = static_cast<uint32_t>(normals.size());
+        std::vector<uint32_t> words((numVertices + 31) / 32, 0);
+        for (uint32_t i = 0; i < numVertices; ++i)
+        {
+            if (normals[i].Cross(tangents[i]).Dot(bitangents[i]) < 0.0f)
+            {
+                words[i / 32] |= 1u << (i % 32);
+            }
+        }
+
+        dest.resize(GetVertexStreamSize(eVertexAttribute_Bitangents, eVertexEncoding_SignBits, numVertices));
+        std::memcpy(dest.data(), words.data(), dest.size());
+    }
+
+    bool DecodeVertexAttribute(const Submesh& submesh, EVertexAttribute attribute, std::vector<float>& dest)
+    {
+        if (!submesh.HasAttributes(attribute))
+        {
+            return false;
+        }
+
+        std::span<const std::byte> stream = submesh.Attributes[attribute];
+        EVertexEncoding encoding = submesh.AttributeEncodings[attribute];
+        uint32_t numVertices = submesh.GetNumVertices();
+        uint32_t numComponents = GetNumComponents(attribute);
+        if (stream.size() < GetVertexStreamSize(attribute, encoding, numVertices))
+        {
+            return false;
+        }
+
+        dest.resize(size_t(numVertices) * numComponents);
+        auto storeVector3 = [&dest](uint32_t vertexIndex, const Math::Vector3& v)
+            {
+                std::memcpy(dest.data() + vertexIndex * 3, &v, sizeof(Math::Vector3));
+            };
+
+        switch (encoding)
+        {
+        case eVertexEncoding_Float:
+        {
+            uint32_t stride = submesh.AttributeStrides[attribute];
+            for (uint32_t i = 0; i < numVertices; ++i)
+            {
+                std::memcpy(dest.data() + size_t(i) * numComponents, stream.data() + size_t(i) * stride, numComponents * sizeof(float));
+            }
+            break;
+        }
+        case eVertexEncoding_Unorm16:
+        {
+            Math::Vector3 scale = submesh.PositionsExtent / Unorm16Max;
+            for (uint32_t i = 0; i < numVertices; ++i)
+            {
+                uint64_t encoded = LoadElement<uint64_t>(stream, size_t(i) * sizeof(uint64_t));
+                Math::Vector3 unorm = Math::Vector3(float(encoded & 0xFFFF), float((encoded >> 16) & 0xFFFF), float((encoded >> 32) & 0xFFFF));
+                storeVector3(i, submesh.PositionsMin + unorm * scale);
+            }
+            break;
+        }
+        case eVertexEncoding_Oct16:
+            for (uint32_t i = 0; i < numVertices; ++i)
+            {
+                storeVector3(i, DecodeOct16(LoadElement<uint32_t>(stream, size_t(i) * sizeof(uint32_t))));
+            }
+            break;
+        case eVertexEncoding_Half:
+            for (uint32_t i = 0; i < numVertices; ++i)
+            {
+                Math::Vector2 texCoord = DecodeHalf2(LoadElement<uint32_t>(stream, size_t(i) * sizeof(uint32_t)));
+                dest[size_t(i) * 2 + 0] = texCoord.x;
+                dest[size_t(i) * 2 + 1] = texCoord.y;
+            }
+            break;
+        case eVertexEncoding_SignBits:
+        {
+            // Same reconstruction as in shaders
+            std::vector<float> normals;
+            std::vector<float> tangents;
+            if (!DecodeVertexAttribute(submesh, eVertexAttribute_Normals, normals) ||
+                !DecodeVertexAttribute(submesh, eVertexAttribute_Tangents, tangents))
+            {
+                return false;
+            }
+
+            for (uint32_t i = 0; i < numVertices; ++i)
+            {
+                Math::Vector3 normal = Math::Vector3(&normals[size_t(i) * 3]);
+                Math::Vector3 tangent = Math::Vector3(&tangents[size_t(i) * 3]);
+                uint32_t word = LoadElement<uint32_t>(stream, size_t(i / 32) * sizeof(uint32_t));
+                float sign = (word >> (i % 32)) & 1 ? -1.0f : 1.0f;
+                storeVector3(i, normal.Cross(tangent) * sign);
+            }
+            break;
+        }
+        default: WARP_ASSERT(false, "Unknown vertex encoding"); return false;
+        }
+
+        return true;
+    }
+
+    void VertexQuantizationError::Merge(const VertexQuantizationError& other)
+    {
+        MaxPositionError = std::max(MaxPositionError, other.MaxPositionError);
+        MaxNormalError = std::max(MaxNormalError, other.MaxNormalError);
+        MaxTexCoordError = std::max(MaxTexCoordError, other.MaxTexCoordError);
+        MaxTangentError = std::max(MaxTangentError, other.MaxTangentError);
+        MaxBitangentError = std::max(MaxBitangentError, other.MaxBitangentError);
+    }
+
+    VertexQuantizationError MeasureQuantizationError(const Submesh& reference, const Submesh& quantized)
+    {
+        VertexQuantizationError error;
+        if (reference.GetNumVertices() != quantized.GetNumVertices())
+        {
+            WARP_ASSERT(false, "Submeshes should be the same");
+            return error;
+        }
+
+        std::vector<float> expected;
+        std::vector<float> decoded;
+        for (uint32_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+        {
+            EVertexAttribute attribute = static_cast<EVertexAttribute>(attributeIndex);
+            if (!DecodeVertexAttribute(reference, attribute, expected) || !DecodeVertexAttribute(quantized, attribute, decoded))
+            {
+                continue;
+            }
+
+            if (attribute == eVertexAttribute_TextureCoords)
+            {
+                for (size_t i = 0; i < expected.size(); ++i)
+                {
+                    error.MaxTexCoordError = std::max(error.MaxTexCoordError, std::abs(expected[i] - decoded[i]));
+                }
+                continue;
+            }
+
+            float& maxError =
+                attribute == eVertexAttribute_Positions ? error.MaxPositionError :
+                attribute == eVertexAttribute_Normals ? error.MaxNormalError :
+                attribute == eVertexAttribute_Tangents ? error.MaxTangentError :
+                error.MaxBitangentError;
+
+            for (size_t i = 0; i < expected.size(); i += 3)
+            {
+                Math::Vector3 a = Math::Vector3(&expected[i]);
+                Math::Vector3 b = Math::Vector3(&decoded[i]);
+                float vertexError = attribute == eVertexAttribute_Positions ? (a - b).Length() : GetAngleInDegrees(a, b);
+                maxError = std::max(maxError, vertexError);
+            }
+        }
+
+        return error;
+    }
+
+}
\ No newline at end of file
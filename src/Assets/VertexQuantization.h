@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "MeshAsset.h"
+#include "../Math/Math.h"
+#include "../Renderer/Vertex.h"
+
+// Compact encodings of vertex attribute streams, see EVertexEncoding
+//
+// Encoders are used by the mesh importer after every other processing step, as everything else (optimization, meshlets, culling data) expects floats.
+// Decoders mirror what shaders do (see Base.hlsl) and exist to measure the error of quantization on the CPU
+namespace Warp
+{
+
+    struct PositionBounds
+    {
+        Math::Vector3 Min;
+        Math::Vector3 Extent;
+
+        // Largest distance between a position and its decoded unorm16 counterpart
+        float GetMaxError() const;
+    };
+
+    PositionBounds ComputePositionBounds(std::span<const Math::Vector3> positions);
+
+    // Scalar encodings. Octahedral encoding is the same as in OctahedronEncoding.hlsli, but picks the rounding with the smallest error
+    uint32_t EncodeOct16(const Math::Vector3& v);
+    Math::Vector3 DecodeOct16(uint32_t encoded);
+
+    uint32_t EncodeHalf2(const Math::Vector2& v);
+    Math::Vector2 DecodeHalf2(uint32_t encoded);
+
+    // Stream encoders, dest is resized to GetVertexStreamSize() of the encoding
+    void EncodePositionsUnorm16(std::span<const Math::Vector3> positions, const PositionBounds& bounds, std::vector<std::byte>& dest);
+    void EncodeUnitVectorsOct16(std::span<const Math::Vector3> vectors, std::vector<std::byte>& dest);
+    void EncodeTexCoordsHalf(std::span<const Math::Vector2> texCoords, std::vector<std::byte>& dest);
+    void EncodeBitangentSigns(
+        std::span<const Math::Vector3> normals,
+        std::span<const Math::Vector3> tangents,
+        std::span<const Math::Vector3> bitangents,
+        std::vector<std::byte>& dest);
+
+    // Decodes a stream of the submesh of any encoding into GetNumComponents(attribute) floats per vertex, in model space
+    // Bitangents stored as sign bits are reconstructed from decoded normals and tangents. Returns false if the submesh has no such attribute
+    bool DecodeVertexAttribute(const Submesh& submesh, EVertexAttribute attribute, std::vector<float>& dest);
+
+    struct VertexQuantizationError
+    {
+        float MaxPositionError = 0.0f;    // Model space units
+        float MaxNormalError = 0.0f;      // Degrees
+        float MaxTexCoordError = 0.0f;    // Per component
+        float MaxTangentError = 0.0f;     // Degrees
+        float MaxBitangentError = 0.0f;   // Degrees
+
+        // Keeps the larger error of every stream, so that errors of several submeshes add up to the error of the mesh
+        void Merge(const VertexQuantizationError& other);
+    };
+
+    // Compares every stream of the quantized submesh against the same submesh imported without quantization
+    // Vertices are in the same order in both, as quantization is the last step of the import. See StaticMeshImportDesc::ReportStatistics
+    VertexQuantizationError MeasureQuantizationError(const Submesh& reference, const Submesh& quantized);
+
+}
\ No newline at end of file
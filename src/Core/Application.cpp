@@ -4,6 +4,8 @@
 #include "Assert.h"
 #include "../Input/DeviceManager.h"
 #include "../Util/Logger.h"
+#include "../Renderer/AssetReleaseQueue.h"
+#include "../Renderer/GpuTextureStreamingBackend.h"
 
 // TODO: Remove
 #include "../World/Components.h"
@@ -20,14 +22,27 @@ namespace Warp
                     .WorkingDirectory = desc.WorkingDirectory,
                     .ShaderDirectory = relativePath / "shaders",
                     .AssetsDirectory = relativePath / "assets",
+                    .DerivedDataDirectory = desc.WorkingDirectory / "DerivedDataCache",
                 };
     return config;
             }())
         // TODO: (14.02.2024) -> Asset manager and importers are on stack. Can cause any problems? Recheck it when youre sane
+                , m_derivedDataCache(m_filepathConfig.DerivedDataDirectory)
                 , m_assetManager()
-                , m_meshImporter(&m_assetManager)
-                , m_textureImporter(&m_assetManager)
+                , m_meshImporter(&m_assetManager, &m_derivedDataCache)
+                , m_textureImporter(&m_assetManager, &m_derivedDataCache)
     {
+        // Kept next to the working directory rather than in the cache, as cooked scenes refer to Guids it assigns
+        m_assetDatabase.Load(m_filepathConfig.WorkingDirectory / "AssetDatabase.wadb");
+        m_assetManager.SetAssetDatabase(&m_assetDatabase);
+    }
+
+    Application::~Application()
+    {
+        // Entities hold handles to their meshes, thus the world goes first. Assets it released are destroyed by the release queue
+        m_world.reset();
+        m_assetManager.LogLiveHandles();
+        m_assetDatabase.Save();
     }
 
             bool Application::Create(const ApplicationDesc& desc)
@@ -50,6 +65,11 @@ namespace Warp
                 return *s_instance;
             }
 
+            bool Application::Exists()
+            {
+                return s_instance != nullptr;
+            }
+
             static void AddEntityFromMesh(
                 const std::filesystem::path& assetsPath,
                 const std::string& filename,
@@ -67,6 +87,58 @@ namespace Warp
                 entity.AddComponent<MeshComponent>(&manager, proxy);
             }
 
+            // Spawns an entity per node of the scene in one batch. Nodes keep local transforms and are linked with ParentComponent,
+            // nodes that share a mesh share the mesh asset as well
+            static void AddEntitiesFromScene(
+                const std::filesystem::path& assetsPath,
+                const std::string& filename,
+                AssetManager& manager,
+                MeshImporter& meshImporter,
+                World* world,
+                const TransformComponent& transform)
+            {
+                std::filesystem::path filepath = assetsPath / filename;
+                StaticMeshScene scene = meshImporter.ImportStaticMeshSceneFromFile(filepath.string());
+                size_t numNodes = scene.Nodes.size();
+
+                std::vector<Entity> entities(numNodes);
+                world->CreateEntities(entities);
+
+                std::vector<TransformComponent> transforms;
+                std::vector<Entity> childEntities;
+                std::vector<ParentComponent> parents;
+                std::vector<Entity> meshEntities;
+                std::vector<MeshComponent> meshes;
+                transforms.reserve(numNodes);
+
+                Math::Matrix sceneToWorld = transform.GetMatrix();
+                for (size_t nodeIndex = 0; nodeIndex < numNodes; ++nodeIndex)
+                {
+                    const StaticMeshSceneNode& node = scene.Nodes[nodeIndex];
+                    if (node.ParentIndex == StaticMeshSceneNode::InvalidIndex)
+                    {
+                        transforms.push_back(TransformComponent::FromMatrix(node.LocalToParent * sceneToWorld));
+                    }
+                    else
+                    {
+                        transforms.push_back(TransformComponent::FromMatrix(node.LocalToParent));
+                        childEntities.push_back(entities[nodeIndex]);
+                        parents.emplace_back(entities[node.ParentIndex]);
+                    }
+
+                    if (node.Mesh.IsValid())
+                    {
+                        meshEntities.push_back(entities[nodeIndex]);
+                        meshes.emplace_back(&manager, node.Mesh);
+                    }
+                }
+
+                EntityCapacitor& capacitor = world->GetEntityCapacitor();
+                capacitor.InsertComponents<TransformComponent>(entities, transforms);
+                capacitor.InsertComponents<ParentComponent>(childEntities, parents);
+                capacitor.InsertComponents<MeshComponent>(meshEntities, meshes);
+            }
+
             // TODO: Temp to play with gbuffers
             void Application::OnKeyPressed(const KeyboardDevice::EvKeyInteraction& keyInteraction)
             {
@@ -95,10 +167,17 @@ namespace Warp
                 m_renderer = std::make_unique<Renderer>(hwnd);
                 m_world = std::make_unique<World>();
 
+                // Both importers hand their textures over to the streamer, thus it has to exist before anything is imported
+                m_textureStreamer = std::make_unique<TextureStreamer>(std::make_unique<GpuTextureStreamingBackend>(m_renderer.get(), &m_assetManager));
+                m_textureImporter.SetTextureStreamer(m_textureStreamer.get());
+                m_meshImporter.GetTextureImporter().SetTextureStreamer(m_textureStreamer.get());
+                m_assetReleaseQueue = std::make_unique<AssetReleaseQueue>(m_renderer.get(), &m_assetManager, m_textureStreamer.get(),
+                    std::vector<TextureImporter*>{ &m_textureImporter, &m_meshImporter.GetTextureImporter() });
+
                 InputDeviceManager& inputManager = InputDeviceManager::Get();
                 inputManager.GetKeyboard().AddKeyInteractionDelegate(OnKeyPressed);
 
-                AddEntityFromMesh(GetAssetsPath(), "Sponza/Sponza.gltf",
+                AddEntitiesFromScene(GetAssetsPath(), "Sponza/Sponza.gltf",
                     m_assetManager,
                     GetMeshImporter(),
                     GetWorld(),
@@ -126,6 +205,8 @@ namespace Warp
                     TransformComponent(Math::Vector3(0.0f, -3.0f, -4.0f), Math::Vector3(), Math::Vector3(8.0f, 0.05f, 8.0f))
                 );*/
 
+                m_derivedDataCache.LogStats();
+
                 Entity light1 = GetWorld()->CreateEntity("Dirlight1");
                 light1.AddComponent<DirectionalLightComponent>(DirectionalLightComponent{
                         .Intensity = 3.2f,
@@ -180,9 +261,27 @@ namespace Warp
 
             void Application::Update(float timestep)
             {
+                UploadImportedTextures();
+                m_textureStreamer->Update();
+                m_assetReleaseQueue->Update();
                 m_world->Update(timestep);
             }
 
+            void Application::UploadImportedTextures()
+            {
+                TextureImporter& materialTextureImporter = m_meshImporter.GetTextureImporter();
+                uint32_t numUploaded = m_textureImporter.UploadReadyTextures() + materialTextureImporter.UploadReadyTextures();
+                if (numUploaded > 0 && !m_textureImporter.HasPendingImports() && !materialTextureImporter.HasPendingImports())
+                {
+                    WARP_LOG_INFO("Application::UploadImportedTextures -> Every pending texture is resident");
+                    m_derivedDataCache.LogStats();
+                    m_textureImporter.LogDeduplicationStats();
+                    materialTextureImporter.LogDeduplicationStats();
+                    m_assetManager.LogLiveHandles();
+                    m_assetDatabase.Save();
+                }
+            }
+
             void Application::Render()
             {
                 m_renderer->Render(m_world.get(), m_renderOpts);
@@ -9,16 +9,21 @@
 #include "../World/World.h"
 
 #include "../Assets/Asset.h"
+#include "../Assets/AssetDatabase.h"
 #include "../Assets/AssetManager.h"
+#include "../Assets/DerivedDataCache.h"
 #include "../Assets/Importers/MeshImporter.h"
 #include "../Assets/Importers/TextureImporter.h"
 
 #include "../Renderer/Renderer.h"
+#include "../Renderer/TextureStreamer.h"
 #include "../WinAPI.h"
 
 namespace Warp
 {
 
+    class AssetReleaseQueue;
+
     struct ApplicationDesc
     {
         std::filesystem::path WorkingDirectory;
@@ -36,6 +41,8 @@ namespace Warp
         Application(Application&&) = delete;
         Application operator=(Application&&) = delete;
 
+        ~Application();
+
         // Creates an application, allocating memory for it
         static bool Create(const ApplicationDesc& desc);
 
@@ -46,6 +53,9 @@ namespace Warp
         // Calling this function when there was no application created using Application::Create() is undefined behavior
         static Application& Get();
 
+        // False before Application::Create() and after Application::Delete(), e.g. when assets are imported by tests
+        static bool Exists();
+
         // Initialize (or reinitialize) the Application
         void Init(HWND hwnd);
         void RequestResize(uint32_t width, uint32_t height);
@@ -67,11 +77,15 @@ namespace Warp
         inline World* GetWorld() const { return m_world.get(); }
         inline MeshImporter& GetMeshImporter() { return m_meshImporter; }
         inline TextureImporter& GetTextureImporter() { return m_textureImporter; }
+        inline TextureStreamer* GetTextureStreamer() const { return m_textureStreamer.get(); }
 
     private:
         // Moved to private, use Application::RequestResize() instead
         void Resize();
 
+        // Makes textures that were decoded in background resident. Called once per frame
+        void UploadImportedTextures();
+
         static inline Application* s_instance = nullptr;
 
         HWND m_hwnd = nullptr;
@@ -84,6 +98,7 @@ namespace Warp
             std::filesystem::path WorkingDirectory;
             std::filesystem::path ShaderDirectory;
             std::filesystem::path AssetsDirectory;
+            std::filesystem::path DerivedDataDirectory;
         };
         const FilepathConfig m_filepathConfig; // For now it is const, we do not plan on ever changing it (yet)
 
@@ -95,10 +110,20 @@ namespace Warp
 
         // TODO: currently we store world in Application. This should be changed though
         std::unique_ptr<World> m_world;
+        DerivedDataCache m_derivedDataCache;
+
+        // Declared before the manager and importers, which keep using it until they are destroyed
+        AssetDatabase m_assetDatabase;
         AssetManager m_assetManager;
         MeshImporter m_meshImporter;
         TextureImporter m_textureImporter;
 
+        // Created along with the renderer, which uploads streamed mips
+        std::unique_ptr<TextureStreamer> m_textureStreamer;
+
+        // Destroys assets whose handles were dropped. Declared after the streamer, thus released textures are removed from it till the end
+        std::unique_ptr<AssetReleaseQueue> m_assetReleaseQueue;
+
         // TODO: Temp, remove when played with gbuffers enough
         static void OnKeyPressed(const KeyboardDevice::EvKeyInteraction& keyInteraction);
         RenderOpts m_renderOpts;
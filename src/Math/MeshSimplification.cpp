@@ -0,0 +1,382 @@
+#include "MeshSimplification.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "../Core/Assert.h"
+
+namespace Warp::Math
+{
+
+    // Sum of squared distances to a set of planes (Garland & Heckbert), stored as the upper half of a symmetric 4x4 matrix
+    // Doubles are used, as quadrics of large flat regions are sums of thousands of nearly identical planes
+    struct Quadric
+    {
+        double A2 = 0.0, B2 = 0.0, C2 = 0.0, D2 = 0.0;
+        double AB = 0.0, AC = 0.0, AD = 0.0;
+        double BC = 0.0, BD = 0.0;
+        double CD = 0.0;
+
+        static Quadric FromPlane(double a, double b, double c, double d)
+        {
+            return Quadric{
+                .A2 = a * a, .B2 = b * b, .C2 = c * c, .D2 = d * d,
+                .AB = a * b, .AC = a * c, .AD = a * d,
+                .BC = b * c, .BD = b * d,
+                .CD = c * d,
+            };
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            A2 += other.A2; B2 += other.B2; C2 += other.C2; D2 += other.D2;
+            AB += other.AB; AC += other.AC; AD += other.AD;
+            BC += other.BC; BD += other.BD;
+            CD += other.CD;
+            return *this;
+        }
+
+        double Evaluate(const Vector3& p) const
+        {
+            double x = p.x;
+            double y = p.y;
+            double z = p.z;
+            double result = A2 * x * x + B2 * y * y + C2 * z * z + D2 +
+                2.0 * (AB * x * y + AC * x * z + AD * x + BC * y * z + BD * y + CD * z);
+
+            // Rounding may push the sum slightly below zero for points on every plane
+            return std::max(result, 0.0);
+        }
+    };
+
+    struct EdgeCollapse
+    {
+        uint32_t From;
+        uint32_t To;
+        double Cost;
+    };
+
+    // Marks vertices that should never be moved. A vertex is locked if it shares its position with another vertex (attribute seam)
+    // or if it lies on an edge that is not shared by exactly two triangles (open border or non-manifold edge)
+    static std::vector<uint8_t> ComputeLockedVertices(std::span<const Vector3> positions, std::span<const uint32_t> indices)
+    {
+        size_t numVertices = positions.size();
+
+        // Weld vertices by exact position, so that seams do not look like borders
+        struct PositionHash
+        {
+            size_t operator()(const Vector3& p) const
+            {
+                uint32_t bits[3];
+                std::memcpy(bits, &p, sizeof(bits));
+                return (size_t(bits[0]) * 73856093u) ^ (size_t(bits[1]) * 19349663u) ^ (size_t(bits[2]) * 83492791u);
+            }
+        };
+
+        std::unordered_map<Vector3, uint32_t, PositionHash> firstVertexAt;
+        firstVertexAt.reserve(numVertices);
+
+        std::vector<uint32_t> welded(numVertices);
+        std::vector<uint32_t> numWeldedVertices(numVertices, 0);
+        for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+        {
+            auto [it, inserted] = firstVertexAt.try_emplace(positions[vertex], vertex);
+            welded[vertex] = it->second;
+            ++numWeldedVertices[it->second];
+        }
+
+        std::unordered_map<uint64_t, uint32_t> numEdgeTriangles;
+        numEdgeTriangles.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                uint32_t a = welded[indices[i + corner]];
+                uint32_t b = welded[indices[i + (corner + 1) % 3]];
+                uint64_t key = (uint64_t(std::min(a, b)) << 32) | std::max(a, b);
+                ++numEdgeTriangles[key];
+            }
+        }
+
+        std::vector<uint8_t> isWeldedLocked(numVertices, false);
+        for (const auto& [key, numTriangles] : numEdgeTriangles)
+        {
+            if (numTriangles != 2)
+            {
+                isWeldedLocked[uint32_t(key >> 32)] = true;
+                isWeldedLocked[uint32_t(key)] = true;
+            }
+        }
+
+        std::vector<uint8_t> isLocked(numVertices, false);
+        for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+        {
+            isLocked[vertex] = isWeldedLocked[welded[vertex]] || numWeldedVertices[welded[vertex]] > 1;
+        }
+        return isLocked;
+    }
+
+    // Returns true if moving the vertex from onto the vertex to turns any of its remaining triangles upside down or makes it degenerate
+    static bool DoesCollapseFlipTriangles(
+        std::span<const Vector3> positions,
+        std::span<const uint32_t> indices,
+        std::span<const uint32_t> triangles,
+        uint32_t from,
+        uint32_t to)
+    {
+        for (uint32_t triangle : triangles)
+        {
+            uint32_t corners[3] = { indices[triangle * 3 + 0], indices[triangle * 3 + 1], indices[triangle * 3 + 2] };
+            if (corners[0] == to || corners[1] == to || corners[2] == to)
+            {
+                // Collapses into a degenerate triangle, which is removed
+                continue;
+            }
+
+            Vector3 before[3] = { positions[corners[0]], positions[corners[1]], positions[corners[2]] };
+            Vector3 after[3] = { before[0], before[1], before[2] };
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                if (corners[corner] == from)
+                {
+                    after[corner] = positions[to];
+                }
+            }
+
+            Vector3 normalBefore = (before[1] - before[0]).Cross(before[2] - before[0]);
+            Vector3 normalAfter = (after[1] - after[0]).Cross(after[2] - after[0]);
+            if (normalBefore.Dot(normalAfter) <= 0.0f)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static MeshSimplifyResult SimplifyMeshImpl(
+        std::span<const Vector3> positions,
+        std::vector<uint32_t>& indices,
+        size_t targetNumIndices,
+        float maxError)
+    {
+        WARP_ASSERT(indices.size() % 3 == 0);
+
+        MeshSimplifyResult result;
+        uint32_t numVertices = static_cast<uint32_t>(positions.size());
+        size_t targetNumTriangles = targetNumIndices / 3;
+        double maxCost = double(maxError) * double(maxError);
+        double resultCost = 0.0;
+
+        std::vector<uint8_t> isLocked = ComputeLockedVertices(positions, indices);
+
+        std::vector<Quadric> quadrics(numVertices);
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            const Vector3& p0 = positions[indices[i + 0]];
+            const Vector3& p1 = positions[indices[i + 1]];
+            const Vector3& p2 = positions[indices[i + 2]];
+
+            Vector3 normal = (p1 - p0).Cross(p2 - p0);
+            float length = normal.Length();
+            if (length == 0.0f)
+            {
+                continue;
+            }
+
+            normal /= length;
+            Quadric quadric = Quadric::FromPlane(normal.x, normal.y, normal.z, -normal.Dot(p0));
+            quadrics[indices[i + 0]] += quadric;
+            quadrics[indices[i + 1]] += quadric;
+            quadrics[indices[i + 2]] += quadric;
+        }
+
+        std::vector<uint32_t> triangleOffsets(numVertices + 1);
+        std::vector<uint32_t> vertexTriangles;
+        std::vector<uint32_t> collapseTargets(numVertices);
+        std::vector<uint8_t> isTouched(numVertices);
+        std::vector<EdgeCollapse> collapses;
+
+        // Every pass collapses the cheapest edges whose neighbourhoods do not overlap, then rebuilds the index buffer
+        // This is simpler than keeping a priority queue up-to-date and produces the same quality in practice
+        while (indices.size() / 3 > targetNumTriangles)
+        {
+            size_t numTriangles = indices.size() / 3;
+
+            // Triangles around every vertex
+            std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+            for (uint32_t index : indices)
+            {
+                ++triangleOffsets[index + 1];
+            }
+
+            for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+            {
+                triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+            }
+
+            vertexTriangles.resize(indices.size());
+            std::vector<uint32_t> writeOffsets(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                vertexTriangles[writeOffsets[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            auto getTriangles = [&](uint32_t vertex)
+                {
+                    return std::span<const uint32_t>(vertexTriangles.data() + triangleOffsets[vertex], triangleOffsets[vertex + 1] - triangleOffsets[vertex]);
+                };
+
+            // Both directions of every edge are candidates, unless the source vertex is locked
+            collapses.clear();
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    uint32_t a = indices[i + corner];
+                    uint32_t b = indices[i + (corner + 1) % 3];
+                    if (!isLocked[a]) collapses.push_back(EdgeCollapse{ a, b, 0.0 });
+                    if (!isLocked[b]) collapses.push_back(EdgeCollapse{ b, a, 0.0 });
+                }
+            }
+
+            std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& lhs, const EdgeCollapse& rhs)
+                {
+                    return lhs.From != rhs.From ? lhs.From < rhs.From : lhs.To < rhs.To;
+                });
+            collapses.erase(std::unique(collapses.begin(), collapses.end(), [](const EdgeCollapse& lhs, const EdgeCollapse& rhs)
+                {
+                    return lhs.From == rhs.From && lhs.To == rhs.To;
+                }), collapses.end());
+
+            // Quadric of the target already holds the error of the collapses it has absorbed
+            for (EdgeCollapse& collapse : collapses)
+            {
+                const Vector3& position = positions[collapse.To];
+                collapse.Cost = quadrics[collapse.From].Evaluate(position) + quadrics[collapse.To].Evaluate(position);
+            }
+
+            collapses.erase(std::remove_if(collapses.begin(), collapses.end(), [maxCost](const EdgeCollapse& collapse)
+                {
+                    return collapse.Cost > maxCost;
+                }), collapses.end());
+
+            // Ties are broken by vertex indices, which keeps the result deterministic
+            std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& lhs, const EdgeCollapse& rhs)
+                {
+                    if (lhs.Cost != rhs.Cost) return lhs.Cost < rhs.Cost;
+                    return lhs.From != rhs.From ? lhs.From < rhs.From : lhs.To < rhs.To;
+                });
+
+            for (uint32_t vertex = 0; vertex < numVertices; ++vertex)
+            {
+                collapseTargets[vertex] = vertex;
+            }
+            std::fill(isTouched.begin(), isTouched.end(), false);
+
+            size_t numRemovedTriangles = 0;
+            uint32_t numAppliedCollapses = 0;
+            for (const EdgeCollapse& collapse : collapses)
+            {
+                if (numTriangles - numRemovedTriangles <= targetNumTriangles)
+                {
+                    break;
+                }
+
+                // Flip checks use positions of the current pass, thus neighbourhoods of collapses within a pass should not overlap
+                if (isTouched[collapse.From] || isTouched[collapse.To])
+                {
+                    continue;
+                }
+
+                std::span<const uint32_t> triangles = getTriangles(collapse.From);
+                if (DoesCollapseFlipTriangles(positions, indices, triangles, collapse.From, collapse.To))
+                {
+                    continue;
+                }
+
+                for (uint32_t triangle : triangles)
+                {
+                    uint32_t corners[3] = { indices[triangle * 3 + 0], indices[triangle * 3 + 1], indices[triangle * 3 + 2] };
+                    if (corners[0] == collapse.To || corners[1] == collapse.To || corners[2] == collapse.To)
+                    {
+                        ++numRemovedTriangles;
+                    }
+
+                    isTouched[corners[0]] = isTouched[corners[1]] = isTouched[corners[2]] = true;
+                }
+
+                collapseTargets[collapse.From] = collapse.To;
+                quadrics[collapse.To] += quadrics[collapse.From];
+                resultCost = std::max(resultCost, collapse.Cost);
+                ++numAppliedCollapses;
+            }
+
+            if (numAppliedCollapses == 0)
+            {
+                break;
+            }
+
+            // Remap indices and drop triangles that became degenerate
+            size_t numIndices = 0;
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                uint32_t a = collapseTargets[indices[i + 0]];
+                uint32_t b = collapseTargets[indices[i + 1]];
+                uint32_t c = collapseTargets[indices[i + 2]];
+                if (a != b && b != c && a != c)
+                {
+                    indices[numIndices++] = a;
+                    indices[numIndices++] = b;
+                    indices[numIndices++] = c;
+                }
+            }
+
+            WARP_ASSERT(numIndices < indices.size());
+            indices.resize(numIndices);
+            result.NumCollapses += numAppliedCollapses;
+        }
+
+        result.Error = static_cast<float>(std::sqrt(resultCost));
+        return result;
+    }
+
+    template<typename IndexType>
+    static MeshSimplifyResult SimplifyMeshWithIndices(
+        std::span<const Vector3> positions,
+        std::span<const IndexType> indices,
+        size_t targetNumIndices,
+        float maxError,
+        std::vector<IndexType>& dest)
+    {
+        std::vector<uint32_t> simplified(indices.begin(), indices.end());
+        MeshSimplifyResult result = SimplifyMeshImpl(positions, simplified, targetNumIndices, maxError);
+
+        // Vertices are never added, thus simplified indices fit into the same width
+        dest.resize(simplified.size());
+        std::transform(simplified.begin(), simplified.end(), dest.begin(), [](uint32_t index) { return static_cast<IndexType>(index); });
+        return result;
+    }
+
+    MeshSimplifyResult SimplifyMesh(
+        std::span<const Vector3> positions,
+        std::span<const uint16_t> indices,
+        size_t targetNumIndices,
+        float maxError,
+        std::vector<uint16_t>& dest)
+    {
+        return SimplifyMeshWithIndices(positions, indices, targetNumIndices, maxError, dest);
+    }
+
+    MeshSimplifyResult SimplifyMesh(
+        std::span<const Vector3> positions,
+        std::span<const uint32_t> indices,
+        size_t targetNumIndices,
+        float maxError,
+        std::vector<uint32_t>& dest)
+    {
+        return SimplifyMeshWithIndices(positions, indices, targetNumIndices, maxError, dest);
+    }
+
+}
\ No newline at end of file
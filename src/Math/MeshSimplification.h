@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Math.h"
+
+namespace Warp::Math
+{
+
+    struct MeshSimplifyResult
+    {
+        // Upper bound of the distance between the simplified surface and the input surface, in units of positions
+        float Error = 0.0f;
+        uint32_t NumCollapses = 0;
+    };
+
+    // Simplifies a triangle list by collapsing edges into one of their endpoints (half-edge collapses ordered by quadric error)
+    // Collapses never introduce new vertices, thus the result indexes the same vertex streams as the input and only needs new meshlets
+    //
+    // Stops once the result has at most targetNumIndices indices or once the next collapse would exceed maxError
+    // Vertices on open borders and on attribute seams (several vertices at the same position) never move, so UVs do not tear and neighbouring submeshes do not crack
+    // Collapses that would flip a triangle are rejected. dest receives the simplified triangle list
+    MeshSimplifyResult SimplifyMesh(
+        std::span<const Vector3> positions,
+        std::span<const uint16_t> indices,
+        size_t targetNumIndices,
+        float maxError,
+        std::vector<uint16_t>& dest);
+
+    MeshSimplifyResult SimplifyMesh(
+        std::span<const Vector3> positions,
+        std::span<const uint32_t> indices,
+        size_t targetNumIndices,
+        float maxError,
+        std::vector<uint32_t>& dest);
+
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "MeshletCulling.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Core/Assert.h"
+
+namespace Warp::Math
+{
+
+    Frustum Frustum::FromMatrix(const Matrix& m)
+    {
+        // Gribb & Hartmann. With row vectors clip coordinates are dot products with columns of the matrix
+        Vector4 col0 = Vector4(m._11, m._21, m._31, m._41);
+        Vector4 col1 = Vector4(m._12, m._22, m._32, m._42);
+        Vector4 col2 = Vector4(m._13, m._23, m._33, m._43);
+        Vector4 col3 = Vector4(m._14, m._24, m._34, m._44);
+
+        Frustum frustum;
+        frustum.Planes[ePlane_Left] = col3 + col0;
+        frustum.Planes[ePlane_Right] = col3 - col0;
+        frustum.Planes[ePlane_Bottom] = col3 + col1;
+        frustum.Planes[ePlane_Top] = col3 - col1;
+        frustum.Planes[ePlane_Near] = col2;
+        frustum.Planes[ePlane_Far] = col3 - col2;
+
+        for (Vector4& plane : frustum.Planes)
+        {
+            float length = Vector3(plane.x, plane.y, plane.z).Length();
+            if (length > 0.0f)
+            {
+                plane /= length;
+            }
+        }
+        return frustum;
+    }
+
+    bool IsSphereInFrustum(const Frustum& frustum, const Vector3& center, float radius)
+    {
+        for (const Vector4& plane : frustum.Planes)
+        {
+            if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool IsMeshletBackfacing(const DirectX::CullData& cullData, const Vector3& viewpoint)
+    {
+        // DirectXMesh marks meshlets whose triangles cannot be bounded by a cone with the maximum cutoff
+        const DirectX::PackedVector::XMUBYTEN4& cone = cullData.NormalCone;
+        if (cone.w == 0xFF)
+        {
+            return false;
+        }
+
+        // Axis is quantized from [-1, 1] to unorm8, cutoff is -cos(a + 90) of the half-angle a of the normal cone
+        Vector3 axis = Vector3(cone.x, cone.y, cone.z) * (2.0f / 255.0f) - Vector3(1.0f);
+        float cutoff = cone.w / 255.0f;
+
+        const DirectX::BoundingSphere& sphere = cullData.BoundingSphere;
+        Vector3 apex = Vector3(sphere.Center) - axis * cullData.ApexOffset;
+        Vector3 view = viewpoint - apex;
+        float length = view.Length();
+        if (length == 0.0f)
+        {
+            return false;
+        }
+
+        // The viewpoint is behind every triangle if it lies inside of the cone that is opposite to the normal cone
+        return view.Dot(-axis) > cutoff * length;
+    }
+
+    MeshletCullStats CullMeshlets(
+        std::span<const DirectX::CullData> cullData,
+        const Matrix& modelToWorld,
+        const Matrix& viewProjection,
+        const Vector3& cameraPosition,
+        std::vector<uint32_t>& visibleMeshlets)
+    {
+        MeshletCullStats stats = MeshletCullStats{ .NumMeshlets = static_cast<uint32_t>(cullData.size()) };
+        visibleMeshlets.clear();
+        visibleMeshlets.reserve(cullData.size());
+
+        // Bring the frustum and the camera into model space once instead of transforming every meshlet into world space
+        Frustum frustum = Frustum::FromMatrix(modelToWorld * viewProjection);
+
+        Vector3 viewpoint = Vector3::Transform(cameraPosition, modelToWorld.Invert());
+
+        // Rotations, mirroring and uniform scaling preserve angles between normals and view directions
+        float scaleX = Vector3(modelToWorld._11, modelToWorld._12, modelToWorld._13).Length();
+        float scaleY = Vector3(modelToWorld._21, modelToWorld._22, modelToWorld._23).Length();
+        float scaleZ = Vector3(modelToWorld._31, modelToWorld._32, modelToWorld._33).Length();
+        float maxScale = std::max({ scaleX, scaleY, scaleZ });
+        float minScale = std::min({ scaleX, scaleY, scaleZ });
+        bool cullBackfaces = maxScale - minScale <= maxScale * 1e-4f;
+
+        for (size_t meshletIndex = 0; meshletIndex < cullData.size(); ++meshletIndex)
+        {
+            const DirectX::CullData& meshlet = cullData[meshletIndex];
+            if (!IsSphereInFrustum(frustum, Vector3(meshlet.BoundingSphere.Center), meshlet.BoundingSphere.Radius))
+            {
+                ++stats.NumFrustumCulled;
+                continue;
+            }
+
+            if (cullBackfaces && IsMeshletBackfacing(meshlet, viewpoint))
+            {
+                ++stats.NumBackfaceCulled;
+                continue;
+            }
+
+            visibleMeshlets.push_back(static_cast<uint32_t>(meshletIndex));
+        }
+
+        WARP_ASSERT(stats.NumFrustumCulled + stats.NumBackfaceCulled + visibleMeshlets.size() == stats.NumMeshlets);
+        return stats;
+    }
+
+}
\ No newline at end of file
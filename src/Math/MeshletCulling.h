@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <DirectXMesh/DirectXMesh.h>
+
+#include "Math.h"
+
+namespace Warp::Math
+{
+
+    // Six planes of a view volume, normals point inside. A point p is inside of a plane if dot(plane.xyz, p) + plane.w >= 0
+    struct Frustum
+    {
+        enum EPlane
+        {
+            ePlane_Left = 0,
+            ePlane_Right,
+            ePlane_Bottom,
+            ePlane_Top,
+            ePlane_Near,
+            ePlane_Far,
+            ePlane_NumPlanes,
+        };
+
+        // Extracts normalized planes of a D3D projection (z in [0, 1]) for row vectors, as SimpleMath uses them
+        // The planes are in the space that the matrix transforms from, e.g. modelToWorld * view * proj gives model space planes
+        static Frustum FromMatrix(const Matrix& m);
+
+        Vector4 Planes[ePlane_NumPlanes];
+    };
+
+    // Returns false if the sphere is fully outside of at least one plane. Conservative near the corners of the frustum
+    bool IsSphereInFrustum(const Frustum& frustum, const Vector3& center, float radius);
+
+    // Returns true if every triangle of the meshlet faces away from the viewpoint, which should be in the space of the meshlet
+    // Meshlets with degenerate normal cones (triangles facing in too many directions) are never backfacing
+    bool IsMeshletBackfacing(const DirectX::CullData& cullData, const Vector3& viewpoint);
+
+    struct MeshletCullStats
+    {
+        uint32_t NumMeshlets = 0;
+        uint32_t NumFrustumCulled = 0;
+        uint32_t NumBackfaceCulled = 0;
+    };
+
+    // Tests every meshlet of a submesh against the view frustum and against its normal cone and writes indices of visible meshlets into visibleMeshlets
+    // cullData is in model space (see SubmeshLod::MeshletCullData). Culling is done in model space, thus only the frustum and the camera are transformed
+    //
+    // Normal cones do not survive non-uniform scaling, meshlets of such instances are only frustum culled
+    MeshletCullStats CullMeshlets(
+        std::span<const DirectX::CullData> cullData,
+        const Matrix& modelToWorld,
+        const Matrix& viewProjection,
+        const Vector3& cameraPosition,
+        std::vector<uint32_t>& visibleMeshlets);
+
+}
\ No newline at end of file
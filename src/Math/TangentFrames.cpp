@@ -0,0 +1,372 @@
+#include "TangentFrames.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <emmintrin.h>
+
+#include "../Core/Assert.h"
+#include "../Util/CpuFeatures.h"
+
+namespace Warp::Math
+{
+
+    ETangentKernel GetPreferredTangentKernel()
+    {
+        return GetCpuFeatures().Avx2 ? ETangentKernel::Avx2 : ETangentKernel::Sse;
+    }
+
+    template<typename IndexType>
+    static bool ComputeTangentFramesImpl(
+        std::span<const Vector3> positions,
+        std::span<const Vector2> uvs,
+        std::span<const IndexType> indices,
+        std::span<Vector3> tangents,
+        std::span<Vector3> bitangents,
+        ETangentKernel kernel)
+    {
+        static constexpr IndexType UnusedIndex = std::numeric_limits<IndexType>::max();
+
+        static_assert(sizeof(Vector3) == sizeof(float) * 3 && sizeof(Vector2) == sizeof(float) * 2);
+        WARP_ASSERT(positions.size() == uvs.size() && positions.size() == tangents.size() && positions.size() == bitangents.size());
+        WARP_ASSERT(indices.size() % 3 == 0);
+
+        // AVX2 kernel gathers with signed 32-bit offsets of floats
+        WARP_ASSERT(positions.size() <= INT32_MAX / 3);
+
+        // A single pass before any kernel runs, so that none of them has to check indices per lane
+        size_t numUnusedIndices = 0;
+        for (IndexType index : indices)
+        {
+            if (index == UnusedIndex)
+            {
+                ++numUnusedIndices;
+            }
+            else if (index >= positions.size())
+            {
+                return false;
+            }
+        }
+
+        // Triangles with unused indices are rare, thus they are dropped from a copy only if there are any
+        std::vector<IndexType> usedIndices;
+        if (numUnusedIndices > 0)
+        {
+            usedIndices.reserve(indices.size());
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                if (indices[i] != UnusedIndex && indices[i + 1] != UnusedIndex && indices[i + 2] != UnusedIndex)
+                {
+                    usedIndices.insert(usedIndices.end(), indices.begin() + i, indices.begin() + i + 3);
+                }
+            }
+            indices = usedIndices;
+        }
+
+        TangentKernels::KernelArgs args = TangentKernels::KernelArgs{
+            .Positions = reinterpret_cast<const float*>(positions.data()),
+            .Uvs = reinterpret_cast<const float*>(uvs.data()),
+            .Indices = indices.data(),
+            .IndexSize = sizeof(IndexType),
+            .NumVertices = static_cast<uint32_t>(positions.size()),
+            .NumTriangles = static_cast<uint32_t>(indices.size() / 3),
+            .Tangents = reinterpret_cast<float*>(tangents.data()),
+            .Bitangents = reinterpret_cast<float*>(bitangents.data()),
+        };
+
+        switch (kernel)
+        {
+        case ETangentKernel::Scalar: TangentKernels::ComputeScalar(args); break;
+        case ETangentKernel::Sse: TangentKernels::ComputeSse(args); break;
+        case ETangentKernel::Avx2:
+            WARP_ASSERT(GetCpuFeatures().Avx2, "AVX2 is not supported by this CPU");
+            TangentKernels::ComputeAvx2(args);
+            break;
+        default: WARP_ASSERT(false, "Unknown tangent kernel"); break;
+        }
+
+        return true;
+    }
+
+    bool ComputeTangentFrames(
+        std::span<const Vector3> positions,
+        std::span<const Vector2> uvs,
+        std::span<const uint16_t> indices,
+        std::span<Vector3> tangents,
+        std::span<Vector3> bitangents,
+        ETangentKernel kernel)
+    {
+        return ComputeTangentFramesImpl(positions, uvs, indices, tangents, bitangents, kernel);
+    }
+
+    bool ComputeTangentFrames(
+        std::span<const Vector3> positions,
+        std::span<const Vector2> uvs,
+        std::span<const uint32_t> indices,
+        std::span<Vector3> tangents,
+        std::span<Vector3> bitangents,
+        ETangentKernel kernel)
+    {
+        return ComputeTangentFramesImpl(positions, uvs, indices, tangents, bitangents, kernel);
+    }
+
+    namespace TangentKernels
+    {
+
+        static inline void NormalizeFloat3(const float* src, float* dest)
+        {
+            // Zero-length (and NaN) vectors become zero, same as masked SIMD kernels do
+            float length = std::sqrt(src[0] * src[0] + src[1] * src[1] + src[2] * src[2]);
+            if (length > 0.0f)
+            {
+                dest[0] = src[0] / length;
+                dest[1] = src[1] / length;
+                dest[2] = src[2] / length;
+            }
+            else
+            {
+                dest[0] = dest[1] = dest[2] = 0.0f;
+            }
+        }
+
+        // Returns false if the triangle is degenerate in UV space
+        static inline bool ComputeTriangleFrame(const KernelArgs& args, uint32_t triangleIndex, float* tangent, float* bitangent, uint32_t* vertexIndices)
+        {
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                vertexIndices[corner] = args.GetIndex(triangleIndex * 3 + corner);
+            }
+
+            const float* p0 = args.Positions + vertexIndices[0] * 3;
+            const float* p1 = args.Positions + vertexIndices[1] * 3;
+            const float* p2 = args.Positions + vertexIndices[2] * 3;
+            const float* uv0 = args.Uvs + vertexIndices[0] * 2;
+            const float* uv1 = args.Uvs + vertexIndices[1] * 2;
+            const float* uv2 = args.Uvs + vertexIndices[2] * 2;
+
+            float du1x = uv1[0] - uv0[0];
+            float du1y = uv1[1] - uv0[1];
+            float du2x = uv2[0] - uv0[0];
+            float du2y = uv2[1] - uv0[1];
+
+            float det = du1x * du2y - du1y * du2x;
+            float detScale = std::fabs(du1x * du2y) + std::fabs(du1y * du2x);
+            if (!(std::fabs(det) > DegenerateUvDeterminant + DegenerateUvRelativeDeterminant * detScale))
+            {
+                return false;
+            }
+
+            float r = 1.0f / det;
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                float dp1 = p1[i] - p0[i];
+                float dp2 = p2[i] - p0[i];
+                tangent[i] = (dp1 * du2y - dp2 * du1y) * r;
+                bitangent[i] = (dp2 * du1x - dp1 * du2x) * r;
+            }
+
+            return true;
+        }
+
+        void ComputeScalar(const KernelArgs& args)
+        {
+            std::memset(args.Tangents, 0, sizeof(float) * 3 * args.NumVertices);
+            std::memset(args.Bitangents, 0, sizeof(float) * 3 * args.NumVertices);
+
+            for (uint32_t triangleIndex = 0; triangleIndex < args.NumTriangles; ++triangleIndex)
+            {
+                float tangent[3];
+                float bitangent[3];
+                uint32_t vertexIndices[3];
+                if (!ComputeTriangleFrame(args, triangleIndex, tangent, bitangent, vertexIndices))
+                {
+                    continue;
+                }
+
+                for (uint32_t vertexIndex : vertexIndices)
+                {
+                    for (uint32_t i = 0; i < 3; ++i)
+                    {
+                        args.Tangents[vertexIndex * 3 + i] += tangent[i];
+                        args.Bitangents[vertexIndex * 3 + i] += bitangent[i];
+                    }
+                }
+            }
+
+            for (uint32_t vertexIndex = 0; vertexIndex < args.NumVertices; ++vertexIndex)
+            {
+                NormalizeFloat3(args.Tangents + vertexIndex * 3, args.Tangents + vertexIndex * 3);
+                NormalizeFloat3(args.Bitangents + vertexIndex * 3, args.Bitangents + vertexIndex * 3);
+            }
+        }
+
+        void AccumulateTriangle(const KernelArgs& args, uint32_t triangleIndex, Accumulator* accumulators)
+        {
+            float tangent[3];
+            float bitangent[3];
+            uint32_t vertexIndices[3];
+            if (!ComputeTriangleFrame(args, triangleIndex, tangent, bitangent, vertexIndices))
+            {
+                return;
+            }
+
+            for (uint32_t vertexIndex : vertexIndices)
+            {
+                Accumulator& accumulator = accumulators[vertexIndex];
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    accumulator.Tangent[i] += tangent[i];
+                    accumulator.Bitangent[i] += bitangent[i];
+                }
+            }
+        }
+
+        void NormalizeVertices(const KernelArgs& args, const Accumulator* accumulators, uint32_t begin, uint32_t end)
+        {
+            for (uint32_t vertexIndex = begin; vertexIndex < end; ++vertexIndex)
+            {
+                NormalizeFloat3(accumulators[vertexIndex].Tangent, args.Tangents + vertexIndex * 3);
+                NormalizeFloat3(accumulators[vertexIndex].Bitangent, args.Bitangents + vertexIndex * 3);
+            }
+        }
+
+        static inline __m128 GatherSse(const float* base, const uint32_t* offsets)
+        {
+            // No hardware gathers before AVX2
+            return _mm_setr_ps(base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]]);
+        }
+
+        static inline void StoreFloat3Sse(float* dest, __m128 v)
+        {
+            _mm_storel_pi(reinterpret_cast<__m64*>(dest), v);
+            _mm_store_ss(dest + 2, _mm_movehl_ps(v, v));
+        }
+
+        // Normalizes xyz rows of 4 vectors in place. Zero-length vectors become zero
+        static inline void NormalizeRowsSse(__m128& x, __m128& y, __m128& z)
+        {
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+            __m128 mask = _mm_cmpgt_ps(length, _mm_setzero_ps());
+            x = _mm_and_ps(_mm_div_ps(x, length), mask);
+            y = _mm_and_ps(_mm_div_ps(y, length), mask);
+            z = _mm_and_ps(_mm_div_ps(z, length), mask);
+        }
+
+        void ComputeSse(const KernelArgs& args)
+        {
+            static constexpr uint32_t Width = 4;
+
+            std::vector<Accumulator> accumulators(args.NumVertices, Accumulator{});
+
+            uint32_t triangleIndex = 0;
+            for (; triangleIndex + Width <= args.NumTriangles; triangleIndex += Width)
+            {
+                // Offsets of vertex attributes for every corner of every lane
+                uint32_t vertexIndices[3][Width];
+                uint32_t positionOffsets[3][Width];
+                uint32_t uvOffsets[3][Width];
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    for (uint32_t lane = 0; lane < Width; ++lane)
+                    {
+                        uint32_t vertexIndex = args.GetIndex((triangleIndex + lane) * 3 + corner);
+                        vertexIndices[corner][lane] = vertexIndex;
+                        positionOffsets[corner][lane] = vertexIndex * 3;
+                        uvOffsets[corner][lane] = vertexIndex * 2;
+                    }
+                }
+
+                __m128 uv0x = GatherSse(args.Uvs + 0, uvOffsets[0]);
+                __m128 uv0y = GatherSse(args.Uvs + 1, uvOffsets[0]);
+                __m128 du1x = _mm_sub_ps(GatherSse(args.Uvs + 0, uvOffsets[1]), uv0x);
+                __m128 du1y = _mm_sub_ps(GatherSse(args.Uvs + 1, uvOffsets[1]), uv0y);
+                __m128 du2x = _mm_sub_ps(GatherSse(args.Uvs + 0, uvOffsets[2]), uv0x);
+                __m128 du2y = _mm_sub_ps(GatherSse(args.Uvs + 1, uvOffsets[2]), uv0y);
+
+                // Degenerate lanes are masked out instead of branching, their infinities and NaNs are zeroed by the mask
+                __m128 signMask = _mm_set1_ps(-0.0f);
+                __m128 det1 = _mm_mul_ps(du1x, du2y);
+                __m128 det2 = _mm_mul_ps(du1y, du2x);
+                __m128 det = _mm_sub_ps(det1, det2);
+                __m128 detScale = _mm_add_ps(_mm_andnot_ps(signMask, det1), _mm_andnot_ps(signMask, det2));
+                __m128 threshold = _mm_add_ps(_mm_set1_ps(DegenerateUvDeterminant), _mm_mul_ps(_mm_set1_ps(DegenerateUvRelativeDeterminant), detScale));
+                __m128 mask = _mm_cmpgt_ps(_mm_andnot_ps(signMask, det), threshold);
+                __m128 r = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+                __m128 tangentRows[4];
+                __m128 bitangentRows[4];
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    __m128 p0 = GatherSse(args.Positions + i, positionOffsets[0]);
+                    __m128 dp1 = _mm_sub_ps(GatherSse(args.Positions + i, positionOffsets[1]), p0);
+                    __m128 dp2 = _mm_sub_ps(GatherSse(args.Positions + i, positionOffsets[2]), p0);
+
+                    __m128 tangent = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dp1, du2y), _mm_mul_ps(dp2, du1y)), r);
+                    __m128 bitangent = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dp2, du1x), _mm_mul_ps(dp1, du2x)), r);
+                    tangentRows[i] = _mm_and_ps(tangent, mask);
+                    bitangentRows[i] = _mm_and_ps(bitangent, mask);
+                }
+                tangentRows[3] = _mm_setzero_ps();
+                bitangentRows[3] = _mm_setzero_ps();
+
+                // SoA -> one xyz0 vector per triangle
+                _MM_TRANSPOSE4_PS(tangentRows[0], tangentRows[1], tangentRows[2], tangentRows[3]);
+                _MM_TRANSPOSE4_PS(bitangentRows[0], bitangentRows[1], bitangentRows[2], bitangentRows[3]);
+
+                // Scatter-add has to stay sequential as lanes may share vertices. It is done in triangle order, thus sums match the scalar kernel
+                for (uint32_t lane = 0; lane < Width; ++lane)
+                {
+                    for (uint32_t corner = 0; corner < 3; ++corner)
+                    {
+                        Accumulator& accumulator = accumulators[vertexIndices[corner][lane]];
+                        _mm_store_ps(accumulator.Tangent, _mm_add_ps(_mm_load_ps(accumulator.Tangent), tangentRows[lane]));
+                        _mm_store_ps(accumulator.Bitangent, _mm_add_ps(_mm_load_ps(accumulator.Bitangent), bitangentRows[lane]));
+                    }
+                }
+            }
+
+            for (; triangleIndex < args.NumTriangles; ++triangleIndex)
+            {
+                AccumulateTriangle(args, triangleIndex, accumulators.data());
+            }
+
+            uint32_t vertexIndex = 0;
+            for (; vertexIndex + Width <= args.NumVertices; vertexIndex += Width)
+            {
+                const Accumulator* accumulator = accumulators.data() + vertexIndex;
+
+                __m128 tx = _mm_load_ps(accumulator[0].Tangent);
+                __m128 ty = _mm_load_ps(accumulator[1].Tangent);
+                __m128 tz = _mm_load_ps(accumulator[2].Tangent);
+                __m128 tw = _mm_load_ps(accumulator[3].Tangent);
+                _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+                NormalizeRowsSse(tx, ty, tz);
+                _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+
+                __m128 bx = _mm_load_ps(accumulator[0].Bitangent);
+                __m128 by = _mm_load_ps(accumulator[1].Bitangent);
+                __m128 bz = _mm_load_ps(accumulator[2].Bitangent);
+                __m128 bw = _mm_load_ps(accumulator[3].Bitangent);
+                _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+                NormalizeRowsSse(bx, by, bz);
+                _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+                float* tangents = args.Tangents + vertexIndex * 3;
+                float* bitangents = args.Bitangents + vertexIndex * 3;
+                StoreFloat3Sse(tangents + 0, tx);
+                StoreFloat3Sse(tangents + 3, ty);
+                StoreFloat3Sse(tangents + 6, tz);
+                StoreFloat3Sse(tangents + 9, tw);
+                StoreFloat3Sse(bitangents + 0, bx);
+                StoreFloat3Sse(bitangents + 3, by);
+                StoreFloat3Sse(bitangents + 6, bz);
+                StoreFloat3Sse(bitangents + 9, bw);
+            }
+
+            NormalizeVertices(args, accumulators.data(), vertexIndex, args.NumVertices);
+        }
+
+    }
+
+}
\ No newline at end of file
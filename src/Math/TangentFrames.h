@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "Math.h"
+#include "../Core/Defines.h"
+
+namespace Warp::Math
+{
+
+    enum class ETangentKernel
+    {
+        Scalar, // Reference implementation
+        Sse,    // 4 triangles per iteration, always available on x64
+        Avx2,   // 8 triangles per iteration using hardware gathers
+    };
+
+    // Returns the widest kernel supported by the CPU
+    ETangentKernel GetPreferredTangentKernel();
+
+    // Generates per-vertex tangents and bitangents of a triangle list by accumulating per-triangle tangent frames (derived from positions and texture coordinates)
+    // and normalizing the sums. Triangles with degenerate UV mapping do not contribute, vertices that are only referenced by such triangles get zero frames
+    //
+    // tangents and bitangents should have as many elements as positions and uvs, their previous contents are overwritten
+    // Every kernel produces the same results up to floating-point rounding
+    //
+    // Kernels read attributes through indices without bounds checks, thus indices are validated first. Triangles with the unused index
+    // (all bits set, the same as DirectX::Validate() accepts) do not contribute. Returns false and leaves outputs untouched if any other index
+    // is out of range
+    WARP_ATTR_NODISCARD bool ComputeTangentFrames(
+        std::span<const Vector3> positions,
+        std::span<const Vector2> uvs,
+        std::span<const uint16_t> indices,
+        std::span<Vector3> tangents,
+        std::span<Vector3> bitangents,
+        ETangentKernel kernel = GetPreferredTangentKernel());
+
+    WARP_ATTR_NODISCARD bool ComputeTangentFrames(
+        std::span<const Vector3> positions,
+        std::span<const Vector2> uvs,
+        std::span<const uint32_t> indices,
+        std::span<Vector3> tangents,
+        std::span<Vector3> bitangents,
+        ETangentKernel kernel = GetPreferredTangentKernel());
+
+    // Internals shared by kernels, which live in separate translation units as they are compiled with different instruction sets
+    namespace TangentKernels
+    {
+
+        // Determinants of UV mapping at or below this magnitude make the triangle degenerate
+        // The relative part covers rounding of collinear UVs (e.g. of triangles with a repeated vertex), which leaves a residue instead of zero
+        // once a compiler fuses the products of the determinant, thus every kernel rejects the same triangles regardless of FMA contraction
+        static constexpr float DegenerateUvDeterminant = 1e-20f;
+        static constexpr float DegenerateUvRelativeDeterminant = 1e-6f;
+
+        // Tangent and bitangent of a vertex are accumulated next to each other, so that a triangle corner touches a single 32-byte block instead of two separate arrays
+        struct alignas(32) Accumulator
+        {
+            float Tangent[4];
+            float Bitangent[4];
+        };
+
+        struct KernelArgs
+        {
+            const float* Positions; // float3 per vertex
+            const float* Uvs;       // float2 per vertex
+            const void* Indices;    // uint16_t or uint32_t per triangle corner, see IndexSize. Every index is below NumVertices
+            uint32_t IndexSize;
+            uint32_t NumVertices;
+            uint32_t NumTriangles;
+
+            float* Tangents;   // float3 per vertex
+            float* Bitangents; // float3 per vertex
+
+            inline uint32_t GetIndex(size_t i) const
+            {
+                return IndexSize == sizeof(uint16_t) ? static_cast<const uint16_t*>(Indices)[i] : static_cast<const uint32_t*>(Indices)[i];
+            }
+        };
+
+        void ComputeScalar(const KernelArgs& args);
+        void ComputeSse(const KernelArgs& args);
+        void ComputeAvx2(const KernelArgs& args);
+
+        // Accumulates a single triangle, used by SIMD kernels for the remainder
+        void AccumulateTriangle(const KernelArgs& args, uint32_t triangleIndex, Accumulator* accumulators);
+
+        // Normalizes a range of accumulated vertices and writes them out, used by SIMD kernels for the remainder
+        void NormalizeVertices(const KernelArgs& args, const Accumulator* accumulators, uint32_t begin, uint32_t end);
+
+    }
+
+}
\ No newline at end of file
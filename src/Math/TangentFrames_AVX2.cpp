@@ -0,0 +1,178 @@
+// This translation unit is compiled with AVX2 enabled (see CMakeLists.txt)
+// Nothing here may be called unless GetCpuFeatures().Avx2 is true
+#include "TangentFrames.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <immintrin.h>
+
+namespace Warp::Math::TangentKernels
+{
+
+    // Rows r[i] become columns. Used both for SoA -> AoS and AoS -> SoA, as the transposition is an involution
+    static inline void Transpose8x8(__m256* r)
+    {
+        __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+        __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+        __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+        __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+        __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+        __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+        __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+        __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+        __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+        r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+    }
+
+    static inline void StoreFloat3(float* dest, __m128 v)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(dest), v);
+        _mm_store_ss(dest + 2, _mm_movehl_ps(v, v));
+    }
+
+    // Normalizes xyz rows of 8 vectors in place. Zero-length vectors become zero
+    static inline void NormalizeRows(__m256& x, __m256& y, __m256& z)
+    {
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+        __m256 mask = _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_GT_OQ);
+        x = _mm256_and_ps(_mm256_div_ps(x, length), mask);
+        y = _mm256_and_ps(_mm256_div_ps(y, length), mask);
+        z = _mm256_and_ps(_mm256_div_ps(z, length), mask);
+    }
+
+    void ComputeAvx2(const KernelArgs& args)
+    {
+        static constexpr uint32_t Width = 8;
+
+        std::vector<Accumulator> accumulators(args.NumVertices, Accumulator{});
+
+        // Lane i reads the corner of triangle i, indices of consecutive triangles are 3 apart
+        const __m256i triangleStrides = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+        // 16-bit indices are gathered as 32-bit values with the upper half masked off. The last lane reads 2 bytes past its triangle,
+        // thus the block that contains the final triangle is left for the scalar remainder
+        const bool is16BitIndices = args.IndexSize == sizeof(uint16_t);
+        const uint32_t numBlockTriangles = is16BitIndices ? args.NumTriangles - std::min(args.NumTriangles, 1u) : args.NumTriangles;
+        const __m256i indexMask = _mm256_set1_epi32(is16BitIndices ? 0xFFFF : -1);
+
+        uint32_t triangleIndex = 0;
+        for (; triangleIndex + Width <= numBlockTriangles; triangleIndex += Width)
+        {
+            const std::byte* indices = static_cast<const std::byte*>(args.Indices) + size_t(triangleIndex) * 3 * args.IndexSize;
+
+            __m256i vertexIndices[3];
+            __m256i positionOffsets[3];
+            __m256i uvOffsets[3];
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const int* cornerIndices = reinterpret_cast<const int*>(indices + corner * args.IndexSize);
+                vertexIndices[corner] = is16BitIndices ?
+                    _mm256_and_si256(_mm256_i32gather_epi32(cornerIndices, triangleStrides, 2), indexMask) :
+                    _mm256_i32gather_epi32(cornerIndices, triangleStrides, 4);
+                positionOffsets[corner] = _mm256_add_epi32(_mm256_slli_epi32(vertexIndices[corner], 1), vertexIndices[corner]);
+                uvOffsets[corner] = _mm256_slli_epi32(vertexIndices[corner], 1);
+            }
+
+            __m256 uv0x = _mm256_i32gather_ps(args.Uvs + 0, uvOffsets[0], 4);
+            __m256 uv0y = _mm256_i32gather_ps(args.Uvs + 1, uvOffsets[0], 4);
+            __m256 du1x = _mm256_sub_ps(_mm256_i32gather_ps(args.Uvs + 0, uvOffsets[1], 4), uv0x);
+            __m256 du1y = _mm256_sub_ps(_mm256_i32gather_ps(args.Uvs + 1, uvOffsets[1], 4), uv0y);
+            __m256 du2x = _mm256_sub_ps(_mm256_i32gather_ps(args.Uvs + 0, uvOffsets[2], 4), uv0x);
+            __m256 du2y = _mm256_sub_ps(_mm256_i32gather_ps(args.Uvs + 1, uvOffsets[2], 4), uv0y);
+
+            // Degenerate lanes are masked out instead of branching, their infinities and NaNs are zeroed by the mask
+            __m256 signMask = _mm256_set1_ps(-0.0f);
+            __m256 det1 = _mm256_mul_ps(du1x, du2y);
+            __m256 det2 = _mm256_mul_ps(du1y, du2x);
+            __m256 det = _mm256_sub_ps(det1, det2);
+            __m256 detScale = _mm256_add_ps(_mm256_andnot_ps(signMask, det1), _mm256_andnot_ps(signMask, det2));
+            __m256 threshold = _mm256_add_ps(_mm256_set1_ps(DegenerateUvDeterminant), _mm256_mul_ps(_mm256_set1_ps(DegenerateUvRelativeDeterminant), detScale));
+            __m256 mask = _mm256_cmp_ps(_mm256_andnot_ps(signMask, det), threshold, _CMP_GT_OQ);
+            __m256 r = _mm256_div_ps(_mm256_set1_ps(1.0f), det);
+
+            // Rows are laid out as an accumulator: tangent xyz0, bitangent xyz0
+            __m256 rows[8];
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                __m256 p0 = _mm256_i32gather_ps(args.Positions + i, positionOffsets[0], 4);
+                __m256 dp1 = _mm256_sub_ps(_mm256_i32gather_ps(args.Positions + i, positionOffsets[1], 4), p0);
+                __m256 dp2 = _mm256_sub_ps(_mm256_i32gather_ps(args.Positions + i, positionOffsets[2], 4), p0);
+
+                __m256 tangent = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(dp1, du2y), _mm256_mul_ps(dp2, du1y)), r);
+                __m256 bitangent = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(dp2, du1x), _mm256_mul_ps(dp1, du2x)), r);
+                rows[i] = _mm256_and_ps(tangent, mask);
+                rows[4 + i] = _mm256_and_ps(bitangent, mask);
+            }
+            rows[3] = _mm256_setzero_ps();
+            rows[7] = _mm256_setzero_ps();
+
+            // SoA -> one accumulator-shaped vector per triangle, so that every corner is a single 256-bit add
+            Transpose8x8(rows);
+
+            alignas(32) uint32_t laneVertexIndices[3][Width];
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(laneVertexIndices[corner]), vertexIndices[corner]);
+            }
+
+            // Scatter-add has to stay sequential as lanes may share vertices. It is done in triangle order, thus sums match the scalar kernel
+            for (uint32_t lane = 0; lane < Width; ++lane)
+            {
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    float* accumulator = accumulators[laneVertexIndices[corner][lane]].Tangent;
+                    _mm256_store_ps(accumulator, _mm256_add_ps(_mm256_load_ps(accumulator), rows[lane]));
+                }
+            }
+        }
+
+        for (; triangleIndex < args.NumTriangles; ++triangleIndex)
+        {
+            AccumulateTriangle(args, triangleIndex, accumulators.data());
+        }
+
+        uint32_t vertexIndex = 0;
+        for (; vertexIndex + Width <= args.NumVertices; vertexIndex += Width)
+        {
+            __m256 rows[8];
+            for (uint32_t i = 0; i < Width; ++i)
+            {
+                rows[i] = _mm256_load_ps(accumulators[vertexIndex + i].Tangent);
+            }
+
+            // AoS -> SoA, normalize 8 tangents and 8 bitangents at once and go back
+            Transpose8x8(rows);
+            NormalizeRows(rows[0], rows[1], rows[2]);
+            NormalizeRows(rows[4], rows[5], rows[6]);
+            Transpose8x8(rows);
+
+            float* tangents = args.Tangents + vertexIndex * 3;
+            float* bitangents = args.Bitangents + vertexIndex * 3;
+            for (uint32_t i = 0; i < Width; ++i)
+            {
+                StoreFloat3(tangents + i * 3, _mm256_castps256_ps128(rows[i]));
+                StoreFloat3(bitangents + i * 3, _mm256_extractf128_ps(rows[i], 1));
+            }
+        }
+
+        NormalizeVertices(args, accumulators.data(), vertexIndex, args.NumVertices);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "AssetReleaseQueue.h"
+
+#include "Renderer.h"
+#include "TextureStreamer.h"
+#include "../Assets/AssetManager.h"
+#include "../Assets/Importers/TextureImporter.h"
+#include "../Core/Assert.h"
+
+namespace Warp
+{
+
+    AssetReleaseQueue::AssetReleaseQueue(Renderer* renderer, AssetManager* assetManager, TextureStreamer* textureStreamer, std::vector<TextureImporter*> textureImporters)
+        : m_renderer(renderer)
+        , m_assetManager(assetManager)
+        , m_textureStreamer(textureStreamer)
+        , m_textureImporters(std::move(textureImporters))
+    {
+        WARP_ASSERT(m_renderer && m_assetManager);
+    }
+
+    AssetReleaseQueue::~AssetReleaseQueue()
+    {
+        // Released meshes release their materials once destroyed, and materials release their textures
+        while (true)
+        {
+            TakeReleasedAssets();
+            if (m_releasedAssets.empty())
+            {
+                break;
+            }
+
+            m_renderer->GetGraphicsContext().GetQueue()->HostWaitForValue(m_releasedAssets.back().GraphicsFenceValue);
+            m_renderer->GetCopyContext().GetQueue()->HostWaitForValue(m_releasedAssets.back().CopyFenceValue);
+            DestroyReleasedAssets(true);
+        }
+    }
+
+    void AssetReleaseQueue::Update()
+    {
+        TakeReleasedAssets();
+        DestroyReleasedAssets(false);
+    }
+
+    void AssetReleaseQueue::TakeReleasedAssets()
+    {
+        m_takenAssets.clear();
+        m_assetManager->TakeReleasedAssets(m_takenAssets);
+
+        // Every submission made so far may use the assets. Nothing new is recorded with them, as nothing refers to them anymore
+        // Uploads are submitted to the copy queue without waiting, an asset released right after its import may still be written by one
+        UINT64 graphicsFenceValue = m_renderer->GetGraphicsContext().GetQueue()->GetFenceNextValue() - 1;
+        UINT64 copyFenceValue = m_renderer->GetCopyContext().GetQueue()->GetFenceNextValue() - 1;
+        for (AssetProxy& proxy : m_takenAssets)
+        {
+            m_releasedAssets.push_back(ReleasedAsset{ .Proxy = proxy, .GraphicsFenceValue = graphicsFenceValue, .CopyFenceValue = copyFenceValue });
+        }
+    }
+
+    void AssetReleaseQueue::DestroyReleasedAssets(bool destroyAll)
+    {
+        while (!m_releasedAssets.empty())
+        {
+            ReleasedAsset& released = m_releasedAssets.front();
+            if (!destroyAll && !IsFenceComplete(released))
+            {
+                // Assets are released in submission order
+                break;
+            }
+
+            AssetProxy proxy = released.Proxy;
+            m_releasedAssets.pop_front();
+            DestroyAsset(proxy);
+        }
+    }
+
+    bool AssetReleaseQueue::IsFenceComplete(const ReleasedAsset& released) const
+    {
+        return m_renderer->GetGraphicsContext().GetQueue()->IsFenceComplete(released.GraphicsFenceValue) &&
+            m_renderer->GetCopyContext().GetQueue()->IsFenceComplete(released.CopyFenceValue);
+    }
+
+    void AssetReleaseQueue::DestroyAsset(AssetProxy proxy)
+    {
+        // Assets may be referenced again after their release, or be released more than once before they are destroyed
+        // Nothing can reference the asset once the callback runs, thus the descriptor and the streamed texture are released only for assets that do get destroyed
+        m_assetManager->DestroyIfUnreferenced(proxy, [this](AssetProxy destroyed)
+            {
+                if (destroyed.Type != EAssetType::Texture)
+                {
+                    return;
+                }
+
+                if (m_textureStreamer)
+                {
+                    m_textureStreamer->RemoveTexture(destroyed);
+                }
+
+                for (TextureImporter* importer : m_textureImporters)
+                {
+                    importer->RemoveTexture(destroyed);
+                }
+
+                // Views do not own their descriptors, the rest of the texture is released along with the asset
+                TextureAsset* texture = m_assetManager->GetAs<TextureAsset>(destroyed);
+                if (texture->SrvAllocation.IsValid())
+                {
+                    m_renderer->GetDevice()->GetViewHeap()->Free(std::move(texture->SrvAllocation));
+                }
+            });
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "../Assets/Asset.h"
+#include "RHI/stdafx.h"
+
+namespace Warp
+{
+
+    class AssetManager;
+    class Renderer;
+    class TextureImporter;
+    class TextureStreamer;
+
+    // Destroys assets whose last handle was dropped (see AssetHandle). Textures and submesh buffers of released assets may still be used by frames in flight,
+    // or be written by uploads of importers and of the texture streamer, which go through the copy queue. Thus assets are destroyed only once both
+    // the graphics queue and the copy queue have passed every submission made before they were released
+    // Destroying an asset drops the handles it holds, meshes release their materials and materials release their textures on the next updates
+    class AssetReleaseQueue
+    {
+    public:
+        // textureStreamer may be nullptr. Destroyed textures are removed from the streamer and from every importer of textureImporters
+        AssetReleaseQueue(Renderer* renderer, AssetManager* assetManager, TextureStreamer* textureStreamer, std::vector<TextureImporter*> textureImporters);
+
+        AssetReleaseQueue(const AssetReleaseQueue&) = delete;
+        AssetReleaseQueue& operator=(const AssetReleaseQueue&) = delete;
+
+        // Waits for the graphics and copy queues and destroys every released asset, including those released by the destruction itself
+        ~AssetReleaseQueue();
+
+        // Takes assets released since the previous update and destroys those both queues are done with. Should be called once per frame
+        void Update();
+
+        inline uint32_t GetNumPendingAssets() const { return static_cast<uint32_t>(m_releasedAssets.size()); }
+
+    private:
+        struct ReleasedAsset
+        {
+            AssetProxy Proxy;
+            UINT64 GraphicsFenceValue; // Last graphics submission that may use the asset
+            UINT64 CopyFenceValue; // Last copy submission that may write its resources
+        };
+
+        bool IsFenceComplete(const ReleasedAsset& released) const;
+
+        void TakeReleasedAssets();
+        void DestroyReleasedAssets(bool destroyAll);
+        void DestroyAsset(AssetProxy proxy);
+
+        Renderer* m_renderer;
+        AssetManager* m_assetManager;
+        TextureStreamer* m_textureStreamer;
+        std::vector<TextureImporter*> m_textureImporters;
+
+        std::vector<AssetProxy> m_takenAssets;
+        std::deque<ReleasedAsset> m_releasedAssets;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "GpuTextureStreamingBackend.h"
+
+#include "Renderer.h"
+#include "../Assets/AssetManager.h"
+#include "../Assets/TextureAsset.h"
+#include "../Core/Assert.h"
+
+namespace Warp
+{
+
+    GpuTextureStreamingBackend::GpuTextureStreamingBackend(Renderer* renderer, AssetManager* assetManager)
+        : m_renderer(renderer)
+        , m_assetManager(assetManager)
+    {
+        WARP_ASSERT(m_renderer && m_assetManager);
+    }
+
+    GpuTextureStreamingBackend::~GpuTextureStreamingBackend()
+    {
+        // Streamer goes away before the renderer, frames in flight may still sample retired textures and uploads may still write them
+        if (!m_retiredTextures.empty())
+        {
+            m_renderer->GetGraphicsContext().GetQueue()->HostWaitForValue(m_retiredTextures.back().GraphicsFenceValue);
+            m_renderer->GetCopyContext().GetQueue()->HostWaitForValue(m_retiredTextures.back().CopyFenceValue);
+        }
+        ReleaseRetiredTextures(true);
+    }
+
+    void GpuTextureStreamingBackend::Update()
+    {
+        ReleaseRetiredTextures(false);
+    }
+
+    void GpuTextureStreamingBackend::BeginUploads()
+    {
+        RHICopyCommandContext& copyContext = m_renderer->GetCopyContext();
+        copyContext.BeginCopy();
+        copyContext.Open();
+    }
+
+    void GpuTextureStreamingBackend::EndUploads()
+    {
+        RHICopyCommandContext& copyContext = m_renderer->GetCopyContext();
+        copyContext.Close();
+
+        UINT64 fenceValue = copyContext.Execute(false);
+        copyContext.EndCopy(fenceValue);
+    }
+
+    bool GpuTextureStreamingBackend::UploadMips(AssetProxy proxy, const ImageLoader::Image& image, uint32_t firstMip, ETextureUsage usage)
+    {
+        TextureAsset* asset = m_assetManager->GetAs<TextureAsset>(proxy);
+        if (!asset || !asset->IsResident())
+        {
+            return false;
+        }
+
+        // Every submission recorded so far may sample the current texture. Nothing new is recorded with it after this point
+        // The texture may have been uploaded by an import or by the previous update, with the copy still in flight
+        m_retiredTextures.push_back(RetiredTexture{
+            .Texture = std::move(asset->Texture),
+            .Srv = std::move(asset->Srv),
+            .SrvAllocation = asset->SrvAllocation,
+            .GraphicsFenceValue = m_renderer->GetGraphicsContext().GetQueue()->GetFenceNextValue() - 1,
+            .CopyFenceValue = m_renderer->GetCopyContext().GetQueue()->GetFenceNextValue() - 1,
+            });
+
+        // Views sample mips relative to the first resident one, UVs stay the same as every mip covers the whole surface
+        TextureImporter::CreateTextureResources(asset, image, usage, m_renderer->GetCopyContext());
+        return true;
+    }
+
+    bool GpuTextureStreamingBackend::IsFenceComplete(const RetiredTexture& retired) const
+    {
+        return m_renderer->GetGraphicsContext().GetQueue()->IsFenceComplete(retired.GraphicsFenceValue) &&
+            m_renderer->GetCopyContext().GetQueue()->IsFenceComplete(retired.CopyFenceValue);
+    }
+
+    void GpuTextureStreamingBackend::ReleaseRetiredTextures(bool releaseAll)
+    {
+        RHIDescriptorHeap* viewHeap = m_renderer->GetDevice()->GetViewHeap();
+        while (!m_retiredTextures.empty())
+        {
+            RetiredTexture& retired = m_retiredTextures.front();
+            if (!releaseAll && !IsFenceComplete(retired))
+            {
+                // Textures are retired in submission order
+                break;
+            }
+
+            viewHeap->Free(std::move(retired.SrvAllocation));
+            m_retiredTextures.pop_front();
+        }
+    }
+
+}
\ No newline at end of file
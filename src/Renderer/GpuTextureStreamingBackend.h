@@ -0,0 +1,47 @@
+#pragma once
+
+#include <deque>
+
+#include "TextureStreamer.h"
+#include "RHI/Resource.h"
+#include "RHI/Descriptor.h"
+
+namespace Warp
+{
+
+    class AssetManager;
+    class Renderer;
+
+    // Recreates streamed textures with their new mip ranges through the copy context of the renderer
+    // Replaced textures and their SRVs may still be used by frames in flight, or be written by uploads in flight on the copy queue,
+    // thus they are released only once both queues have passed them
+    class GpuTextureStreamingBackend final : public TextureStreamingBackend
+    {
+    public:
+        GpuTextureStreamingBackend(Renderer* renderer, AssetManager* assetManager);
+        ~GpuTextureStreamingBackend() override;
+
+        void Update() override;
+        void BeginUploads() override;
+        void EndUploads() override;
+        bool UploadMips(AssetProxy proxy, const ImageLoader::Image& image, uint32_t firstMip, ETextureUsage usage) override;
+
+    private:
+        struct RetiredTexture
+        {
+            RHITexture Texture;
+            RHIShaderResourceView Srv;
+            RHIDescriptorAllocation SrvAllocation;
+            UINT64 GraphicsFenceValue; // Last graphics submission that may use the texture
+            UINT64 CopyFenceValue; // Last copy submission that may write the texture
+        };
+
+        bool IsFenceComplete(const RetiredTexture& retired) const;
+        void ReleaseRetiredTextures(bool releaseAll);
+
+        Renderer* m_renderer;
+        AssetManager* m_assetManager;
+        std::deque<RetiredTexture> m_retiredTextures;
+    };
+
+}
\ No newline at end of file
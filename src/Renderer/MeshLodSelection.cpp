@@ -0,0 +1,89 @@
+#include "MeshLodSelection.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Core/Assert.h"
+
+namespace Warp
+{
+
+    // Largest scale of the instance, so that both the sphere and the error grow conservatively
+    static float GetMaxScale(const Math::Matrix& instanceToWorld)
+    {
+        float scaleX = Math::Vector3(instanceToWorld._11, instanceToWorld._12, instanceToWorld._13).Length();
+        float scaleY = Math::Vector3(instanceToWorld._21, instanceToWorld._22, instanceToWorld._23).Length();
+        float scaleZ = Math::Vector3(instanceToWorld._31, instanceToWorld._32, instanceToWorld._33).Length();
+        return std::max({ scaleX, scaleY, scaleZ });
+    }
+
+    // Returns the number of pixels a unit at the closest point of the submesh's bounding sphere covers
+    static float GetPixelsPerUnit(
+        const Submesh& submesh,
+        float scale,
+        const Math::Matrix& instanceToWorld,
+        const EulersCameraComponent& camera,
+        uint32_t viewportHeight)
+    {
+        Math::Vector3 center = Math::Vector3::Transform(Math::Vector3(submesh.BoundingSphere.Center), instanceToWorld);
+        float radius = submesh.BoundingSphere.Radius * scale;
+
+        // Inside of the sphere every level is as close as the near plane
+        float distance = std::max((center - camera.EyePos).Length() - radius, camera.NearPlane);
+
+        // Fov is vertical, see EulersCameraComponent::SetProjection()
+        float pixelsPerUnitAtOne = static_cast<float>(viewportHeight) / (2.0f * std::tan(Math::ToRadians(camera.Fov) * 0.5f));
+        return pixelsPerUnitAtOne / distance;
+    }
+
+    float ComputeLodScreenSpaceError(
+        const Submesh& submesh,
+        uint32_t lodIndex,
+        const Math::Matrix& instanceToWorld,
+        const EulersCameraComponent& camera,
+        uint32_t viewportHeight)
+    {
+        WARP_ASSERT(lodIndex < submesh.GetNumLods());
+
+        const SubmeshLod& lod = submesh.Lods[lodIndex];
+        if (lod.Error == 0.0f)
+        {
+            return 0.0f;
+        }
+
+        float scale = GetMaxScale(instanceToWorld);
+        return lod.Error * scale * GetPixelsPerUnit(submesh, scale, instanceToWorld, camera, viewportHeight);
+    }
+
+    float ComputeSubmeshScreenSize(
+        const Submesh& submesh,
+        const Math::Matrix& instanceToWorld,
+        const EulersCameraComponent& camera,
+        uint32_t viewportHeight)
+    {
+        float scale = GetMaxScale(instanceToWorld);
+        return 2.0f * submesh.BoundingSphere.Radius * scale * GetPixelsPerUnit(submesh, scale, instanceToWorld, camera, viewportHeight);
+    }
+
+    LodSelection SelectSubmeshLod(
+        const Submesh& submesh,
+        const Math::Matrix& instanceToWorld,
+        const EulersCameraComponent& camera,
+        uint32_t viewportHeight,
+        float maxScreenSpaceError)
+    {
+        LodSelection selection;
+        for (uint32_t lodIndex = 1; lodIndex < submesh.GetNumLods(); ++lodIndex)
+        {
+            float error = ComputeLodScreenSpaceError(submesh, lodIndex, instanceToWorld, camera, viewportHeight);
+            if (error > maxScreenSpaceError)
+            {
+                break;
+            }
+
+            selection = LodSelection{ .LodIndex = lodIndex, .ScreenSpaceError = error };
+        }
+        return selection;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../Assets/MeshAsset.h"
+#include "../Math/Math.h"
+#include "../World/Components/CameraComponent.h"
+
+namespace Warp
+{
+
+    struct LodSelection
+    {
+        uint32_t LodIndex = 0;
+        float ScreenSpaceError = 0.0f; // Pixels
+    };
+
+    // Projects the simplification error of a level of detail onto the screen, in pixels
+    // The error is placed at the point of the bounding sphere that is closest to the camera, which makes the estimate conservative
+    float ComputeLodScreenSpaceError(
+        const Submesh& submesh,
+        uint32_t lodIndex,
+        const Math::Matrix& instanceToWorld,
+        const EulersCameraComponent& camera,
+        uint32_t viewportHeight);
+
+    // Projects the bounding sphere of the submesh onto the screen and returns its diameter, in pixels
+    // Like the error above, the sphere is measured at its point closest to the camera
+    float ComputeSubmeshScreenSize(
+        const Submesh& submesh,
+        const Math::Matrix& instanceToWorld,
+        const EulersCameraComponent& camera,
+        uint32_t viewportHeight);
+
+    // Picks the coarsest level of detail of the submesh whose projected error stays within maxScreenSpaceError pixels
+    // Errors grow with every level (see SubmeshLod::Error), thus levels are tested from the finest one
+    LodSelection SelectSubmeshLod(
+        const Submesh& submesh,
+        const Math::Matrix& instanceToWorld,
+        const EulersCameraComponent& camera,
+        uint32_t viewportHeight,
+        float maxScreenSpaceError);
+
+}
\ No newline at end of file
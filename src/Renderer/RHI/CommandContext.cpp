@@ -227,7 +227,7 @@ namespace Warp
         WARP_ASSERT(processedBytes > 0, "Upload was unsuccessful");
     }
 
-    void RHICopyCommandContext::UploadToBuffer(RHIBuffer* dest, void* src, size_t numBytes)
+    void RHICopyCommandContext::UploadToBuffer(RHIBuffer* dest, const void* src, size_t numBytes)
     {
         RHIDevice* Device = m_queue->GetDevice();
         RHIBuffer uploadBuffer = RHIBuffer(Device,
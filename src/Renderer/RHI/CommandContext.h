@@ -89,7 +89,7 @@ namespace Warp
         void CopyResource(RHIResource* dest, RHIResource* src);
         void UploadSubresources(RHIResource* dest, std::span<D3D12_SUBRESOURCE_DATA> subresourceData, UINT subresourceOffset);
         void UploadSubresources(RHIResource* dest, std::span<D3D12_SUBRESOURCE_DATA> subresourceData, UINT subresourceOffset, RHIResource* uploadBuffer);
-        void UploadToBuffer(RHIBuffer* dest, void* src, size_t numBytes);
+        void UploadToBuffer(RHIBuffer* dest, const void* src, size_t numBytes);
 
     private:
         RHIResourceTrackingContext<RHIBuffer> m_uploadBufferTrackingContext;
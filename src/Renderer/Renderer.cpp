@@ -1,5 +1,10 @@
 #include "Renderer.h"
 
+#include <algorithm>
+#include <format>
+#include <numeric>
+#include <string>
+
 #include "../World/World.h"
 #include "../World/Components.h"
 #include "../World/Entity.h"
@@ -12,7 +17,10 @@
 
 // TODO: Temp, remove
 #include "../Math/Math.h"
+#include "../Math/MeshletCulling.h"
 
+#include "MeshLodSelection.h"
+#include "TextureStreamer.h"
 #include "RHI/PIXRuntime.h"
 
 
@@ -36,8 +44,17 @@ namespace Warp
         eHlslDrawPropertyFlag_NoNormalMap = 8,
         eHlslDrawPropertyFlag_NoRoughnessMetalnessMap = 16,
         eHlslDrawPropertyFlag_NoBaseColorMap = 32,
+        eHlslDrawPropertyFlag_16BitVertexIndices = 64,
+        eHlslDrawPropertyFlag_QuantizedVertices = 128,
     };
 
+    // Textures that are still being imported asynchronously are valid assets, but have nothing to bind yet
+    static bool IsTextureResident(AssetManager* manager, AssetProxy proxy)
+    {
+        TextureAsset* texture = manager->GetAs<TextureAsset>(proxy);
+        return texture && texture->IsResident();
+    }
+
     struct alignas(256) HlslDrawData
     {
         Math::Matrix InstanceToWorld;
@@ -58,6 +75,7 @@ namespace Warp
         BasicRootParamIdx_Meshlets,
         BasicRootParamIdx_UniqueVertexIndices,
         BasicRootParamIdx_PrimitiveIndices,
+        BasicRootParamIdx_VisibleMeshlets,
         BasicRootParamIdx_BaseColor,
         BasicRootParamIdx_NormalMap,
         BasicRootParamIdx_MetalnessRoughnessMap,
@@ -70,16 +88,20 @@ namespace Warp
         Math::Matrix LightProj;
     };
 
-    struct alignas(256) HlslShadowingDrawData
+    // Element of a structured buffer, thus tightly packed. It does not depend on the light, every submesh has one per frame
+    struct HlslShadowingDrawData
     {
         Math::Matrix InstanceToWorld;
+        EHlslDrawPropertyFlags DrawFlags;
     };
+    static_assert(sizeof(HlslShadowingDrawData) == 68, "Should match DrawData of DirectionalShadowing.hlsl");
 
     // Represents indices of DirectionalShadowing.hlsl root signature
     enum DirShadowingRootParamIdx
     {
         DirShadowingRootParamIdx_CbViewData,
-        DirShadowingRootParamIdx_CbDrawData,
+        DirShadowingRootParamIdx_DrawIndex,
+        DirShadowingRootParamIdx_DrawData,
         DirShadowingRootParamIdx_Positions,
         DirShadowingRootParamIdx_Meshlets,
         DirShadowingRootParamIdx_UniqueVertexIndices,
@@ -203,26 +225,32 @@ namespace Warp
             struct Submesh
             {
                 EHlslDrawPropertyFlags DrawFlags;
+                uint32_t LodIndex;
             };
             std::vector<Submesh> Submeshes;
         };
 
+        Entity worldCamera = world->GetWorldCamera();
+        const EulersCameraComponent& cameraComponent = worldCamera.GetComponent<EulersCameraComponent>();
+        uint32_t viewportHeight = m_swapchain->GetHeight();
+
+        // Every sampled texture tells the streamer how large it appears, see TextureStreamer::RequestScreenSize()
+        TextureStreamer* textureStreamer = Application::Get().GetTextureStreamer();
+
         std::vector<MeshInstance> meshInstances;
-        world->GetEntityCapacitor().ViewOf<MeshComponent, TransformComponent>().each(
-            [&meshInstances](MeshComponent& meshComponent, const TransformComponent& transformComponent)
+        EntityCapacitor& entityCapacitor = world->GetEntityCapacitor();
+        entityCapacitor.ViewOf<MeshComponent, TransformComponent>().each(
+            [&meshInstances, &cameraComponent, viewportHeight, &opts, world, &entityCapacitor, textureStreamer](entt::entity handle, MeshComponent& meshComponent, const TransformComponent&)
             {
                 MeshInstance& instance = meshInstances.emplace_back();
 
-                Math::Matrix translation = Math::Matrix::CreateTranslation(transformComponent.Translation);
-                Math::Matrix rotation = Math::Matrix::CreateFromYawPitchRoll(transformComponent.Rotation);
-                Math::Matrix scale = Math::Matrix::CreateScale(transformComponent.Scaling);
-
                 MeshAsset* mesh = meshComponent.GetMesh();
 
                 instance.Manager = meshComponent.Manager;
                 instance.MeshProxy = meshComponent.Proxy;
 
-                instance.InstanceToWorld = scale * rotation * translation;
+                // Entities of imported scenes keep transforms relative to their parents
+                instance.InstanceToWorld = world->GetInstanceToWorld(Entity(&entityCapacitor, handle));
                 instance.InstanceToWorld.Invert(instance.NormalMatrix);
                 instance.NormalMatrix.Transpose(instance.NormalMatrix);
 
@@ -231,6 +259,17 @@ namespace Warp
                 {
                     Submesh& submesh = mesh->Submeshes[submeshIndex];
 
+                    // Shadow passes draw the same level as the camera sees, so that surfaces do not shadow themselves
+                    instance.Submeshes[submeshIndex].LodIndex = SelectSubmeshLod(submesh, instance.InstanceToWorld, cameraComponent, viewportHeight, opts.LodScreenSpaceError).LodIndex;
+
+                    // Needed by every pass, even if the submesh has no material
+                    EHlslDrawPropertyFlags& flags = instance.Submeshes[submeshIndex].DrawFlags;
+                    if (submesh.Has16BitUniqueVertexIndices())
+                        flags |= eHlslDrawPropertyFlag_16BitVertexIndices;
+
+                    if (submesh.HasQuantizedAttributes())
+                        flags |= eHlslDrawPropertyFlag_QuantizedVertices;
+
                     MaterialAsset* material = meshComponent.Manager->GetAs<MaterialAsset>(mesh->SubmeshMaterials[submeshIndex]);
                     if (!material)
                     {
@@ -238,7 +277,13 @@ namespace Warp
                         continue;
                     }
 
-                    EHlslDrawPropertyFlags& flags = instance.Submeshes[submeshIndex].DrawFlags;
+                    if (textureStreamer)
+                    {
+                        float screenSize = ComputeSubmeshScreenSize(submesh, instance.InstanceToWorld, cameraComponent, viewportHeight);
+                        textureStreamer->RequestScreenSize(material->AlbedoMap, screenSize);
+                        textureStreamer->RequestScreenSize(material->NormalMap, screenSize);
+                        textureStreamer->RequestScreenSize(material->RoughnessMetalnessMap, screenSize);
+                    }
 
                     if (submesh.HasAttributes(eVertexAttribute_TextureCoords))
                         flags |= eHlslDrawPropertyFlag_HasTexCoords;
@@ -250,15 +295,15 @@ namespace Warp
                         flags |= eHlslDrawPropertyFlag_HasBitangents;
 
                     if (!material->HasNormalMap() ||
-                        !meshComponent.Manager->IsValid<TextureAsset>(material->NormalMap))
+                        !IsTextureResident(meshComponent.Manager, material->NormalMap))
                         flags |= eHlslDrawPropertyFlag_NoNormalMap;
 
                     if (!material->HasRoughnessMetalnessMap() ||
-                        !meshComponent.Manager->IsValid<TextureAsset>(material->RoughnessMetalnessMap))
+                        !IsTextureResident(meshComponent.Manager, material->RoughnessMetalnessMap))
                         flags |= eHlslDrawPropertyFlag_NoRoughnessMetalnessMap;
 
                     if (!material->HasAlbedoMap() ||
-                        !meshComponent.Manager->IsValid<TextureAsset>(material->AlbedoMap))
+                        !IsTextureResident(meshComponent.Manager, material->AlbedoMap))
                         flags |= eHlslDrawPropertyFlag_NoBaseColorMap;
                 }
             }
@@ -356,9 +401,6 @@ namespace Warp
             }
         );
 
-        Entity worldCamera = world->GetWorldCamera();
-        const EulersCameraComponent& cameraComponent = worldCamera.GetComponent<EulersCameraComponent>();
-
         RHIDevice* Device = m_device.get();
 
         UINT frameIndex = m_swapchain->GetCurrentBackbufferIndex();
@@ -371,6 +413,26 @@ namespace Warp
         RHIBuffer& constantBuffer = m_constantBuffers[frameIndex];
         UINT currentCbOffset = 0;
 
+        // Every meshlet of the drawn levels may turn out to be visible
+        size_t numDrawnSubmeshes = 0;
+        size_t numDrawnMeshlets = 0;
+        for (const MeshInstance& meshInstance : meshInstances)
+        {
+            MeshAsset* mesh = meshInstance.Manager->GetAs<MeshAsset>(meshInstance.MeshProxy);
+            numDrawnSubmeshes += mesh->GetNumSubmeshes();
+            for (uint32_t submeshIndex = 0; submeshIndex < mesh->GetNumSubmeshes(); ++submeshIndex)
+            {
+                numDrawnMeshlets += mesh->Submeshes[submeshIndex].Lods[meshInstance.Submeshes[submeshIndex].LodIndex].GetNumMeshlets();
+            }
+        }
+
+        RHIBuffer& visibleMeshletBuffer = m_visibleMeshletBuffers[frameIndex];
+        ReserveFrameBuffer(visibleMeshletBuffer, numDrawnMeshlets * sizeof(uint32_t), L"VisibleMeshlets");
+        UINT visibleMeshletOffset = 0;
+
+        RHIBuffer& shadowingDrawDataBuffer = m_shadowingDrawDataBuffers[frameIndex];
+        ReserveFrameBuffer(shadowingDrawDataBuffer, numDrawnSubmeshes * sizeof(HlslShadowingDrawData), L"ShadowingDrawData");
+
         RHICommandContext& graphicsContext = GetGraphicsContext();
         graphicsContext.Open();
         {
@@ -387,6 +449,24 @@ namespace Warp
                 graphicsContext->SetDescriptorHeaps(static_cast<UINT>(descriptorHeaps.size()), descriptorHeaps.data());
             }
 
+            // Draw data is written once per submesh and shared by every light, draws pick theirs by the index in a root constant
+            // Submeshes are visited in the same order below, thus draw index of a submesh is its position in that order
+            if (shadowmappingTargets.NumTargets > 0)
+            {
+                HlslShadowingDrawData* drawData = shadowingDrawDataBuffer.GetCpuVirtualAddress<HlslShadowingDrawData>();
+                for (const MeshInstance& meshInstance : meshInstances)
+                {
+                    MeshAsset* mesh = meshInstance.Manager->GetAs<MeshAsset>(meshInstance.MeshProxy);
+                    for (uint32_t submeshIndex = 0; submeshIndex < mesh->GetNumSubmeshes(); ++submeshIndex)
+                    {
+                        *drawData++ = HlslShadowingDrawData{
+                            .InstanceToWorld = mesh->Submeshes[submeshIndex].GetPositionDequantizeMatrix() * meshInstance.InstanceToWorld,
+                            .DrawFlags = meshInstance.Submeshes[submeshIndex].DrawFlags,
+                        };
+                    }
+                }
+            }
+
             for (uint32_t i = 0; i < shadowmappingTargets.NumTargets; ++i)
             {
                 DirectionalLightShadowmappingComponent* shadowComponent = shadowmappingTargets.Targets[i];
@@ -401,7 +481,6 @@ namespace Warp
                 graphicsContext.SetScissorRect(0, 0, shadowmapWidth, shadowmapHeight);
 
                 graphicsContext.SetGraphicsRootSignature(m_directionalShadowingSignature);
-                graphicsContext.SetPipelineState(m_directionalShadowingPSO);
 
                 HlslDirShadowingViewData viewData = HlslDirShadowingViewData{
                     .LightView = shadowComponent->LightView,
@@ -412,39 +491,39 @@ namespace Warp
                 Warp::Memcpy(cbViewData.GetCpuAddress(), &viewData, sizeof(HlslDirShadowingViewData));
 
                 graphicsContext->SetGraphicsRootConstantBufferView(DirShadowingRootParamIdx_CbViewData, cbViewData.GetGpuAddress());
+                graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_DrawData, shadowingDrawDataBuffer.GetGpuVirtualAddress());
 
+                // Pipelines only change between submeshes of different meshlet sizes, root arguments stay bound
+                EMeshletSize boundMeshletSize = eMeshletSize_NumSizes;
+                UINT drawIndex = 0;
                 for (MeshInstance& meshInstance : meshInstances)
                 {
-                    HlslShadowingDrawData drawData = HlslShadowingDrawData{
-                        .InstanceToWorld = meshInstance.InstanceToWorld,
-                    };
-
-                    WARP_ASSERT(currentCbOffset < SizeOfGlobalCb, "Handle this! This is the time!");
-
-                    RHIBuffer::Address cbDrawData(&constantBuffer, sizeof(HlslShadowingDrawData), currentCbOffset);
-                    currentCbOffset += cbDrawData.SizeInBytes;
-                    Warp::Memcpy(cbDrawData.GetCpuAddress(), &drawData, sizeof(HlslShadowingDrawData));
-
-                    graphicsContext->SetGraphicsRootConstantBufferView(DirShadowingRootParamIdx_CbDrawData, cbDrawData.GetGpuAddress());
-
                     MeshAsset* mesh = meshInstance.Manager->GetAs<MeshAsset>(meshInstance.MeshProxy);
                     for (uint32_t submeshIndex = 0; submeshIndex < mesh->GetNumSubmeshes(); ++submeshIndex)
                     {
                         Submesh& submesh = mesh->Submeshes[submeshIndex];
+                        SubmeshLod& lod = submesh.Lods[meshInstance.Submeshes[submeshIndex].LodIndex];
+                        if (submesh.MeshletSize != boundMeshletSize)
+                        {
+                            graphicsContext.SetPipelineState(m_directionalShadowingPSOs[submesh.MeshletSize]);
+                            boundMeshletSize = submesh.MeshletSize;
+                        }
+
+                        graphicsContext->SetGraphicsRoot32BitConstant(DirShadowingRootParamIdx_DrawIndex, drawIndex++, 0);
 
                         graphicsContext.AddTransitionBarrier(&submesh.Resources[eVertexAttribute_Positions], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
                         graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_Positions, submesh.Resources[eVertexAttribute_Positions].GetGpuVirtualAddress());
 
-                        graphicsContext.AddTransitionBarrier(&submesh.MeshletBuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-                        graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_Meshlets, submesh.MeshletBuffer.GetGpuVirtualAddress());
+                        graphicsContext.AddTransitionBarrier(&lod.MeshletBuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+                        graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_Meshlets, lod.MeshletBuffer.GetGpuVirtualAddress());
 
-                        graphicsContext.AddTransitionBarrier(&submesh.PrimitiveIndicesBuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-                        graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_PrimitiveIndices, submesh.PrimitiveIndicesBuffer.GetGpuVirtualAddress());
+                        graphicsContext.AddTransitionBarrier(&lod.PrimitiveIndicesBuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+                        graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_PrimitiveIndices, lod.PrimitiveIndicesBuffer.GetGpuVirtualAddress());
 
-                        graphicsContext.AddTransitionBarrier(&submesh.UniqueVertexIndicesBuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-                        graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_UniqueVertexIndices, submesh.UniqueVertexIndicesBuffer.GetGpuVirtualAddress());
+                        graphicsContext.AddTransitionBarrier(&lod.UniqueVertexIndicesBuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+                        graphicsContext->SetGraphicsRootShaderResourceView(DirShadowingRootParamIdx_UniqueVertexIndices, lod.UniqueVertexIndicesBuffer.GetGpuVirtualAddress());
 
-                        graphicsContext.DispatchMesh(submesh.GetNumMeshlets(), 1, 1); // should be good enough for now
+                        graphicsContext.DispatchMesh(lod.GetNumMeshlets(), 1, 1); // should be good enough for now
                     }
                 }
             }
@@ -493,7 +572,6 @@ namespace Warp
                 graphicsContext.ClearDsv(m_sceneDepthDsv, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
                 graphicsContext.SetGraphicsRootSignature(m_baseRootSignature);
-                graphicsContext.SetPipelineState(m_basePSO);
 
                 HlslViewData viewData = HlslViewData{
                     .ViewMatrix = cameraComponent.ViewMatrix,
@@ -521,14 +599,48 @@ namespace Warp
                 //	WARP_ASSERT(false, "No Lights! Should handle using scene cb! -> Currently not implemented");
                 //}
 
+                // Meshlets outside of the camera frustum or facing away from the camera are culled on the CPU. Indices of the visible ones
+                // are written into the visible meshlet buffer of the frame and the mesh shader is dispatched only for them
+                Math::Matrix viewProjection = cameraComponent.ViewMatrix * cameraComponent.ProjMatrix;
+                Math::Vector3 cameraPosition = cameraComponent.ViewInvMatrix.Translation();
+                std::vector<uint32_t> visibleMeshlets;
+
+                // Pipelines only change between submeshes of different meshlet sizes, root arguments stay bound
+                EMeshletSize boundMeshletSize = eMeshletSize_NumSizes;
                 for (MeshInstance& meshInstance : meshInstances)
                 {
                     // Iterate over each submesh
                     MeshAsset* mesh = meshInstance.Manager->GetAs<MeshAsset>(meshInstance.MeshProxy);
                     for (uint32_t submeshIndex = 0; submeshIndex < mesh->GetNumSubmeshes(); ++submeshIndex)
                     {
+                        // Quantized positions are brought into model space by the same matrix that brings them into world space
+                        Submesh& submesh = mesh->Submeshes[submeshIndex];
+                        SubmeshLod& lod = submesh.Lods[meshInstance.Submeshes[submeshIndex].LodIndex];
+
+                        // Cull data is in model space before quantization, thus it is culled with the instance transform alone
+                        if (lod.MeshletCullData.size() == lod.GetNumMeshlets())
+                        {
+                            Math::CullMeshlets(lod.MeshletCullData, meshInstance.InstanceToWorld, viewProjection, cameraPosition, visibleMeshlets);
+                        }
+                        else
+                        {
+                            visibleMeshlets.resize(lod.GetNumMeshlets());
+                            std::iota(visibleMeshlets.begin(), visibleMeshlets.end(), 0);
+                        }
+
+                        if (visibleMeshlets.empty())
+                        {
+                            continue;
+                        }
+
+                        if (submesh.MeshletSize != boundMeshletSize)
+                        {
+                            graphicsContext.SetPipelineState(m_basePSOs[submesh.MeshletSize]);
+                            boundMeshletSize = submesh.MeshletSize;
+                        }
+
                         HlslDrawData drawData = HlslDrawData{
-                            .InstanceToWorld = meshInstance.InstanceToWorld,
+                            .InstanceToWorld = submesh.GetPositionDequantizeMatrix() * meshInstance.InstanceToWorld,
                             .NormalMatrix = meshInstance.NormalMatrix,
                             .DrawFlags = meshInstance.Submeshes[submeshIndex].DrawFlags
                         };
@@ -541,7 +653,13 @@ namespace Warp
 
                         graphicsContext->SetGraphicsRootConstantBufferView(BasicRootParamIdx_CbDrawData, cbDrawData.GetGpuAddress());
 
-                        Submesh& submesh = mesh->Submeshes[submeshIndex];
+                        // Root views of structured buffers only need 4-byte alignment, thus the lists are packed tightly
+                        UINT visibleMeshletsSize = static_cast<UINT>(visibleMeshlets.size() * sizeof(uint32_t));
+                        RHIBuffer::Address visibleMeshletsAddress(&visibleMeshletBuffer, visibleMeshletsSize, visibleMeshletOffset);
+                        visibleMeshletOffset += visibleMeshletsSize;
+                        Warp::Memcpy(visibleMeshletsAddress.GetCpuAddress(), visibleMeshlets.data(), visibleMeshletsSize);
+
+                        graphicsContext->SetGraphicsRootShaderResourceView(BasicRootParamIdx_VisibleMeshlets, visibleMeshletsAddress.GetGpuAddress());
                         MaterialAsset* material = meshInstance.Manager->GetAs<MaterialAsset>(mesh->SubmeshMaterials[submeshIndex]);
                         WARP_ASSERT(material, "Invalid material, handle this!");
 
@@ -560,9 +678,9 @@ namespace Warp
                         }
 
                         std::array meshletResources = {
-                            &submesh.MeshletBuffer,
-                            &submesh.UniqueVertexIndicesBuffer,
-                            &submesh.PrimitiveIndicesBuffer
+                            &lod.MeshletBuffer,
+                            &lod.UniqueVertexIndicesBuffer,
+                            &lod.PrimitiveIndicesBuffer
                         };
 
                         for (uint32_t i = 0; i < static_cast<uint32_t>(meshletResources.size()); ++i)
@@ -573,24 +691,24 @@ namespace Warp
 
                         // We need a default texture for meshes with no albedoMap. This is a better solution rather than doing float4 albedo factor (as it is now in material)
                         TextureAsset* albedoMap = meshInstance.Manager->GetAs<TextureAsset>(material->AlbedoMap);
-                        if (albedoMap)
+                        if (albedoMap && albedoMap->IsResident())
                         {
                             graphicsContext->SetGraphicsRootDescriptorTable(BasicRootParamIdx_BaseColor, albedoMap->Srv.GetGpuAddress());
                         }
 
                         TextureAsset* normalMap = meshInstance.Manager->GetAs<TextureAsset>(material->NormalMap);
-                        if (normalMap)
+                        if (normalMap && normalMap->IsResident())
                         {
                             graphicsContext->SetGraphicsRootDescriptorTable(BasicRootParamIdx_NormalMap, normalMap->Srv.GetGpuAddress());
                         }
 
                         TextureAsset* roughnessMetalnessMap = meshInstance.Manager->GetAs<TextureAsset>(material->RoughnessMetalnessMap);
-                        if (roughnessMetalnessMap)
+                        if (roughnessMetalnessMap && roughnessMetalnessMap->IsResident())
                         {
                             graphicsContext->SetGraphicsRootDescriptorTable(BasicRootParamIdx_MetalnessRoughnessMap, roughnessMetalnessMap->Srv.GetGpuAddress());
                         }
 
-                        graphicsContext.DispatchMesh(submesh.GetNumMeshlets(), 1, 1); // should be good enough for now
+                        graphicsContext.DispatchMesh(static_cast<UINT>(visibleMeshlets.size()), 1, 1);
                     }
                 }
             }
@@ -803,14 +921,27 @@ namespace Warp
         m_sceneDepthSrv.RecreateDescriptor(&m_sceneDepth);
     }
 
+    // Outputs of mesh shaders are sized at compile time, thus they are compiled for every meshlet size (see MESHLET_SIZE in Base.hlsl)
+    // Thread groups never exceed 128 threads, meshlets larger than that are processed by a group in several iterations
+    static ShaderCompilationDesc GetMeshShaderCompilationDesc(EMeshletSize meshletSize)
+    {
+        uint32_t maxElements = GetMeshletMaxElements(meshletSize);
+        ShaderCompilationDesc desc("MSMain", EShaderModel::sm_6_5, EShaderType::Mesh);
+        desc.AddDefine(ShaderDefine("MESHLET_SIZE", std::to_string(maxElements)));
+        desc.AddDefine(ShaderDefine("MESHLET_NUM_THREADS", std::to_string(std::min(maxElements, 128u))));
+        return desc;
+    }
+
     void Renderer::InitBase()
     {
         std::string shaderPath = (Application::Get().GetShaderPath() / "Base.hlsl").string();
-        m_MSBase = m_shaderCompiler.CompileShader(shaderPath, ShaderCompilationDesc("MSMain", EShaderModel::sm_6_5, EShaderType::Mesh));
+        for (uint32_t size = 0; size < eMeshletSize_NumSizes; ++size)
+        {
+            m_MSBase[size] = m_shaderCompiler.CompileShader(shaderPath, GetMeshShaderCompilationDesc(static_cast<EMeshletSize>(size)));
+            WARP_ASSERT(m_MSBase[size].HasBinary(), "Failed to compile Base.hlsl");
+        }
         m_PSBase = m_shaderCompiler.CompileShader(shaderPath, ShaderCompilationDesc("PSMain", EShaderModel::sm_6_5, EShaderType::Pixel));
-        WARP_ASSERT(
-            m_MSBase.HasBinary() &&
-            m_PSBase.HasBinary(), "Failed to compile Base.hlsl");
+        WARP_ASSERT(m_PSBase.HasBinary(), "Failed to compile Base.hlsl");
 
         RHIDevice* Device = GetDevice();
 
@@ -829,6 +960,7 @@ namespace Warp
             .SetShaderResourceView(BasicRootParamIdx_Meshlets, 1, 0, D3D12_SHADER_VISIBILITY_ALL)
             .SetShaderResourceView(BasicRootParamIdx_UniqueVertexIndices, 2, 0, D3D12_SHADER_VISIBILITY_ALL)
             .SetShaderResourceView(BasicRootParamIdx_PrimitiveIndices, 3, 0, D3D12_SHADER_VISIBILITY_ALL)
+            .SetShaderResourceView(BasicRootParamIdx_VisibleMeshlets, 5, 0, D3D12_SHADER_VISIBILITY_ALL)
             // SRVs
             .SetDescriptorTable(BasicRootParamIdx_BaseColor, RHIDescriptorTable(1).AddDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 4, 0), D3D12_SHADER_VISIBILITY_PIXEL)
             .SetDescriptorTable(BasicRootParamIdx_NormalMap, RHIDescriptorTable(1).AddDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 4, 1), D3D12_SHADER_VISIBILITY_PIXEL)
@@ -843,7 +975,6 @@ namespace Warp
 
         RHIMeshPipelineDesc psoDesc = {};
         psoDesc.RootSignature = m_baseRootSignature;
-        psoDesc.MS = m_MSBase.GetBinaryBytecode();
         psoDesc.PS = m_PSBase.GetBinaryBytecode();
         psoDesc.Rasterizer.FrontCounterClockwise = TRUE; // TODO: We need this, because cube's triangle winding order is smhw ccw
         psoDesc.DepthStencil.DepthEnable = TRUE;
@@ -854,8 +985,12 @@ namespace Warp
         psoDesc.RTVFormats[1] = DXGI_FORMAT_R8G8B8A8_SNORM;
         psoDesc.RTVFormats[2] = DXGI_FORMAT_R8G8_UNORM;
         psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
-        m_basePSO = RHIMeshPipelineState(Device, psoDesc);
-        m_basePSO.SetName(L"PSO_Base");
+        for (uint32_t size = 0; size < eMeshletSize_NumSizes; ++size)
+        {
+            psoDesc.MS = m_MSBase[size].GetBinaryBytecode();
+            m_basePSOs[size] = RHIMeshPipelineState(Device, psoDesc);
+            m_basePSOs[size].SetName(std::format(L"PSO_Base_Meshlet{}", GetMeshletMaxElements(static_cast<EMeshletSize>(size))));
+        }
     }
 
     void Renderer::InitGbuffers()
@@ -955,8 +1090,11 @@ namespace Warp
     void Renderer::InitDirectionalShadowmapping()
     {
         std::string shaderPath = (Application::Get().GetShaderPath() / "DirectionalShadowing.hlsl").string();
-        m_MSDirectionalShadowing = m_shaderCompiler.CompileShader(shaderPath, ShaderCompilationDesc("MSMain", EShaderModel::sm_6_5, EShaderType::Mesh));
-        WARP_ASSERT(m_MSDirectionalShadowing.HasBinary() && "Failed to compile DirectionalShadowing.hlsl");
+        for (uint32_t size = 0; size < eMeshletSize_NumSizes; ++size)
+        {
+            m_MSDirectionalShadowing[size] = m_shaderCompiler.CompileShader(shaderPath, GetMeshShaderCompilationDesc(static_cast<EMeshletSize>(size)));
+            WARP_ASSERT(m_MSDirectionalShadowing[size].HasBinary() && "Failed to compile DirectionalShadowing.hlsl");
+        }
 
         RHIDevice* Device = GetDevice();
 
@@ -964,8 +1102,9 @@ namespace Warp
         m_directionalShadowingSignature = RHIRootSignature(Device, RHIRootSignatureDesc(DirShadowingRootParamIdx_NumParams)
             // Cbvs
             .SetConstantBufferView(DirShadowingRootParamIdx_CbViewData, 0, 0, D3D12_SHADER_VISIBILITY_ALL)
-            .SetConstantBufferView(DirShadowingRootParamIdx_CbDrawData, 1, 0, D3D12_SHADER_VISIBILITY_ALL)
+            .Set32BitConstants(DirShadowingRootParamIdx_DrawIndex, 1, 1, 0, D3D12_SHADER_VISIBILITY_ALL)
             // Srvs
+            .SetShaderResourceView(DirShadowingRootParamIdx_DrawData, 4, 0, D3D12_SHADER_VISIBILITY_ALL)
             .SetShaderResourceView(DirShadowingRootParamIdx_Positions, 0, 0, D3D12_SHADER_VISIBILITY_ALL)
             .SetShaderResourceView(DirShadowingRootParamIdx_Meshlets, 1, 0, D3D12_SHADER_VISIBILITY_ALL)
             .SetShaderResourceView(DirShadowingRootParamIdx_UniqueVertexIndices, 2, 0, D3D12_SHADER_VISIBILITY_ALL)
@@ -975,7 +1114,6 @@ namespace Warp
 
         RHIMeshPipelineDesc psoDesc = {};
         psoDesc.RootSignature = m_directionalShadowingSignature;
-        psoDesc.MS = m_MSDirectionalShadowing.GetBinaryBytecode();
         psoDesc.Rasterizer.FrontCounterClockwise = TRUE; // TODO: We need this, because cube's triangle winding order is smhw ccw
         psoDesc.Rasterizer.DepthBias = 4;
         psoDesc.Rasterizer.DepthBiasClamp = 0.0f;
@@ -985,8 +1123,12 @@ namespace Warp
         psoDesc.DepthStencil.StencilEnable = FALSE;
         psoDesc.NumRTVs = 0;
         psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
-        m_directionalShadowingPSO = RHIMeshPipelineState(Device, psoDesc);
-        m_directionalShadowingPSO.SetName(L"PSO_DirectionalShadowing");
+        for (uint32_t size = 0; size < eMeshletSize_NumSizes; ++size)
+        {
+            psoDesc.MS = m_MSDirectionalShadowing[size].GetBinaryBytecode();
+            m_directionalShadowingPSOs[size] = RHIMeshPipelineState(Device, psoDesc);
+            m_directionalShadowingPSOs[size].SetName(std::format(L"PSO_DirectionalShadowing_Meshlet{}", GetMeshletMaxElements(static_cast<EMeshletSize>(size))));
+        }
     }
 
     void Renderer::InitDeferredLighting()
@@ -1079,4 +1221,19 @@ namespace Warp
         }
     }
 
+    void Renderer::ReserveFrameBuffer(RHIBuffer& buffer, UINT64 sizeInBytes, const wchar_t* name)
+    {
+        if (buffer.GetSizeInBytes() >= sizeInBytes && buffer.GetSizeInBytes() > 0)
+        {
+            return;
+        }
+
+        UINT64 newSize = std::max({ sizeInBytes, buffer.GetSizeInBytes() * 2, MinSizeOfFrameBuffer });
+        buffer = RHIBuffer(m_device.get(),
+            D3D12_HEAP_TYPE_UPLOAD,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            D3D12_RESOURCE_FLAG_NONE, newSize);
+        buffer.SetName(name);
+    }
+
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "RHI/Swapchain.h"
 #include "RHI/RootSignature.h"
 #include "ShaderCompiler.h"
+#include "../Assets/MeshAsset.h"
 #include "../Math/Math.h"
 
 namespace Warp
@@ -36,6 +37,10 @@ namespace Warp
     struct RenderOpts
     {
         EGbufferType ViewGbuffer = EGbufferType::eGbufferType_NumTypes;
+
+        // Submeshes are drawn with the coarsest level of detail whose simplification error projects to at most this many pixels
+        // 0 always draws full detail levels
+        float LodScreenSpaceError = 1.0f;
     };
 
     class Renderer
@@ -87,8 +92,9 @@ namespace Warp
 
         void InitBase();
         RHIRootSignature m_baseRootSignature;
-        RHIMeshPipelineState m_basePSO;
-        CShader m_MSBase;
+        // Mesh shaders and their pipelines exist per meshlet size, see EMeshletSize
+        std::array<RHIMeshPipelineState, eMeshletSize_NumSizes> m_basePSOs;
+        std::array<CShader, eMeshletSize_NumSizes> m_MSBase;
         CShader m_PSBase;
 
         // TODO: Remove entirely when rendergraph
@@ -107,8 +113,8 @@ namespace Warp
         void InitDirectionalShadowmapping();
         RHIDescriptorAllocation m_directionalShadowingSrvs;
         RHIRootSignature m_directionalShadowingSignature;
-        RHIMeshPipelineState m_directionalShadowingPSO;
-        CShader m_MSDirectionalShadowing;
+        std::array<RHIMeshPipelineState, eMeshletSize_NumSizes> m_directionalShadowingPSOs;
+        std::array<CShader, eMeshletSize_NumSizes> m_MSDirectionalShadowing;
 
         void InitDeferredLighting();
         RHIRootSignature m_deferredLightingSignature;
@@ -125,5 +131,12 @@ namespace Warp
         void AllocateGlobalCbuffers();
         static constexpr size_t SizeOfGlobalCb = 64 * 16384;
         RHIBuffer m_constantBuffers[SimultaneousFrames];
+
+        // Per-frame upload buffers of data whose size depends on the scene. A buffer is only reallocated by the frame that uses it,
+        // after waiting for its previous use, and grows geometrically so that a growing scene does not reallocate it every frame
+        void ReserveFrameBuffer(RHIBuffer& buffer, UINT64 sizeInBytes, const wchar_t* name);
+        static constexpr UINT64 MinSizeOfFrameBuffer = 64 * 1024;
+        RHIBuffer m_visibleMeshletBuffers[SimultaneousFrames]; // Lists of visible meshlets of the base pass, packed one after another
+        RHIBuffer m_shadowingDrawDataBuffers[SimultaneousFrames]; // Draw data of every submesh, shared by shadow passes of every light
     };
 }
\ No newline at end of file
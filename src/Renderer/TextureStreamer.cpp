@@ -0,0 +1,387 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "../Core/Assert.h"
+#include "../Util/Logger.h"
+
+namespace Warp
+{
+
+    // Block-compressed textures are created from whole blocks only, see D3D12 requirements on the top level
+    static constexpr size_t BlockSize = 4;
+
+    // Copies mips starting at firstMip into an image of their own. Pages of mapped sources are read here
+    static ImageLoader::Image ReadMips(const ImageLoader::Image& source, uint32_t firstMip)
+    {
+        using namespace DirectX;
+
+        const TexMetadata& metadata = source.GetMetadata();
+        TexMetadata mipsMetadata = metadata;
+        mipsMetadata.width = std::max<size_t>(metadata.width >> firstMip, 1);
+        mipsMetadata.height = std::max<size_t>(metadata.height >> firstMip, 1);
+        mipsMetadata.mipLevels = metadata.mipLevels - firstMip;
+
+        ImageLoader::Image image;
+        image.Filepath = source.Filepath;
+        if (FAILED(image.DxImage.Initialize(mipsMetadata)))
+        {
+            return ImageLoader::Image();
+        }
+
+        for (size_t mip = 0; mip < mipsMetadata.mipLevels; ++mip)
+        {
+            const DirectX::Image& src = source.GetImages()[metadata.ComputeIndex(mip + firstMip, 0, 0)];
+            const DirectX::Image* dst = image.DxImage.GetImage(mip, 0, 0);
+            WARP_ASSERT(src.slicePitch == dst->slicePitch);
+            std::memcpy(dst->pixels, src.pixels, src.slicePitch);
+        }
+
+        return image;
+    }
+
+    TextureStreamer::TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend, const TextureStreamingDesc& desc)
+        : m_backend(std::move(backend))
+        , m_desc(desc)
+        , m_ioThread(std::make_unique<ThreadPool>(1))
+    {
+        WARP_ASSERT(m_backend);
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        m_ioThread.reset();
+    }
+
+    ImageLoader::Image TextureStreamer::AddTexture(AssetProxy proxy, ImageLoader::Image&& image, ETextureUsage usage)
+    {
+        using namespace DirectX;
+
+        if (!proxy.IsValid() || !image.IsValid() || m_textureIndices.contains(proxy.ID))
+        {
+            return std::move(image);
+        }
+
+        const TexMetadata& metadata = image.GetMetadata();
+        if (metadata.dimension != TEX_DIMENSION_TEXTURE2D || metadata.arraySize != 1 || metadata.mipLevels == 1)
+        {
+            return std::move(image);
+        }
+
+        // First mip that fits the initial size, unless a coarser one would not consist of whole blocks
+        uint32_t initialFirstMip = 0;
+        for (uint32_t mip = 0; mip < metadata.mipLevels; ++mip)
+        {
+            size_t width = std::max<size_t>(metadata.width >> mip, 1);
+            size_t height = std::max<size_t>(metadata.height >> mip, 1);
+            if (IsCompressed(metadata.format) && (width % BlockSize != 0 || height % BlockSize != 0))
+            {
+                break;
+            }
+
+            initialFirstMip = mip;
+            if (std::max(width, height) <= m_desc.MaxInitialMipSize)
+            {
+                break;
+            }
+        }
+
+        if (initialFirstMip == 0)
+        {
+            // Nothing to stream, the whole chain is the initial one
+            return std::move(image);
+        }
+
+        ImageLoader::Image initialMips = ReadMips(image, initialFirstMip);
+        if (!initialMips.IsValid())
+        {
+            WARP_LOG_ERROR("TextureStreamer::AddTexture -> Failed to allocate initial mips of \'{}\', it is not streamed", image.Filepath);
+            return std::move(image);
+        }
+
+        std::unique_ptr<StreamedTexture> texture = std::make_unique<StreamedTexture>();
+        texture->Proxy = proxy;
+        texture->Usage = usage;
+        texture->MipSizes.resize(metadata.mipLevels);
+        for (uint32_t mip = 0; mip < metadata.mipLevels; ++mip)
+        {
+            texture->MipSizes[mip] = image.GetImages()[metadata.ComputeIndex(mip, 0, 0)].slicePitch;
+        }
+        texture->InitialFirstMip = initialFirstMip;
+        texture->ResidentFirstMip = initialFirstMip;
+        texture->WantedFirstMip = initialFirstMip;
+        texture->ReadFirstMip = initialFirstMip;
+        texture->RequestedFirstMip = initialFirstMip;
+        texture->Source = std::move(image);
+
+        m_textureIndices.emplace(proxy.ID, static_cast<uint32_t>(m_textures.size()));
+        m_textures.push_back(std::move(texture));
+        return initialMips;
+    }
+
+    void TextureStreamer::RemoveTexture(AssetProxy proxy)
+    {
+        auto it = m_textureIndices.find(proxy.ID);
+        if (it == m_textureIndices.end())
+        {
+            return;
+        }
+
+        StreamedTexture& texture = *m_textures[it->second];
+        texture.IsRemoved = true;
+        texture.MipSizes.clear();
+        if (!texture.IsReading)
+        {
+            texture.Source = ImageLoader::Image();
+        }
+
+        m_textureIndices.erase(it);
+    }
+
+    void TextureStreamer::RequestScreenSize(AssetProxy proxy, float screenSize)
+    {
+        auto it = m_textureIndices.find(proxy.ID);
+        if (it == m_textureIndices.end())
+        {
+            return;
+        }
+
+        StreamedTexture& texture = *m_textures[it->second];
+        const DirectX::TexMetadata& metadata = texture.Source.GetMetadata();
+
+        // A texel per pixel at log2(textureSize / screenSize)
+        float textureSize = static_cast<float>(std::max(metadata.width, metadata.height));
+        float mip = std::floor(std::log2(textureSize / std::max(screenSize, 1.0f)) - m_desc.MipBias);
+        uint32_t firstMip = static_cast<uint32_t>(std::clamp(mip, 0.0f, static_cast<float>(texture.InitialFirstMip)));
+
+        if (texture.LastRequestedUpdate != m_updateIndex)
+        {
+            texture.LastRequestedUpdate = m_updateIndex;
+            texture.RequestedFirstMip = firstMip;
+            texture.ScreenSize = screenSize;
+        }
+        else
+        {
+            texture.RequestedFirstMip = std::min(texture.RequestedFirstMip, firstMip);
+            texture.ScreenSize = std::max(texture.ScreenSize, screenSize);
+        }
+    }
+
+    void TextureStreamer::Update()
+    {
+        m_backend->Update();
+        UploadFinishedReads();
+
+        // Textures that are being read are accounted with whichever of their mip ranges is larger
+        size_t residentSize = 0;
+        std::vector<uint32_t> loads;
+        std::vector<uint32_t> evictable;
+        for (uint32_t textureIndex = 0; textureIndex < m_textures.size(); ++textureIndex)
+        {
+            StreamedTexture& texture = *m_textures[textureIndex];
+            if (texture.IsRemoved)
+            {
+                continue;
+            }
+
+            // Textures keep their wanted mips between requests, until they count as unused
+            if (texture.LastRequestedUpdate == m_updateIndex)
+            {
+                texture.WantedFirstMip = texture.RequestedFirstMip;
+            }
+            else if (m_updateIndex - texture.LastRequestedUpdate > m_desc.NumUnusedUpdatesToEvict)
+            {
+                texture.WantedFirstMip = texture.InitialFirstMip;
+            }
+
+            if (texture.IsReading)
+            {
+                residentSize += GetSizeOfMips(texture, std::min(texture.ResidentFirstMip, texture.ReadFirstMip));
+                continue;
+            }
+
+            // Dropping mips reads the remaining ones into a new texture, thus it takes a read slot like a load. It goes ahead of loads, as it frees memory
+            if (texture.WantedFirstMip > texture.ResidentFirstMip)
+            {
+                residentSize += GetSizeOfMips(texture, texture.ResidentFirstMip);
+                if (m_numPendingReads < m_desc.MaxPendingReads)
+                {
+                    ScheduleRead(textureIndex, texture.WantedFirstMip);
+                }
+                continue;
+            }
+
+            residentSize += GetSizeOfMips(texture, texture.ResidentFirstMip);
+            if (texture.WantedFirstMip < texture.ResidentFirstMip)
+            {
+                loads.push_back(textureIndex);
+            }
+            if (texture.ResidentFirstMip < texture.InitialFirstMip)
+            {
+                evictable.push_back(textureIndex);
+            }
+        }
+
+        // Textures that were requested more recently, and then those that cover more of the screen, are more important
+        auto isMoreImportant = [this](uint32_t lhs, uint32_t rhs)
+            {
+                const StreamedTexture& a = *m_textures[lhs];
+                const StreamedTexture& b = *m_textures[rhs];
+                if (a.LastRequestedUpdate != b.LastRequestedUpdate)
+                {
+                    return a.LastRequestedUpdate > b.LastRequestedUpdate;
+                }
+                return a.ScreenSize > b.ScreenSize;
+            };
+
+        // Exceeding the budget (it was lowered, or initial mips alone exceed it) costs the least important textures their finest mip
+        // Evictions are reads as well, those that do not fit into the pending reads wait for the next update
+        if (residentSize > m_desc.MemoryBudget)
+        {
+            std::sort(evictable.begin(), evictable.end(), [&](uint32_t lhs, uint32_t rhs) { return isMoreImportant(rhs, lhs); });
+            for (uint32_t textureIndex : evictable)
+            {
+                if (residentSize <= m_desc.MemoryBudget || m_numPendingReads >= m_desc.MaxPendingReads)
+                {
+                    break;
+                }
+
+                StreamedTexture& texture = *m_textures[textureIndex];
+                residentSize -= texture.MipSizes[texture.ResidentFirstMip];
+                ScheduleRead(textureIndex, texture.ResidentFirstMip + 1);
+            }
+        }
+
+        // Textures that miss the most mips go first
+        std::sort(loads.begin(), loads.end(), [&](uint32_t lhs, uint32_t rhs)
+            {
+                const StreamedTexture& a = *m_textures[lhs];
+                const StreamedTexture& b = *m_textures[rhs];
+                uint32_t aMissing = a.ResidentFirstMip - a.WantedFirstMip;
+                uint32_t bMissing = b.ResidentFirstMip - b.WantedFirstMip;
+                return aMissing != bMissing ? aMissing > bMissing : isMoreImportant(lhs, rhs);
+            });
+
+        for (uint32_t textureIndex : loads)
+        {
+            if (m_numPendingReads >= m_desc.MaxPendingReads)
+            {
+                break;
+            }
+
+            StreamedTexture& texture = *m_textures[textureIndex];
+            if (texture.IsReading)
+            {
+                // Evicted above
+                continue;
+            }
+
+            // Textures that do not fit get as many of their wanted mips as the budget allows
+            size_t currentSize = GetSizeOfMips(texture, texture.ResidentFirstMip);
+            uint32_t firstMip = texture.WantedFirstMip;
+            while (firstMip < texture.ResidentFirstMip && residentSize - currentSize + GetSizeOfMips(texture, firstMip) > m_desc.MemoryBudget)
+            {
+                ++firstMip;
+            }
+
+            if (firstMip < texture.ResidentFirstMip)
+            {
+                residentSize += GetSizeOfMips(texture, firstMip) - currentSize;
+                ScheduleRead(textureIndex, firstMip);
+            }
+        }
+
+        ++m_updateIndex;
+    }
+
+    TextureStreamingStats TextureStreamer::GetStats() const
+    {
+        TextureStreamingStats stats;
+        stats.NumTextures = static_cast<uint32_t>(m_textureIndices.size());
+        stats.NumPendingReads = m_numPendingReads;
+        for (const std::unique_ptr<StreamedTexture>& texture : m_textures)
+        {
+            stats.ResidentSize += GetSizeOfMips(*texture, texture->ResidentFirstMip);
+            stats.RequestedSize += GetSizeOfMips(*texture, texture->WantedFirstMip);
+        }
+        return stats;
+    }
+
+    uint32_t TextureStreamer::GetResidentFirstMip(AssetProxy proxy) const
+    {
+        auto it = m_textureIndices.find(proxy.ID);
+        return it == m_textureIndices.end() ? 0 : m_textures[it->second]->ResidentFirstMip;
+    }
+
+    size_t TextureStreamer::GetSizeOfMips(const StreamedTexture& texture, uint32_t firstMip) const
+    {
+        size_t size = 0;
+        for (uint32_t mip = firstMip; mip < texture.MipSizes.size(); ++mip)
+        {
+            size += texture.MipSizes[mip];
+        }
+        return size;
+    }
+
+    void TextureStreamer::UploadFinishedReads()
+    {
+        std::vector<FinishedRead> finishedReads;
+        {
+            std::lock_guard lock(m_readMutex);
+            finishedReads.swap(m_finishedReads);
+        }
+
+        if (finishedReads.empty())
+        {
+            return;
+        }
+
+        m_backend->BeginUploads();
+        for (FinishedRead& read : finishedReads)
+        {
+            StreamedTexture& texture = *m_textures[read.TextureIndex];
+            texture.IsReading = false;
+            --m_numPendingReads;
+
+            if (texture.IsRemoved)
+            {
+                // The I/O thread is done with the source as well
+                texture.Source = ImageLoader::Image();
+                continue;
+            }
+
+            if (!read.Image.IsValid() || !m_backend->UploadMips(texture.Proxy, read.Image, read.FirstMip, texture.Usage))
+            {
+                // Residency stays as it was, the texture is reconsidered on the next update
+                WARP_LOG_WARN("TextureStreamer::UploadFinishedReads -> Failed to make mip {} of \'{}\' the first resident one", read.FirstMip, texture.Source.Filepath);
+                continue;
+            }
+
+            texture.ResidentFirstMip = read.FirstMip;
+        }
+        m_backend->EndUploads();
+    }
+
+    void TextureStreamer::ScheduleRead(uint32_t textureIndex, uint32_t firstMip)
+    {
+        StreamedTexture& texture = *m_textures[textureIndex];
+        WARP_ASSERT(!texture.IsReading && firstMip <= texture.InitialFirstMip);
+
+        texture.IsReading = true;
+        texture.ReadFirstMip = firstMip;
+        ++m_numPendingReads;
+
+        // Sources are never modified after they are added, thus the I/O thread reads them without locking
+        const ImageLoader::Image* source = &texture.Source;
+        m_ioThread->Submit([this, source, textureIndex, firstMip]
+            {
+                ImageLoader::Image image = ReadMips(*source, firstMip);
+
+                std::lock_guard lock(m_readMutex);
+                m_finishedReads.push_back(FinishedRead{ .TextureIndex = textureIndex, .FirstMip = firstMip, .Image = std::move(image) });
+            });
+    }
+
+}
\ No newline at end of file
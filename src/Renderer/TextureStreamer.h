@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../Assets/Asset.h"
+#include "../Assets/Importers/TextureImporter.h"
+#include "../Util/ThreadPool.h"
+
+namespace Warp
+{
+
+    // Makes mips of streamed textures resident. The streamer only decides which mips should be resident and reads them,
+    // thus residency decisions can be exercised without a GPU by a backend that merely records the calls
+    class TextureStreamingBackend
+    {
+    public:
+        virtual ~TextureStreamingBackend() = default;
+
+        // Called once per TextureStreamer::Update(), before any upload. Backends release textures that were replaced and are no longer in use here
+        virtual void Update() {}
+
+        // Uploads are batched, every UploadMips() call of an update is enclosed by BeginUploads() and EndUploads()
+        virtual void BeginUploads() = 0;
+        virtual void EndUploads() = 0;
+
+        // Replaces the texture of the asset with one that holds mips of the image only. Mip 0 of the image is mip firstMip of the full chain
+        // Returns false if the texture could not be replaced, it should stay as it was then
+        virtual bool UploadMips(AssetProxy proxy, const ImageLoader::Image& image, uint32_t firstMip, ETextureUsage usage) = 0;
+    };
+
+    struct TextureStreamingDesc
+    {
+        // Bytes that resident mips of every streamed texture may take at once. Initial mips are always resident, even above the budget
+        size_t MemoryBudget = size_t(512) << 20;
+
+        // Textures start with mips no larger than this and never drop them
+        uint32_t MaxInitialMipSize = 64;
+
+        // Textures that were not requested for this many updates fall back to their initial mips
+        uint32_t NumUnusedUpdatesToEvict = 120;
+
+        // Requests mips this many levels finer than the screen-space estimate. Estimates assume that UVs span the surface once, which tiled textures exceed
+        float MipBias = 1.0f;
+
+        // Mip ranges that are being read or uploaded at once. Bounds the memory of images read ahead of their upload
+        // Textures that drop mips are read again without them, thus loads, drops and evictions all count towards it
+        uint32_t MaxPendingReads = 8;
+    };
+
+    struct TextureStreamingStats
+    {
+        uint32_t NumTextures = 0;
+        uint32_t NumPendingReads = 0;
+        size_t ResidentSize = 0; // Bytes, including initial mips
+        size_t RequestedSize = 0; // Bytes that would be resident without the budget
+    };
+
+    // Streams mips of imported textures in and out under a memory budget
+    //
+    // Textures are added with their full mip chains (see TextureImporter::SetTextureStreamer()), but only the mips up to
+    // TextureStreamingDesc::MaxInitialMipSize are uploaded. The renderer requests every texture it samples with the on-screen size
+    // of the surface, which picks the finest mip the texture needs. Update() then orders textures by how many mips they miss
+    // and reads missing mips on a background I/O thread. Images of mapped .dds files are paged in by that thread, not by the frame
+    // Finished reads are uploaded with the backend on the next Update(). Textures that need fewer mips than they have drop them
+    // ahead of any load, and textures that were not requested for a while are dropped first whenever the budget is exceeded
+    class TextureStreamer
+    {
+    public:
+        TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend, const TextureStreamingDesc& desc = TextureStreamingDesc());
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        // Waits for reads that are still running, their images are dropped
+        ~TextureStreamer();
+
+        // Takes the full mip chain of the texture and returns the initial mips, which should be uploaded instead
+        // Images that cannot be streamed (cubemaps, arrays, volumes, single mips) are returned as they are
+        ImageLoader::Image AddTexture(AssetProxy proxy, ImageLoader::Image&& image, ETextureUsage usage);
+
+        // Stops streaming the texture and frees its source. Should be called before the asset is destroyed, reads in flight are dropped
+        void RemoveTexture(AssetProxy proxy);
+
+        // Records that the texture is sampled on a surface that covers screenSize pixels. Textures that were not added are ignored
+        void RequestScreenSize(AssetProxy proxy, float screenSize);
+
+        // Uploads finished reads, decides residency of every texture and issues new reads. Should be called once per frame
+        void Update();
+
+        TextureStreamingStats GetStats() const;
+
+        // Returns the first resident mip of the texture, or 0 if the texture is not streamed
+        uint32_t GetResidentFirstMip(AssetProxy proxy) const;
+
+        inline const TextureStreamingDesc& GetDesc() const { return m_desc; }
+        inline void SetMemoryBudget(size_t budget) { m_desc.MemoryBudget = budget; }
+
+    private:
+        struct StreamedTexture
+        {
+            AssetProxy Proxy;
+            ETextureUsage Usage;
+            ImageLoader::Image Source; // Full mip chain. Read by the I/O thread, never modified after the texture is added
+
+            std::vector<size_t> MipSizes;
+            uint32_t InitialFirstMip; // Coarsest mip that is ever the first one. Block-compressed textures also need it to consist of whole blocks
+            uint32_t ResidentFirstMip;
+            uint32_t WantedFirstMip;
+            uint32_t ReadFirstMip; // First mip of the read in flight, if any
+
+            uint32_t RequestedFirstMip; // Finest mip requested during the current update
+            uint64_t LastRequestedUpdate = 0;
+            float ScreenSize = 0.0f; // Largest screen size of the last requested update, breaks ties between equally urgent textures
+
+            bool IsReading = false;
+            bool IsRemoved = false; // Source is freed once the read in flight, if any, is finished
+        };
+
+        struct FinishedRead
+        {
+            uint32_t TextureIndex;
+            uint32_t FirstMip;
+            ImageLoader::Image Image; // Invalid if the read failed
+        };
+
+        size_t GetSizeOfMips(const StreamedTexture& texture, uint32_t firstMip) const;
+        void UploadFinishedReads();
+        void ScheduleRead(uint32_t textureIndex, uint32_t firstMip);
+
+        std::unique_ptr<TextureStreamingBackend> m_backend;
+        TextureStreamingDesc m_desc;
+
+        // Entries are never erased, removed textures only free their sources. Entries are separate allocations, as the I/O thread reads their sources while new ones are added
+        std::vector<std::unique_ptr<StreamedTexture>> m_textures;
+        std::unordered_map<uint32_t, uint32_t> m_textureIndices; // Asset IDs to m_textures
+        uint64_t m_updateIndex = 1;
+        uint32_t m_numPendingReads = 0;
+
+        mutable std::mutex m_readMutex;
+        std::vector<FinishedRead> m_finishedReads;
+
+        // Declared last, thus it is destroyed (and joined) before anything it uses
+        std::unique_ptr<ThreadPool> m_ioThread;
+    };
+
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <cstddef>
+
 namespace Warp
 {
 
@@ -13,4 +16,57 @@ namespace Warp
         eVertexAttribute_NumAttributes,
     };
 
+    // How a stream of vertex attributes is stored. Quantized encodings are described in Assets/VertexQuantization.h
+    // Shaders decode them as well, see DRAWFLAG_QUANTIZED_VERTICES
+    enum EVertexEncoding : uint32_t
+    {
+        eVertexEncoding_Float = 0, // 32-bit float per component
+        eVertexEncoding_Unorm16,   // Positions. 16-bit unorm per component relative to bounds of the submesh, padded to 8 bytes
+        eVertexEncoding_Oct16,     // Normals and tangents. Octahedral encoding with 16-bit snorm per component
+        eVertexEncoding_Half,      // Texture coordinates. 16-bit float per component
+        eVertexEncoding_SignBits,  // Bitangents. A bit per vertex, set if the bitangent is -cross(normal, tangent). Packed into 32-bit words
+    };
+
+    inline constexpr uint32_t GetNumComponents(EVertexAttribute attribute)
+    {
+        return attribute == eVertexAttribute_TextureCoords ? 2 : 3;
+    }
+
+    // Encoding that is used for the attribute when vertices are quantized
+    inline constexpr EVertexEncoding GetQuantizedEncoding(EVertexAttribute attribute)
+    {
+        switch (attribute)
+        {
+        case eVertexAttribute_Positions: return eVertexEncoding_Unorm16;
+        case eVertexAttribute_Normals: return eVertexEncoding_Oct16;
+        case eVertexAttribute_TextureCoords: return eVertexEncoding_Half;
+        case eVertexAttribute_Tangents: return eVertexEncoding_Oct16;
+        case eVertexAttribute_Bitangents: return eVertexEncoding_SignBits;
+        default: return eVertexEncoding_Float;
+        }
+    }
+
+    // Returns the number of bytes per vertex. Sign bits take less than a byte per vertex, thus their stride is 0
+    inline constexpr uint32_t GetVertexStride(EVertexAttribute attribute, EVertexEncoding encoding)
+    {
+        switch (encoding)
+        {
+        case eVertexEncoding_Float: return GetNumComponents(attribute) * sizeof(float);
+        case eVertexEncoding_Unorm16: return 4 * sizeof(uint16_t);
+        case eVertexEncoding_Oct16: return 2 * sizeof(uint16_t);
+        case eVertexEncoding_Half: return 2 * sizeof(uint16_t);
+        case eVertexEncoding_SignBits: return 0;
+        default: return 0;
+        }
+    }
+
+    inline constexpr size_t GetVertexStreamSize(EVertexAttribute attribute, EVertexEncoding encoding, uint32_t numVertices)
+    {
+        if (encoding == eVertexEncoding_SignBits)
+        {
+            return (size_t(numVertices) + 31) / 32 * sizeof(uint32_t);
+        }
+        return size_t(numVertices) * GetVertexStride(attribute, encoding);
+    }
+
 }
\ No newline at end of file
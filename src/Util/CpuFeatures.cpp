@@ -0,0 +1,46 @@
+#include "CpuFeatures.h"
+
+#include <intrin.h>
+
+namespace Warp
+{
+
+    static CpuFeatures DetectCpuFeatures()
+    {
+        CpuFeatures features;
+
+        int info[4] = {};
+        __cpuid(info, 0);
+        int maxFunctionID = info[0];
+        if (maxFunctionID < 1)
+        {
+            return features;
+        }
+
+        __cpuid(info, 1);
+        features.Sse41 = (info[2] & (1 << 19)) != 0;
+        bool hasFma = (info[2] & (1 << 12)) != 0;
+        bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+        bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+        // AVX registers are only usable if the OS saves YMM state on context switches (XCR0 bits 1 and 2)
+        bool isYmmStateEnabled = hasOsxsave && (_xgetbv(0) & 0x6) == 0x6;
+        features.Avx = hasAvx && isYmmStateEnabled;
+        features.Fma = hasFma && features.Avx;
+
+        if (maxFunctionID >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            features.Avx2 = features.Avx && (info[1] & (1 << 5)) != 0;
+        }
+
+        return features;
+    }
+
+    const CpuFeatures& GetCpuFeatures()
+    {
+        static const CpuFeatures Features = DetectCpuFeatures();
+        return Features;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Warp
+{
+
+    // Instruction set extensions available on the CPU the application runs on
+    // Used to select SIMD kernels at runtime, as the executable itself only targets baseline x64 (SSE2)
+    struct CpuFeatures
+    {
+        bool Sse41 = false;
+        bool Avx = false;
+        bool Avx2 = false;
+        bool Fma = false;
+    };
+
+    // Features are detected once on the first call. It is safe to call it from any thread
+    const CpuFeatures& GetCpuFeatures();
+
+}
\ No newline at end of file
@@ -1,29 +1,94 @@
 #include "Guid.h"
 
-// WinApis GUID and CoCreateGuid
-#include <combaseapi.h>
+#include <bit>
+#include <chrono>
+#include <random>
 
 namespace Warp
 {
 
-    Guid Guid::Create()
+    namespace GuidGenerator
     {
-        GUID winGuid;
-        HRESULT hr = CoCreateGuid(&winGuid);
-        if (FAILED(hr))
+        // xoshiro256** (public domain, David Blackman and Sebastiano Vigna)
+        class Xoshiro256
         {
-            return Guid();
-        }
+        public:
+            explicit Xoshiro256(uint64_t seed)
+            {
+                // State is expanded with splitmix64, as recommended by the authors, thus it is never all zeros
+                for (uint64_t& word : m_state)
+                {
+                    seed += 0x9E3779B97F4A7C15ull;
+                    uint64_t z = seed;
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                    word = z ^ (z >> 31);
+                }
+            }
 
-        Guid result;
-        result.Data1 = winGuid.Data1;
-        result.Data2 = winGuid.Data2;
-        result.Data3 = winGuid.Data3;
-        for (uint32_t i = 0; i < 8; ++i)
+            uint64_t Next()
+            {
+                uint64_t result = std::rotl(m_state[1] * 5, 7) * 9;
+                uint64_t t = m_state[1] << 17;
+                m_state[2] ^= m_state[0];
+                m_state[3] ^= m_state[1];
+                m_state[1] ^= m_state[2];
+                m_state[0] ^= m_state[3];
+                m_state[2] ^= t;
+                m_state[3] = std::rotl(m_state[3], 45);
+                return result;
+            }
+
+        private:
+            uint64_t m_state[4];
+        };
+
+        // The OS is asked for entropy once per thread
+        static Xoshiro256& GetThreadGenerator()
         {
-            result.Data4 |= static_cast<uint64_t>(winGuid.Data4[i] << (8 * i));
+            thread_local Xoshiro256 generator = []
+                {
+                    std::random_device device;
+                    return Xoshiro256((uint64_t(device()) << 32) | device());
+                }();
+            return generator;
         }
 
+        // RFC 9562 variant is stored in the top bits of the first byte of the fourth group, which is the lowest byte of Data4
+        static constexpr uint64_t SetVariant(uint64_t data4) { return (data4 & ~uint64_t(0xC0)) | 0x80; }
+    }
+
+    Guid Guid::Create()
+    {
+        return CreateV7();
+    }
+
+    Guid Guid::CreateV4()
+    {
+        GuidGenerator::Xoshiro256& generator = GuidGenerator::GetThreadGenerator();
+        uint64_t high = generator.Next();
+
+        Guid result;
+        result.Data1 = static_cast<uint32_t>(high >> 32);
+        result.Data2 = static_cast<uint16_t>(high >> 16);
+        result.Data3 = static_cast<uint16_t>(0x4000 | (high & 0x0FFF));
+        result.Data4 = GuidGenerator::SetVariant(generator.Next());
+        return result;
+    }
+
+    Guid Guid::CreateV7()
+    {
+        using namespace std::chrono;
+
+        // 48 bits of milliseconds last until the year 10889
+        uint64_t timestamp = static_cast<uint64_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+
+        GuidGenerator::Xoshiro256& generator = GuidGenerator::GetThreadGenerator();
+        Guid result;
+        result.Data1 = static_cast<uint32_t>(timestamp >> 16);
+        result.Data2 = static_cast<uint16_t>(timestamp);
+        result.Data3 = static_cast<uint16_t>(0x7000 | (generator.Next() & 0x0FFF));
+        result.Data4 = GuidGenerator::SetVariant(generator.Next());
         return result;
     }
 
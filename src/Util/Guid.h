@@ -1,34 +1,48 @@
 #pragma once
 
+#include <compare>
 #include <cstdint>
 #include <functional>
 
 namespace Warp
 {
 
-    // A GUID is a 128-bit value consisting of one group of 8 hexadecimal digits, 
-    // followed by three groups of 4 hexadecimal digits each, followed by one group of 12 hexadecimal digits. 
+    // A GUID is a 128-bit value consisting of one group of 8 hexadecimal digits,
+    // followed by three groups of 4 hexadecimal digits each, followed by one group of 12 hexadecimal digits.
     // The following example GUID shows the groupings of hexadecimal digits in a GUID: 6B29FC40-CA47-1067-B31D-00DD010662DA.
     struct Guid
     {
+        // Same as CreateV7(). Asset Guids created one after another sort next to each other, which keeps ordered indices local
         static Guid Create();
 
+        // RFC 9562 UUIDs. Random bits come from a per-thread generator, seeded once per thread, thus creating a Guid never calls into the OS
+        // Version 7 starts with the Unix time in milliseconds, version 4 is random except for the version and variant bits
+        static Guid CreateV4();
+        static Guid CreateV7();
+
         constexpr bool IsValid() const { return Data1 != 0 || Data2 != 0 || Data3 != 0 || Data4 != 0; }
 
-        constexpr bool operator==(const Guid& other) const { return Data1 == other.Data1 && Data2 == other.Data2 && Data3 == other.Data3 && Data4 == other.Data4; }
-        constexpr bool operator!=(const Guid& other) const { return !(operator==(other)); }
+        // Lexicographic over the groups, in the order they are written in
+        constexpr bool operator==(const Guid& other) const = default;
+        constexpr auto operator<=>(const Guid& other) const = default;
 
-        constexpr bool operator<(const Guid& other) const { return Data1 < other.Data1&& Data2 < other.Data2&& Data3 < other.Data3&& Data4 < other.Data4; }
-        constexpr bool operator>(const Guid& other) const { return Data1 > other.Data1 && Data2 > other.Data2 && Data3 > other.Data3 && Data4 > other.Data4; }
+        // First three groups, as they are written
+        constexpr uint64_t GetHigh() const { return (uint64_t(Data1) << 32) | (uint64_t(Data2) << 16) | uint64_t(Data3); }
 
-        constexpr bool operator<=(const Guid& other) const { return operator<(other) || operator==(other); }
-        constexpr bool operator>=(const Guid& other) const { return operator>(other) || operator==(other); }
+        // Single pass over both halves. Version 7 Guids share their leading bits, thus the halves are mixed rather than folded
+        // Not meant to be persisted, it may change along with the standard library support below
+        constexpr uint64_t GetHash() const
+        {
+            uint64_t hash = (GetHigh() * 0x9E3779B97F4A7C15ull) ^ Data4;
+            hash = (hash ^ (hash >> 32)) * 0xD6E8FEB86659FD93ull;
+            return hash ^ (hash >> 32);
+        }
 
         uint32_t Data1 = 0;
         uint16_t Data2 = 0;
         uint16_t Data3 = 0;
 
-        // Array of 8 bytes. The first 2 bytes contain the third group of 4 hexadecimal digits. 
+        // Array of 8 bytes. The first 2 bytes contain the third group of 4 hexadecimal digits.
         // The remaining 6 bytes contain the final 12 hexadecimal digits.
         uint64_t Data4 = 0;
     };
@@ -40,22 +54,8 @@ namespace Warp
 template<>
 struct std::hash<Warp::Guid>
 {
-    constexpr std::size_t operator()(const Warp::Guid& guid) const
-    {
-        std::size_t r = 0;
-        HashCombine(r, guid.Data1);
-        HashCombine(r, guid.Data2);
-        HashCombine(r, guid.Data3);
-        HashCombine(r, guid.Data4);
-        return r;
-    }
-
-private:
-    // We like doing what boost once did
-    // TODO: Maybe this should be a separate piece of art?
-    template<typename T>
-    static constexpr void HashCombine(std::size_t& seed, const T& t)
+    constexpr std::size_t operator()(const Warp::Guid& guid) const noexcept
     {
-        seed ^= std::hash<T>()(t) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return static_cast<std::size_t>(guid.GetHash());
     }
 };
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "Hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+
+namespace Warp
+{
+
+    static constexpr uint64_t C1 = 0x87c37b91114253d5ULL;
+    static constexpr uint64_t C2 = 0x4cf5ad432745937fULL;
+
+    static inline uint64_t LoadU64(const uint8_t* bytes)
+    {
+        // memcpy is used to avoid unaligned loads. Compilers turn it into a single mov
+        uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    static inline uint64_t FMix64(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    std::string Hash128::ToString() const
+    {
+        return std::format("{:016x}{:016x}", High, Low);
+    }
+
+    Hasher128::Hasher128(uint64_t seed)
+        : m_h1(seed)
+        , m_h2(seed)
+    {
+    }
+
+    void Hasher128::Update(const void* data, size_t numBytes)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        m_totalBytes += numBytes;
+
+        // Complete the pending block first
+        if (m_tailSize > 0)
+        {
+            size_t numCopied = std::min(numBytes, sizeof(m_tail) - m_tailSize);
+            std::memcpy(m_tail + m_tailSize, bytes, numCopied);
+            m_tailSize += numCopied;
+            bytes += numCopied;
+            numBytes -= numCopied;
+
+            if (m_tailSize < sizeof(m_tail))
+            {
+                return;
+            }
+
+            ProcessBlock(m_tail);
+            m_tailSize = 0;
+        }
+
+        for (; numBytes >= sizeof(m_tail); bytes += sizeof(m_tail), numBytes -= sizeof(m_tail))
+        {
+            ProcessBlock(bytes);
+        }
+
+        std::memcpy(m_tail, bytes, numBytes);
+        m_tailSize = numBytes;
+    }
+
+    Hash128 Hasher128::Finalize() const
+    {
+        uint64_t h1 = m_h1;
+        uint64_t h2 = m_h2;
+
+        // Tail is zero-padded, which is equivalent to the byte-by-byte switch of the reference implementation
+        if (m_tailSize > 0)
+        {
+            uint8_t tail[16] = {};
+            std::memcpy(tail, m_tail, m_tailSize);
+
+            uint64_t k1 = LoadU64(tail);
+            uint64_t k2 = LoadU64(tail + 8);
+            if (m_tailSize > 8)
+            {
+                k2 *= C2; k2 = std::rotl(k2, 33); k2 *= C1; h2 ^= k2;
+            }
+
+            k1 *= C1; k1 = std::rotl(k1, 31); k1 *= C2; h1 ^= k1;
+        }
+
+        h1 ^= m_totalBytes;
+        h2 ^= m_totalBytes;
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = FMix64(h1);
+        h2 = FMix64(h2);
+
+        h1 += h2;
+        h2 += h1;
+
+        return Hash128{ .High = h2, .Low = h1 };
+    }
+
+    void Hasher128::ProcessBlock(const uint8_t* block)
+    {
+        uint64_t k1 = LoadU64(block);
+        uint64_t k2 = LoadU64(block + 8);
+
+        k1 *= C1; k1 = std::rotl(k1, 31); k1 *= C2; m_h1 ^= k1;
+
+        m_h1 = std::rotl(m_h1, 27); m_h1 += m_h2; m_h1 = m_h1 * 5 + 0x52dce729;
+
+        k2 *= C2; k2 = std::rotl(k2, 33); k2 *= C1; m_h2 ^= k2;
+
+        m_h2 = std::rotl(m_h2, 31); m_h2 += m_h1; m_h2 = m_h2 * 5 + 0x38495ab5;
+    }
+
+}
\ No newline at end of file
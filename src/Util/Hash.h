@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <compare>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Warp
+{
+
+    // 128-bit hash value. Collisions are negligible for content-addressing, thus it is safe to use it as a key of derived data
+    struct Hash128
+    {
+        constexpr bool operator==(const Hash128& other) const = default;
+        constexpr auto operator<=>(const Hash128& other) const = default;
+
+        // Returns 32 lowercase hexadecimal digits, High first
+        std::string ToString() const;
+
+        uint64_t High = 0;
+        uint64_t Low = 0;
+    };
+
+    // Incremental 128-bit hasher based on MurmurHash3_x64_128 (public domain, Austin Appleby)
+    // Data can be fed in arbitrary pieces, result only depends on the concatenation of all pieces
+    class Hasher128
+    {
+    public:
+        explicit Hasher128(uint64_t seed = 0);
+
+        void Update(const void* data, size_t numBytes);
+        inline void Update(std::string_view str) { Update(str.data(), str.size()); }
+
+        // Hashes object representation of a value. Types with padding should not be passed here
+        template<typename T>
+            requires std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>
+        inline void UpdateValue(const T& value) { Update(&value, sizeof(T)); }
+
+        // Does not modify the state, thus more data can be appended after that
+        Hash128 Finalize() const;
+
+    private:
+        void ProcessBlock(const uint8_t* block);
+
+        uint64_t m_h1 = 0;
+        uint64_t m_h2 = 0;
+        uint64_t m_totalBytes = 0;
+
+        uint8_t m_tail[16] = {};
+        size_t m_tailSize = 0;
+    };
+
+    inline Hash128 HashBytes(const void* data, size_t numBytes, uint64_t seed = 0)
+    {
+        Hasher128 hasher(seed);
+        hasher.Update(data, numBytes);
+        return hasher.Finalize();
+    }
+
+}
+
+template<>
+struct std::hash<Warp::Hash128>
+{
+    std::size_t operator()(const Warp::Hash128& hash) const noexcept
+    {
+        // Already well distributed, just fold it
+        return static_cast<std::size_t>(hash.Low ^ hash.High);
+    }
+};
\ No newline at end of file
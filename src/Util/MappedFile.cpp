@@ -0,0 +1,109 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#include "../WinAPI.h"
+#include "../Util/Logger.h"
+
+namespace Warp
+{
+
+    MappedFile::MappedFile(const std::filesystem::path& filepath)
+    {
+        Open(filepath);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_fileHandle(std::exchange(other.m_fileHandle, nullptr))
+        , m_mappingHandle(std::exchange(other.m_mappingHandle, nullptr))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+            m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+            m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::filesystem::path& filepath)
+    {
+        Close();
+
+        // FILE_FLAG_SEQUENTIAL_SCAN hints the cache manager to read ahead, which is what importers and loaders do
+        HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            WARP_LOG_ERROR("MappedFile::Open -> Failed to open \'{}\'", filepath.string());
+            return false;
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            WARP_LOG_ERROR("MappedFile::Open -> \'{}\' is empty or its size cannot be queried", filepath.string());
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            WARP_LOG_ERROR("MappedFile::Open -> Failed to create file mapping for \'{}\'", filepath.string());
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view)
+        {
+            WARP_LOG_ERROR("MappedFile::Open -> Failed to map a view of \'{}\'", filepath.string());
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_fileHandle = file;
+        m_mappingHandle = mapping;
+        m_data = static_cast<const std::byte*>(view);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mappingHandle)
+        {
+            CloseHandle(m_mappingHandle);
+        }
+
+        if (m_fileHandle)
+        {
+            CloseHandle(m_fileHandle);
+        }
+
+        m_fileHandle = nullptr;
+        m_mappingHandle = nullptr;
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+}
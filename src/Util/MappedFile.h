@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace Warp
+{
+
+    // Read-only view of a whole file mapped into the address space of the process
+    // Pages are brought in lazily by the OS on first access, so opening a huge file is cheap and nothing is copied into private memory
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& filepath);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        // Maps the file at filepath, closing the previously mapped file if any. Returns false if the file cannot be mapped
+        // Empty files cannot be mapped, they are treated as failure as well
+        bool Open(const std::filesystem::path& filepath);
+        void Close();
+
+        inline bool IsValid() const { return m_data != nullptr; }
+
+        inline const std::byte* GetData() const { return m_data; }
+        inline size_t GetSize() const { return m_size; }
+        inline std::span<const std::byte> GetBytes() const { return std::span(m_data, m_size); }
+
+    private:
+        // Raw WinAPI handles, stored as void* to avoid dragging Windows.h into every header
+        void* m_fileHandle = nullptr;
+        void* m_mappingHandle = nullptr;
+
+        const std::byte* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+}
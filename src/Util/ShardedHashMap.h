@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace Warp
+{
+
+    // Hash map that is safe to use from many threads at once. Keys are spread across NumShards independent maps, each guarded by its own lock,
+    // thus threads only contend when their keys land in the same shard. Lookups take the lock shared, modifications take it exclusively
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, size_t NumShards = 64>
+    class ShardedHashMap
+    {
+        static_assert(NumShards > 1 && std::has_single_bit(NumShards), "Shard is selected with the top bits of the hash");
+
+    public:
+        using Shard = std::unordered_map<Key, Value, Hash>;
+
+        ShardedHashMap() = default;
+
+        ShardedHashMap(const ShardedHashMap&) = delete;
+        ShardedHashMap& operator=(const ShardedHashMap&) = delete;
+
+        // Copies the value out, as it may be modified by other threads as soon as the lock is released
+        bool Find(const Key& key, Value& value) const
+        {
+            const LockedShard& shard = GetShard(key);
+            std::shared_lock lock(shard.Mutex);
+
+            auto it = shard.Map.find(key);
+            if (it == shard.Map.end())
+            {
+                return false;
+            }
+
+            value = it->second;
+            return true;
+        }
+
+        bool Contains(const Key& key) const
+        {
+            const LockedShard& shard = GetShard(key);
+            std::shared_lock lock(shard.Mutex);
+            return shard.Map.contains(key);
+        }
+
+        // Returns false if the key is already there, the value is left as it was then
+        bool Insert(const Key& key, const Value& value)
+        {
+            LockedShard& shard = GetShard(key);
+            std::unique_lock lock(shard.Mutex);
+            return shard.Map.emplace(key, value).second;
+        }
+
+        void InsertOrAssign(const Key& key, const Value& value)
+        {
+            LockedShard& shard = GetShard(key);
+            std::unique_lock lock(shard.Mutex);
+            shard.Map.insert_or_assign(key, value);
+        }
+
+        bool Erase(const Key& key)
+        {
+            LockedShard& shard = GetShard(key);
+            std::unique_lock lock(shard.Mutex);
+            return shard.Map.erase(key) > 0;
+        }
+
+        // Erases the key only if pred(value) returns true. Lets callers drop entries they found stale without erasing whatever replaced them meanwhile
+        template<typename Pred>
+        bool EraseIf(const Key& key, Pred&& pred)
+        {
+            LockedShard& shard = GetShard(key);
+            std::unique_lock lock(shard.Mutex);
+
+            auto it = shard.Map.find(key);
+            if (it == shard.Map.end() || !pred(it->second))
+            {
+                return false;
+            }
+
+            shard.Map.erase(it);
+            return true;
+        }
+
+        // Calls func(Shard&) with the shard of the key locked exclusively and returns whatever it returns
+        // Used for find-or-create sequences that should be atomic for the key. func should not touch other keys of the map
+        template<typename Func>
+        decltype(auto) Modify(const Key& key, Func&& func)
+        {
+            LockedShard& shard = GetShard(key);
+            std::unique_lock lock(shard.Mutex);
+            return func(shard.Map);
+        }
+
+        // Not atomic with respect to concurrent modifications, shards are counted one after another
+        size_t GetSize() const
+        {
+            size_t size = 0;
+            for (const LockedShard& shard : m_shards)
+            {
+                std::shared_lock lock(shard.Mutex);
+                size += shard.Map.size();
+            }
+            return size;
+        }
+
+        void Clear()
+        {
+            for (LockedShard& shard : m_shards)
+            {
+                std::unique_lock lock(shard.Mutex);
+                shard.Map.clear();
+            }
+        }
+
+    private:
+        // Shards are cache line aligned, thus locks of neighbouring shards do not share a line
+        struct alignas(64) LockedShard
+        {
+            mutable std::shared_mutex Mutex;
+            Shard Map;
+        };
+
+        static size_t GetShardIndex(const Key& key)
+        {
+            // Maps use the low bits of the hash for buckets, shards take the top bits of its Fibonacci mix, thus both stay spread
+            // std::hash of integers is the identity, the mix also spreads consecutive keys across shards
+            uint64_t hash = static_cast<uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(hash >> (64 - std::countr_zero(NumShards)));
+        }
+
+        LockedShard& GetShard(const Key& key) { return m_shards[GetShardIndex(key)]; }
+        const LockedShard& GetShard(const Key& key) const { return m_shards[GetShardIndex(key)]; }
+
+        std::array<LockedShard, NumShards> m_shards;
+    };
+
+}
\ No newline at end of file
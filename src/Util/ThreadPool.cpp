@@ -0,0 +1,126 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <latch>
+
+#include "../Core/Assert.h"
+
+namespace Warp
+{
+
+    ThreadPool::ThreadPool(uint32_t numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = GetDefaultNumThreads();
+        }
+
+        m_workers.reserve(numThreads);
+        for (uint32_t i = 0; i < numThreads; ++i)
+        {
+            m_workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_taskAvailable.notify_all();
+
+        // Workers drain the remaining tasks before exiting
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    uint32_t ThreadPool::GetDefaultNumThreads()
+    {
+        // hardware_concurrency() is allowed to return 0 if the value is not computable
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    void ThreadPool::Submit(Task task)
+    {
+        WARP_ASSERT(task);
+        {
+            std::lock_guard lock(m_mutex);
+            WARP_ASSERT(!m_stopping, "Submitting a task to a pool that is being destroyed");
+            m_tasks.emplace_back(std::move(task));
+        }
+        m_taskAvailable.notify_one();
+    }
+
+    void ThreadPool::WaitIdle()
+    {
+        std::unique_lock lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_tasks.empty() && m_numActiveTasks == 0; });
+    }
+
+    void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Every worker pulls indices from a shared counter. This balances well when iterations differ a lot in cost,
+        // which is the case for submeshes of a real scene
+        uint32_t numTasks = std::min(count, GetNumThreads());
+        std::atomic<uint32_t> nextIndex = 0;
+        std::latch finished(numTasks);
+
+        for (uint32_t i = 0; i < numTasks; ++i)
+        {
+            Submit([&nextIndex, &finished, &func, count]
+                {
+                    for (uint32_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+                        index < count;
+                        index = nextIndex.fetch_add(1, std::memory_order_relaxed))
+                    {
+                        func(index);
+                    }
+                    finished.count_down();
+                });
+        }
+
+        finished.wait();
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true)
+        {
+            Task task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    // Only reachable when stopping
+                    return;
+                }
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                ++m_numActiveTasks;
+            }
+
+            task();
+
+            {
+                std::lock_guard lock(m_mutex);
+                --m_numActiveTasks;
+                if (m_tasks.empty() && m_numActiveTasks == 0)
+                {
+                    m_idle.notify_all();
+                }
+            }
+        }
+    }
+
+}
\ No newline at end of file
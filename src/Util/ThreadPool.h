@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Core/Defines.h"
+
+namespace Warp
+{
+
+    // A fixed-size pool of worker threads that execute submitted tasks in FIFO order
+    // Used by importers to spread independent CPU-heavy work (mesh optimization, image decoding) across cores
+    //
+    // Tasks must not throw. The pool does not track which tasks belong to whom, thus WaitIdle() waits for ALL submitted tasks
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        // Passing 0 as numThreads will create as many workers as there are hardware threads available
+        explicit ThreadPool(uint32_t numThreads = 0);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        ~ThreadPool();
+
+        // Returns the number of threads that should be used if the user requests 0 threads
+        static uint32_t GetDefaultNumThreads();
+
+        inline uint32_t GetNumThreads() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        void Submit(Task task);
+
+        // Blocks the calling thread until the task queue is empty and no worker is executing a task
+        void WaitIdle();
+
+        // Invokes func(i) for every i in [0, count) across the workers and blocks until all invocations are finished
+        // The calling thread does not participate, so it is safe to call this from a thread that is not a part of the pool
+        void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+    private:
+        void WorkerLoop();
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_taskAvailable;
+        std::condition_variable m_idle;
+        std::deque<Task> m_tasks;
+        uint32_t m_numActiveTasks = 0;
+        bool m_stopping = false;
+    };
+
+}
\ No newline at end of file
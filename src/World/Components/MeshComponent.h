@@ -13,14 +13,14 @@ namespace Warp
         MeshComponent() = default;
         MeshComponent(AssetManager* manager, AssetProxy proxy)
             : Manager(manager)
-            , Proxy(proxy)
+            , Proxy(manager, proxy)
         {
         }
 
         MeshAsset* GetMesh() { return Manager->GetAs<MeshAsset>(Proxy); }
 
         AssetManager* Manager = nullptr;
-        AssetProxy Proxy;
+        AssetHandle Proxy; // Entities keep their meshes alive, the mesh is released once the component is removed
     };
 
 }
\ No newline at end of file
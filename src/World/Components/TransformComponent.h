@@ -16,6 +16,27 @@ namespace Warp
         {
         }
 
+        // Shear cannot be described by a transform component and is lost. Matrices that do not decompose keep only their translation
+        static TransformComponent FromMatrix(const Math::Matrix& matrix)
+        {
+            Math::Vector3 scaling;
+            Math::Quaternion rotation;
+            Math::Vector3 translation;
+            Math::Matrix decomposed = matrix;
+            if (!decomposed.Decompose(scaling, rotation, translation))
+            {
+                return TransformComponent(matrix.Translation(), Math::Vector3(), Math::Vector3(1.0f));
+            }
+
+            // Quaternion::ToEuler() is the inverse of Matrix::CreateFromYawPitchRoll() used by GetMatrix()
+            return TransformComponent(translation, rotation.ToEuler(), scaling);
+        }
+
+        Math::Matrix GetMatrix() const
+        {
+            return Math::Matrix::CreateScale(Scaling) * Math::Matrix::CreateFromYawPitchRoll(Rotation) * Math::Matrix::CreateTranslation(Translation);
+        }
+
         Math::Vector3 Translation;
         Math::Vector3 Rotation;
         Math::Vector3 Scaling;
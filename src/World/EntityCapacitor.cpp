@@ -1,5 +1,7 @@
 #include "EntityCapacitor.h"
 
+#include <vector>
+
 namespace Warp
 {
 
@@ -9,6 +11,16 @@ namespace Warp
         return Entity(this, handle);
     }
 
+    void EntityCapacitor::CreateEntities(std::span<Entity> entities)
+    {
+        std::vector<entt::entity> handles(entities.size());
+        m_registry.create(handles.begin(), handles.end());
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            entities[i] = Entity(this, handles[i]);
+        }
+    }
+
     Entity EntityCapacitor::RemoveEntity(Entity entity)
     {
         m_registry.destroy(entity.m_handle);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <ranges>
+#include <span>
 
 #include "Entity.h"
 #include "../Core/Defines.h"
@@ -20,6 +22,25 @@ namespace Warp
         Entity CreateEntity();
         Entity RemoveEntity(Entity entity);
 
+        // Creates entities.size() entities at once, which allocates the entity pool a single time
+        void CreateEntities(std::span<Entity> entities);
+
+        // Allocates storage of every component type for numComponents components up front
+        template<typename... ComponentTypes>
+        void ReserveComponents(size_t numComponents)
+        {
+            (m_registry.storage<ComponentTypes>().reserve(numComponents), ...);
+        }
+
+        // Assigns components[i] to entities[i] in a single insertion per component pool
+        template<typename ComponentType>
+        void InsertComponents(std::span<const Entity> entities, std::span<const ComponentType> components)
+        {
+            WARP_ASSERT(entities.size() == components.size());
+            auto handles = entities | std::views::transform([](const Entity& entity) { return entity.m_handle; });
+            m_registry.insert<ComponentType>(handles.begin(), handles.end(), components.begin());
+        }
+
         template<typename ComponentType, typename... Args>
         auto AddComponent(Entity entity, Args&&... args) -> ComponentType&
         {
@@ -114,6 +114,27 @@ namespace Warp
         return entity;
     }
 
+    void World::CreateEntities(std::span<Entity> entities)
+    {
+        m_entityCapacitor.CreateEntities(entities);
+    }
+
+    Math::Matrix World::GetInstanceToWorld(Entity entity) const
+    {
+        Math::Matrix instanceToWorld = m_entityCapacitor.GetComponent<TransformComponent>(entity).GetMatrix();
+        while (m_entityCapacitor.HasComponents<ParentComponent>(entity))
+        {
+            entity = m_entityCapacitor.GetComponent<ParentComponent>(entity).Parent;
+            if (!m_entityCapacitor.IsValid(entity) || !m_entityCapacitor.HasComponents<TransformComponent>(entity))
+            {
+                break;
+            }
+
+            instanceToWorld *= m_entityCapacitor.GetComponent<TransformComponent>(entity).GetMatrix();
+        }
+        return instanceToWorld;
+    }
+
     Entity World::RemoveEntity(Entity entity)
     {
         m_entityCapacitor.RemoveEntity(entity);
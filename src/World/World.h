@@ -1,10 +1,12 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <span>
 #include <unordered_map>
 
 #include "Entity.h"
 #include "EntityCapacitor.h"
+#include "../Math/Math.h"
 #include "../Core/Defines.h"
 #include "../Core/Assert.h"
 
@@ -26,6 +28,13 @@ namespace Warp
         WARP_ATTR_NODISCARD Entity CreateEntity(std::string_view name = "Unnamed");
         WARP_ATTR_NODISCARD Entity RemoveEntity(Entity entity);
 
+        // Creates every entity with a single registry allocation. Unlike CreateEntity() no NametagComponent is added,
+        // so that spawning thousands of entities does not allocate a string per entity
+        void CreateEntities(std::span<Entity> entities);
+
+        // TransformComponent is relative to the parent for entities with ParentComponent. Combines transforms up to the root
+        Math::Matrix GetInstanceToWorld(Entity entity) const;
+
         constexpr       EntityCapacitor& GetEntityCapacitor() { return m_entityCapacitor; }
         constexpr const EntityCapacitor& GetEntityCapacitor() const { return m_entityCapacitor; }
 
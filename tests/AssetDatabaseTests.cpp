@@ -0,0 +1,218 @@
+#include "Test.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../src/Assets/AssetDatabase.h"
+#include "../src/Assets/AssetManager.h"
+
+namespace Warp
+{
+
+    static AssetProxy MakeTestProxy(uint32_t ID)
+    {
+        AssetProxy proxy;
+        proxy.ID = ID;
+        proxy.Index = ID;
+        proxy.Type = EAssetType::Texture;
+        return proxy;
+    }
+
+    static std::vector<char> ReadFileBytes(const std::filesystem::path& filepath)
+    {
+        std::ifstream file(filepath, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    static void WriteFileBytes(const std::filesystem::path& filepath, const std::vector<char>& bytes)
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    WARP_TEST(AssetDatabase_SavedRecordsAreFoundAfterLoad)
+    {
+        Test::ScopedTestFolder folder("AssetDatabase_RoundTrip");
+        std::filesystem::path filepath = folder / "AssetDatabase.wadb";
+
+        Guid albedoGuid;
+        Guid meshGuid;
+        {
+            AssetDatabase database;
+            WARP_TEST_CHECK(database.Load(filepath));
+            WARP_TEST_CHECK(database.GetNumRecords() == 0);
+
+            albedoGuid = database.Register(EAssetType::Texture, "Sponza/Albedo.png");
+            meshGuid = database.Register(EAssetType::Mesh, "Sponza/Sponza.gltf");
+            database.SetCookedPath(meshGuid, "Sponza/Sponza.wmesh");
+            WARP_TEST_CHECK(albedoGuid.IsValid() && meshGuid.IsValid() && albedoGuid != meshGuid);
+            WARP_TEST_CHECK(database.Register(EAssetType::Texture, "Sponza/Albedo.png") == albedoGuid);
+            WARP_TEST_CHECK(database.Save());
+        }
+
+        AssetDatabase database;
+        WARP_TEST_CHECK(database.Load(filepath));
+        WARP_TEST_CHECK(database.GetNumRecords() == 2);
+        WARP_TEST_CHECK(database.FindGuid("Sponza/Albedo.png") == albedoGuid);
+        WARP_TEST_CHECK(database.FindGuid("Sponza/Sponza.gltf") == meshGuid);
+        WARP_TEST_CHECK(!database.FindGuid("Sponza/Normal.png").IsValid());
+
+        AssetDatabase::Record record;
+        WARP_TEST_CHECK(database.FindRecord(meshGuid, record));
+        WARP_TEST_CHECK(record.AssetGuid == meshGuid);
+        WARP_TEST_CHECK(record.Type == EAssetType::Mesh);
+        WARP_TEST_CHECK(record.SourcePath == "Sponza/Sponza.gltf");
+        WARP_TEST_CHECK(record.CookedPath == "Sponza/Sponza.wmesh");
+        WARP_TEST_CHECK(database.FindRecord(albedoGuid, record) && record.CookedPath.empty());
+        WARP_TEST_CHECK(!database.FindRecord(Guid::Create(), record));
+
+        // Mapped records keep their Guids, changes shadow them until the next save
+        WARP_TEST_CHECK(database.Register(EAssetType::Texture, "Sponza/Albedo.png", Guid::Create()) == albedoGuid);
+        database.SetCookedPath(albedoGuid, "Sponza/Albedo.dds");
+        Guid normalGuid = database.Register(EAssetType::Texture, "Sponza/Normal.png");
+        WARP_TEST_CHECK(database.GetNumRecords() == 3);
+        WARP_TEST_CHECK(database.Save());
+
+        AssetDatabase reloaded;
+        WARP_TEST_CHECK(reloaded.Load(filepath));
+        WARP_TEST_CHECK(reloaded.GetNumRecords() == 3);
+        WARP_TEST_CHECK(reloaded.FindRecord(albedoGuid, record) && record.CookedPath == "Sponza/Albedo.dds");
+        WARP_TEST_CHECK(reloaded.FindGuid("Sponza/Normal.png") == normalGuid);
+        WARP_TEST_CHECK(reloaded.FindGuid("Sponza/Sponza.gltf") == meshGuid);
+    }
+
+    WARP_TEST(AssetDatabase_CorruptedHeaderResultsInEmptyDatabase)
+    {
+        Test::ScopedTestFolder folder("AssetDatabase_CorruptedHeader");
+        std::filesystem::path filepath = folder / "AssetDatabase.wadb";
+
+        Guid guid;
+        {
+            AssetDatabase database;
+            database.Load(filepath);
+            guid = database.Register(EAssetType::Texture, "Sponza/Albedo.png");
+            WARP_TEST_CHECK(database.Save());
+        }
+
+        const std::vector<char> validBytes = ReadFileBytes(filepath);
+        WARP_TEST_CHECK(validBytes.size() > 64);
+
+        // Offsets of AssetDatabase::FileHeader members: Magic, Version, FileSize, TableCapacity, RecordTableOffset, StringsOffset
+        auto patchWord = [](std::vector<char>& bytes, size_t offset, uint64_t value, size_t numBytes)
+            {
+                std::memcpy(bytes.data() + offset, &value, numBytes);
+            };
+
+        std::vector<std::vector<char>> corruptedFiles;
+        corruptedFiles.push_back(std::vector<char>(validBytes.begin(), validBytes.begin() + 12)); // Truncated header
+        corruptedFiles.push_back(std::vector<char>(validBytes.begin(), validBytes.end() - 16)); // Truncated sections
+        corruptedFiles.push_back(validBytes); patchWord(corruptedFiles.back(), 0, 0x12345678, 4);
+        corruptedFiles.push_back(validBytes); patchWord(corruptedFiles.back(), 4, 0xFFFF, 4);
+        corruptedFiles.push_back(validBytes); patchWord(corruptedFiles.back(), 8, validBytes.size() + 1, 8);
+        corruptedFiles.push_back(validBytes); patchWord(corruptedFiles.back(), 20, 3, 4);
+        corruptedFiles.push_back(validBytes); patchWord(corruptedFiles.back(), 24, 7, 8);
+        corruptedFiles.push_back(validBytes); patchWord(corruptedFiles.back(), 48, uint64_t(-16), 8);
+
+        for (const std::vector<char>& corruptedBytes : corruptedFiles)
+        {
+            WriteFileBytes(filepath, corruptedBytes);
+
+            AssetDatabase database;
+            WARP_TEST_CHECK(!database.Load(filepath));
+            WARP_TEST_CHECK(database.GetNumRecords() == 0);
+            WARP_TEST_CHECK(!database.FindGuid("Sponza/Albedo.png").IsValid());
+
+            // The index is rewritten on save
+            Guid newGuid = database.Register(EAssetType::Texture, "Sponza/Albedo.png");
+            WARP_TEST_CHECK(newGuid.IsValid() && newGuid != guid);
+            WARP_TEST_CHECK(database.Save());
+
+            AssetDatabase reloaded;
+            WARP_TEST_CHECK(reloaded.Load(filepath));
+            WARP_TEST_CHECK(reloaded.FindGuid("Sponza/Albedo.png") == newGuid);
+        }
+    }
+
+    WARP_TEST(AssetDatabase_UnboundProxiesLeaveReusableTombstones)
+    {
+        static constexpr uint32_t NumGuids = 1000;
+
+        AssetDatabase database;
+        std::vector<Guid> guids;
+        for (uint32_t i = 0; i < NumGuids; ++i)
+        {
+            guids.push_back(Guid::Create());
+            database.BindProxy(guids.back(), MakeTestProxy(i));
+        }
+
+        // Every other Guid is unbound, those placed after them in a probe sequence stay reachable
+        for (uint32_t i = 0; i < NumGuids; i += 2)
+        {
+            database.UnbindProxy(guids[i], MakeTestProxy(i));
+        }
+
+        for (uint32_t i = 0; i < NumGuids; ++i)
+        {
+            AssetProxy proxy = database.ResolveProxy(guids[i]);
+            WARP_TEST_CHECK(i % 2 == 0 ? !proxy.IsValid() : proxy.ID == i);
+        }
+
+        // A proxy of another asset does not unbind the Guid, e.g. a destroyed asset whose Guid was already given to a new one
+        database.UnbindProxy(guids[1], MakeTestProxy(NumGuids));
+        WARP_TEST_CHECK(database.ResolveProxy(guids[1]).ID == 1);
+
+        // Unbound Guids are bound again, new ones take the tombstones over
+        for (uint32_t i = 0; i < NumGuids; i += 2)
+        {
+            database.BindProxy(guids[i], MakeTestProxy(NumGuids + i));
+        }
+
+        for (uint32_t round = 0; round < 16; ++round)
+        {
+            for (uint32_t i = 0; i < NumGuids; ++i)
+            {
+                Guid guid = Guid::Create();
+                database.BindProxy(guid, MakeTestProxy(i));
+                database.UnbindProxy(guid, MakeTestProxy(i));
+                WARP_TEST_CHECK(!database.ResolveProxy(guid).IsValid());
+            }
+        }
+
+        for (uint32_t i = 0; i < NumGuids; ++i)
+        {
+            WARP_TEST_CHECK(database.ResolveProxy(guids[i]).ID == (i % 2 == 0 ? NumGuids + i : i));
+        }
+    }
+
+    WARP_TEST(AssetDatabase_ManagerResolvesGuidsOfLiveAssets)
+    {
+        Test::ScopedTestFolder folder("AssetDatabase_Manager");
+
+        AssetDatabase database;
+        database.Load(folder / "AssetDatabase.wadb");
+
+        AssetManager manager;
+        manager.SetAssetDatabase(&database);
+
+        AssetProxy proxy = manager.CreateAsset<TextureAsset>("Sponza/Albedo.png");
+        Guid guid = manager.GetAs<TextureAsset>(proxy)->GetGuid();
+        WARP_TEST_CHECK(guid == database.FindGuid("Sponza/Albedo.png"));
+        WARP_TEST_CHECK(manager.GetAssetProxy(guid).ID == proxy.ID);
+
+        proxy = manager.DestroyAsset(proxy);
+        WARP_TEST_CHECK(!manager.GetAssetProxy(guid).IsValid());
+
+        // The path keeps its Guid, which now resolves to the new asset
+        AssetProxy reimported = manager.CreateAsset<TextureAsset>("Sponza/Albedo.png");
+        WARP_TEST_CHECK(manager.GetAs<TextureAsset>(reimported)->GetGuid() == guid);
+        WARP_TEST_CHECK(manager.GetAssetProxy(guid).ID == reimported.ID);
+
+        reimported = manager.DestroyAsset(reimported);
+        manager.SetAssetDatabase(nullptr);
+    }
+
+}
\ No newline at end of file
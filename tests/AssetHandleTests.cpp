@@ -0,0 +1,171 @@
+#include "Test.h"
+
+#include <vector>
+
+#include "../src/Assets/AssetHandle.h"
+#include "../src/Assets/AssetManager.h"
+
+namespace Warp
+{
+
+    static std::vector<AssetProxy> TakeReleasedAssets(AssetManager& manager)
+    {
+        std::vector<AssetProxy> releasedAssets;
+        manager.TakeReleasedAssets(releasedAssets);
+        return releasedAssets;
+    }
+
+    WARP_TEST(AssetHandle_LastReferenceQueuesAssetOnce)
+    {
+        AssetManager manager;
+        AssetProxy proxy = manager.CreateAsset<TextureAsset>("Textures/Albedo.png");
+
+        {
+            AssetHandle handle(&manager, proxy);
+            AssetHandle copy = handle;
+            AssetHandle moved = std::move(copy);
+            WARP_TEST_CHECK(!copy.IsValid());
+            WARP_TEST_CHECK(manager.GetNumRefs(proxy) == 2);
+
+            moved.Reset();
+            WARP_TEST_CHECK(manager.GetNumRefs(proxy) == 1);
+            WARP_TEST_CHECK(TakeReleasedAssets(manager).empty());
+        }
+
+        std::vector<AssetProxy> releasedAssets = TakeReleasedAssets(manager);
+        WARP_TEST_CHECK(releasedAssets.size() == 1 && releasedAssets[0].ID == proxy.ID);
+        WARP_TEST_CHECK(TakeReleasedAssets(manager).empty());
+
+        // Released assets stay alive until they are destroyed
+        WARP_TEST_CHECK(manager.GetAs<TextureAsset>(proxy) != nullptr);
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(proxy));
+        WARP_TEST_CHECK(!manager.IsValid<TextureAsset>(proxy));
+    }
+
+    WARP_TEST(AssetHandle_AssetsWithoutHandlesAreNeverReleased)
+    {
+        AssetManager manager;
+        AssetProxy proxy = manager.CreateAsset<TextureAsset>("Textures/Albedo.png");
+
+        AssetHandle invalidHandle(&manager, AssetProxy());
+        AssetHandle nullManagerHandle(nullptr, proxy);
+        WARP_TEST_CHECK(!invalidHandle.IsValid());
+        WARP_TEST_CHECK(!nullManagerHandle.IsValid());
+
+        WARP_TEST_CHECK(manager.GetNumRefs(proxy) == 0);
+        WARP_TEST_CHECK(TakeReleasedAssets(manager).empty());
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(proxy));
+    }
+
+    WARP_TEST(AssetHandle_ReferencedAgainAfterReleaseIsNotDestroyed)
+    {
+        AssetManager manager;
+        AssetProxy proxy = manager.CreateAsset<TextureAsset>("Textures/Albedo.png");
+
+        AssetHandle(&manager, proxy).Reset();
+        std::vector<AssetProxy> releasedAssets = TakeReleasedAssets(manager);
+        WARP_TEST_CHECK(releasedAssets.size() == 1);
+
+        // An importer found the asset by its path before the release queue got to it
+        AssetHandle handle(&manager, manager.GetAssetProxy("Textures/Albedo.png"));
+        WARP_TEST_CHECK(handle.IsValid());
+
+        bool wasDestroyCallbackCalled = false;
+        WARP_TEST_CHECK(!manager.DestroyIfUnreferenced(releasedAssets[0], [&wasDestroyCallbackCalled](AssetProxy) { wasDestroyCallbackCalled = true; }));
+        WARP_TEST_CHECK(!wasDestroyCallbackCalled);
+        WARP_TEST_CHECK(manager.GetAs<TextureAsset>(handle) != nullptr);
+
+        // Dropping it again queues it for the second time
+        handle.Reset();
+        releasedAssets = TakeReleasedAssets(manager);
+        WARP_TEST_CHECK(releasedAssets.size() == 1 && releasedAssets[0].ID == proxy.ID);
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(releasedAssets[0]));
+    }
+
+    WARP_TEST(AssetHandle_DestroyingAssetCannotBeReferenced)
+    {
+        AssetManager manager;
+        AssetProxy proxy = manager.CreateAsset<TextureAsset>("Textures/Albedo.png");
+        AssetHandle(&manager, proxy).Reset();
+
+        bool wasDestroyCallbackCalled = false;
+        bool wasDestroyed = manager.DestroyIfUnreferenced(proxy, [&manager, &wasDestroyCallbackCalled](AssetProxy destroyed)
+            {
+                // The asset is still there for releasing its descriptors, but it is not alive anymore
+                wasDestroyCallbackCalled = true;
+                WARP_TEST_CHECK(manager.GetAs<TextureAsset>(destroyed) != nullptr);
+                WARP_TEST_CHECK(!manager.GetAssetProxy("Textures/Albedo.png").IsValid());
+                WARP_TEST_CHECK(!manager.AddRef(destroyed));
+                WARP_TEST_CHECK(!AssetHandle(&manager, destroyed).IsValid());
+                WARP_TEST_CHECK(manager.GetNumRefs(destroyed) == 0);
+            });
+
+        WARP_TEST_CHECK(wasDestroyed && wasDestroyCallbackCalled);
+        WARP_TEST_CHECK(!manager.DestroyIfUnreferenced(proxy));
+        WARP_TEST_CHECK(!manager.AddRef(proxy));
+
+        // The path is free again, importing it creates a new asset
+        WARP_TEST_CHECK(!manager.GetAssetProxy("Textures/Albedo.png").IsValid());
+        AssetProxy reimported = manager.CreateAsset<TextureAsset>("Textures/Albedo.png");
+        WARP_TEST_CHECK(reimported.IsValid() && reimported.ID != proxy.ID);
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(reimported));
+    }
+
+    WARP_TEST(AssetHandle_StaleHandleDoesNotTouchReusedSlot)
+    {
+        AssetManager manager;
+        AssetProxy proxy = manager.CreateAsset<MaterialAsset>();
+        AssetHandle handle(&manager, proxy);
+
+        // Destroyed regardless of the handle, then the slot is handed out again
+        AssetProxy stale = proxy;
+        proxy = manager.DestroyAsset(proxy);
+        AssetProxy reused = manager.CreateAsset<MaterialAsset>();
+        AssetHandle reusedHandle(&manager, reused);
+        WARP_TEST_CHECK(reused.Index == stale.Index);
+
+        // References of the stale handle are checked against the generation of the slot, thus they never land on the new asset
+        WARP_TEST_CHECK(!AssetHandle(handle).IsValid());
+        WARP_TEST_CHECK(manager.GetNumRefs(stale) == 0);
+        handle.Reset();
+        WARP_TEST_CHECK(manager.GetNumRefs(reused) == 1);
+        WARP_TEST_CHECK(TakeReleasedAssets(manager).empty());
+
+        reusedHandle.Reset();
+        WARP_TEST_CHECK(!manager.DestroyIfUnreferenced(stale));
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(reused));
+    }
+
+    WARP_TEST(AssetHandle_DestroyedMaterialReleasesItsTextures)
+    {
+        AssetManager manager;
+        AssetProxy albedo = manager.CreateAsset<TextureAsset>("Textures/Albedo.png");
+        AssetProxy normal = manager.CreateAsset<TextureAsset>("Textures/Normal.png");
+        AssetProxy material = manager.CreateAsset<MaterialAsset>();
+
+        AssetHandle materialHandle(&manager, material);
+        manager.GetAs<MaterialAsset>(material)->AlbedoMap = AssetHandle(&manager, albedo);
+        manager.GetAs<MaterialAsset>(material)->NormalMap = AssetHandle(&manager, normal);
+
+        // Textures shared with another material outlive the first one
+        AssetHandle sharedNormal(&manager, normal);
+        materialHandle.Reset();
+
+        std::vector<AssetProxy> releasedAssets = TakeReleasedAssets(manager);
+        WARP_TEST_CHECK(releasedAssets.size() == 1 && releasedAssets[0].ID == material.ID);
+        WARP_TEST_CHECK(manager.GetNumRefs(albedo) == 1);
+
+        // Textures are released only once the material is destroyed, thus they outlive every frame that used the material
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(material));
+        releasedAssets = TakeReleasedAssets(manager);
+        WARP_TEST_CHECK(releasedAssets.size() == 1 && releasedAssets[0].ID == albedo.ID);
+        WARP_TEST_CHECK(manager.GetNumRefs(albedo) == 0);
+        WARP_TEST_CHECK(manager.GetNumRefs(normal) == 1);
+
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(albedo));
+        WARP_TEST_CHECK(!manager.DestroyIfUnreferenced(normal));
+        sharedNormal.Reset();
+        WARP_TEST_CHECK(manager.DestroyIfUnreferenced(normal));
+    }
+
+}
\ No newline at end of file
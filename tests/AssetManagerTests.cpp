@@ -0,0 +1,155 @@
+#include "Test.h"
+
+#include <atomic>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/Assets/AssetManager.h"
+
+namespace Warp
+{
+
+    static constexpr uint32_t NumStressThreads = 8;
+
+    static std::string MakeStressPath(uint32_t index)
+    {
+        return std::format("Stress/Texture{}.png", index);
+    }
+
+    WARP_TEST(AssetManager_ConcurrentCreateAssetYieldsSingleProxyPerPath)
+    {
+        static constexpr uint32_t NumPaths = 500;
+        static constexpr uint32_t NumIterations = 4000;
+
+        AssetManager manager;
+        std::vector<std::vector<AssetProxy>> proxies(NumStressThreads, std::vector<AssetProxy>(NumPaths));
+
+        std::vector<std::thread> threads;
+        for (uint32_t threadIndex = 0; threadIndex < NumStressThreads; ++threadIndex)
+        {
+            threads.emplace_back([&manager, &proxies, threadIndex]
+                {
+                    // Threads walk the paths with different strides, thus they meet on the same paths at different times
+                    for (uint32_t i = 0; i < NumIterations; ++i)
+                    {
+                        uint32_t pathIndex = (i * (threadIndex * 2 + 1)) % NumPaths;
+                        AssetProxy proxy = manager.CreateAsset<TextureAsset>(MakeStressPath(pathIndex));
+                        WARP_TEST_CHECK(manager.IsValid<TextureAsset>(proxy));
+
+                        AssetProxy& seen = proxies[threadIndex][pathIndex];
+                        WARP_TEST_CHECK(!seen.IsValid() || seen.ID == proxy.ID);
+                        seen = proxy;
+                    }
+                });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (uint32_t pathIndex = 0; pathIndex < NumPaths; ++pathIndex)
+        {
+            AssetProxy proxy = manager.GetAssetProxy(MakeStressPath(pathIndex));
+            WARP_TEST_CHECK(proxy.IsValid());
+            for (const std::vector<AssetProxy>& threadProxies : proxies)
+            {
+                WARP_TEST_CHECK(!threadProxies[pathIndex].IsValid() || threadProxies[pathIndex].ID == proxy.ID);
+            }
+
+            // Assets were never referenced, the manager would warn about them otherwise
+            WARP_TEST_CHECK(manager.DestroyIfUnreferenced(proxy));
+        }
+    }
+
+    WARP_TEST(AssetManager_ConcurrentReferencesRaceWithReleaseQueue)
+    {
+        static constexpr uint32_t NumPaths = 64;
+        static constexpr uint32_t NumIterations = 20000;
+
+        AssetManager manager;
+        std::atomic<bool> isImporting = true;
+        std::atomic<uint32_t> numDestroyed = 0;
+
+        // Stands in for AssetReleaseQueue, without waiting for the GPU
+        auto destroyReleasedAssets = [&manager, &numDestroyed]
+            {
+                std::vector<AssetProxy> releasedAssets;
+                manager.TakeReleasedAssets(releasedAssets);
+                for (AssetProxy& proxy : releasedAssets)
+                {
+                    manager.DestroyIfUnreferenced(proxy, [&manager, &numDestroyed](AssetProxy destroyed)
+                        {
+                            // Nothing may reference the asset or find it by its path anymore
+                            WARP_TEST_CHECK(manager.GetNumRefs(destroyed) == 0);
+                            WARP_TEST_CHECK(!manager.AddRef(destroyed));
+                            for (uint32_t pathIndex = 0; pathIndex < NumPaths; ++pathIndex)
+                            {
+                                WARP_TEST_CHECK(manager.GetAssetProxy(MakeStressPath(pathIndex)).ID != destroyed.ID);
+                            }
+                            ++numDestroyed;
+                        });
+                }
+            };
+
+        std::thread releaseThread([&isImporting, &destroyReleasedAssets]
+            {
+                while (isImporting)
+                {
+                    destroyReleasedAssets();
+                }
+            });
+
+        std::vector<std::thread> threads;
+        for (uint32_t threadIndex = 0; threadIndex < NumStressThreads; ++threadIndex)
+        {
+            threads.emplace_back([&manager, threadIndex]
+                {
+                    for (uint32_t i = 0; i < NumIterations; ++i)
+                    {
+                        std::string path = MakeStressPath((i * 7 + threadIndex) % NumPaths);
+
+                        // Lookups go through both paths importers use
+                        AssetProxy proxy = (i % 2) ? manager.GetAssetProxy(path) : AssetProxy();
+                        if (!proxy.IsValid())
+                        {
+                            proxy = manager.CreateAsset<TextureAsset>(path);
+                        }
+
+                        // The asset may be destroyed before it is referenced, the handle is empty then. Once it is referenced, it stays alive
+                        // and it is the only asset of its path
+                        AssetHandle handle(&manager, proxy);
+                        if (!handle.IsValid())
+                        {
+                            continue;
+                        }
+
+                        AssetHandle copy = handle;
+                        WARP_TEST_CHECK(manager.GetNumRefs(handle) >= 2);
+                        WARP_TEST_CHECK(manager.GetAs<TextureAsset>(handle) != nullptr);
+                        WARP_TEST_CHECK(manager.GetAssetProxy(path).ID == proxy.ID);
+                        WARP_TEST_CHECK(manager.CreateAsset<TextureAsset>(path).ID == proxy.ID);
+                    }
+                });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        isImporting = false;
+        releaseThread.join();
+        destroyReleasedAssets();
+
+        // Every asset was referenced and released at least once, thus none is left behind
+        WARP_TEST_CHECK(numDestroyed > 0);
+        for (uint32_t pathIndex = 0; pathIndex < NumPaths; ++pathIndex)
+        {
+            WARP_TEST_CHECK(!manager.GetAssetProxy(MakeStressPath(pathIndex)).IsValid());
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "Test.h"
+
+#include <vector>
+
+#include "../src/Assets/AssetManager.h"
+
+namespace Warp
+{
+
+    WARP_TEST(AssetRegistry_DestroyedSlotIsReusedWithNewGeneration)
+    {
+        AssetManager manager;
+        AssetProxy first = manager.CreateAsset<TextureAsset>();
+        AssetProxy second = manager.CreateAsset<TextureAsset>();
+        TextureAsset* firstAsset = manager.GetAs<TextureAsset>(first);
+
+        AssetProxy stale = first;
+        first = manager.DestroyAsset(first);
+        WARP_TEST_CHECK(!first.IsValid());
+        WARP_TEST_CHECK(!manager.IsValid<TextureAsset>(stale));
+        WARP_TEST_CHECK(manager.GetAs<TextureAsset>(stale) == nullptr);
+        WARP_TEST_CHECK(!manager.GetAssetProxy(stale.ID).IsValid());
+
+        // The freed slot is handed out first, at the same address, while the stale proxy keeps failing on the generation
+        AssetProxy reused = manager.CreateAsset<TextureAsset>();
+        WARP_TEST_CHECK(reused.Index == stale.Index);
+        WARP_TEST_CHECK(reused.Generation != stale.Generation);
+        WARP_TEST_CHECK(reused.ID != stale.ID);
+        WARP_TEST_CHECK(manager.GetAs<TextureAsset>(reused) == firstAsset);
+        WARP_TEST_CHECK(manager.GetAs<TextureAsset>(stale) == nullptr);
+        WARP_TEST_CHECK(manager.GetAssetProxy(reused.ID).Generation == reused.Generation);
+        WARP_TEST_CHECK(manager.IsValid<TextureAsset>(second));
+
+        reused = manager.DestroyAsset(reused);
+        second = manager.DestroyAsset(second);
+    }
+
+    WARP_TEST(AssetRegistry_FreeListIsLastInFirstOut)
+    {
+        AssetManager manager;
+        std::vector<AssetProxy> proxies;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            proxies.push_back(manager.CreateAsset<MaterialAsset>());
+        }
+
+        uint32_t firstIndex = proxies[2].Index;
+        uint32_t secondIndex = proxies[5].Index;
+        proxies[2] = manager.DestroyAsset(proxies[2]);
+        proxies[5] = manager.DestroyAsset(proxies[5]);
+
+        proxies[5] = manager.CreateAsset<MaterialAsset>();
+        proxies[2] = manager.CreateAsset<MaterialAsset>();
+        WARP_TEST_CHECK(proxies[5].Index == secondIndex);
+        WARP_TEST_CHECK(proxies[2].Index == firstIndex);
+
+        // Nothing was freed anymore, thus slots past the used ones are handed out
+        AssetProxy next = manager.CreateAsset<MaterialAsset>();
+        WARP_TEST_CHECK(next.Index == 8);
+        proxies.push_back(next);
+
+        for (AssetProxy& proxy : proxies)
+        {
+            WARP_TEST_CHECK(manager.IsValid<MaterialAsset>(proxy));
+            proxy = manager.DestroyAsset(proxy);
+        }
+    }
+
+    WARP_TEST(AssetRegistry_AssetsKeepAddressesWhileRegistryGrows)
+    {
+        static constexpr uint32_t NumAssets = 1000;
+        static constexpr uint32_t NumAssetsPerChunk = 64; // Same as in AssetManager::Registry
+
+        AssetManager manager;
+        std::vector<AssetProxy> proxies;
+        std::vector<MaterialAsset*> assets;
+        for (uint32_t i = 0; i < NumAssets; ++i)
+        {
+            proxies.push_back(manager.CreateAsset<MaterialAsset>());
+            assets.push_back(manager.GetAs<MaterialAsset>(proxies.back()));
+            assets.back()->Albedo.x = static_cast<float>(i);
+        }
+
+        for (uint32_t i = 0; i < NumAssets; ++i)
+        {
+            WARP_TEST_CHECK(manager.GetAs<MaterialAsset>(proxies[i]) == assets[i]);
+            WARP_TEST_CHECK(assets[i]->Albedo.x == static_cast<float>(i));
+
+            // Assets created one after another within a chunk are next to each other
+            if (i % NumAssetsPerChunk != 0)
+            {
+                WARP_TEST_CHECK(assets[i] == assets[i - 1] + 1);
+            }
+        }
+
+        for (AssetProxy& proxy : proxies)
+        {
+            proxy = manager.DestroyAsset(proxy);
+        }
+    }
+
+    WARP_TEST(AssetRegistry_GrowsPastTheFirstChunkTable)
+    {
+        static constexpr uint32_t NumAssetsPerTable = 64 * 16384; // Same as in AssetManager::Registry
+        static constexpr uint32_t NumAssets = NumAssetsPerTable + 1;
+
+        AssetManager manager;
+        std::vector<AssetProxy> proxies(NumAssets);
+        for (AssetProxy& proxy : proxies)
+        {
+            proxy = manager.CreateAsset<MaterialAsset>();
+        }
+
+        // The last asset lives in a chunk of the second table
+        WARP_TEST_CHECK(proxies.back().Index == NumAssetsPerTable);
+        MaterialAsset* last = manager.GetAs<MaterialAsset>(proxies.back());
+        WARP_TEST_CHECK(last != nullptr);
+
+        uint32_t numInvalid = 0;
+        for (AssetProxy& proxy : proxies)
+        {
+            numInvalid += manager.IsValid<MaterialAsset>(proxy) ? 0 : 1;
+            proxy = manager.DestroyAsset(proxy);
+        }
+        WARP_TEST_CHECK(numInvalid == 0);
+
+        // Slots of the second table are reused just like the others
+        AssetProxy reused = manager.CreateAsset<MaterialAsset>();
+        WARP_TEST_CHECK(reused.Index == NumAssetsPerTable);
+        WARP_TEST_CHECK(manager.GetAs<MaterialAsset>(reused) == last);
+        reused = manager.DestroyAsset(reused);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "Test.h"
+#include "GltfTestFiles.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../src/Assets/AssetManager.h"
+#include "../src/Assets/DerivedDataCache.h"
+#include "../src/Assets/Importers/MeshImporter.h"
+#include "../src/Assets/Importers/Formats/WMeshFormat.h"
+
+namespace Warp
+{
+
+    // Writes the test mesh with its buffer next to it and returns the path of the .gltf
+    static std::string WriteGltfTestFiles(const Test::ScopedTestFolder& folder, const char* name)
+    {
+        const std::vector<std::byte> buffer = Test::MakeGltfTestBuffer();
+        const std::filesystem::path filepath = folder / name;
+        std::filesystem::create_directories(filepath.parent_path());
+        Test::WriteFileBytes(filepath.parent_path() / "Grids.bin", buffer);
+        Test::WriteTextFile(filepath, Test::MakeGltfTestJson("Grids.bin", buffer.size()));
+        return filepath.string();
+    }
+
+    static std::vector<std::filesystem::path> GetCachedMeshes(const Test::ScopedTestFolder& folder)
+    {
+        std::vector<std::filesystem::path> entries;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(folder / "DDC/Mesh"))
+        {
+            if (entry.path().extension() == ".wmesh")
+            {
+                entries.push_back(entry.path());
+            }
+        }
+        return entries;
+    }
+
+    // A manager per import, as meshes are registered under their filepath. Returns false if the import failed
+    static bool ImportCached(DerivedDataCache& cache, const std::string& filepath, const StaticMeshImportDesc& desc, const MeshAsset* expected = nullptr)
+    {
+        AssetManager manager;
+        MeshImporter importer(&manager, &cache);
+        AssetProxy proxy = importer.ImportStaticMeshFromFile(filepath, desc);
+        if (!manager.IsValid<MeshAsset>(proxy))
+        {
+            return false;
+        }
+
+        if (expected)
+        {
+            Test::CheckMeshesMatch(*expected, *manager.GetAs<MeshAsset>(proxy));
+        }
+        proxy = manager.DestroyAsset(proxy);
+        return true;
+    }
+
+    WARP_TEST(DerivedDataCache_MissCooksEntryAndHitLoadsTheSameMesh)
+    {
+        Test::ScopedTestFolder folder("DerivedDataCache_HitMiss");
+        const std::string filepath = WriteGltfTestFiles(folder, "Grids.gltf");
+
+        // Reference import without the cache
+        AssetManager manager;
+        MeshImporter importer(&manager);
+        AssetProxy proxy = importer.ImportStaticMeshFromFile(filepath);
+        WARP_TEST_CHECK(manager.IsValid<MeshAsset>(proxy));
+        if (!manager.IsValid<MeshAsset>(proxy))
+        {
+            return;
+        }
+        const MeshAsset& expected = *manager.GetAs<MeshAsset>(proxy);
+
+        DerivedDataCache cache(folder / "DDC");
+        WARP_TEST_CHECK(cache.IsEnabled());
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc(), &expected));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumMisses == 1 && cache.GetStats(eDerivedDataType_Mesh).NumHits == 0);
+        WARP_TEST_CHECK(GetCachedMeshes(folder).size() == 1);
+
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc(), &expected));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumMisses == 1 && cache.GetStats(eDerivedDataType_Mesh).NumHits == 1);
+
+        // Settings that affect cooked data miss, the ones that do not still hit
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc{ .NumWorkerThreads = 1, .ReportStatistics = true }, &expected));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumHits == 2);
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc{ .MaxNumLods = 1 }));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumMisses == 2 && GetCachedMeshes(folder).size() == 2);
+
+        proxy = manager.DestroyAsset(proxy);
+    }
+
+    WARP_TEST(DerivedDataCache_HitDoesNotReadBuffersNorDependOnLocation)
+    {
+        Test::ScopedTestFolder folder("DerivedDataCache_Key");
+        const std::string filepath = WriteGltfTestFiles(folder, "Grids.gltf");
+
+        DerivedDataCache cache(folder / "DDC");
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumMisses == 1);
+
+        // A copy in another folder shares the entry, the key has no path in it
+        const std::filesystem::path copyFolder = folder / "Copy";
+        std::filesystem::create_directories(copyFolder);
+        std::filesystem::copy_file(filepath, copyFolder / "Grids.gltf");
+        std::filesystem::copy_file(folder / "Grids.bin", copyFolder / "Grids.bin");
+        std::filesystem::last_write_time(copyFolder / "Grids.bin", std::filesystem::last_write_time(folder / "Grids.bin"));
+        WARP_TEST_CHECK(ImportCached(cache, (copyFolder / "Grids.gltf").string(), StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumHits == 1);
+
+        // Buffer of the same size and time stamp is not read on a hit, thus its garbage does not matter
+        const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(folder / "Grids.bin");
+        Test::WriteFileBytes(folder / "Grids.bin", std::vector<std::byte>(Test::MakeGltfTestBuffer().size(), std::byte(0xCD)));
+        std::filesystem::last_write_time(folder / "Grids.bin", lastWriteTime);
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumHits == 2);
+
+        // Once the buffer is written again, its time stamp changes and the mesh is imported from the source
+        Test::WriteFileBytes(folder / "Grids.bin", Test::MakeGltfTestBuffer());
+        std::filesystem::last_write_time(folder / "Grids.bin", lastWriteTime + std::chrono::seconds(1));
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumMisses == 2);
+    }
+
+    WARP_TEST(DerivedDataCache_CorruptedEntryIsCookedAgain)
+    {
+        Test::ScopedTestFolder folder("DerivedDataCache_Corrupted");
+        const std::string filepath = WriteGltfTestFiles(folder, "Grids.gltf");
+
+        DerivedDataCache cache(folder / "DDC");
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        std::vector<std::filesystem::path> entries = GetCachedMeshes(folder);
+        WARP_TEST_CHECK(entries.size() == 1);
+        if (entries.size() != 1)
+        {
+            return;
+        }
+
+        // Garbage in place of the entry falls back to the source, which overwrites the entry
+        std::vector<std::byte> cooked = Test::ReadFileBytes(entries[0]);
+        Test::WriteFileBytes(entries[0], std::vector<std::byte>(cooked.size(), std::byte(0xCD)));
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumMisses == 2 && cache.GetStats(eDerivedDataType_Mesh).NumHits == 0);
+
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumHits == 1 && Test::ReadFileBytes(entries[0]).size() == cooked.size());
+    }
+
+    WARP_TEST(DerivedDataCache_EntryOfOtherVersionIsCookedAgain)
+    {
+        Test::ScopedTestFolder folder("DerivedDataCache_Version");
+        const std::string filepath = WriteGltfTestFiles(folder, "Grids.gltf");
+
+        DerivedDataCache cache(folder / "DDC");
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        std::vector<std::filesystem::path> entries = GetCachedMeshes(folder);
+        WARP_TEST_CHECK(entries.size() == 1);
+        if (entries.size() != 1)
+        {
+            return;
+        }
+
+        // Entries of another format version are rejected by the loader, even if the key were to collide
+        std::vector<std::byte> outdated = Test::ReadFileBytes(entries[0]);
+        const uint32_t otherVersion = WMesh::Version + 1;
+        std::memcpy(outdated.data() + offsetof(WMesh::FileHeader, Version), &otherVersion, sizeof(otherVersion));
+        Test::WriteFileBytes(entries[0], outdated);
+
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumMisses == 2 && cache.GetStats(eDerivedDataType_Mesh).NumHits == 0);
+
+        WARP_TEST_CHECK(ImportCached(cache, filepath, StaticMeshImportDesc()));
+        WARP_TEST_CHECK(cache.GetStats(eDerivedDataType_Mesh).NumHits == 1);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "Test.h"
+
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include <cgltf.h>
+
+#include "../src/Assets/Importers/Formats/GltfAccessor.h"
+
+namespace Warp
+{
+
+    // A buffer and views into it, as cgltf would have loaded them. Accessors under test point into the views, thus it is not movable
+    struct AccessorTestBuffer
+    {
+        explicit AccessorTestBuffer(std::vector<std::byte> bytes)
+            : Bytes(std::move(bytes))
+        {
+            Buffer.size = Bytes.size();
+            Buffer.data = Bytes.data();
+        }
+
+        AccessorTestBuffer(const AccessorTestBuffer&) = delete;
+        AccessorTestBuffer& operator=(const AccessorTestBuffer&) = delete;
+
+        cgltf_buffer_view* AddView(size_t offset, size_t size)
+        {
+            cgltf_buffer_view& view = Views.emplace_back();
+            view.buffer = &Buffer;
+            view.offset = offset;
+            view.size = size;
+            return &view;
+        }
+
+        std::vector<std::byte> Bytes;
+        cgltf_buffer Buffer{};
+        std::deque<cgltf_buffer_view> Views;
+    };
+
+    template<typename T>
+    static std::vector<std::byte> ToBytes(const std::vector<T>& values)
+    {
+        std::vector<std::byte> bytes(values.size() * sizeof(T));
+        std::memcpy(bytes.data(), values.data(), bytes.size());
+        return bytes;
+    }
+
+    static cgltf_accessor MakeAccessor(cgltf_buffer_view* view, cgltf_type type, cgltf_component_type componentType, size_t count, size_t offset, size_t stride)
+    {
+        cgltf_accessor accessor{};
+        accessor.buffer_view = view;
+        accessor.type = type;
+        accessor.component_type = componentType;
+        accessor.count = count;
+        accessor.offset = offset;
+        accessor.stride = stride;
+        return accessor;
+    }
+
+    static void MakeSparse(cgltf_accessor& accessor, size_t count, cgltf_buffer_view* indices, cgltf_component_type indexType, cgltf_buffer_view* values)
+    {
+        accessor.is_sparse = true;
+        accessor.sparse.count = count;
+        accessor.sparse.indices_buffer_view = indices;
+        accessor.sparse.indices_component_type = indexType;
+        accessor.sparse.values_buffer_view = values;
+    }
+
+    WARP_TEST(GltfAccessor_StridedFloatsAreDeinterleaved)
+    {
+        static constexpr size_t NumVertices = 7;
+        static constexpr float Guard = -123.0f;
+
+        // Interleaved vertices of 20 floats behind a 4 byte header: float3, float2, float4 and padding
+        // Element i of component c holds i * 100 + c, so that every misplaced float shows up
+        static constexpr size_t Stride = 20 * sizeof(float);
+        std::vector<float> vertices(1 + NumVertices * 20, 0.0f);
+        for (size_t i = 0; i < NumVertices; ++i)
+        {
+            for (size_t c = 0; c < 9; ++c)
+            {
+                vertices[1 + i * 20 + c] = static_cast<float>(i * 100 + c);
+            }
+        }
+        AccessorTestBuffer buffer(ToBytes(vertices));
+        cgltf_buffer_view* view = buffer.AddView(sizeof(float), NumVertices * Stride);
+
+        struct Case
+        {
+            cgltf_type Type;
+            uint32_t NumComponents;
+            size_t FirstComponent;
+        };
+        const Case cases[] = {
+            Case{ .Type = cgltf_type_vec3, .NumComponents = 3, .FirstComponent = 0 },
+            Case{ .Type = cgltf_type_vec2, .NumComponents = 2, .FirstComponent = 3 },
+            Case{ .Type = cgltf_type_vec4, .NumComponents = 4, .FirstComponent = 5 },
+        };
+
+        for (const Case& c : cases)
+        {
+            cgltf_accessor accessor = MakeAccessor(view, c.Type, cgltf_component_type_r_32f, NumVertices, c.FirstComponent * sizeof(float), Stride);
+
+            // dest is followed by guard values, SSE moves must not write past it
+            std::vector<float> dest(NumVertices * c.NumComponents + 4, Guard);
+            WARP_TEST_CHECK(GltfImporter::ReadAccessorFloats(&accessor, c.NumComponents, std::span<float>(dest.data(), NumVertices * c.NumComponents)));
+            for (size_t i = 0; i < NumVertices; ++i)
+            {
+                for (size_t component = 0; component < c.NumComponents; ++component)
+                {
+                    WARP_TEST_CHECK(dest[i * c.NumComponents + component] == static_cast<float>(i * 100 + c.FirstComponent + component));
+                }
+            }
+            for (size_t i = NumVertices * c.NumComponents; i < dest.size(); ++i)
+            {
+                WARP_TEST_CHECK(dest[i] == Guard);
+            }
+        }
+
+        // Too few components requested, or a stride that runs past the view
+        cgltf_accessor accessor = MakeAccessor(view, cgltf_type_vec3, cgltf_component_type_r_32f, NumVertices, 0, Stride * 2);
+        std::vector<float> dest(NumVertices * 3);
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorFloats(&accessor, 2, dest));
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorFloats(&accessor, 3, dest));
+    }
+
+    WARP_TEST(GltfAccessor_LastFloat3EndingAtBufferEndIsNotOverRead)
+    {
+        static constexpr size_t NumVertices = 5;
+
+        // float3 at offset 4 of every 16 byte vertex, thus the last one ends exactly at the end of the allocation
+        // A 16 byte load of the last element would read past it, which sanitizers report
+        std::vector<float> vertices(NumVertices * 4, 0.0f);
+        for (size_t i = 0; i < NumVertices; ++i)
+        {
+            vertices[i * 4 + 1] = static_cast<float>(i);
+            vertices[i * 4 + 2] = static_cast<float>(i) + 0.25f;
+            vertices[i * 4 + 3] = static_cast<float>(i) + 0.5f;
+        }
+        AccessorTestBuffer buffer(ToBytes(vertices));
+        cgltf_buffer_view* view = buffer.AddView(0, buffer.Bytes.size());
+        cgltf_accessor accessor = MakeAccessor(view, cgltf_type_vec3, cgltf_component_type_r_32f, NumVertices, sizeof(float), 4 * sizeof(float));
+
+        std::vector<float> dest(NumVertices * 3);
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorFloats(&accessor, 3, dest));
+        for (size_t i = 0; i < NumVertices; ++i)
+        {
+            WARP_TEST_CHECK(dest[i * 3] == static_cast<float>(i) && dest[i * 3 + 1] == static_cast<float>(i) + 0.25f && dest[i * 3 + 2] == static_cast<float>(i) + 0.5f);
+        }
+
+        // One more element would not fit into the view
+        accessor.count = NumVertices + 1;
+        dest.resize(accessor.count * 3);
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorFloats(&accessor, 3, dest));
+    }
+
+    WARP_TEST(GltfAccessor_NormalizedIntegersAreConvertedToFloats)
+    {
+        // Unsigned byte texture coordinates padded to 4 bytes, and signed short normals padded to 8 bytes (KHR_mesh_quantization)
+        const std::vector<uint8_t> uvs = { 0, 255, 7, 7, 51, 102, 7, 7, 255, 0, 7, 7 };
+        const std::vector<int16_t> normals = { 0, 32767, -32767, 7, -32768, 0, 16384, 7 };
+
+        std::vector<std::byte> bytes = ToBytes(uvs);
+        std::vector<std::byte> normalBytes = ToBytes(normals);
+        bytes.insert(bytes.end(), normalBytes.begin(), normalBytes.end());
+        AccessorTestBuffer buffer(std::move(bytes));
+        cgltf_buffer_view* uvView = buffer.AddView(0, uvs.size());
+        cgltf_buffer_view* normalView = buffer.AddView(uvs.size(), normals.size() * sizeof(int16_t));
+
+        cgltf_accessor uvAccessor = MakeAccessor(uvView, cgltf_type_vec2, cgltf_component_type_r_8u, 3, 0, 4);
+        uvAccessor.normalized = true;
+        std::vector<float> uvDest(6);
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorFloats(&uvAccessor, 2, uvDest));
+        const float expectedUvs[] = { 0.0f, 1.0f, 0.2f, 0.4f, 1.0f, 0.0f };
+        for (size_t i = 0; i < uvDest.size(); ++i)
+        {
+            WARP_TEST_CHECK(Test::IsNear(uvDest[i], expectedUvs[i], 1e-6));
+        }
+
+        // -32768 clamps to -1 as the spec requires
+        cgltf_accessor normalAccessor = MakeAccessor(normalView, cgltf_type_vec3, cgltf_component_type_r_16, 2, 0, 8);
+        normalAccessor.normalized = true;
+        std::vector<float> normalDest(6);
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorFloats(&normalAccessor, 3, normalDest));
+        const float expectedNormals[] = { 0.0f, 1.0f, -1.0f, -1.0f, 0.0f, 16384.0f / 32767.0f };
+        for (size_t i = 0; i < normalDest.size(); ++i)
+        {
+            WARP_TEST_CHECK(Test::IsNear(normalDest[i], expectedNormals[i], 1e-6));
+        }
+    }
+
+    WARP_TEST(GltfAccessor_SparseValuesReplaceElements)
+    {
+        // Base positions, then sparse indices (unsigned bytes, padded to 4) and sparse values
+        std::vector<float> positions(4 * 3);
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            positions[i] = static_cast<float>(i);
+        }
+        const std::vector<uint8_t> sparseIndices = { 3, 1, 0, 0 };
+        const std::vector<float> sparseValues = { -1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f };
+
+        std::vector<std::byte> bytes = ToBytes(positions);
+        std::vector<std::byte> indexBytes = ToBytes(sparseIndices);
+        std::vector<std::byte> valueBytes = ToBytes(sparseValues);
+        bytes.insert(bytes.end(), indexBytes.begin(), indexBytes.end());
+        bytes.insert(bytes.end(), valueBytes.begin(), valueBytes.end());
+        AccessorTestBuffer buffer(std::move(bytes));
+        cgltf_buffer_view* baseView = buffer.AddView(0, positions.size() * sizeof(float));
+        cgltf_buffer_view* indicesView = buffer.AddView(baseView->size, 2);
+        cgltf_buffer_view* valuesView = buffer.AddView(baseView->size + sparseIndices.size(), sparseValues.size() * sizeof(float));
+
+        cgltf_accessor accessor = MakeAccessor(baseView, cgltf_type_vec3, cgltf_component_type_r_32f, 4, 0, 3 * sizeof(float));
+        MakeSparse(accessor, 2, indicesView, cgltf_component_type_r_8u, valuesView);
+
+        std::vector<float> dest(4 * 3);
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorFloats(&accessor, 3, dest));
+        const float expected[] = { 0.0f, 1.0f, 2.0f, -4.0f, -5.0f, -6.0f, 6.0f, 7.0f, 8.0f, -1.0f, -2.0f, -3.0f };
+        for (size_t i = 0; i < dest.size(); ++i)
+        {
+            WARP_TEST_CHECK(dest[i] == expected[i]);
+        }
+
+        // Without a buffer view, elements that are not replaced are zeros
+        accessor.buffer_view = nullptr;
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorFloats(&accessor, 3, dest));
+        const float expectedWithoutView[] = { 0.0f, 0.0f, 0.0f, -4.0f, -5.0f, -6.0f, 0.0f, 0.0f, 0.0f, -1.0f, -2.0f, -3.0f };
+        for (size_t i = 0; i < dest.size(); ++i)
+        {
+            WARP_TEST_CHECK(dest[i] == expectedWithoutView[i]);
+        }
+
+        // A sparse index past the last element, and sparse values that run past their view
+        buffer.Bytes[baseView->size] = std::byte(4);
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorFloats(&accessor, 3, dest));
+        buffer.Bytes[baseView->size] = std::byte(3);
+        accessor.sparse.count = 3;
+        indicesView->size = 3;
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorFloats(&accessor, 3, dest));
+    }
+
+    WARP_TEST(GltfAccessor_IndicesAreConvertedAndRangeChecked)
+    {
+        static constexpr uint32_t NumVertices = 10;
+
+        // Indices of every width. Bytes are strided to cover the conversion loop, 32-bit ones include a value that wraps to 3 when narrowed
+        const std::vector<uint8_t> byteIndices = { 0, 0xAA, 9, 0xAA, 4, 0xAA };
+        const std::vector<uint16_t> shortIndices = { 1, 2, 9 };
+        const std::vector<uint32_t> intIndices = { 7, 8, 0x10003 };
+
+        std::vector<std::byte> bytes = ToBytes(byteIndices);
+        std::vector<std::byte> shortBytes = ToBytes(shortIndices);
+        std::vector<std::byte> intBytes = ToBytes(intIndices);
+        bytes.insert(bytes.end(), shortBytes.begin(), shortBytes.end());
+        bytes.insert(bytes.end(), intBytes.begin(), intBytes.end());
+        bytes.insert(bytes.end(), { std::byte(2), std::byte(5), std::byte(NumVertices) }); // Sparse index and values
+        AccessorTestBuffer buffer(std::move(bytes));
+        cgltf_buffer_view* byteView = buffer.AddView(0, byteIndices.size());
+        cgltf_buffer_view* shortView = buffer.AddView(byteIndices.size(), shortBytes.size());
+        cgltf_buffer_view* intView = buffer.AddView(byteIndices.size() + shortBytes.size(), intBytes.size());
+
+        cgltf_accessor byteAccessor = MakeAccessor(byteView, cgltf_type_scalar, cgltf_component_type_r_8u, 3, 0, 2);
+        std::vector<uint16_t> dest16(3);
+        std::vector<uint32_t> dest32(3);
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorIndices(&byteAccessor, NumVertices, std::span<uint16_t>(dest16)));
+        WARP_TEST_CHECK(dest16 == std::vector<uint16_t>({ 0, 9, 4 }));
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorIndices(&byteAccessor, NumVertices, std::span<uint32_t>(dest32)));
+        WARP_TEST_CHECK(dest32 == std::vector<uint32_t>({ 0, 9, 4 }));
+
+        // Same width is copied as-is, the largest index is still checked
+        cgltf_accessor shortAccessor = MakeAccessor(shortView, cgltf_type_scalar, cgltf_component_type_r_16u, 3, 0, sizeof(uint16_t));
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorIndices(&shortAccessor, NumVertices, std::span<uint16_t>(dest16)));
+        WARP_TEST_CHECK(dest16 == shortIndices);
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorIndices(&shortAccessor, 9, std::span<uint16_t>(dest16)));
+
+        // Out of range indices fail instead of being narrowed or clamped
+        cgltf_accessor intAccessor = MakeAccessor(intView, cgltf_type_scalar, cgltf_component_type_r_32u, 3, 0, sizeof(uint32_t));
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorIndices(&intAccessor, NumVertices, std::span<uint16_t>(dest16)));
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorIndices(&intAccessor, NumVertices, std::span<uint32_t>(dest32)));
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorIndices(&intAccessor, 0x10004, std::span<uint32_t>(dest32)));
+        WARP_TEST_CHECK(dest32 == intIndices);
+
+        // Sparse substitution of the byte indices, element 2 becomes 5 and then 10, which is out of range
+        cgltf_buffer_view* sparseIndexView = buffer.AddView(buffer.Bytes.size() - 3, 1);
+        cgltf_buffer_view* sparseValueView = buffer.AddView(buffer.Bytes.size() - 2, 1);
+        MakeSparse(byteAccessor, 1, sparseIndexView, cgltf_component_type_r_8u, sparseValueView);
+        WARP_TEST_CHECK(GltfImporter::ReadAccessorIndices(&byteAccessor, NumVertices, std::span<uint16_t>(dest16)));
+        WARP_TEST_CHECK(dest16 == std::vector<uint16_t>({ 0, 9, 5 }));
+        sparseValueView->offset = buffer.Bytes.size() - 1;
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorIndices(&byteAccessor, NumVertices, std::span<uint32_t>(dest32)));
+
+        // Not an index accessor, or dest of the wrong size
+        cgltf_accessor floatAccessor = MakeAccessor(intView, cgltf_type_scalar, cgltf_component_type_r_32f, 3, 0, sizeof(float));
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorIndices(&floatAccessor, NumVertices, std::span<uint32_t>(dest32)));
+        WARP_TEST_CHECK(!GltfImporter::ReadAccessorIndices(&byteAccessor, NumVertices, std::span<uint32_t>(dest32.data(), 2)));
+    }
+
+}
\ No newline at end of file
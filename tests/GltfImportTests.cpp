@@ -0,0 +1,393 @@
+#include "Test.h"
+#include "GltfTestFiles.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../src/Assets/AssetManager.h"
+#include "../src/Assets/Importers/MeshImporter.h"
+#include "../src/Assets/Importers/Formats/WMeshFormat.h"
+
+namespace Warp
+{
+
+    static bool IsNearPoint(const Math::Vector3& a, const Math::Vector3& b)
+    {
+        return Test::IsNear(a.x, b.x, 1e-5) && Test::IsNear(a.y, b.y, 1e-5) && Test::IsNear(a.z, b.z, 1e-5);
+    }
+
+    WARP_TEST(GltfImport_MappedAndSpilledImportsMatchInMemoryImport)
+    {
+        Test::ScopedTestFolder folder("GltfImport_Streaming");
+        const std::vector<std::byte> buffer = Test::MakeGltfTestBuffer();
+
+        // The same geometry twice, in an external buffer that is mapped and in a data URI that cgltf decodes into memory
+        const std::filesystem::path binPath = folder / "Grids.bin";
+        const std::string mappedPath = (folder / "Mapped.gltf").string();
+        const std::string embeddedPath = (folder / "Embedded.gltf").string();
+        Test::WriteFileBytes(binPath, buffer);
+        Test::WriteTextFile(mappedPath, Test::MakeGltfTestJson("Grids.bin", buffer.size()));
+        Test::WriteTextFile(embeddedPath, Test::MakeGltfTestJson("data:application/octet-stream;base64," + Test::EncodeBase64(buffer), buffer.size()));
+
+        // A manager per import, as meshes are registered under their filepath
+        AssetManager embeddedManager;
+        MeshImporter embeddedImporter(&embeddedManager);
+        AssetProxy embeddedProxy = embeddedImporter.ImportStaticMeshFromFile(embeddedPath);
+        WARP_TEST_CHECK(embeddedManager.IsValid<MeshAsset>(embeddedProxy));
+        if (!embeddedManager.IsValid<MeshAsset>(embeddedProxy))
+        {
+            return;
+        }
+
+        const MeshAsset& expected = *embeddedManager.GetAs<MeshAsset>(embeddedProxy);
+        WARP_TEST_CHECK(expected.GetNumSubmeshes() == Test::GltfTestNumPrimitives);
+        for (const Submesh& submesh : expected.Submeshes)
+        {
+            WARP_TEST_CHECK(submesh.GetNumVertices() == Test::GltfTestNumVertices && submesh.Lods.front().NumTriangles == Test::GltfTestNumIndices / 3);
+        }
+
+        // Spilling a batch of one submesh at a time goes through the temporary file for every submesh
+        const StaticMeshImportDesc descs[] = {
+            StaticMeshImportDesc(),
+            StaticMeshImportDesc{ .NumWorkerThreads = 1, .LowMemoryImport = true },
+            StaticMeshImportDesc{ .LowMemoryImport = true },
+        };
+
+        for (const StaticMeshImportDesc& desc : descs)
+        {
+            AssetManager manager;
+            MeshImporter importer(&manager);
+            AssetProxy proxy = importer.ImportStaticMeshFromFile(mappedPath, desc);
+            WARP_TEST_CHECK(manager.IsValid<MeshAsset>(proxy));
+            if (manager.IsValid<MeshAsset>(proxy))
+            {
+                Test::CheckMeshesMatch(expected, *manager.GetAs<MeshAsset>(proxy));
+                proxy = manager.DestroyAsset(proxy);
+            }
+
+            // Mappings of the buffer are released once the import is done, thus the file can be replaced right away
+            std::ofstream binFile(binPath, std::ios::binary | std::ios::trunc);
+            WARP_TEST_CHECK(binFile.is_open());
+            binFile.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        embeddedProxy = embeddedManager.DestroyAsset(embeddedProxy);
+    }
+
+    WARP_TEST(GltfImport_GlbWithEmbeddedBufferMatchesGltf)
+    {
+        Test::ScopedTestFolder folder("GltfImport_Glb");
+        const std::vector<std::byte> buffer = Test::MakeGltfTestBuffer();
+
+        // The same geometry in a .gltf with an external buffer, and in a .glb that has no file next to it. Its buffer is the binary chunk
+        const std::string gltfPath = (folder / "Grids.gltf").string();
+        const std::string glbPath = (folder / "Glb/Grids.glb").string();
+        Test::WriteFileBytes(folder / "Grids.bin", buffer);
+        Test::WriteTextFile(gltfPath, Test::MakeGltfTestJson("Grids.bin", buffer.size()));
+        std::filesystem::create_directories(folder / "Glb");
+        const std::vector<std::byte> glb = Test::MakeGlb(Test::MakeGltfTestJson("", buffer.size()), buffer);
+        Test::WriteFileBytes(glbPath, glb);
+
+        AssetManager gltfManager;
+        MeshImporter gltfImporter(&gltfManager);
+        AssetProxy gltfProxy = gltfImporter.ImportStaticMeshFromFile(gltfPath);
+        WARP_TEST_CHECK(gltfManager.IsValid<MeshAsset>(gltfProxy));
+        if (!gltfManager.IsValid<MeshAsset>(gltfProxy))
+        {
+            return;
+        }
+        const MeshAsset& expected = *gltfManager.GetAs<MeshAsset>(gltfProxy);
+
+        for (const StaticMeshImportDesc& desc : { StaticMeshImportDesc(), StaticMeshImportDesc{ .LowMemoryImport = true } })
+        {
+            AssetManager manager;
+            MeshImporter importer(&manager);
+            AssetProxy proxy = importer.ImportStaticMeshFromFile(glbPath, desc);
+            WARP_TEST_CHECK(manager.IsValid<MeshAsset>(proxy));
+            if (manager.IsValid<MeshAsset>(proxy))
+            {
+                Test::CheckMeshesMatch(expected, *manager.GetAs<MeshAsset>(proxy));
+                proxy = manager.DestroyAsset(proxy);
+            }
+        }
+
+        // A file cut off inside of its binary chunk fails to import instead of reading past the mapping
+        const std::string truncatedPath = (folder / "Glb/Truncated.glb").string();
+        Test::WriteFileBytes(truncatedPath, std::vector<std::byte>(glb.begin(), glb.end() - Test::GltfTestNumIndices));
+        AssetManager manager;
+        MeshImporter importer(&manager);
+        AssetProxy proxy = importer.ImportStaticMeshFromFile(truncatedPath);
+        WARP_TEST_CHECK(!manager.IsValid<MeshAsset>(proxy));
+
+        gltfProxy = gltfManager.DestroyAsset(gltfProxy);
+    }
+
+    WARP_TEST(GltfImport_SceneKeepsHierarchyAndSharesMeshes)
+    {
+        Test::ScopedTestFolder folder("GltfImport_Scene");
+        const std::vector<std::byte> buffer = Test::MakeGltfTestBuffer();
+
+        // Root only groups and scales, B is an instance of the same mesh as A and parents C
+        const std::string nodes = "["
+            "{\"name\":\"Root\",\"children\":[1,2],\"translation\":[1,0,0],\"scale\":[2,2,2]},"
+            "{\"name\":\"A\",\"mesh\":0,\"translation\":[0,1,0]},"
+            "{\"name\":\"B\",\"mesh\":0,\"children\":[3]},"
+            "{\"mesh\":0,\"translation\":[0,0,1]}]";
+
+        const std::string filepath = (folder / "Scene.gltf").string();
+        Test::WriteFileBytes(folder / "Grids.bin", buffer);
+        Test::WriteTextFile(filepath, Test::MakeGltfTestJson("Grids.bin", buffer.size(), nodes));
+
+        AssetManager manager;
+        MeshImporter importer(&manager);
+        StaticMeshScene scene = importer.ImportStaticMeshSceneFromFile(filepath);
+        WARP_TEST_CHECK(scene.Nodes.size() == 4);
+        if (scene.Nodes.size() != 4)
+        {
+            return;
+        }
+
+        // Parents come first, transforms stay local and every instance refers to the one imported mesh
+        const uint32_t expectedParents[] = { StaticMeshSceneNode::InvalidIndex, 0, 0, 2 };
+        const Math::Vector3 expectedOrigins[] = { Math::Vector3(1.0f, 0.0f, 0.0f), Math::Vector3(0.0f, 1.0f, 0.0f), Math::Vector3(0.0f), Math::Vector3(0.0f, 0.0f, 1.0f) };
+        for (size_t nodeIndex = 0; nodeIndex < scene.Nodes.size(); ++nodeIndex)
+        {
+            const StaticMeshSceneNode& node = scene.Nodes[nodeIndex];
+            WARP_TEST_CHECK(node.ParentIndex == expectedParents[nodeIndex]);
+            WARP_TEST_CHECK(IsNearPoint(node.LocalToParent.Translation(), expectedOrigins[nodeIndex]));
+            WARP_TEST_CHECK(nodeIndex == 0 ? !node.Mesh.IsValid() : node.Mesh.ID == scene.Nodes[1].Mesh.ID);
+        }
+        WARP_TEST_CHECK(manager.IsValid<MeshAsset>(scene.Nodes[1].Mesh));
+        WARP_TEST_CHECK(scene.Nodes[0].Name == "Root" && scene.Nodes[1].Name == "A" && scene.Nodes[2].Name == "B" && !scene.Nodes[3].Name.empty());
+
+        // Instances flatten the hierarchy, C is offset by its parents and scaled by the root
+        std::vector<StaticMeshInstance> instances = importer.ImportStaticMeshInstancesFromFile(filepath);
+        WARP_TEST_CHECK(instances.size() == 3);
+        if (instances.size() == 3)
+        {
+            WARP_TEST_CHECK(instances[0].Mesh.ID == scene.Nodes[1].Mesh.ID && instances[2].Mesh.ID == scene.Nodes[1].Mesh.ID);
+            WARP_TEST_CHECK(IsNearPoint(instances[0].InstanceToScene.Translation(), Math::Vector3(1.0f, 2.0f, 0.0f)));
+            WARP_TEST_CHECK(IsNearPoint(instances[1].InstanceToScene.Translation(), Math::Vector3(1.0f, 0.0f, 0.0f)));
+            WARP_TEST_CHECK(IsNearPoint(instances[2].InstanceToScene.Translation(), Math::Vector3(1.0f, 0.0f, 2.0f)));
+        }
+
+        scene.Nodes[1].Mesh = manager.DestroyAsset(scene.Nodes[1].Mesh);
+    }
+
+    WARP_TEST(GltfImport_CookedMeshMatchesImportedMesh)
+    {
+        Test::ScopedTestFolder folder("GltfImport_Cook");
+        const std::vector<std::byte> buffer = Test::MakeGltfTestBuffer();
+
+        const std::string filepath = (folder / "Grids.gltf").string();
+        const std::string cookedPath = (folder / "Grids.wmesh").string();
+        Test::WriteFileBytes(folder / "Grids.bin", buffer);
+        Test::WriteTextFile(filepath, Test::MakeGltfTestJson("Grids.bin", buffer.size()));
+
+        AssetManager manager;
+        MeshImporter importer(&manager);
+        AssetProxy proxy = importer.ImportStaticMeshFromFile(filepath, StaticMeshImportDesc{ .QuantizeVertices = true });
+        WARP_TEST_CHECK(manager.IsValid<MeshAsset>(proxy));
+        if (!manager.IsValid<MeshAsset>(proxy))
+        {
+            return;
+        }
+        WARP_TEST_CHECK(importer.CookStaticMesh(proxy, cookedPath));
+
+        // Cooked mesh is mapped as-is, every stream and every level should come back unchanged
+        AssetManager cookedManager;
+        MeshImporter cookedImporter(&cookedManager);
+        AssetProxy cookedProxy = cookedImporter.ImportStaticMeshFromFile(cookedPath);
+        WARP_TEST_CHECK(cookedManager.IsValid<MeshAsset>(cookedProxy));
+        if (cookedManager.IsValid<MeshAsset>(cookedProxy))
+        {
+            const MeshAsset& cooked = *cookedManager.GetAs<MeshAsset>(cookedProxy);
+            const MeshAsset& expected = *manager.GetAs<MeshAsset>(proxy);
+            Test::CheckMeshesMatch(expected, cooked);
+            for (uint32_t submeshIndex = 0; submeshIndex < std::min(cooked.GetNumSubmeshes(), expected.GetNumSubmeshes()); ++submeshIndex)
+            {
+                const Submesh& a = expected.Submeshes[submeshIndex];
+                const Submesh& b = cooked.Submeshes[submeshIndex];
+                WARP_TEST_CHECK(b.HasQuantizedAttributes() && IsNearPoint(a.PositionsMin, b.PositionsMin) && IsNearPoint(a.PositionsExtent, b.PositionsExtent));
+            }
+            cookedProxy = cookedManager.DestroyAsset(cookedProxy);
+        }
+
+        proxy = manager.DestroyAsset(proxy);
+    }
+
+    WARP_TEST(GltfImport_CorruptedCookedMeshIsRejected)
+    {
+        Test::ScopedTestFolder folder("GltfImport_CorruptedCook");
+        const std::vector<std::byte> buffer = Test::MakeGltfTestBuffer();
+
+        const std::string filepath = (folder / "Grids.gltf").string();
+        const std::filesystem::path cookedPath = folder / "Grids.wmesh";
+        Test::WriteFileBytes(folder / "Grids.bin", buffer);
+        Test::WriteTextFile(filepath, Test::MakeGltfTestJson("Grids.bin", buffer.size()));
+
+        {
+            AssetManager manager;
+            MeshImporter importer(&manager);
+            AssetProxy proxy = importer.ImportStaticMeshFromFile(filepath);
+            WARP_TEST_CHECK(importer.CookStaticMesh(proxy, cookedPath.string()));
+            proxy = manager.DestroyAsset(proxy);
+        }
+
+        const std::vector<std::byte> cooked = Test::ReadFileBytes(cookedPath);
+        WARP_TEST_CHECK(cooked.size() > sizeof(WMesh::FileHeader));
+        if (cooked.size() <= sizeof(WMesh::FileHeader))
+        {
+            return;
+        }
+
+        WMesh::FileHeader header;
+        WMesh::SubmeshHeader submesh;
+        WMesh::LodHeader lod;
+        std::memcpy(&header, cooked.data(), sizeof(header));
+        std::memcpy(&submesh, cooked.data() + header.SubmeshTableOffset, sizeof(submesh));
+        std::memcpy(&lod, cooked.data() + header.LodTableOffset + submesh.FirstLod * sizeof(WMesh::LodHeader), sizeof(lod));
+
+        DirectX::Meshlet meshlet;
+        std::memcpy(&meshlet, cooked.data() + lod.Meshlets.Offset, sizeof(meshlet));
+
+        // Every corruption keeps the tables intact, only the indices that shaders read through are broken
+        const uint32_t outOfRangeVertex = submesh.NumVertices;
+        const DirectX::Meshlet outOfRangeMeshlets[] = {
+            DirectX::Meshlet{ .VertCount = meshlet.VertCount, .VertOffset = static_cast<uint32_t>(lod.UniqueVertexIndices.NumBytes), .PrimCount = meshlet.PrimCount, .PrimOffset = meshlet.PrimOffset },
+            DirectX::Meshlet{ .VertCount = meshlet.VertCount, .VertOffset = meshlet.VertOffset, .PrimCount = meshlet.PrimCount, .PrimOffset = uint32_t(-1) },
+            DirectX::Meshlet{ .VertCount = 0, .VertOffset = meshlet.VertOffset, .PrimCount = meshlet.PrimCount, .PrimOffset = meshlet.PrimOffset },
+        };
+
+        std::vector<std::vector<std::byte>> corrupted;
+        for (const DirectX::Meshlet& outOfRangeMeshlet : outOfRangeMeshlets)
+        {
+            std::vector<std::byte>& bytes = corrupted.emplace_back(cooked);
+            std::memcpy(bytes.data() + lod.Meshlets.Offset, &outOfRangeMeshlet, sizeof(outOfRangeMeshlet));
+        }
+
+        std::vector<std::byte>& badVertex = corrupted.emplace_back(cooked);
+        std::memcpy(badVertex.data() + lod.UniqueVertexIndices.Offset, &outOfRangeVertex, submesh.UniqueVertexIndexStride);
+
+        std::vector<std::byte>& truncated = corrupted.emplace_back(cooked);
+        truncated.resize(truncated.size() - WMesh::Alignment);
+
+        for (size_t i = 0; i < corrupted.size(); ++i)
+        {
+            const std::string corruptedPath = (folder / std::format("Corrupted{}.wmesh", i).c_str()).string();
+            Test::WriteFileBytes(corruptedPath, corrupted[i]);
+
+            AssetManager manager;
+            MeshImporter importer(&manager);
+            AssetProxy proxy = importer.ImportStaticMeshFromFile(corruptedPath);
+            WARP_TEST_CHECK(!manager.IsValid<MeshAsset>(proxy));
+        }
+
+        // The untouched file still loads
+        Test::WriteFileBytes(folder / "Intact.wmesh", cooked);
+        AssetManager manager;
+        MeshImporter importer(&manager);
+        AssetProxy proxy = importer.ImportStaticMeshFromFile((folder / "Intact.wmesh").string());
+        WARP_TEST_CHECK(manager.IsValid<MeshAsset>(proxy));
+        if (manager.IsValid<MeshAsset>(proxy))
+        {
+            proxy = manager.DestroyAsset(proxy);
+        }
+    }
+
+    // A strip of numVertices vertices two wide, indexed with 32-bit indices whatever the number of vertices
+    static void WriteStripGltfFiles(const Test::ScopedTestFolder& folder, const char* name, uint32_t numVertices)
+    {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        for (uint32_t i = 0; i < numVertices; ++i)
+        {
+            positions.insert(positions.end(), { static_cast<float>(i % 2), static_cast<float>(i / 2) * 0.01f, 0.0f });
+            normals.insert(normals.end(), { 0.0f, 0.0f, 1.0f });
+        }
+
+        // Every other triangle is flipped, so that the whole strip faces the same way
+        std::vector<uint32_t> indices;
+        for (uint32_t i = 0; i + 2 < numVertices; ++i)
+        {
+            indices.insert(indices.end(), { i % 2 == 0 ? i : i + 1, i % 2 == 0 ? i + 1 : i, i + 2 });
+        }
+
+        std::vector<std::byte> buffer;
+        Test::AppendBytes(buffer, positions);
+        Test::AppendBytes(buffer, normals);
+        Test::AppendBytes(buffer, indices);
+
+        const std::string binName = std::format("{}.bin", name);
+        Test::WriteFileBytes(folder / binName.c_str(), buffer);
+        Test::WriteTextFile(folder / std::format("{}.gltf", name).c_str(), std::format(
+            "{{\"asset\":{{\"version\":\"2.0\"}},\"scene\":0,\"scenes\":[{{\"nodes\":[0]}}],\"nodes\":[{{\"mesh\":0}}],"
+            "\"meshes\":[{{\"primitives\":[{{\"attributes\":{{\"POSITION\":0,\"NORMAL\":1}},\"indices\":2}}]}}],"
+            "\"buffers\":[{{\"byteLength\":{},\"uri\":\"{}\"}}],"
+            "\"bufferViews\":[{{\"buffer\":0,\"byteOffset\":0,\"byteLength\":{}}},{{\"buffer\":0,\"byteOffset\":{},\"byteLength\":{}}},{{\"buffer\":0,\"byteOffset\":{},\"byteLength\":{}}}],"
+            "\"accessors\":[{{\"bufferView\":0,\"componentType\":5126,\"count\":{},\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[1,{},0]}},"
+            "{{\"bufferView\":1,\"componentType\":5126,\"count\":{},\"type\":\"VEC3\"}},{{\"bufferView\":2,\"componentType\":5125,\"count\":{},\"type\":\"SCALAR\"}}]}}",
+            buffer.size(), binName,
+            positions.size() * sizeof(float), positions.size() * sizeof(float), normals.size() * sizeof(float),
+            (positions.size() + normals.size()) * sizeof(float), indices.size() * sizeof(uint32_t),
+            numVertices, static_cast<float>((numVertices - 1) / 2) * 0.01f, numVertices, indices.size()));
+    }
+
+    WARP_TEST(GltfImport_IndexWidthFollowsNumberOfVertices)
+    {
+        Test::ScopedTestFolder folder("GltfImport_IndexWidth");
+
+        // 0xFFFF is the unused index of DirectXMesh, which rejects 16-bit meshes of 65535 vertices or more
+        struct Case
+        {
+            const char* Name;
+            uint32_t NumVertices;
+            bool Is16Bit;
+        };
+        const Case cases[] = {
+            Case{ .Name = "Below", .NumVertices = 65534, .Is16Bit = true },
+            Case{ .Name = "Boundary", .NumVertices = 65535, .Is16Bit = false },
+            Case{ .Name = "Above", .NumVertices = 65536, .Is16Bit = false },
+        };
+
+        for (const Case& c : cases)
+        {
+            WriteStripGltfFiles(folder, c.Name, c.NumVertices);
+
+            AssetManager manager;
+            MeshImporter importer(&manager);
+            AssetProxy proxy = importer.ImportStaticMeshFromFile((folder / std::format("{}.gltf", c.Name).c_str()).string(), StaticMeshImportDesc{ .MaxNumLods = 1 });
+            WARP_TEST_CHECK(manager.IsValid<MeshAsset>(proxy));
+            if (!manager.IsValid<MeshAsset>(proxy))
+            {
+                continue;
+            }
+
+            const MeshAsset& mesh = *manager.GetAs<MeshAsset>(proxy);
+            WARP_TEST_CHECK(mesh.GetNumSubmeshes() == 1);
+            const Submesh& submesh = mesh.Submeshes.front();
+            WARP_TEST_CHECK(submesh.Has16BitUniqueVertexIndices() == c.Is16Bit);
+            WARP_TEST_CHECK(submesh.Lods.front().NumTriangles == c.NumVertices - 2);
+
+            // The strip keeps all of its vertices, thus the largest unique vertex index shows that none got truncated
+            const SubmeshLod& lod = submesh.Lods.front();
+            WARP_TEST_CHECK(lod.UniqueVertexIndices.size() % submesh.UniqueVertexIndexStride == 0);
+            uint32_t maxIndex = 0;
+            for (size_t offset = 0; offset < lod.UniqueVertexIndices.size(); offset += submesh.UniqueVertexIndexStride)
+            {
+                uint32_t index = 0;
+                std::memcpy(&index, lod.UniqueVertexIndices.data() + offset, submesh.UniqueVertexIndexStride);
+                maxIndex = std::max(maxIndex, index);
+            }
+            WARP_TEST_CHECK(submesh.GetNumVertices() == c.NumVertices && maxIndex == c.NumVertices - 1);
+
+            proxy = manager.DestroyAsset(proxy);
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+#include "../src/Assets/MeshAsset.h"
+
+// Generated glTF files and helpers shared by tests of the mesh importer and of the derived data cache
+namespace Warp::Test
+{
+
+    inline constexpr uint32_t GltfTestQuadsPerSide = 16;
+    inline constexpr uint32_t GltfTestNumVertices = (GltfTestQuadsPerSide + 1) * (GltfTestQuadsPerSide + 1);
+    inline constexpr uint32_t GltfTestNumIndices = GltfTestQuadsPerSide * GltfTestQuadsPerSide * 6;
+    inline constexpr uint32_t GltfTestNumPrimitives = 2;
+
+    template<typename T>
+    void AppendBytes(std::vector<std::byte>& bytes, const std::vector<T>& values)
+    {
+        size_t offset = bytes.size();
+        bytes.resize(offset + values.size() * sizeof(T));
+        std::memcpy(bytes.data() + offset, values.data(), values.size() * sizeof(T));
+    }
+
+    inline std::string EncodeBase64(std::span<const std::byte> bytes)
+    {
+        static constexpr char Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::string encoded;
+        for (size_t i = 0; i < bytes.size(); i += 3)
+        {
+            uint32_t word = uint32_t(bytes[i]) << 16;
+            word |= i + 1 < bytes.size() ? uint32_t(bytes[i + 1]) << 8 : 0;
+            word |= i + 2 < bytes.size() ? uint32_t(bytes[i + 2]) : 0;
+            encoded += Alphabet[(word >> 18) & 63];
+            encoded += Alphabet[(word >> 12) & 63];
+            encoded += i + 1 < bytes.size() ? Alphabet[(word >> 6) & 63] : '=';
+            encoded += i + 2 < bytes.size() ? Alphabet[word & 63] : '=';
+        }
+        return encoded;
+    }
+
+    // A mesh of two grids, the second one is a wave. Both are stored in a single buffer as positions, normals, UVs and 16-bit indices
+    // bufferUri is either the name of a .bin file next to the .gltf, a data URI or empty for the binary chunk of a .glb
+    // nodes is the JSON array of nodes, the first one is the root
+    inline std::string MakeGltfTestJson(const std::string& bufferUri, size_t bufferSize, const std::string& nodes = "[{\"mesh\":0,\"name\":\"Grids\"}]")
+    {
+        std::string bufferViews;
+        std::string accessors;
+        std::string primitives;
+        size_t offset = 0;
+        for (uint32_t primitiveIndex = 0; primitiveIndex < GltfTestNumPrimitives; ++primitiveIndex)
+        {
+            const uint32_t first = primitiveIndex * 4;
+            const size_t sizes[] = { GltfTestNumVertices * 12, GltfTestNumVertices * 12, GltfTestNumVertices * 8, GltfTestNumIndices * 2 };
+            for (size_t size : sizes)
+            {
+                bufferViews += std::format("{}{{\"buffer\":0,\"byteOffset\":{},\"byteLength\":{}}}", bufferViews.empty() ? "" : ",", offset, size);
+                offset += size;
+            }
+
+            accessors += std::format("{}{{\"bufferView\":{},\"componentType\":5126,\"count\":{},\"type\":\"VEC3\",\"min\":[-1,-1,-1],\"max\":[1,1,1]}},",
+                accessors.empty() ? "" : ",", first, GltfTestNumVertices);
+            accessors += std::format("{{\"bufferView\":{},\"componentType\":5126,\"count\":{},\"type\":\"VEC3\"}},", first + 1, GltfTestNumVertices);
+            accessors += std::format("{{\"bufferView\":{},\"componentType\":5126,\"count\":{},\"type\":\"VEC2\"}},", first + 2, GltfTestNumVertices);
+            accessors += std::format("{{\"bufferView\":{},\"componentType\":5123,\"count\":{},\"type\":\"SCALAR\"}}", first + 3, GltfTestNumIndices);
+
+            primitives += std::format("{}{{\"attributes\":{{\"POSITION\":{},\"NORMAL\":{},\"TEXCOORD_0\":{}}},\"indices\":{}}}",
+                primitives.empty() ? "" : ",", first, first + 1, first + 2, first + 3);
+        }
+        WARP_TEST_CHECK(offset == bufferSize);
+
+        return std::format("{{\"asset\":{{\"version\":\"2.0\"}},\"scene\":0,\"scenes\":[{{\"nodes\":[0]}}],\"nodes\":{},"
+            "\"meshes\":[{{\"name\":\"Grids\",\"primitives\":[{}]}}],\"buffers\":[{{\"byteLength\":{}{}}}],"
+            "\"bufferViews\":[{}],\"accessors\":[{}]}}",
+            nodes, primitives, bufferSize, bufferUri.empty() ? "" : std::format(",\"uri\":\"{}\"", bufferUri), bufferViews, accessors);
+    }
+
+    inline std::vector<std::byte> MakeGltfTestBuffer()
+    {
+        std::vector<std::byte> buffer;
+        for (uint32_t primitiveIndex = 0; primitiveIndex < GltfTestNumPrimitives; ++primitiveIndex)
+        {
+            std::vector<float> positions;
+            std::vector<float> normals;
+            std::vector<float> uvs;
+            for (uint32_t y = 0; y <= GltfTestQuadsPerSide; ++y)
+            {
+                for (uint32_t x = 0; x <= GltfTestQuadsPerSide; ++x)
+                {
+                    float u = static_cast<float>(x) / GltfTestQuadsPerSide;
+                    float v = static_cast<float>(y) / GltfTestQuadsPerSide;
+                    float height = primitiveIndex == 0 ? 0.0f : 0.2f * std::sin(u * 6.0f);
+                    positions.insert(positions.end(), { u * 2.0f - 1.0f, v * 2.0f - 1.0f, height });
+                    normals.insert(normals.end(), { 0.0f, 0.0f, 1.0f });
+                    uvs.insert(uvs.end(), { u, v });
+                }
+            }
+
+            std::vector<uint16_t> indices;
+            for (uint32_t y = 0; y < GltfTestQuadsPerSide; ++y)
+            {
+                for (uint32_t x = 0; x < GltfTestQuadsPerSide; ++x)
+                {
+                    uint16_t v00 = static_cast<uint16_t>(y * (GltfTestQuadsPerSide + 1) + x);
+                    uint16_t v10 = v00 + 1;
+                    uint16_t v01 = static_cast<uint16_t>(v00 + GltfTestQuadsPerSide + 1);
+                    uint16_t v11 = v01 + 1;
+                    indices.insert(indices.end(), { v00, v10, v11, v00, v11, v01 });
+                }
+            }
+
+            AppendBytes(buffer, positions);
+            AppendBytes(buffer, normals);
+            AppendBytes(buffer, uvs);
+            AppendBytes(buffer, indices);
+        }
+        return buffer;
+    }
+
+    // Binary glTF: 12 byte header, then the JSON chunk and the binary chunk, each padded to 4 bytes
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#binary-gltf-layout
+    inline std::vector<std::byte> MakeGlb(const std::string& json, std::span<const std::byte> bin)
+    {
+        auto appendUint32 = [](std::vector<std::byte>& bytes, uint32_t value) { AppendBytes(bytes, std::vector<uint32_t>{ value }); };
+
+        const uint32_t jsonSize = static_cast<uint32_t>((json.size() + 3) & ~size_t(3));
+        const uint32_t binSize = static_cast<uint32_t>((bin.size() + 3) & ~size_t(3));
+
+        std::vector<std::byte> glb;
+        appendUint32(glb, 0x46546C67); // "glTF"
+        appendUint32(glb, 2);
+        appendUint32(glb, 12 + 8 + jsonSize + 8 + binSize);
+
+        appendUint32(glb, jsonSize);
+        appendUint32(glb, 0x4E4F534A); // "JSON"
+        for (size_t i = 0; i < jsonSize; ++i)
+        {
+            glb.push_back(std::byte(i < json.size() ? json[i] : ' '));
+        }
+
+        appendUint32(glb, binSize);
+        appendUint32(glb, 0x004E4942); // "BIN"
+        glb.insert(glb.end(), bin.begin(), bin.end());
+        glb.resize(glb.size() + binSize - bin.size(), std::byte(0));
+        return glb;
+    }
+
+    inline void WriteTextFile(const std::filesystem::path& filepath, const std::string& text)
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    inline void WriteFileBytes(const std::filesystem::path& filepath, const std::vector<std::byte>& bytes)
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    inline std::vector<std::byte> ReadFileBytes(const std::filesystem::path& filepath)
+    {
+        std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+        std::vector<std::byte> bytes(file.is_open() ? static_cast<size_t>(file.tellg()) : 0);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    }
+
+    inline bool AreSpansEqual(std::span<const std::byte> a, std::span<const std::byte> b)
+    {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size()) == 0);
+    }
+
+    template<typename T>
+    bool AreSpansEqual(std::span<const T> a, std::span<const T> b)
+    {
+        return AreSpansEqual(std::as_bytes(a), std::as_bytes(b));
+    }
+
+    inline void CheckMeshesMatch(const MeshAsset& expected, const MeshAsset& mesh)
+    {
+        WARP_TEST_CHECK(mesh.GetNumSubmeshes() == expected.GetNumSubmeshes());
+        for (uint32_t submeshIndex = 0; submeshIndex < std::min(mesh.GetNumSubmeshes(), expected.GetNumSubmeshes()); ++submeshIndex)
+        {
+            const Submesh& a = expected.Submeshes[submeshIndex];
+            const Submesh& b = mesh.Submeshes[submeshIndex];
+            WARP_TEST_CHECK(a.GetNumVertices() == b.GetNumVertices() && a.GetNumLods() == b.GetNumLods());
+            for (size_t attribute = 0; attribute < eVertexAttribute_NumAttributes; ++attribute)
+            {
+                WARP_TEST_CHECK(AreSpansEqual(a.Attributes[attribute], b.Attributes[attribute]));
+            }
+
+            for (uint32_t lodIndex = 0; lodIndex < std::min(a.GetNumLods(), b.GetNumLods()); ++lodIndex)
+            {
+                const SubmeshLod& lodA = a.Lods[lodIndex];
+                const SubmeshLod& lodB = b.Lods[lodIndex];
+                WARP_TEST_CHECK(AreSpansEqual(lodA.Meshlets, lodB.Meshlets));
+                WARP_TEST_CHECK(AreSpansEqual(lodA.UniqueVertexIndices, lodB.UniqueVertexIndices));
+                WARP_TEST_CHECK(AreSpansEqual(lodA.PrimitiveIndices, lodB.PrimitiveIndices));
+                WARP_TEST_CHECK(AreSpansEqual(lodA.MeshletCullData, lodB.MeshletCullData));
+            }
+        }
+    }
+
+}
\ No newline at end of file
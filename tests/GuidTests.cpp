@@ -0,0 +1,131 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../src/Util/Guid.h"
+
+namespace Warp
+{
+
+    // Version is the top nibble of the third group, RFC 9562 variant is 0b10 in the top bits of the lowest byte of Data4
+    static uint32_t GetGuidVersion(const Guid& guid) { return guid.Data3 >> 12; }
+    static bool HasRfcVariant(const Guid& guid) { return (guid.Data4 & 0xC0) == 0x80; }
+
+    WARP_TEST(Guid_VersionAndVariantBitsAreSet)
+    {
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            Guid v4 = Guid::CreateV4();
+            Guid v7 = Guid::CreateV7();
+            WARP_TEST_CHECK(v4.IsValid() && v7.IsValid());
+            WARP_TEST_CHECK(GetGuidVersion(v4) == 4 && HasRfcVariant(v4));
+            WARP_TEST_CHECK(GetGuidVersion(v7) == 7 && HasRfcVariant(v7));
+        }
+
+        WARP_TEST_CHECK(GetGuidVersion(Guid::Create()) == 7);
+        WARP_TEST_CHECK(!Guid().IsValid());
+    }
+
+    WARP_TEST(Guid_V7StartsWithUnixTimeInMilliseconds)
+    {
+        using namespace std::chrono;
+        auto getMilliseconds = [] { return static_cast<uint64_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()); };
+
+        uint64_t before = getMilliseconds();
+        Guid guid = Guid::CreateV7();
+        uint64_t after = getMilliseconds();
+
+        uint64_t timestamp = guid.GetHigh() >> 16;
+        WARP_TEST_CHECK(timestamp >= before && timestamp <= after);
+
+        // Guids created a few milliseconds apart sort by their creation time
+        std::this_thread::sleep_for(milliseconds(5));
+        WARP_TEST_CHECK(guid < Guid::CreateV7());
+    }
+
+    WARP_TEST(Guid_ComparisonIsLexicographicOverGroups)
+    {
+        Guid a;
+        a.Data1 = 1;
+        a.Data4 = 0xFF;
+
+        Guid b = a;
+        WARP_TEST_CHECK(a == b);
+        WARP_TEST_CHECK(std::hash<Guid>()(a) == std::hash<Guid>()(b));
+
+        // Earlier groups take precedence, regardless of later ones
+        b.Data2 = 1;
+        b.Data4 = 0;
+        WARP_TEST_CHECK(a < b && a != b);
+
+        Guid c = a;
+        c.Data1 = 0;
+        c.Data2 = 0xFFFF;
+        WARP_TEST_CHECK(c < a);
+
+        Guid d = a;
+        d.Data3 = 0x7000;
+        WARP_TEST_CHECK(a < d && d < b);
+        WARP_TEST_CHECK(a.GetHigh() == (uint64_t(1) << 32));
+    }
+
+    WARP_TEST(Guid_ConcurrentlyCreatedGuidsAreUnique)
+    {
+        static constexpr uint32_t NumThreads = 8;
+        static constexpr uint32_t NumGuidsPerThread = 50000;
+
+        std::vector<std::vector<Guid>> guids(NumThreads);
+        std::vector<std::thread> threads;
+        for (uint32_t threadIndex = 0; threadIndex < NumThreads; ++threadIndex)
+        {
+            threads.emplace_back([&threadGuids = guids[threadIndex], threadIndex]
+                {
+                    threadGuids.reserve(NumGuidsPerThread);
+                    for (uint32_t i = 0; i < NumGuidsPerThread; ++i)
+                    {
+                        threadGuids.push_back(threadIndex % 2 ? Guid::CreateV4() : Guid::CreateV7());
+                    }
+                });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::vector<Guid> allGuids;
+        std::unordered_set<Guid> set;
+        for (const std::vector<Guid>& threadGuids : guids)
+        {
+            allGuids.insert(allGuids.end(), threadGuids.begin(), threadGuids.end());
+            set.insert(threadGuids.begin(), threadGuids.end());
+        }
+
+        std::sort(allGuids.begin(), allGuids.end());
+        WARP_TEST_CHECK(std::adjacent_find(allGuids.begin(), allGuids.end()) == allGuids.end());
+        WARP_TEST_CHECK(set.size() == allGuids.size());
+    }
+
+    WARP_TEST(Guid_HashSpreadsSequentialGuids)
+    {
+        static constexpr uint32_t NumGuids = 1 << 16;
+        static constexpr uint32_t NumBuckets = 1 << 10;
+
+        // v7 Guids of a single thread share their leading bits, the low bits of their hashes should not
+        std::vector<uint32_t> bucketSizes(NumBuckets, 0);
+        for (uint32_t i = 0; i < NumGuids; ++i)
+        {
+            ++bucketSizes[std::hash<Guid>()(Guid::CreateV7()) & (NumBuckets - 1)];
+        }
+
+        // 64 per bucket on average, a uniform hash stays well within 2x of it
+        uint32_t maxBucketSize = *std::max_element(bucketSizes.begin(), bucketSizes.end());
+        WARP_TEST_CHECK(maxBucketSize < 2 * NumGuids / NumBuckets);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include "Test.h"
+
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <d3d12.h>
+
+#include "../src/Assets/Importers/Formats/ImageLoader.h"
+#include "../src/Assets/Importers/Formats/MipGenerator.h"
+#include "../src/Assets/Importers/TextureImporter.h"
+#include "../src/Util/ThreadPool.h"
+
+namespace Warp
+{
+
+    // RGBA8 image whose texels are returned by getTexel(x, y) as packed 0xAABBGGRR
+    template<typename TexelFunc>
+    static ImageLoader::Image MakeTestImage(size_t width, size_t height, TexelFunc getTexel)
+    {
+        ImageLoader::Image image;
+        image.Filepath = "Test";
+        WARP_TEST_CHECK(SUCCEEDED(image.DxImage.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1)));
+
+        const DirectX::Image* pixels = image.DxImage.GetImage(0, 0, 0);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                uint32_t texel = getTexel(x, y);
+                std::memcpy(pixels->pixels + y * pixels->rowPitch + x * sizeof(uint32_t), &texel, sizeof(uint32_t));
+            }
+        }
+        return image;
+    }
+
+    static uint32_t GetTexel(const ImageLoader::Image& image, size_t x, size_t y, size_t mip = 0)
+    {
+        const DirectX::Image* pixels = image.DxImage.GetImage(mip, 0, 0);
+        uint32_t texel;
+        std::memcpy(&texel, pixels->pixels + y * pixels->rowPitch + x * sizeof(uint32_t), sizeof(uint32_t));
+        return texel;
+    }
+
+    static bool AreImagesEqual(const DirectX::ScratchImage& a, const DirectX::ScratchImage& b)
+    {
+        return a.GetMetadata().format == b.GetMetadata().format && a.GetImageCount() == b.GetImageCount() &&
+            a.GetPixelsSize() == b.GetPixelsSize() && std::memcmp(a.GetPixels(), b.GetPixels(), a.GetPixelsSize()) == 0;
+    }
+
+    static void FillNoise(DirectX::ScratchImage& image, uint32_t seed)
+    {
+        std::mt19937 generator(seed);
+        for (size_t i = 0; i < image.GetPixelsSize(); ++i)
+        {
+            image.GetPixels()[i] = static_cast<uint8_t>(generator());
+        }
+    }
+
+    // Compares layouts and pixels of every subresource, wherever the pixels of the image live
+    static bool AreSubresourcesEqual(const ImageLoader::Image& image, const DirectX::ScratchImage& expected)
+    {
+        const DirectX::TexMetadata& metadata = image.GetMetadata();
+        const DirectX::TexMetadata& expectedMetadata = expected.GetMetadata();
+        if (metadata.width != expectedMetadata.width || metadata.height != expectedMetadata.height || metadata.depth != expectedMetadata.depth ||
+            metadata.arraySize != expectedMetadata.arraySize || metadata.mipLevels != expectedMetadata.mipLevels ||
+            metadata.format != expectedMetadata.format || metadata.dimension != expectedMetadata.dimension ||
+            metadata.IsCubemap() != expectedMetadata.IsCubemap() || image.GetImageCount() != expected.GetImageCount())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < image.GetImageCount(); ++i)
+        {
+            const DirectX::Image& a = image.GetImages()[i];
+            const DirectX::Image& b = expected.GetImages()[i];
+            if (a.width != b.width || a.height != b.height || a.rowPitch != b.rowPitch || a.slicePitch != b.slicePitch ||
+                std::memcmp(a.pixels, b.pixels, a.slicePitch) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    WARP_TEST(ImageLoader_CompressedStripsMatchWholeImageCompression)
+    {
+        // 264 rows are a full strip of 64 block rows and a partial one, smaller mips are not multiples of the block size
+        std::mt19937 generator(3);
+        ImageLoader::Image source = MakeTestImage(520, 264, [&](size_t, size_t) { return static_cast<uint32_t>(generator()) | 0xFF000000; });
+
+        DirectX::ScratchImage mips;
+        WARP_TEST_CHECK(SUCCEEDED(DirectX::GenerateMipMaps(*source.DxImage.GetImage(0, 0, 0), DirectX::TEX_FILTER_BOX, 0, mips)));
+        source.DxImage = std::move(mips);
+
+        ThreadPool threadPool(4);
+        for (DXGI_FORMAT format : { DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC5_UNORM })
+        {
+            DirectX::ScratchImage expected;
+            WARP_TEST_CHECK(SUCCEEDED(DirectX::Compress(source.DxImage.GetImages(), source.DxImage.GetImageCount(), source.DxImage.GetMetadata(),
+                format, DirectX::TEX_COMPRESS_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, expected)));
+
+            // Blocks do not depend on their neighbours, thus strips assemble into the same bytes whether they are compressed in parallel or not
+            for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+            {
+                ImageLoader::Image image;
+                image.Filepath = source.Filepath;
+                WARP_TEST_CHECK(SUCCEEDED(image.DxImage.InitializeFromImage(*source.DxImage.GetImage(0, 0, 0))));
+                WARP_TEST_CHECK(SUCCEEDED(DirectX::GenerateMipMaps(*image.DxImage.GetImage(0, 0, 0), DirectX::TEX_FILTER_BOX, 0, mips)));
+                image.DxImage = std::move(mips);
+
+                WARP_TEST_CHECK(ImageLoader::CompressImage(image, format, pool));
+                WARP_TEST_CHECK(image.DxImage.GetMetadata().mipLevels == source.DxImage.GetMetadata().mipLevels);
+                WARP_TEST_CHECK(AreImagesEqual(image.DxImage, expected));
+            }
+        }
+
+        // Top level of partial blocks is not compressed at all
+        ImageLoader::Image partial = MakeTestImage(6, 4, [](size_t, size_t) { return 0xFF808080u; });
+        WARP_TEST_CHECK(!ImageLoader::CompressImage(partial, DXGI_FORMAT_BC1_UNORM, &threadPool));
+        WARP_TEST_CHECK(partial.GetMetadata().format == DXGI_FORMAT_R8G8B8A8_UNORM && GetTexel(partial, 5, 3) == 0xFF808080u);
+    }
+
+    // Fraction of texels of the mip whose alpha is at least the threshold
+    static float GetAlphaCoverage(const ImageLoader::Image& image, size_t mip, float threshold)
+    {
+        const DirectX::Image* pixels = image.DxImage.GetImage(mip, 0, 0);
+        size_t numCovered = 0;
+        for (size_t y = 0; y < pixels->height; ++y)
+        {
+            for (size_t x = 0; x < pixels->width; ++x)
+            {
+                numCovered += (GetTexel(image, x, y, mip) >> 24) / 255.0f >= threshold ? 1 : 0;
+            }
+        }
+        return static_cast<float>(numCovered) / static_cast<float>(pixels->width * pixels->height);
+    }
+
+    WARP_TEST(ImageLoader_GeneratedNormalMipsAreUnitLength)
+    {
+        // Random normals of the upper hemisphere, mapped to [0, 1]
+        std::mt19937 generator(5);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        auto encode = [](float value) { return static_cast<uint32_t>(std::lround((value * 0.5f + 0.5f) * 255.0f)); };
+        ImageLoader::Image noise = MakeTestImage(96, 80, [&](size_t, size_t)
+            {
+                float x = distribution(generator);
+                float y = distribution(generator);
+                float z = std::abs(distribution(generator)) + 0.1f;
+                float length = std::sqrt(x * x + y * y + z * z);
+                return 0xFF000000u | encode(z / length) << 16 | encode(y / length) << 8 | encode(x / length);
+            });
+
+        ThreadPool threadPool(4);
+        for (ImageLoader::EMipFilter filter : { ImageLoader::eMipFilter_Box, ImageLoader::eMipFilter_Kaiser })
+        {
+            for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+            {
+                ImageLoader::Image image;
+                image.Filepath = noise.Filepath;
+                WARP_TEST_CHECK(SUCCEEDED(image.DxImage.InitializeFromImage(*noise.DxImage.GetImage(0, 0, 0))));
+                WARP_TEST_CHECK(ImageLoader::GenerateMips(image, ImageLoader::MipGenerationDesc{ .Filter = filter, .IsNormalMap = true }, pool));
+                WARP_TEST_CHECK(image.GetMetadata().mipLevels == 7);
+
+                // Averages of diverging normals are much shorter than 1 before renormalization. 8-bit storage is good to about 1%
+                for (size_t mip = 1; mip < image.GetMetadata().mipLevels; ++mip)
+                {
+                    const DirectX::Image* pixels = image.DxImage.GetImage(mip, 0, 0);
+                    for (size_t y = 0; y < pixels->height; ++y)
+                    {
+                        for (size_t x = 0; x < pixels->width; ++x)
+                        {
+                            uint32_t texel = GetTexel(image, x, y, mip);
+                            double length = 0.0;
+                            for (uint32_t channel = 0; channel < 3; ++channel)
+                            {
+                                double value = ((texel >> (channel * 8)) & 0xFF) / 255.0 * 2.0 - 1.0;
+                                length += value * value;
+                            }
+                            WARP_TEST_CHECK(Test::IsNear(std::sqrt(length), 1.0, 0.02));
+                        }
+                    }
+                }
+            }
+        }
+
+        // Normals that cancel out entirely point straight up
+        ImageLoader::Image opposite = MakeTestImage(8, 8, [](size_t x, size_t) { return x % 2 == 0 ? 0xFF7F00FFu : 0xFF80FF00u; });
+        WARP_TEST_CHECK(ImageLoader::GenerateMips(opposite, ImageLoader::MipGenerationDesc{ .IsNormalMap = true }, nullptr));
+        WARP_TEST_CHECK(GetTexel(opposite, 0, 0, 1) == 0xFFFF8080u && GetTexel(opposite, 3, 3, 1) == 0xFFFF8080u);
+    }
+
+    WARP_TEST(ImageLoader_GeneratedMipsPreserveAlphaCoverage)
+    {
+        // Cutout noise, a fifth of the texels pass the test. Plain filtering averages alpha towards 0.5, so lower mips lose the cutouts
+        static constexpr float Threshold = 0.8f;
+        std::mt19937 generator(9);
+        ImageLoader::Image noise = MakeTestImage(128, 128, [&](size_t, size_t) { return static_cast<uint32_t>(generator()) | 0x00FFFFFFu; });
+        const float coverage = GetAlphaCoverage(noise, 0, Threshold);
+        WARP_TEST_CHECK(Test::IsNear(coverage, 0.2, 0.02));
+
+        ThreadPool threadPool(4);
+        for (ImageLoader::EMipFilter filter : { ImageLoader::eMipFilter_Box, ImageLoader::eMipFilter_Kaiser })
+        {
+            for (float threshold : { 0.0f, Threshold })
+            {
+                ImageLoader::Image image;
+                image.Filepath = noise.Filepath;
+                WARP_TEST_CHECK(SUCCEEDED(image.DxImage.InitializeFromImage(*noise.DxImage.GetImage(0, 0, 0))));
+                WARP_TEST_CHECK(ImageLoader::GenerateMips(image, ImageLoader::MipGenerationDesc{ .Filter = filter, .AlphaCoverageThreshold = threshold }, &threadPool));
+
+                // Down to 16x16, where a texel is still less than 0.5% of coverage
+                for (size_t mip = 1; mip <= 3; ++mip)
+                {
+                    float mipCoverage = GetAlphaCoverage(image, mip, Threshold);
+                    WARP_TEST_CHECK(threshold > 0.0f ? Test::IsNear(mipCoverage, coverage, 0.03) : mipCoverage < coverage * 0.5f);
+                }
+            }
+        }
+    }
+
+    WARP_TEST(ImageLoader_FormatsAndChannelsFollowUsage)
+    {
+        ImageLoader::Image opaque = MakeTestImage(8, 8, [](size_t x, size_t y) { return 0xFF000000u | static_cast<uint32_t>(x * 16 + y); });
+        ImageLoader::Image translucent = MakeTestImage(8, 8, [](size_t x, size_t) { return x == 7 ? 0x80FFFFFFu : 0xFFFFFFFFu; });
+
+        // Roughness in green, metalness in blue
+        ImageLoader::Image roughness = MakeTestImage(8, 8, [](size_t, size_t) { return 0xFF00C000u; });
+        ImageLoader::Image roughnessMetalness = MakeTestImage(8, 8, [](size_t, size_t y) { return 0xFF00C000u | static_cast<uint32_t>(y * 16) << 16; });
+
+        WARP_TEST_CHECK(TextureImporter::GetCompressedFormat(opaque, eTextureUsage_Default) == DXGI_FORMAT_UNKNOWN);
+        WARP_TEST_CHECK(TextureImporter::GetCompressedFormat(opaque, eTextureUsage_Albedo) == DXGI_FORMAT_BC1_UNORM);
+        WARP_TEST_CHECK(TextureImporter::GetCompressedFormat(translucent, eTextureUsage_Albedo) == DXGI_FORMAT_BC7_UNORM);
+        WARP_TEST_CHECK(TextureImporter::GetCompressedFormat(opaque, eTextureUsage_Normal) == DXGI_FORMAT_BC5_UNORM);
+        WARP_TEST_CHECK(TextureImporter::GetCompressedFormat(roughness, eTextureUsage_RoughnessMetalness) == DXGI_FORMAT_BC4_UNORM);
+        WARP_TEST_CHECK(TextureImporter::GetCompressedFormat(roughnessMetalness, eTextureUsage_RoughnessMetalness) == DXGI_FORMAT_BC5_UNORM);
+
+        // Blue of the first row is zero, which does not make the channel zero
+        WARP_TEST_CHECK(ImageLoader::IsChannelZero(roughness, 2) && ImageLoader::IsChannelZero(roughness, 0));
+        WARP_TEST_CHECK(!ImageLoader::IsChannelZero(roughnessMetalness, 2) && !ImageLoader::IsChannelZero(roughness, 1));
+
+        // Green and blue move into red and green, 8-bit values survive the float round trip exactly
+        ImageLoader::Image swizzled;
+        WARP_TEST_CHECK(ImageLoader::SwizzleGreenBlueToRedGreen(roughnessMetalness, swizzled));
+        WARP_TEST_CHECK(swizzled.GetMetadata().format == DXGI_FORMAT_R8G8B8A8_UNORM);
+        WARP_TEST_CHECK(GetTexel(swizzled, 0, 3) == 0xFFFF30C0u);
+
+        // Views put the channels back where glTF has them: roughness in green, metalness in blue
+        UINT bc5Mapping = TextureImporter::GetShaderComponentMapping(eTextureUsage_RoughnessMetalness, DXGI_FORMAT_BC5_UNORM);
+        WARP_TEST_CHECK(D3D12_DECODE_SHADER_4_COMPONENT_MAPPING(1, bc5Mapping) == D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0);
+        WARP_TEST_CHECK(D3D12_DECODE_SHADER_4_COMPONENT_MAPPING(2, bc5Mapping) == D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_1);
+
+        UINT bc4Mapping = TextureImporter::GetShaderComponentMapping(eTextureUsage_RoughnessMetalness, DXGI_FORMAT_BC4_UNORM);
+        WARP_TEST_CHECK(D3D12_DECODE_SHADER_4_COMPONENT_MAPPING(1, bc4Mapping) == D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0);
+        WARP_TEST_CHECK(D3D12_DECODE_SHADER_4_COMPONENT_MAPPING(2, bc4Mapping) == D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_0);
+
+        WARP_TEST_CHECK(TextureImporter::GetShaderComponentMapping(eTextureUsage_Normal, DXGI_FORMAT_BC5_UNORM) == D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING);
+        WARP_TEST_CHECK(TextureImporter::GetShaderComponentMapping(eTextureUsage_RoughnessMetalness, DXGI_FORMAT_R8G8B8A8_UNORM) == D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING);
+    }
+
+    WARP_TEST(ImageLoader_DDSSubresourcesAreMappedInPlace)
+    {
+        Test::ScopedTestFolder folder("ImageLoader_DDS");
+
+        // Block-compressed arrays, cubemaps with mips and volumes whose slices halve along with mips. Any bytes are valid pixels
+        DirectX::ScratchImage bc1;
+        DirectX::ScratchImage bc7Array;
+        DirectX::ScratchImage cube;
+        DirectX::ScratchImage volume;
+        WARP_TEST_CHECK(SUCCEEDED(bc1.Initialize2D(DXGI_FORMAT_BC1_UNORM, 520, 264, 1, 0)));
+        WARP_TEST_CHECK(SUCCEEDED(bc7Array.Initialize2D(DXGI_FORMAT_BC7_UNORM_SRGB, 64, 32, 3, 0)));
+        WARP_TEST_CHECK(SUCCEEDED(cube.InitializeCube(DXGI_FORMAT_R8G8B8A8_UNORM, 16, 16, 1, 0)));
+        WARP_TEST_CHECK(SUCCEEDED(volume.Initialize3D(DXGI_FORMAT_R16G16B16A16_FLOAT, 8, 8, 4, 0)));
+
+        uint32_t seed = 0;
+        for (DirectX::ScratchImage* sourceImage : { &bc1, &bc7Array, &cube, &volume })
+        {
+            DirectX::ScratchImage& source = *sourceImage;
+            FillNoise(source, ++seed);
+
+            std::filesystem::path filepath = folder / std::format("Image{}.dds", seed).c_str();
+            WARP_TEST_CHECK(SUCCEEDED(DirectX::SaveToDDSFile(source.GetImages(), source.GetImageCount(), source.GetMetadata(), DirectX::DDS_FLAGS_NONE, filepath.c_str())));
+
+            ImageLoader::Image image = ImageLoader::LoadDDSFromFile(filepath.string(), false);
+            WARP_TEST_CHECK(image.IsMapped() && AreSubresourcesEqual(image, source));
+
+            // Mips are already there, nothing to generate
+            image = ImageLoader::LoadDDSFromFile(filepath.string(), true);
+            WARP_TEST_CHECK(image.IsMapped() && AreSubresourcesEqual(image, source));
+
+            // Copies keep every subresource and release the file
+            WARP_TEST_CHECK(ImageLoader::CopyMappedImage(image));
+            WARP_TEST_CHECK(!image.IsMapped() && AreSubresourcesEqual(image, source));
+            std::error_code ec;
+            WARP_TEST_CHECK(std::filesystem::remove(filepath, ec));
+        }
+
+        // A single level of an uncompressed image is decoded, so that mips can be generated
+        DirectX::ScratchImage single;
+        WARP_TEST_CHECK(SUCCEEDED(single.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, 16, 8, 1, 1)));
+        FillNoise(single, 7);
+        std::filesystem::path singlePath = folder / "Single.dds";
+        WARP_TEST_CHECK(SUCCEEDED(DirectX::SaveToDDSFile(*single.GetImage(0, 0, 0), DirectX::DDS_FLAGS_NONE, singlePath.c_str())));
+
+        ImageLoader::Image withMips = ImageLoader::LoadDDSFromFile(singlePath.string(), true);
+        WARP_TEST_CHECK(!withMips.IsMapped() && withMips.GetMetadata().mipLevels == 5);
+        WARP_TEST_CHECK(std::memcmp(withMips.GetImages()[0].pixels, single.GetPixels(), single.GetPixelsSize()) == 0);
+        WARP_TEST_CHECK(ImageLoader::LoadDDSFromFile(singlePath.string(), false).IsMapped());
+    }
+
+    WARP_TEST(ImageLoader_LegacyDDSFormatsAreDecoded)
+    {
+        Test::ScopedTestFolder folder("ImageLoader_LegacyDDS");
+
+        // 24-bit RGB has no DXGI format, DirectXTex expands it to 32 bits per texel. The file is shorter than that layout
+        static constexpr uint32_t Size = 4;
+        std::vector<uint32_t> header(32, 0);
+        header[0] = 0x20534444; // 'DDS '
+        header[1] = 124;
+        header[2] = 0x1 | 0x2 | 0x4 | 0x1000; // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT
+        header[3] = Size;
+        header[4] = Size;
+        header[5] = Size * 3;
+        header[19] = 32; // DDS_PIXELFORMAT
+        header[20] = 0x40; // DDPF_RGB
+        header[22] = 24;
+        header[23] = 0xFF0000;
+        header[24] = 0xFF00;
+        header[25] = 0xFF;
+        header[27] = 0x1000; // DDSCAPS_TEXTURE
+
+        std::vector<uint8_t> pixels(Size * Size * 3);
+        for (size_t i = 0; i < pixels.size(); ++i)
+        {
+            pixels[i] = static_cast<uint8_t>(i * 5);
+        }
+
+        const std::string filepath = (folder / "Legacy.dds").string();
+        {
+            std::ofstream file(folder / "Legacy.dds", std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size() * sizeof(uint32_t)));
+            file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        }
+
+        DirectX::ScratchImage expected;
+        WARP_TEST_CHECK(SUCCEEDED(DirectX::LoadFromDDSFile((folder / "Legacy.dds").c_str(), DirectX::DDS_FLAGS_NONE, nullptr, expected)));
+
+        ImageLoader::Image image = ImageLoader::LoadDDSFromFile(filepath, false);
+        WARP_TEST_CHECK(image.IsValid() && !image.IsMapped());
+        WARP_TEST_CHECK(DirectX::BitsPerPixel(image.GetMetadata().format) == 32 && AreSubresourcesEqual(image, expected));
+    }
+
+}
\ No newline at end of file
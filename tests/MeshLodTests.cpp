@@ -0,0 +1,198 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#include "../src/Math/MeshSimplification.h"
+#include "../src/Renderer/MeshLodSelection.h"
+
+namespace Warp
+{
+
+    struct LodTestMesh
+    {
+        std::vector<Math::Vector3> Positions;
+        std::vector<uint32_t> Indices;
+        std::vector<uint32_t> SeamVertices; // Copies of vertices of the middle column, as if UVs were split along it
+    };
+
+    // Square grid spanning [-1, 1] in the xy plane, counter-clockwise when seen from +z. height displaces vertices along z
+    // If hasSeam is set, quads right of the middle column index copies of its vertices
+    template<typename HeightFunc>
+    static LodTestMesh MakeLodTestGrid(uint32_t numQuadsPerSide, bool hasSeam, HeightFunc height)
+    {
+        LodTestMesh mesh;
+        uint32_t numVerticesPerSide = numQuadsPerSide + 1;
+        for (uint32_t y = 0; y < numVerticesPerSide; ++y)
+        {
+            for (uint32_t x = 0; x < numVerticesPerSide; ++x)
+            {
+                float u = static_cast<float>(x) / numQuadsPerSide * 2.0f - 1.0f;
+                float v = static_cast<float>(y) / numQuadsPerSide * 2.0f - 1.0f;
+                mesh.Positions.push_back(Math::Vector3(u, v, height(u, v)));
+            }
+        }
+
+        uint32_t seamColumn = numQuadsPerSide / 2;
+        std::vector<uint32_t> seamCopies(numVerticesPerSide);
+        for (uint32_t y = 0; hasSeam && y < numVerticesPerSide; ++y)
+        {
+            seamCopies[y] = static_cast<uint32_t>(mesh.Positions.size());
+            mesh.Positions.push_back(mesh.Positions[y * numVerticesPerSide + seamColumn]);
+            mesh.SeamVertices.push_back(y * numVerticesPerSide + seamColumn);
+            mesh.SeamVertices.push_back(seamCopies[y]);
+        }
+
+        auto getVertex = [&](uint32_t x, uint32_t y, bool isRightOfSeam)
+            {
+                return hasSeam && isRightOfSeam && x == seamColumn ? seamCopies[y] : y * numVerticesPerSide + x;
+            };
+
+        for (uint32_t y = 0; y < numQuadsPerSide; ++y)
+        {
+            for (uint32_t x = 0; x < numQuadsPerSide; ++x)
+            {
+                bool isRightOfSeam = x >= seamColumn;
+                uint32_t v00 = getVertex(x, y, isRightOfSeam);
+                uint32_t v10 = getVertex(x + 1, y, isRightOfSeam);
+                uint32_t v01 = getVertex(x, y + 1, isRightOfSeam);
+                uint32_t v11 = getVertex(x + 1, y + 1, isRightOfSeam);
+                mesh.Indices.insert(mesh.Indices.end(), { v00, v10, v11, v00, v11, v01 });
+            }
+        }
+        return mesh;
+    }
+
+    static float GetFlatness(float, float) { return 0.0f; }
+
+    static Math::Vector3 GetTriangleNormal(const LodTestMesh& mesh, std::span<const uint32_t> indices, size_t triangleIndex)
+    {
+        const Math::Vector3& p0 = mesh.Positions[indices[triangleIndex * 3 + 0]];
+        const Math::Vector3& p1 = mesh.Positions[indices[triangleIndex * 3 + 1]];
+        const Math::Vector3& p2 = mesh.Positions[indices[triangleIndex * 3 + 2]];
+        return (p1 - p0).Cross(p2 - p0);
+    }
+
+    static bool IsVertexReferenced(std::span<const uint32_t> indices, uint32_t vertex)
+    {
+        return std::find(indices.begin(), indices.end(), vertex) != indices.end();
+    }
+
+    WARP_TEST(MeshLod_FlatGridSimplifiesWithoutMovingBordersOrSeams)
+    {
+        static constexpr uint32_t NumQuadsPerSide = 16;
+
+        LodTestMesh mesh = MakeLodTestGrid(NumQuadsPerSide, true, GetFlatness);
+
+        // Interior of a plane collapses at no cost
+        std::vector<uint32_t> simplified;
+        Math::MeshSimplifyResult result = Math::SimplifyMesh(mesh.Positions, std::span<const uint32_t>(mesh.Indices), 0, 1e-4f, simplified);
+        WARP_TEST_CHECK(result.NumCollapses > 0 && result.Error <= 1e-4f);
+        WARP_TEST_CHECK(simplified.size() % 3 == 0 && simplified.size() < mesh.Indices.size() / 2);
+
+        // Triangles keep facing +z and still cover the whole square
+        float area = 0.0f;
+        for (size_t triangleIndex = 0; triangleIndex < simplified.size() / 3; ++triangleIndex)
+        {
+            Math::Vector3 normal = GetTriangleNormal(mesh, simplified, triangleIndex);
+            WARP_TEST_CHECK(normal.z > 0.0f);
+            area += normal.z * 0.5f;
+        }
+        WARP_TEST_CHECK(Test::IsNear(area, 4.0f, 1e-4));
+
+        // Borders and both sides of the seam never move, thus every one of their vertices is still referenced
+        uint32_t numVerticesPerSide = NumQuadsPerSide + 1;
+        for (uint32_t i = 0; i < numVerticesPerSide; ++i)
+        {
+            WARP_TEST_CHECK(IsVertexReferenced(simplified, i));
+            WARP_TEST_CHECK(IsVertexReferenced(simplified, i * numVerticesPerSide));
+            WARP_TEST_CHECK(IsVertexReferenced(simplified, i * numVerticesPerSide + NumQuadsPerSide));
+            WARP_TEST_CHECK(IsVertexReferenced(simplified, NumQuadsPerSide * numVerticesPerSide + i));
+        }
+
+        for (uint32_t vertex : mesh.SeamVertices)
+        {
+            WARP_TEST_CHECK(IsVertexReferenced(simplified, vertex));
+        }
+
+        // 16-bit indices simplify the same way
+        std::vector<uint16_t> indices16(mesh.Indices.begin(), mesh.Indices.end());
+        std::vector<uint16_t> simplified16;
+        Math::MeshSimplifyResult result16 = Math::SimplifyMesh(mesh.Positions, std::span<const uint16_t>(indices16), 0, 1e-4f, simplified16);
+        WARP_TEST_CHECK(result16.NumCollapses == result.NumCollapses && std::equal(simplified.begin(), simplified.end(), simplified16.begin(), simplified16.end()));
+    }
+
+    WARP_TEST(MeshLod_SimplificationStopsAtTargetAndMaxError)
+    {
+        auto getWaves = [](float u, float v) { return 0.1f * std::sin(u * 3.0f) * std::cos(v * 3.0f); };
+        LodTestMesh mesh = MakeLodTestGrid(16, false, getWaves);
+
+        // Every collapse of a curved surface costs something
+        std::vector<uint32_t> simplified;
+        Math::MeshSimplifyResult result = Math::SimplifyMesh(mesh.Positions, std::span<const uint32_t>(mesh.Indices), 0, 0.0f, simplified);
+        WARP_TEST_CHECK(result.NumCollapses == 0 && result.Error == 0.0f && simplified == mesh.Indices);
+
+        // Larger errors allow more collapses, the reported error stays within the limit
+        size_t previousNumIndices = mesh.Indices.size();
+        for (float maxError : { 0.001f, 0.01f, 0.1f })
+        {
+            result = Math::SimplifyMesh(mesh.Positions, std::span<const uint32_t>(mesh.Indices), 0, maxError, simplified);
+            WARP_TEST_CHECK(result.Error <= maxError);
+            WARP_TEST_CHECK(simplified.size() <= previousNumIndices);
+            previousNumIndices = simplified.size();
+        }
+        WARP_TEST_CHECK(previousNumIndices < mesh.Indices.size());
+
+        // Simplification stops as soon as the target is reached, even if more collapses would fit into the error
+        size_t targetNumIndices = mesh.Indices.size() / 2;
+        result = Math::SimplifyMesh(mesh.Positions, std::span<const uint32_t>(mesh.Indices), targetNumIndices, 1.0f, simplified);
+        WARP_TEST_CHECK(simplified.size() <= targetNumIndices && simplified.size() > targetNumIndices / 2);
+    }
+
+    WARP_TEST(MeshLod_SelectionFollowsDistanceAndScale)
+    {
+        // Unit sphere at the origin, errors of levels grow tenfold
+        Submesh submesh;
+        submesh.BoundingSphere.Center = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+        submesh.BoundingSphere.Radius = 1.0f;
+        submesh.Lods.resize(4);
+        submesh.Lods[1].Error = 0.001f;
+        submesh.Lods[2].Error = 0.01f;
+        submesh.Lods[3].Error = 0.1f;
+
+        // 90 degrees of vertical fov over 1000 pixels is 500 pixels per unit at a distance of one
+        static constexpr uint32_t ViewportHeight = 1000;
+        static constexpr float MaxScreenSpaceError = 1.0f;
+
+        EulersCameraComponent camera;
+        camera.Fov = 90.0f;
+        camera.NearPlane = 0.1f;
+
+        auto selectAt = [&](float cameraZ, const Math::Matrix& instanceToWorld)
+            {
+                camera.EyePos = Math::Vector3(0.0f, 0.0f, cameraZ);
+                return SelectSubmeshLod(submesh, instanceToWorld, camera, ViewportHeight, MaxScreenSpaceError);
+            };
+
+        // One unit away from the sphere, 0.5, 5 and 50 pixels
+        LodSelection selection = selectAt(2.0f, Math::Matrix::Identity);
+        WARP_TEST_CHECK(selection.LodIndex == 1 && Test::IsNear(selection.ScreenSpaceError, 0.5f, 1e-3));
+
+        // A hundred units away even the coarsest level is within half of a pixel
+        selection = selectAt(101.0f, Math::Matrix::Identity);
+        WARP_TEST_CHECK(selection.LodIndex == 3 && Test::IsNear(selection.ScreenSpaceError, 0.5f, 1e-3));
+        WARP_TEST_CHECK(Test::IsNear(ComputeSubmeshScreenSize(submesh, Math::Matrix::Identity, camera, ViewportHeight), 10.0f, 1e-3));
+
+        // Scale grows both the error and the sphere, the sphere comes closer to the camera
+        selection = selectAt(101.0f, Math::Matrix::CreateScale(10.0f));
+        WARP_TEST_CHECK(selection.LodIndex == 2 && Test::IsNear(selection.ScreenSpaceError, 0.01f * 10.0f * 500.0f / 91.0f, 1e-3));
+
+        // Inside of the sphere levels are as close as the near plane, the finest level is already 5 pixels off
+        selection = selectAt(0.5f, Math::Matrix::Identity);
+        WARP_TEST_CHECK(selection.LodIndex == 0 && selection.ScreenSpaceError == 0.0f);
+        WARP_TEST_CHECK(ComputeLodScreenSpaceError(submesh, 0, Math::Matrix::Identity, camera, ViewportHeight) == 0.0f);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "Test.h"
+
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "../src/Assets/MeshStatistics.h"
+
+namespace Warp
+{
+
+    template<typename IndexType>
+    static VertexCacheStatistics AnalyzeTestIndices(const std::vector<uint32_t>& indices, uint32_t numVertices, uint32_t cacheSize)
+    {
+        std::vector<IndexType> typedIndices(indices.begin(), indices.end());
+        return AnalyzeVertexCache(std::span<const IndexType>(typedIndices), numVertices, cacheSize);
+    }
+
+    // Unique vertex indices are stored as bytes of either width, as the importer keeps them
+    static std::vector<uint8_t> MakeUniqueVertexIndices(const std::vector<uint32_t>& indices, uint32_t stride)
+    {
+        std::vector<uint8_t> bytes(indices.size() * stride);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            uint16_t index16 = static_cast<uint16_t>(indices[i]);
+            std::memcpy(bytes.data() + i * stride, stride == sizeof(uint16_t) ? static_cast<const void*>(&index16) : &indices[i], stride);
+        }
+        return bytes;
+    }
+
+    WARP_TEST(MeshStatistics_VertexCacheIsFifo)
+    {
+        for (uint32_t cacheSize : { 3u, 16u })
+        {
+            // Every vertex misses on its first use only, as long as the cache holds a triangle
+            VertexCacheStatistics triangle = AnalyzeTestIndices<uint16_t>({ 0, 1, 2, 2, 1, 0 }, 3, cacheSize);
+            WARP_TEST_CHECK(triangle.NumTransformedVertices == 3 && triangle.NumTriangles == 2 && triangle.NumVertices == 3);
+            WARP_TEST_CHECK(Test::IsNear(triangle.GetAcmr(), 1.5, 1e-6) && Test::IsNear(triangle.GetAtvr(), 1.0, 1e-6));
+
+            VertexCacheStatistics quad = AnalyzeTestIndices<uint32_t>({ 0, 1, 2, 0, 2, 3 }, 4, cacheSize);
+            WARP_TEST_CHECK(quad.NumTransformedVertices == 4 && Test::IsNear(quad.GetAcmr(), 2.0, 1e-6));
+        }
+
+        // Hits do not refresh entries: 0 is evicted by 3 although it was just used, which is not what a LRU cache would do
+        const std::vector<uint32_t> indices = { 0, 1, 2, 0, 1, 3, 0, 4, 5 };
+        VertexCacheStatistics fifo16 = AnalyzeTestIndices<uint16_t>(indices, 6, 3);
+        VertexCacheStatistics fifo32 = AnalyzeTestIndices<uint32_t>(indices, 6, 3);
+        WARP_TEST_CHECK(fifo16.NumTransformedVertices == 7 && fifo32.NumTransformedVertices == 7);
+
+        // A cache that fits every vertex transforms each of them once
+        WARP_TEST_CHECK(AnalyzeTestIndices<uint32_t>(indices, 6, 6).NumTransformedVertices == 6);
+
+        // Statistics keep raw counts, thus ratios of sums are weighted by triangles
+        VertexCacheStatistics total = fifo16;
+        total += AnalyzeTestIndices<uint32_t>({ 0, 1, 2 }, 3, 3);
+        WARP_TEST_CHECK(total.NumTransformedVertices == 10 && total.NumTriangles == 4 && total.NumVertices == 9);
+        WARP_TEST_CHECK(Test::IsNear(total.GetAcmr(), 2.5, 1e-6));
+
+        WARP_TEST_CHECK(VertexCacheStatistics().GetAcmr() == 0.0f && VertexCacheStatistics().GetAtvr() == 0.0f);
+    }
+
+    WARP_TEST(MeshStatistics_MeshletsCountFillDuplicationAndFetchedLines)
+    {
+        static constexpr uint32_t PositionStride = 12;
+        static constexpr uint32_t NumVertices = 8;
+
+        // Second meshlet shares vertex 3 with the first one. Its positions span bytes 36..95, vertex 5 straddles the first two lines
+        const std::vector<uint32_t> uniqueVertexIndices = { 0, 1, 2, 3, 3, 4, 5, 6, 7 };
+        const std::vector<DirectX::Meshlet> meshlets = {
+            DirectX::Meshlet{ .VertCount = 4, .VertOffset = 0, .PrimCount = 2, .PrimOffset = 0 },
+            DirectX::Meshlet{ .VertCount = 5, .VertOffset = 4, .PrimCount = 3, .PrimOffset = 2 },
+        };
+
+        for (uint32_t stride : { uint32_t(sizeof(uint16_t)), uint32_t(sizeof(uint32_t)) })
+        {
+            std::vector<uint8_t> bytes = MakeUniqueVertexIndices(uniqueVertexIndices, stride);
+            MeshletStatistics stats = AnalyzeMeshlets(meshlets, bytes, stride, NumVertices, PositionStride, eMeshletSize_64);
+            WARP_TEST_CHECK(stats.NumMeshlets == 2 && stats.NumMeshletSlots == 128);
+            WARP_TEST_CHECK(stats.NumMeshletVertices == 9 && stats.NumMeshletPrimitives == 5);
+            WARP_TEST_CHECK(Test::IsNear(stats.GetVertexFill(), 9.0 / 128.0, 1e-6) && Test::IsNear(stats.GetPrimitiveFill(), 5.0 / 128.0, 1e-6));
+            WARP_TEST_CHECK(Test::IsNear(stats.GetVertexDuplication(), 9.0 / 8.0, 1e-6));
+
+            // One line for the first meshlet, two for the second one, out of a stream of 96 bytes
+            WARP_TEST_CHECK(stats.NumFetchedBytes == 3 * DefaultCacheLineSize && stats.NumStreamBytes == NumVertices * PositionStride);
+            WARP_TEST_CHECK(Test::IsNear(stats.GetOverfetch(), 192.0 / 96.0, 1e-6));
+
+            // Lines as large as the stream are fetched once per meshlet
+            MeshletStatistics wideLines = AnalyzeMeshlets(meshlets, bytes, stride, NumVertices, PositionStride, eMeshletSize_64, 128);
+            WARP_TEST_CHECK(wideLines.NumFetchedBytes == 2 * 128);
+        }
+
+        // Sums are weighted by meshlets and vertices
+        std::vector<uint8_t> bytes = MakeUniqueVertexIndices(uniqueVertexIndices, sizeof(uint32_t));
+        MeshletStatistics total = AnalyzeMeshlets(meshlets, bytes, sizeof(uint32_t), NumVertices, PositionStride, eMeshletSize_128);
+        total += AnalyzeMeshlets(std::span<const DirectX::Meshlet>(meshlets.data(), 1), bytes, sizeof(uint32_t), NumVertices, PositionStride, eMeshletSize_128);
+        WARP_TEST_CHECK(total.NumMeshlets == 3 && total.NumMeshletSlots == 3 * 128 && total.NumMeshletVertices == 13 && total.NumVertices == 16);
+        WARP_TEST_CHECK(total.NumFetchedBytes == 4 * DefaultCacheLineSize);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "Test.h"
+
+#include <vector>
+#include <DirectXMesh/DirectXMesh.h>
+
+#include "../src/Math/MeshletCulling.h"
+
+namespace Warp
+{
+
+    struct CullingTestMesh
+    {
+        std::vector<DirectX::XMFLOAT3> Positions;
+        std::vector<uint32_t> Indices;
+    };
+
+    // Cull data is computed the same way GltfMeshImporter does it, with counter-clockwise front faces
+    static std::vector<DirectX::CullData> ComputeTestCullData(const CullingTestMesh& mesh)
+    {
+        std::vector<DirectX::Meshlet> meshlets;
+        std::vector<uint8_t> uniqueVertexIB;
+        std::vector<DirectX::MeshletTriangle> primitiveIndices;
+        HRESULT hr = DirectX::ComputeMeshlets(mesh.Indices.data(), mesh.Indices.size() / 3, mesh.Positions.data(), mesh.Positions.size(), nullptr,
+            meshlets, uniqueVertexIB, primitiveIndices);
+        WARP_TEST_CHECK(SUCCEEDED(hr));
+
+        std::vector<DirectX::CullData> cullData(meshlets.size());
+        hr = DirectX::ComputeCullData(mesh.Positions.data(), mesh.Positions.size(), meshlets.data(), meshlets.size(),
+            reinterpret_cast<const uint32_t*>(uniqueVertexIB.data()), uniqueVertexIB.size() / sizeof(uint32_t),
+            primitiveIndices.data(), primitiveIndices.size(), cullData.data());
+        WARP_TEST_CHECK(SUCCEEDED(hr));
+        return cullData;
+    }
+
+    // Square grid spanning [-1, 1] in the xy plane, counter-clockwise when seen from +z
+    static CullingTestMesh MakePlane(uint32_t numQuadsPerSide)
+    {
+        CullingTestMesh mesh;
+        uint32_t numVerticesPerSide = numQuadsPerSide + 1;
+        for (uint32_t y = 0; y < numVerticesPerSide; ++y)
+        {
+            for (uint32_t x = 0; x < numVerticesPerSide; ++x)
+            {
+                float u = static_cast<float>(x) / numQuadsPerSide;
+                float v = static_cast<float>(y) / numQuadsPerSide;
+                mesh.Positions.push_back(DirectX::XMFLOAT3(u * 2.0f - 1.0f, v * 2.0f - 1.0f, 0.0f));
+            }
+        }
+
+        for (uint32_t y = 0; y < numQuadsPerSide; ++y)
+        {
+            for (uint32_t x = 0; x < numQuadsPerSide; ++x)
+            {
+                uint32_t v00 = y * numVerticesPerSide + x;
+                uint32_t v10 = v00 + 1;
+                uint32_t v01 = v00 + numVerticesPerSide;
+                uint32_t v11 = v01 + 1;
+                mesh.Indices.insert(mesh.Indices.end(), { v00, v10, v11, v00, v11, v01 });
+            }
+        }
+        return mesh;
+    }
+
+    // Unit cube around the origin with outward facing, counter-clockwise triangles
+    static CullingTestMesh MakeBox()
+    {
+        CullingTestMesh mesh;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            mesh.Positions.push_back(DirectX::XMFLOAT3(i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f));
+        }
+
+        mesh.Indices = {
+            0, 4, 6, 0, 6, 2, // -x
+            1, 3, 7, 1, 7, 5, // +x
+            0, 1, 5, 0, 5, 4, // -y
+            2, 6, 7, 2, 7, 3, // +y
+            0, 2, 3, 0, 3, 1, // -z
+            4, 5, 7, 4, 7, 6, // +z
+        };
+        return mesh;
+    }
+
+    static Math::Matrix MakeViewProjection(const Math::Vector3& cameraPosition, const Math::Vector3& target)
+    {
+        return Math::Matrix::CreateLookAt(cameraPosition, target, Math::Vector3(0.0f, 1.0f, 0.0f)) *
+            Math::Matrix::CreatePerspectiveFieldOfView(Math::ToRadians(45.0f), 1.0f, 0.1f, 100.0f);
+    }
+
+    static Math::MeshletCullStats CullTestMesh(const std::vector<DirectX::CullData>& cullData, const Math::Matrix& modelToWorld, const Math::Vector3& cameraPosition)
+    {
+        std::vector<uint32_t> visibleMeshlets;
+        Math::MeshletCullStats stats = Math::CullMeshlets(cullData, modelToWorld, MakeViewProjection(cameraPosition, Math::Vector3(0.0f)), cameraPosition, visibleMeshlets);
+        WARP_TEST_CHECK(stats.NumMeshlets == cullData.size());
+        WARP_TEST_CHECK(stats.NumMeshlets - stats.NumFrustumCulled - stats.NumBackfaceCulled == visibleMeshlets.size());
+        return stats;
+    }
+
+    WARP_TEST(MeshletCulling_PlaneFacingAwayIsCulled)
+    {
+        // Several meshlets, each of them is flat and thus has the narrowest normal cone
+        std::vector<DirectX::CullData> cullData = ComputeTestCullData(MakePlane(32));
+        WARP_TEST_CHECK(cullData.size() > 1);
+
+        Math::MeshletCullStats stats = CullTestMesh(cullData, Math::Matrix::Identity, Math::Vector3(0.0f, 0.0f, 10.0f));
+        WARP_TEST_CHECK(stats.NumFrustumCulled == 0 && stats.NumBackfaceCulled == 0);
+
+        stats = CullTestMesh(cullData, Math::Matrix::Identity, Math::Vector3(0.0f, 0.0f, -10.0f));
+        WARP_TEST_CHECK(stats.NumFrustumCulled == 0 && stats.NumBackfaceCulled == stats.NumMeshlets);
+
+        // The camera is brought into model space, a plane turned around faces away from the camera in front of it
+        Math::Matrix turnedAround = Math::Matrix::CreateRotationY(Math::ToRadians(180.0f)) * Math::Matrix::CreateScale(3.0f);
+        stats = CullTestMesh(cullData, turnedAround, Math::Vector3(0.0f, 0.0f, 10.0f));
+        WARP_TEST_CHECK(stats.NumBackfaceCulled == stats.NumMeshlets);
+
+        // A camera in the plane of the triangles sees their edges only, which is not enough to cull them
+        stats = CullTestMesh(cullData, Math::Matrix::Identity, Math::Vector3(10.0f, 0.0f, 0.0f));
+        WARP_TEST_CHECK(stats.NumBackfaceCulled == 0);
+
+        // Non-uniform scale distorts normal cones, such instances are only frustum culled
+        stats = CullTestMesh(cullData, Math::Matrix::CreateScale(1.0f, 2.0f, 1.0f), Math::Vector3(0.0f, 0.0f, -10.0f));
+        WARP_TEST_CHECK(stats.NumFrustumCulled == 0 && stats.NumBackfaceCulled == 0);
+    }
+
+    WARP_TEST(MeshletCulling_BoxOutsideOfFrustumIsCulled)
+    {
+        std::vector<DirectX::CullData> cullData = ComputeTestCullData(MakeBox());
+        WARP_TEST_CHECK(cullData.size() == 1);
+
+        // Faces of a box point in every direction, thus it is never backfacing
+        Math::Vector3 cameraPosition = Math::Vector3(0.0f, 0.0f, 10.0f);
+        Math::MeshletCullStats stats = CullTestMesh(cullData, Math::Matrix::Identity, cameraPosition);
+        WARP_TEST_CHECK(stats.NumFrustumCulled == 0 && stats.NumBackfaceCulled == 0);
+
+        // Beside, behind and past the far plane of the camera that looks at the origin
+        const Math::Vector3 outsidePositions[] = {
+            Math::Vector3(50.0f, 0.0f, 0.0f),
+            Math::Vector3(0.0f, -50.0f, 0.0f),
+            Math::Vector3(0.0f, 0.0f, 20.0f),
+            Math::Vector3(0.0f, 0.0f, -200.0f),
+        };
+
+        for (const Math::Vector3& position : outsidePositions)
+        {
+            stats = CullTestMesh(cullData, Math::Matrix::CreateTranslation(position), cameraPosition);
+            WARP_TEST_CHECK(stats.NumFrustumCulled == stats.NumMeshlets);
+        }
+
+        // Bounding spheres are scaled along with the instance, a large box reaches into the frustum again
+        stats = CullTestMesh(cullData, Math::Matrix::CreateScale(100.0f) * Math::Matrix::CreateTranslation(outsidePositions[0]), cameraPosition);
+        WARP_TEST_CHECK(stats.NumFrustumCulled == 0);
+
+        // A sphere crossing the near plane is kept, one that is fully on the side of the camera is culled
+        Math::Frustum frustum = Math::Frustum::FromMatrix(MakeViewProjection(cameraPosition, Math::Vector3(0.0f)));
+        WARP_TEST_CHECK(Math::IsSphereInFrustum(frustum, Math::Vector3(0.0f, 0.0f, 9.85f), 0.1f));
+        WARP_TEST_CHECK(!Math::IsSphereInFrustum(frustum, Math::Vector3(0.0f, 0.0f, 10.05f), 0.1f));
+    }
+
+}
\ No newline at end of file
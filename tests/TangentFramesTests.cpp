@@ -0,0 +1,180 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../src/Math/TangentFrames.h"
+#include "../src/Util/CpuFeatures.h"
+
+namespace Warp
+{
+
+    struct TangentTestMesh
+    {
+        std::vector<Math::Vector3> Positions;
+        std::vector<Math::Vector2> Uvs;
+        std::vector<uint32_t> Indices;
+        uint32_t FirstDegenerateVertex = 0; // Vertices past it are only referenced by triangles with degenerate UVs
+    };
+
+    // Random triangles over shared vertices. Every fourth triangle maps all of its corners to the same UV, some others repeat a vertex,
+    // which makes their UVs collinear
+    static TangentTestMesh MakeTangentTestMesh(uint32_t numTriangles, uint32_t seed)
+    {
+        static constexpr uint32_t NumDegenerateVertices = 4;
+
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> positionDistribution(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> uvDistribution(0.0f, 1.0f);
+
+        TangentTestMesh mesh;
+        uint32_t numVertices = numTriangles + 3;
+        mesh.FirstDegenerateVertex = numVertices;
+        for (uint32_t i = 0; i < numVertices + NumDegenerateVertices; ++i)
+        {
+            mesh.Positions.push_back(Math::Vector3(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator)));
+            mesh.Uvs.push_back(i < numVertices ? Math::Vector2(uvDistribution(generator), uvDistribution(generator)) : Math::Vector2(0.25f, 0.75f));
+        }
+
+        std::uniform_int_distribution<uint32_t> vertexDistribution(0, numVertices - 1);
+        std::uniform_int_distribution<uint32_t> degenerateVertexDistribution(numVertices, numVertices + NumDegenerateVertices - 1);
+        for (uint32_t triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+        {
+            bool isDegenerate = triangleIndex % 4 == 3;
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                mesh.Indices.push_back(isDegenerate ? degenerateVertexDistribution(generator) : vertexDistribution(generator));
+            }
+
+            if (triangleIndex % 7 == 5)
+            {
+                mesh.Indices.back() = mesh.Indices[mesh.Indices.size() - 2];
+            }
+        }
+
+        return mesh;
+    }
+
+    template<typename IndexType>
+    static void CheckTangentKernelsMatch(const TangentTestMesh& mesh, Math::ETangentKernel kernel)
+    {
+        // Tangents of a vertex sum up to a few hundred frames, each of which may be scaled up by a near-degenerate UV mapping
+        static constexpr double Tolerance = 1e-3;
+
+        std::vector<IndexType> indices(mesh.Indices.begin(), mesh.Indices.end());
+        size_t numVertices = mesh.Positions.size();
+
+        std::vector<Math::Vector3> expectedTangents(numVertices);
+        std::vector<Math::Vector3> expectedBitangents(numVertices);
+        WARP_TEST_CHECK(Math::ComputeTangentFrames(mesh.Positions, mesh.Uvs, std::span<const IndexType>(indices), expectedTangents, expectedBitangents,
+            Math::ETangentKernel::Scalar));
+
+        // Previous contents are overwritten, thus garbage must not leak into the results
+        std::vector<Math::Vector3> tangents(numVertices, Math::Vector3(7.0f, 7.0f, 7.0f));
+        std::vector<Math::Vector3> bitangents(numVertices, Math::Vector3(7.0f, 7.0f, 7.0f));
+        WARP_TEST_CHECK(Math::ComputeTangentFrames(mesh.Positions, mesh.Uvs, std::span<const IndexType>(indices), tangents, bitangents, kernel));
+
+        for (size_t vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+        {
+            const Math::Vector3& t = tangents[vertexIndex];
+            const Math::Vector3& b = bitangents[vertexIndex];
+            const Math::Vector3& expectedT = expectedTangents[vertexIndex];
+            const Math::Vector3& expectedB = expectedBitangents[vertexIndex];
+            WARP_TEST_CHECK(Test::IsNear(t.x, expectedT.x, Tolerance) && Test::IsNear(t.y, expectedT.y, Tolerance) && Test::IsNear(t.z, expectedT.z, Tolerance));
+            WARP_TEST_CHECK(Test::IsNear(b.x, expectedB.x, Tolerance) && Test::IsNear(b.y, expectedB.y, Tolerance) && Test::IsNear(b.z, expectedB.z, Tolerance));
+
+            if (vertexIndex >= mesh.FirstDegenerateVertex)
+            {
+                WARP_TEST_CHECK(t.x == 0.0f && t.y == 0.0f && t.z == 0.0f);
+                WARP_TEST_CHECK(b.x == 0.0f && b.y == 0.0f && b.z == 0.0f);
+            }
+        }
+    }
+
+    WARP_TEST(TangentFrames_SimdKernelsMatchScalarKernel)
+    {
+        // SIMD kernels process 4 or 8 triangles at once, thus counts around their widths exercise the remainder paths
+        static constexpr uint32_t TriangleCounts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 250, 1001, 4099 };
+
+        std::vector<Math::ETangentKernel> kernels = { Math::ETangentKernel::Sse };
+        if (GetCpuFeatures().Avx2)
+        {
+            kernels.push_back(Math::ETangentKernel::Avx2);
+        }
+        else
+        {
+            std::printf("    AVX2 is not supported by this CPU, only the SSE kernel is checked\n");
+        }
+
+        for (uint32_t numTriangles : TriangleCounts)
+        {
+            TangentTestMesh mesh = MakeTangentTestMesh(numTriangles, numTriangles + 1);
+            for (Math::ETangentKernel kernel : kernels)
+            {
+                CheckTangentKernelsMatch<uint16_t>(mesh, kernel);
+                CheckTangentKernelsMatch<uint32_t>(mesh, kernel);
+            }
+        }
+    }
+
+    template<typename IndexType>
+    static void CheckOutOfRangeIndices(Math::ETangentKernel kernel)
+    {
+        static constexpr IndexType UnusedIndex = std::numeric_limits<IndexType>::max();
+
+        // Enough triangles for full SIMD batches, every triangle but the last one is valid
+        TangentTestMesh mesh = MakeTangentTestMesh(33, 7);
+        const size_t numVertices = mesh.Positions.size();
+        std::vector<IndexType> indices(mesh.Indices.begin(), mesh.Indices.end());
+
+        // An index past the vertices (or far past them, where a gather would fault) rejects the whole mesh, outputs stay untouched
+        for (size_t outOfRange : { numVertices, size_t(UnusedIndex) - 1 })
+        {
+            std::vector<IndexType> badIndices = indices;
+            badIndices[badIndices.size() - 2] = static_cast<IndexType>(outOfRange);
+
+            std::vector<Math::Vector3> tangents(numVertices, Math::Vector3(7.0f, 7.0f, 7.0f));
+            std::vector<Math::Vector3> bitangents(numVertices, Math::Vector3(7.0f, 7.0f, 7.0f));
+            WARP_TEST_CHECK(!Math::ComputeTangentFrames(mesh.Positions, mesh.Uvs, std::span<const IndexType>(badIndices), tangents, bitangents, kernel));
+            WARP_TEST_CHECK(tangents[0].x == 7.0f && bitangents[numVertices - 1].z == 7.0f);
+        }
+
+        // Triangles with the unused index are skipped, the rest matches frames of a mesh without them
+        std::vector<IndexType> unusedIndices = indices;
+        std::vector<IndexType> expectedIndices = indices;
+        unusedIndices[4] = UnusedIndex;
+        expectedIndices.erase(expectedIndices.begin() + 3, expectedIndices.begin() + 6);
+
+        std::vector<Math::Vector3> expectedTangents(numVertices);
+        std::vector<Math::Vector3> expectedBitangents(numVertices);
+        WARP_TEST_CHECK(Math::ComputeTangentFrames(mesh.Positions, mesh.Uvs, std::span<const IndexType>(expectedIndices), expectedTangents, expectedBitangents,
+            Math::ETangentKernel::Scalar));
+
+        std::vector<Math::Vector3> tangents(numVertices);
+        std::vector<Math::Vector3> bitangents(numVertices);
+        WARP_TEST_CHECK(Math::ComputeTangentFrames(mesh.Positions, mesh.Uvs, std::span<const IndexType>(unusedIndices), tangents, bitangents, kernel));
+        for (size_t vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+        {
+            WARP_TEST_CHECK(Test::IsNear(tangents[vertexIndex].x, expectedTangents[vertexIndex].x, 1e-3) &&
+                Test::IsNear(bitangents[vertexIndex].y, expectedBitangents[vertexIndex].y, 1e-3));
+        }
+    }
+
+    WARP_TEST(TangentFrames_OutOfRangeIndicesAreRejected)
+    {
+        std::vector<Math::ETangentKernel> kernels = { Math::ETangentKernel::Scalar, Math::ETangentKernel::Sse };
+        if (GetCpuFeatures().Avx2)
+        {
+            kernels.push_back(Math::ETangentKernel::Avx2);
+        }
+
+        for (Math::ETangentKernel kernel : kernels)
+        {
+            CheckOutOfRangeIndices<uint16_t>(kernel);
+            CheckOutOfRangeIndices<uint32_t>(kernel);
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+// Minimal test registry of WarpTests. Tests register themselves with WARP_TEST and report failures with WARP_TEST_CHECK,
+// which logs the expression and lets the test go on, thus a single run reports every failed check
+namespace Warp::Test
+{
+
+    using TestFunc = void(*)();
+
+    struct TestCase
+    {
+        const char* Name;
+        TestFunc Func;
+    };
+
+    std::vector<TestCase>& GetTestCases();
+    void ReportFailure(const char* expression, const char* file, int line);
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* name, TestFunc func) { GetTestCases().push_back(TestCase{ .Name = name, .Func = func }); }
+    };
+
+    inline bool IsNear(double a, double b, double tolerance) { return std::abs(a - b) <= tolerance; }
+
+    // Empty folder for files written by a test, it is removed along with them once the test is done
+    class ScopedTestFolder
+    {
+    public:
+        explicit ScopedTestFolder(const char* name)
+            : m_path(std::filesystem::temp_directory_path() / "WarpTests" / name)
+        {
+            std::filesystem::remove_all(m_path);
+            std::filesystem::create_directories(m_path);
+        }
+
+        ~ScopedTestFolder()
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(m_path, ec);
+        }
+
+        std::filesystem::path operator/(const char* filename) const { return m_path / filename; }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+}
+
+#define WARP_TEST(Name)\
+    static void WarpTest_##Name();\
+    static ::Warp::Test::TestRegistrar s_warpTestRegistrar_##Name(#Name, &WarpTest_##Name);\
+    static void WarpTest_##Name()
+
+#define WARP_TEST_CHECK(expression)\
+    do { if (!(expression)) { ::Warp::Test::ReportFailure(#expression, __FILE__, __LINE__); } } while (false)
\ No newline at end of file
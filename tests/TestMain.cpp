@@ -0,0 +1,67 @@
+#include "Test.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "../src/Util/Logger.h"
+#include "../src/WinWrap.h"
+
+namespace Warp::Test
+{
+
+    static std::atomic<uint32_t> s_numFailures = 0;
+
+    std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    void ReportFailure(const char* expression, const char* file, int line)
+    {
+        // Checks may fail on worker threads of stress tests
+        ++s_numFailures;
+        std::printf("    FAILED: %s at %s:%d\n", expression, std::filesystem::path(file).filename().string().c_str(), line);
+    }
+
+}
+
+// Runs every test, or only those whose name contains the first argument. Returns the number of failed tests
+int main(int argc, char** argv)
+{
+    using namespace Warp;
+
+    // Same setup as WinMain, image loaders decode through WIC
+    WinWrap::ScopedCOMLibrary comLibrary;
+    if (Log::Logger::Create())
+    {
+        Log::Logger::Get()->SetSeverity(Log::ESeverity::Warn);
+    }
+
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int numFailedTests = 0;
+    int numRunTests = 0;
+    for (const Test::TestCase& testCase : Test::GetTestCases())
+    {
+        if (filter && !std::strstr(testCase.Name, filter))
+        {
+            continue;
+        }
+
+        std::printf("[ RUN  ] %s\n", testCase.Name);
+        uint32_t numFailuresBefore = Test::s_numFailures;
+        testCase.Func();
+
+        bool hasFailed = Test::s_numFailures != numFailuresBefore;
+        std::printf("[ %s ] %s\n", hasFailed ? "FAIL" : " OK ", testCase.Name);
+        numFailedTests += hasFailed ? 1 : 0;
+        ++numRunTests;
+    }
+
+    std::printf("%d of %d tests failed\n", numFailedTests, numRunTests);
+
+    Log::Logger::Delete();
+    return numFailedTests;
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "Test.h"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/Assets/AssetManager.h"
+#include "../src/Assets/Importers/TextureImporter.h"
+
+namespace Warp
+{
+
+    // Uncompressed 4x4 24-bit .bmp, texels are filled with value. Every image has the same size, thus only hashes tell them apart
+    static std::vector<std::byte> MakeBmpBytes(uint8_t value)
+    {
+        static constexpr uint32_t Size = 4;
+        static constexpr uint32_t NumPixelBytes = Size * Size * 3;
+        static constexpr uint32_t PixelsOffset = 54;
+
+        std::vector<std::byte> bytes;
+        auto write = [&bytes](auto word)
+            {
+                size_t offset = bytes.size();
+                bytes.resize(offset + sizeof(word));
+                std::memcpy(bytes.data() + offset, &word, sizeof(word));
+            };
+
+        write(uint16_t(0x4D42)); write(uint32_t(PixelsOffset + NumPixelBytes)); write(uint32_t(0)); write(PixelsOffset);
+        write(uint32_t(40)); write(int32_t(Size)); write(int32_t(Size)); write(uint16_t(1)); write(uint16_t(24));
+        write(uint32_t(0)); write(NumPixelBytes); write(int32_t(2835)); write(int32_t(2835)); write(uint32_t(0)); write(uint32_t(0));
+        bytes.resize(bytes.size() + NumPixelBytes, std::byte(value));
+        return bytes;
+    }
+
+    static void WriteFileBytes(const std::filesystem::path& filepath, const std::vector<std::byte>& bytes)
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    WARP_TEST(TextureImporter_ConcurrentImportsOfIdenticalSourcesShareTexture)
+    {
+        static constexpr uint32_t NumThreads = 8;
+        static constexpr uint32_t NumCopies = 4;
+
+        Test::ScopedTestFolder folder("TextureImporter_Deduplication");
+        const std::vector<std::byte> bytes = MakeBmpBytes(0x40);
+        const std::vector<std::byte> otherBytes = MakeBmpBytes(0x80);
+
+        std::vector<std::string> copyPaths;
+        for (uint32_t i = 0; i < NumCopies; ++i)
+        {
+            copyPaths.push_back((folder / std::format("Copy{}.bmp", i).c_str()).string());
+            WriteFileBytes(copyPaths.back(), bytes);
+        }
+
+        const std::string otherPath = (folder / "Other.bmp").string();
+        const std::string mipsPath = (folder / "Mips.bmp").string();
+        WriteFileBytes(otherPath, otherBytes);
+        WriteFileBytes(mipsPath, bytes);
+
+        AssetManager manager;
+        std::vector<AssetProxy> textures;
+        {
+            TextureImporter importer(&manager);
+
+            // Threads import every copy in a different order, thus they race for both the filepaths and the content
+            std::vector<std::vector<AssetProxy>> proxies(NumThreads);
+            std::vector<std::thread> threads;
+            for (uint32_t threadIndex = 0; threadIndex < NumThreads; ++threadIndex)
+            {
+                threads.emplace_back([&, threadIndex]
+                    {
+                        for (uint32_t i = 0; i < NumCopies; ++i)
+                        {
+                            proxies[threadIndex].push_back(importer.ImportFromFileAsync(copyPaths[(i + threadIndex) % NumCopies], TextureImportDesc()));
+                        }
+                        proxies[threadIndex].push_back(importer.ImportFromFileAsync(otherPath, TextureImportDesc()));
+                    });
+            }
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            const AssetProxy texture = proxies[0][0];
+            const AssetProxy otherTexture = proxies[0][NumCopies];
+            WARP_TEST_CHECK(manager.IsValid<TextureAsset>(texture) && manager.IsValid<TextureAsset>(otherTexture));
+            WARP_TEST_CHECK(texture.ID != otherTexture.ID);
+            for (const std::vector<AssetProxy>& threadProxies : proxies)
+            {
+                for (uint32_t i = 0; i < NumCopies; ++i)
+                {
+                    WARP_TEST_CHECK(threadProxies[i].ID == texture.ID);
+                }
+                WARP_TEST_CHECK(threadProxies[NumCopies].ID == otherTexture.ID);
+            }
+
+            // Embedded images are compared by their bytes as well
+            auto storage = std::make_shared<std::vector<std::byte>>(bytes);
+            AssetProxy embedded = importer.ImportFromMemoryAsync(TextureImporter::MakeEmbeddedImagePath("Scene.glb", 0), EAssetFormat::Bmp,
+                *storage, storage, TextureImportDesc());
+            WARP_TEST_CHECK(embedded.ID == texture.ID);
+
+            // Same bytes processed differently are another texture
+            AssetProxy mipsTexture = importer.ImportFromFileAsync(mipsPath, TextureImportDesc{ .GenerateMips = true });
+            WARP_TEST_CHECK(manager.IsValid<TextureAsset>(mipsTexture) && mipsTexture.ID != texture.ID);
+
+            // Every copy but the first one and the embedded image are duplicates, whichever thread got to import first
+            TextureImporter::DeduplicationStats stats = importer.GetDeduplicationStats();
+            WARP_TEST_CHECK(stats.NumDuplicates == NumCopies);
+            WARP_TEST_CHECK(stats.SourceBytesSaved == NumCopies * bytes.size());
+            WARP_TEST_CHECK(stats.TextureBytesSaved == 0);
+
+            textures = { texture, otherTexture, mipsTexture };
+        }
+
+        // Decoded images are dropped along with the importer, nothing is uploaded without a renderer
+        for (AssetProxy& texture : textures)
+        {
+            texture = manager.DestroyAsset(texture);
+        }
+    }
+
+    WARP_TEST(TextureImporter_RemovedTexturesAreNotDuplicatesAnymore)
+    {
+        Test::ScopedTestFolder folder("TextureImporter_Removal");
+        const std::vector<std::byte> bytes = MakeBmpBytes(0x40);
+
+        std::vector<std::string> copyPaths;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            copyPaths.push_back((folder / std::format("Copy{}.bmp", i).c_str()).string());
+            WriteFileBytes(copyPaths.back(), bytes);
+        }
+
+        AssetManager manager;
+        TextureImporter importer(&manager);
+        AssetProxy texture = importer.ImportFromFileAsync(copyPaths[0], TextureImportDesc());
+        WARP_TEST_CHECK(importer.ImportFromFileAsync(copyPaths[1], TextureImportDesc()).ID == texture.ID);
+        importer.WaitForPendingImports();
+        WARP_TEST_CHECK(importer.GetDeduplicationStats().NumDuplicates == 1);
+
+        // Same order as in AssetReleaseQueue, the importer forgets the texture right before it is destroyed
+        const uint32_t removedID = texture.ID;
+        importer.RemoveTexture(texture);
+        texture = manager.DestroyAsset(texture);
+
+        // Another copy is imported on its own, while duplicates of the removed texture still count
+        AssetProxy reimported = importer.ImportFromFileAsync(copyPaths[2], TextureImportDesc());
+        WARP_TEST_CHECK(manager.IsValid<TextureAsset>(reimported) && reimported.ID != removedID);
+        importer.WaitForPendingImports();
+
+        TextureImporter::DeduplicationStats stats = importer.GetDeduplicationStats();
+        WARP_TEST_CHECK(stats.NumDuplicates == 1 && stats.SourceBytesSaved == bytes.size());
+
+        // Textures the importer does not know about are ignored, thus removing twice is harmless
+        importer.RemoveTexture(reimported);
+        importer.RemoveTexture(reimported);
+        WARP_TEST_CHECK(importer.GetDeduplicationStats().NumDuplicates == 1);
+        reimported = manager.DestroyAsset(reimported);
+    }
+
+    WARP_TEST(TextureImporter_WaitForPendingImportsDrainsEveryBatch)
+    {
+        // More images than fit into the ready queue, thus decoding workers block until batches are taken from it
+        static constexpr uint32_t NumImages = 3 * TextureImporter::MaxNumReadyImages + 1;
+
+        Test::ScopedTestFolder folder("TextureImporter_Batches");
+        std::vector<std::string> paths;
+        for (uint32_t i = 0; i < NumImages; ++i)
+        {
+            paths.push_back((folder / std::format("Image{}.bmp", i).c_str()).string());
+            WriteFileBytes(paths.back(), MakeBmpBytes(static_cast<uint8_t>(i)));
+        }
+
+        // Broken source is picked up by the uploader as well, it just stays a placeholder
+        const std::string brokenPath = (folder / "Broken.bmp").string();
+        WriteFileBytes(brokenPath, std::vector<std::byte>(64, std::byte(0xCD)));
+
+        AssetManager manager;
+        std::vector<AssetProxy> textures;
+        {
+            TextureImporter importer(&manager);
+            WARP_TEST_CHECK(!importer.HasPendingImports() && importer.UploadReadyTextures() == 0);
+
+            for (const std::string& path : paths)
+            {
+                textures.push_back(importer.ImportFromFileAsync(path, TextureImportDesc{ .GenerateMips = true }));
+            }
+            textures.push_back(importer.ImportFromFileAsync(brokenPath, TextureImportDesc()));
+            WARP_TEST_CHECK(importer.HasPendingImports());
+
+            // Returns only once every image went through an upload batch, nothing is left for the next one
+            importer.WaitForPendingImports();
+            WARP_TEST_CHECK(!importer.HasPendingImports());
+            WARP_TEST_CHECK(importer.UploadReadyTextures() == 0);
+            WARP_TEST_CHECK(importer.GetDeduplicationStats().NumDuplicates == 0);
+
+            // Without a renderer nothing becomes resident, the placeholders stay valid though
+            for (size_t i = 0; i < textures.size(); ++i)
+            {
+                WARP_TEST_CHECK(manager.IsValid<TextureAsset>(textures[i]));
+                WARP_TEST_CHECK(i == 0 || textures[i].ID != textures[i - 1].ID);
+                if (manager.IsValid<TextureAsset>(textures[i]))
+                {
+                    WARP_TEST_CHECK(!manager.GetAs<TextureAsset>(textures[i])->IsResident());
+                }
+            }
+
+            // Importing the same file again returns the same texture without another pending import
+            WARP_TEST_CHECK(importer.ImportFromFileAsync(paths[0], TextureImportDesc{ .GenerateMips = true }).ID == textures[0].ID);
+            WARP_TEST_CHECK(!importer.HasPendingImports());
+        }
+
+        for (AssetProxy& texture : textures)
+        {
+            texture = manager.DestroyAsset(texture);
+        }
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "../src/Renderer/TextureStreamer.h"
+
+namespace Warp
+{
+
+    // Records uploads instead of creating textures, thus residency is decided by the streamer alone
+    class MockTextureStreamingBackend final : public TextureStreamingBackend
+    {
+    public:
+        struct Upload
+        {
+            uint32_t AssetID;
+            uint32_t FirstMip;
+            size_t NumMips;
+        };
+
+        void BeginUploads() override
+        {
+            WARP_TEST_CHECK(!IsUploading);
+            IsUploading = true;
+        }
+
+        void EndUploads() override
+        {
+            WARP_TEST_CHECK(IsUploading);
+            IsUploading = false;
+        }
+
+        bool UploadMips(AssetProxy proxy, const ImageLoader::Image& image, uint32_t firstMip, ETextureUsage) override
+        {
+            WARP_TEST_CHECK(IsUploading);
+            Uploads.push_back(Upload{ .AssetID = proxy.ID, .FirstMip = firstMip, .NumMips = image.GetMetadata().mipLevels });
+            return true;
+        }
+
+        std::vector<Upload> Uploads;
+        bool IsUploading = false;
+    };
+
+    static constexpr uint32_t StreamedTextureSize = 1024;
+    static constexpr uint32_t StreamedTextureMips = 11;
+    static constexpr uint32_t StreamedInitialFirstMip = 4; // 64x64 with the default TextureStreamingDesc::MaxInitialMipSize
+
+    static AssetProxy MakeStreamedProxy(uint32_t ID)
+    {
+        AssetProxy proxy;
+        proxy.ID = ID;
+        proxy.Index = ID;
+        proxy.Type = EAssetType::Texture;
+        return proxy;
+    }
+
+    static ImageLoader::Image MakeStreamedImage()
+    {
+        ImageLoader::Image image;
+        image.Filepath = "Textures/Streamed.png";
+        WARP_TEST_CHECK(SUCCEEDED(image.DxImage.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, StreamedTextureSize, StreamedTextureSize, 1, 0)));
+        return image;
+    }
+
+    static size_t GetStreamedSizeOfMips(uint32_t firstMip)
+    {
+        size_t size = 0;
+        for (uint32_t mip = firstMip; mip < StreamedTextureMips; ++mip)
+        {
+            size_t mipSize = std::max<size_t>(StreamedTextureSize >> mip, 1);
+            size += mipSize * mipSize * 4;
+        }
+        return size;
+    }
+
+    // Updates until no read is in flight anymore. request is called before every update, as the renderer does every frame
+    static void UpdateUntilIdle(TextureStreamer& streamer, const std::function<void()>& request)
+    {
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            request();
+            streamer.Update();
+
+            TextureStreamingStats stats = streamer.GetStats();
+            WARP_TEST_CHECK(stats.NumPendingReads <= streamer.GetDesc().MaxPendingReads);
+            if (stats.NumPendingReads == 0)
+            {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        WARP_TEST_CHECK(!"Reads of the texture streamer did not finish");
+    }
+
+    WARP_TEST(TextureStreamer_ResidencyFollowsRequestedScreenSize)
+    {
+        MockTextureStreamingBackend* backend = new MockTextureStreamingBackend();
+        TextureStreamer streamer(std::unique_ptr<TextureStreamingBackend>(backend), TextureStreamingDesc{ .MipBias = 0.0f });
+
+        AssetProxy proxy = MakeStreamedProxy(1);
+        ImageLoader::Image initialMips = streamer.AddTexture(proxy, MakeStreamedImage(), eTextureUsage_Default);
+        WARP_TEST_CHECK(initialMips.GetMetadata().width == 64 && initialMips.GetMetadata().mipLevels == StreamedTextureMips - StreamedInitialFirstMip);
+        WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxy) == StreamedInitialFirstMip);
+        WARP_TEST_CHECK(streamer.GetStats().ResidentSize == GetStreamedSizeOfMips(StreamedInitialFirstMip));
+
+        // A texel per pixel on a surface as large as the texture
+        UpdateUntilIdle(streamer, [&] { streamer.RequestScreenSize(proxy, static_cast<float>(StreamedTextureSize)); });
+        WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxy) == 0);
+        WARP_TEST_CHECK(!backend->Uploads.empty() && backend->Uploads.back().FirstMip == 0 && backend->Uploads.back().NumMips == StreamedTextureMips);
+        WARP_TEST_CHECK(streamer.GetStats().ResidentSize == GetStreamedSizeOfMips(0));
+
+        // Mips finer than needed are dropped, the coarser ones are uploaded again
+        UpdateUntilIdle(streamer, [&] { streamer.RequestScreenSize(proxy, StreamedTextureSize / 4.0f); });
+        WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxy) == 2);
+        WARP_TEST_CHECK(backend->Uploads.back().FirstMip == 2 && backend->Uploads.back().NumMips == StreamedTextureMips - 2);
+        WARP_TEST_CHECK(streamer.GetStats().ResidentSize == GetStreamedSizeOfMips(2));
+
+        // Textures that are no longer streamed are ignored, reads in flight included
+        streamer.RequestScreenSize(proxy, static_cast<float>(StreamedTextureSize));
+        streamer.Update();
+        streamer.RemoveTexture(proxy);
+        WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxy) == 0 && streamer.GetStats().NumTextures == 0);
+
+        size_t numUploads = backend->Uploads.size();
+        UpdateUntilIdle(streamer, [&] { streamer.RequestScreenSize(proxy, static_cast<float>(StreamedTextureSize)); });
+        WARP_TEST_CHECK(backend->Uploads.size() == numUploads);
+    }
+
+    WARP_TEST(TextureStreamer_DropsAndEvictionsRespectPendingReadLimit)
+    {
+        static constexpr uint32_t NumTextures = 6;
+
+        MockTextureStreamingBackend* backend = new MockTextureStreamingBackend();
+        TextureStreamer streamer(std::unique_ptr<TextureStreamingBackend>(backend), TextureStreamingDesc{ .MipBias = 0.0f, .MaxPendingReads = 2 });
+
+        std::vector<AssetProxy> proxies;
+        for (uint32_t i = 0; i < NumTextures; ++i)
+        {
+            proxies.push_back(MakeStreamedProxy(i + 1));
+            streamer.AddTexture(proxies.back(), MakeStreamedImage(), eTextureUsage_Default);
+        }
+
+        auto requestAll = [&](float screenSize)
+            {
+                for (const AssetProxy& proxy : proxies)
+                {
+                    streamer.RequestScreenSize(proxy, screenSize);
+                }
+            };
+
+        requestAll(static_cast<float>(StreamedTextureSize));
+        streamer.Update();
+        WARP_TEST_CHECK(streamer.GetStats().NumPendingReads == 2);
+
+        UpdateUntilIdle(streamer, [&] { requestAll(static_cast<float>(StreamedTextureSize)); });
+        for (const AssetProxy& proxy : proxies)
+        {
+            WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxy) == 0);
+        }
+
+        // Every texture drops its finest mips at once, which takes a read each
+        requestAll(StreamedTextureSize / 2.0f);
+        streamer.Update();
+        WARP_TEST_CHECK(streamer.GetStats().NumPendingReads == 2);
+
+        UpdateUntilIdle(streamer, [&] { requestAll(StreamedTextureSize / 2.0f); });
+        for (const AssetProxy& proxy : proxies)
+        {
+            WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxy) == 1);
+        }
+
+        // Lowering the budget evicts finest mips, the same limit applies. Equally important textures are evicted in no particular order
+        const size_t budget = NumTextures * GetStreamedSizeOfMips(2);
+        streamer.SetMemoryBudget(budget);
+        requestAll(StreamedTextureSize / 2.0f);
+        streamer.Update();
+        WARP_TEST_CHECK(streamer.GetStats().NumPendingReads == 2);
+
+        UpdateUntilIdle(streamer, [&] { requestAll(StreamedTextureSize / 2.0f); });
+        WARP_TEST_CHECK(streamer.GetStats().ResidentSize <= budget);
+        WARP_TEST_CHECK(streamer.GetStats().ResidentSize >= NumTextures * GetStreamedSizeOfMips(StreamedInitialFirstMip));
+    }
+
+    WARP_TEST(TextureStreamer_BudgetKeepsMostImportantTextures)
+    {
+        static constexpr uint32_t NumTextures = 4;
+
+        // Two full mip chains fit along with the initial mips of the others
+        const size_t budget = 2 * GetStreamedSizeOfMips(0) + (NumTextures - 2) * GetStreamedSizeOfMips(StreamedInitialFirstMip);
+
+        MockTextureStreamingBackend* backend = new MockTextureStreamingBackend();
+        TextureStreamer streamer(std::unique_ptr<TextureStreamingBackend>(backend),
+            TextureStreamingDesc{ .MemoryBudget = budget, .NumUnusedUpdatesToEvict = 3, .MipBias = 0.0f });
+
+        std::vector<AssetProxy> proxies;
+        for (uint32_t i = 0; i < NumTextures; ++i)
+        {
+            proxies.push_back(MakeStreamedProxy(i + 1));
+            streamer.AddTexture(proxies.back(), MakeStreamedImage(), eTextureUsage_Default);
+        }
+
+        // Every texture wants its full chain, those that cover more of the screen get it
+        auto requestAll = [&]
+            {
+                for (uint32_t i = 0; i < NumTextures; ++i)
+                {
+                    streamer.RequestScreenSize(proxies[i], static_cast<float>(StreamedTextureSize << i));
+                }
+            };
+
+        UpdateUntilIdle(streamer, requestAll);
+        TextureStreamingStats stats = streamer.GetStats();
+        WARP_TEST_CHECK(stats.ResidentSize <= budget);
+        WARP_TEST_CHECK(stats.RequestedSize == NumTextures * GetStreamedSizeOfMips(0));
+        WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxies[3]) == 0 && streamer.GetResidentFirstMip(proxies[2]) == 0);
+        WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxies[1]) > 0 && streamer.GetResidentFirstMip(proxies[0]) > 0);
+
+        // Textures that are no longer requested fall back to their initial mips after a few updates, making room for the others
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            UpdateUntilIdle(streamer, [&] { streamer.RequestScreenSize(proxies[0], static_cast<float>(StreamedTextureSize)); });
+        }
+
+        WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxies[0]) == 0);
+        for (uint32_t i = 1; i < NumTextures; ++i)
+        {
+            WARP_TEST_CHECK(streamer.GetResidentFirstMip(proxies[i]) == StreamedInitialFirstMip);
+        }
+        WARP_TEST_CHECK(streamer.GetStats().ResidentSize == GetStreamedSizeOfMips(0) + (NumTextures - 1) * GetStreamedSizeOfMips(StreamedInitialFirstMip));
+    }
+
+}
\ No newline at end of file
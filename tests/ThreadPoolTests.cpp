@@ -0,0 +1,97 @@
+#include "Test.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "../src/Util/ThreadPool.h"
+
+namespace Warp
+{
+
+    WARP_TEST(ThreadPool_ParallelForVisitsEveryIndexOnce)
+    {
+        static constexpr uint32_t Count = 10000;
+
+        ThreadPool threadPool(4);
+        WARP_TEST_CHECK(threadPool.GetNumThreads() == 4);
+
+        std::vector<std::atomic<uint32_t>> numVisits(Count);
+        threadPool.ParallelFor(Count, [&numVisits](uint32_t index) { numVisits[index].fetch_add(1, std::memory_order_relaxed); });
+        for (const std::atomic<uint32_t>& visits : numVisits)
+        {
+            WARP_TEST_CHECK(visits.load() == 1);
+        }
+
+        // Fewer iterations than workers, and none at all
+        std::atomic<uint32_t> numCalls = 0;
+        threadPool.ParallelFor(2, [&numCalls](uint32_t) { ++numCalls; });
+        threadPool.ParallelFor(0, [&numCalls](uint32_t) { ++numCalls; });
+        WARP_TEST_CHECK(numCalls == 2);
+    }
+
+    WARP_TEST(ThreadPool_ResultsStoredByIndexAreDeterministic)
+    {
+        static constexpr uint32_t Count = 4096;
+
+        // Iterations differ a lot in cost, so workers finish them in a different order on every run
+        auto compute = [](uint32_t index)
+            {
+                uint64_t value = index;
+                for (uint32_t i = 0; i < (index % 64) * 100; ++i)
+                {
+                    value = value * 6364136223846793005ull + 1442695040888963407ull;
+                }
+                return value;
+            };
+
+        std::vector<uint64_t> expected(Count);
+        for (uint32_t index = 0; index < Count; ++index)
+        {
+            expected[index] = compute(index);
+        }
+
+        for (uint32_t numThreads : { 1u, 3u, 8u })
+        {
+            ThreadPool threadPool(numThreads);
+            for (uint32_t run = 0; run < 4; ++run)
+            {
+                std::vector<uint64_t> results(Count);
+                threadPool.ParallelFor(Count, [&](uint32_t index) { results[index] = compute(index); });
+                WARP_TEST_CHECK(results == expected);
+            }
+        }
+    }
+
+    WARP_TEST(ThreadPool_SubmittedTasksRunInOrderAndWaitIdleWaitsForThem)
+    {
+        // A single worker executes tasks in the order they were submitted
+        std::vector<uint32_t> order;
+        {
+            ThreadPool threadPool(1);
+            for (uint32_t i = 0; i < 100; ++i)
+            {
+                threadPool.Submit([&order, i] { order.push_back(i); });
+            }
+            threadPool.WaitIdle();
+            WARP_TEST_CHECK(order.size() == 100);
+        }
+
+        for (uint32_t i = 0; i < order.size(); ++i)
+        {
+            WARP_TEST_CHECK(order[i] == i);
+        }
+
+        // Tasks that are still queued run before the pool is destroyed
+        std::atomic<uint32_t> numRun = 0;
+        {
+            ThreadPool threadPool(2);
+            for (uint32_t i = 0; i < 1000; ++i)
+            {
+                threadPool.Submit([&numRun] { ++numRun; });
+            }
+        }
+        WARP_TEST_CHECK(numRun == 1000);
+    }
+
+}
\ No newline at end of file
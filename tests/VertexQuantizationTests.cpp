@@ -0,0 +1,158 @@
+#include "Test.h"
+
+#include <cstring>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "../src/Assets/VertexQuantization.h"
+
+namespace Warp
+{
+
+    // Float streams of random vertices along with their quantized counterparts, viewed as submeshes the same way the mesh importer does it
+    struct QuantizationTestMesh
+    {
+        std::vector<Math::Vector3> Positions;
+        std::vector<Math::Vector3> Normals;
+        std::vector<Math::Vector2> TexCoords;
+        std::vector<Math::Vector3> Tangents;
+        std::vector<Math::Vector3> Bitangents;
+
+        Submesh::AttributeArray<std::vector<std::byte>> FloatStreams;
+        Submesh::AttributeArray<std::vector<std::byte>> QuantizedStreams;
+        PositionBounds Bounds;
+    };
+
+    template<typename T>
+    static std::vector<std::byte> MakeFloatStream(const std::vector<T>& values)
+    {
+        std::vector<std::byte> stream(values.size() * sizeof(T));
+        std::memcpy(stream.data(), values.data(), stream.size());
+        return stream;
+    }
+
+    // Positions lie on a plane of constant z, thus one axis of the bounds is flat. Frames are orthonormal, every other one is mirrored
+    static QuantizationTestMesh MakeQuantizationTestMesh(uint32_t numVertices, uint32_t seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> positionDistribution(-5.0f, 5.0f);
+        std::uniform_real_distribution<float> uvDistribution(0.0f, 1.0f);
+        std::normal_distribution<float> directionDistribution;
+        auto makeDirection = [&]
+            {
+                Math::Vector3 direction = Math::Vector3(directionDistribution(generator), directionDistribution(generator), directionDistribution(generator));
+                direction.Normalize();
+                return direction;
+            };
+
+        QuantizationTestMesh mesh;
+        for (uint32_t i = 0; i < numVertices; ++i)
+        {
+            Math::Vector3 normal = makeDirection();
+            Math::Vector3 tangent = normal.Cross(makeDirection());
+            tangent.Normalize();
+
+            mesh.Positions.push_back(Math::Vector3(positionDistribution(generator), positionDistribution(generator) * 0.1f, 1.0f));
+            mesh.Normals.push_back(normal);
+            mesh.TexCoords.push_back(Math::Vector2(uvDistribution(generator), uvDistribution(generator)));
+            mesh.Tangents.push_back(tangent);
+            mesh.Bitangents.push_back(normal.Cross(tangent) * (i % 2 ? -1.0f : 1.0f));
+        }
+
+        mesh.FloatStreams[eVertexAttribute_Positions] = MakeFloatStream(mesh.Positions);
+        mesh.FloatStreams[eVertexAttribute_Normals] = MakeFloatStream(mesh.Normals);
+        mesh.FloatStreams[eVertexAttribute_TextureCoords] = MakeFloatStream(mesh.TexCoords);
+        mesh.FloatStreams[eVertexAttribute_Tangents] = MakeFloatStream(mesh.Tangents);
+        mesh.FloatStreams[eVertexAttribute_Bitangents] = MakeFloatStream(mesh.Bitangents);
+
+        mesh.Bounds = ComputePositionBounds(mesh.Positions);
+        EncodePositionsUnorm16(mesh.Positions, mesh.Bounds, mesh.QuantizedStreams[eVertexAttribute_Positions]);
+        EncodeUnitVectorsOct16(mesh.Normals, mesh.QuantizedStreams[eVertexAttribute_Normals]);
+        EncodeTexCoordsHalf(mesh.TexCoords, mesh.QuantizedStreams[eVertexAttribute_TextureCoords]);
+        EncodeUnitVectorsOct16(mesh.Tangents, mesh.QuantizedStreams[eVertexAttribute_Tangents]);
+        EncodeBitangentSigns(mesh.Normals, mesh.Tangents, mesh.Bitangents, mesh.QuantizedStreams[eVertexAttribute_Bitangents]);
+        return mesh;
+    }
+
+    static Submesh MakeQuantizationTestView(const QuantizationTestMesh& mesh, bool isQuantized)
+    {
+        Submesh view;
+        view.NumVertices = static_cast<uint32_t>(mesh.Positions.size());
+        for (size_t attributeIndex = 0; attributeIndex < eVertexAttribute_NumAttributes; ++attributeIndex)
+        {
+            EVertexAttribute attribute = static_cast<EVertexAttribute>(attributeIndex);
+            view.AttributeEncodings[attribute] = isQuantized ? GetQuantizedEncoding(attribute) : eVertexEncoding_Float;
+            view.AttributeStrides[attribute] = GetVertexStride(attribute, view.AttributeEncodings[attribute]);
+            view.Attributes[attribute] = isQuantized ? mesh.QuantizedStreams[attribute] : mesh.FloatStreams[attribute];
+        }
+
+        if (isQuantized)
+        {
+            view.PositionsMin = mesh.Bounds.Min;
+            view.PositionsExtent = mesh.Bounds.Extent;
+        }
+        return view;
+    }
+
+    WARP_TEST(VertexQuantization_ScalarEncodingsRoundTrip)
+    {
+        // Axes and the zero vector hit the folds and the degenerate case of the octahedral mapping
+        const Math::Vector3 axes[] = {
+            Math::Vector3(1.0f, 0.0f, 0.0f), Math::Vector3(-1.0f, 0.0f, 0.0f),
+            Math::Vector3(0.0f, 1.0f, 0.0f), Math::Vector3(0.0f, -1.0f, 0.0f),
+            Math::Vector3(0.0f, 0.0f, 1.0f), Math::Vector3(0.0f, 0.0f, -1.0f),
+        };
+
+        for (const Math::Vector3& axis : axes)
+        {
+            Math::Vector3 decoded = DecodeOct16(EncodeOct16(axis));
+            WARP_TEST_CHECK(Test::IsNear(decoded.x, axis.x, 1e-6) && Test::IsNear(decoded.y, axis.y, 1e-6) && Test::IsNear(decoded.z, axis.z, 1e-6));
+        }
+
+        Math::Vector3 zero = DecodeOct16(EncodeOct16(Math::Vector3(0.0f)));
+        WARP_TEST_CHECK(zero.x == 0.0f && zero.y == 0.0f && zero.z == 1.0f);
+
+        // Values of a power of two are exact in half precision, others are within half of the step of their binade
+        WARP_TEST_CHECK(DecodeHalf2(EncodeHalf2(Math::Vector2(0.5f, -2.0f))) == Math::Vector2(0.5f, -2.0f));
+        Math::Vector2 decoded = DecodeHalf2(EncodeHalf2(Math::Vector2(0.3f, 0.9f)));
+        WARP_TEST_CHECK(Test::IsNear(decoded.x, 0.3f, 1.0 / 8192.0) && Test::IsNear(decoded.y, 0.9f, 1.0 / 4096.0));
+    }
+
+    WARP_TEST(VertexQuantization_QuantizedStreamsStayWithinErrorBounds)
+    {
+        // Every 32nd vertex starts a new word of bitangent signs, the count leaves a partial word at the end
+        QuantizationTestMesh mesh = MakeQuantizationTestMesh(1000, 7);
+        Submesh reference = MakeQuantizationTestView(mesh, false);
+        Submesh quantized = MakeQuantizationTestView(mesh, true);
+
+        VertexQuantizationError error = MeasureQuantizationError(reference, quantized);
+        WARP_TEST_CHECK(error.MaxPositionError > 0.0f && error.MaxPositionError <= mesh.Bounds.GetMaxError() + 1e-5f);
+
+        // Oct16 is within a few thousandths of a degree, float math of the comparison adds a few hundredths
+        WARP_TEST_CHECK(error.MaxNormalError < 0.05f && error.MaxTangentError < 0.05f);
+        WARP_TEST_CHECK(error.MaxBitangentError < 0.1f);
+        WARP_TEST_CHECK(error.MaxTexCoordError <= 1.0f / 4096.0f);
+
+        // The flat axis decodes to its minimum exactly
+        std::vector<float> positions;
+        WARP_TEST_CHECK(DecodeVertexAttribute(quantized, eVertexAttribute_Positions, positions));
+        WARP_TEST_CHECK(mesh.Bounds.Extent.z == 0.0f);
+        for (size_t i = 0; i < positions.size(); i += 3)
+        {
+            WARP_TEST_CHECK(positions[i + 2] == 1.0f);
+        }
+
+        // Float streams decode to themselves. Angles between equal vectors are only zero up to the precision of acos() near 1
+        VertexQuantizationError noError = MeasureQuantizationError(reference, reference);
+        WARP_TEST_CHECK(noError.MaxPositionError == 0.0f && noError.MaxTexCoordError == 0.0f);
+        WARP_TEST_CHECK(noError.MaxNormalError < 0.05f && noError.MaxTangentError < 0.05f && noError.MaxBitangentError < 0.05f);
+
+        // Errors of submeshes combine into the largest ones
+        VertexQuantizationError merged = noError;
+        merged.Merge(error);
+        merged.Merge(noError);
+        WARP_TEST_CHECK(merged.MaxPositionError == error.MaxPositionError && merged.MaxTexCoordError == error.MaxTexCoordError);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "Test.h"
+
+#include <vector>
+
+#include "../src/World/Components.h"
+#include "../src/World/World.h"
+
+namespace Warp
+{
+
+    static bool IsNearPoint(const Math::Vector3& a, const Math::Vector3& b)
+    {
+        return Test::IsNear(a.x, b.x, 1e-5) && Test::IsNear(a.y, b.y, 1e-5) && Test::IsNear(a.z, b.z, 1e-5);
+    }
+
+    static Math::Vector3 GetWorldOrigin(const World& world, Entity entity)
+    {
+        return Math::Vector3::Transform(Math::Vector3(0.0f), world.GetInstanceToWorld(entity));
+    }
+
+    WARP_TEST(World_InstanceToWorldCombinesParentChain)
+    {
+        World world("Test World");
+
+        // Root scales its subtree by 2, every child is offset from its parent
+        std::vector<Entity> entities(4);
+        world.CreateEntities(entities);
+
+        const std::vector<TransformComponent> transforms = {
+            TransformComponent(Math::Vector3(1.0f, 0.0f, 0.0f), Math::Vector3(0.0f), Math::Vector3(2.0f)),
+            TransformComponent(Math::Vector3(0.0f, 1.0f, 0.0f), Math::Vector3(0.0f), Math::Vector3(1.0f)),
+            TransformComponent(Math::Vector3(0.0f, 0.0f, 1.0f), Math::Vector3(0.0f), Math::Vector3(1.0f)),
+            TransformComponent(Math::Vector3(5.0f, 0.0f, 0.0f), Math::Vector3(0.0f), Math::Vector3(1.0f)),
+        };
+        const std::vector<Entity> children = { entities[1], entities[2] };
+        const std::vector<ParentComponent> parents = { ParentComponent(entities[0]), ParentComponent(entities[1]) };
+
+        EntityCapacitor& capacitor = world.GetEntityCapacitor();
+        capacitor.InsertComponents<TransformComponent>(entities, transforms);
+        capacitor.InsertComponents<ParentComponent>(children, parents);
+
+        // Batched entities carry no name. Distinct origins below show that each one got its own transform
+        for (const Entity& entity : entities)
+        {
+            WARP_TEST_CHECK(capacitor.IsValid(entity) && !capacitor.HasComponents<NametagComponent>(entity));
+        }
+
+        WARP_TEST_CHECK(IsNearPoint(GetWorldOrigin(world, entities[0]), Math::Vector3(1.0f, 0.0f, 0.0f)));
+        WARP_TEST_CHECK(IsNearPoint(GetWorldOrigin(world, entities[1]), Math::Vector3(1.0f, 2.0f, 0.0f)));
+        WARP_TEST_CHECK(IsNearPoint(GetWorldOrigin(world, entities[2]), Math::Vector3(1.0f, 2.0f, 2.0f)));
+        WARP_TEST_CHECK(IsNearPoint(GetWorldOrigin(world, entities[3]), Math::Vector3(5.0f, 0.0f, 0.0f)));
+
+        // Chains end at a parent that is gone, the rest of the chain still applies
+        entities[0] = world.RemoveEntity(entities[0]);
+        WARP_TEST_CHECK(IsNearPoint(GetWorldOrigin(world, entities[2]), Math::Vector3(0.0f, 1.0f, 1.0f)));
+    }
+
+}
\ No newline at end of file